@@ -6,6 +6,14 @@ struct DirLight {
 	vec3 diffuse;
 };
 
+struct LocalLight {
+	vec4 position_range;
+	// w: cos of the inner cone angle
+	vec4 colour_inner;
+	// w: cos of the outer cone angle
+	vec4 direction_outer;
+};
+
 const uint ALPHA_OPAQUE = 0;
 const uint ALPHA_BLEND = 1;
 const uint ALPHA_MASK = 2;
@@ -16,12 +24,37 @@ struct Material {
 	vec4 emissive;
 };
 
+const uint MAX_CASCADES = 4;
+
+layout (set = 0, binding = 0) uniform VP {
+	mat4 mat_vp;
+	vec4 vpos_exposure;
+	mat4 mat_shadow;
+	vec4 shadow_dir;
+	vec4 front_cascades;
+	vec4 cascade_far;
+	vec4 cascade_rects[MAX_CASCADES];
+	mat4 cascade_mats[MAX_CASCADES];
+	// w: local light count
+	uvec4 cluster_grid;
+	vec4 cluster_depth;
+};
+
 layout (set = 1, binding = 0) readonly buffer DL {
 	DirLight dir_lights[];
 };
 
 layout (set = 1, binding = 1) uniform sampler2D shadow_map;
 
+layout (set = 1, binding = 2) readonly buffer LL {
+	LocalLight local_lights[];
+};
+
+// [offset, count] per cluster, followed by light indices
+layout (set = 1, binding = 3) readonly buffer LC {
+	uint cluster_data[];
+};
+
 layout (set = 2, binding = 0) uniform sampler2D base_colour;
 layout (set = 2, binding = 1) uniform sampler2D roughness_metallic;
 layout (set = 2, binding = 2) uniform sampler2D emissive;
@@ -82,6 +115,38 @@ vec3 gamc(vec3 a) {
 	);
 }
 
+vec3 radiance(vec3 N, vec3 V, vec3 L, vec3 light_colour, float roughness, float metallic, vec3 f0) {
+	vec3 H = normalize(V + L);
+
+	float NdotL = max(dot(N, L), 0.0);
+	float NdotV = max(dot(N, V), 0.0);
+
+	float NDF = distribution_ggx(N, H, roughness);
+	float G = geometry_smith(NdotV, NdotL, roughness);
+	vec3 F = fresnel_schlick(max(dot(H, V), 0.0), f0);
+
+	vec3 kS = F;
+	vec3 kD = vec3(1.0) - kS;
+	kD *= 1.0 - metallic;
+
+	vec3 num = NDF * kS * G;
+	float denom = 4.0 * NdotV * NdotL + 0.0001;
+	vec3 spec = num / denom;
+
+	return (kD * vec3(material.albedo) / pi_v + spec) * light_colour * max(in_vpos_exposure.w, 0.0) * NdotL;
+}
+
+uint cluster_index() {
+	vec4 clip = mat_vp * in_fpos;
+	vec2 tile = clamp(clip.xy / clip.w * 0.5 + 0.5, 0.0, 1.0) * vec2(cluster_grid.xy);
+	uvec2 xy = min(uvec2(tile), cluster_grid.xy - 1u);
+	// same mapping as LightClusters: logarithmic slices for perspective views, linear otherwise
+	float depth = dot(in_fpos.xyz - vpos_exposure.xyz, front_cascades.xyz);
+	float d = cluster_depth.z > 0.0 ? log(max(depth, 1e-30)) : depth;
+	uint z = uint(clamp(floor(d * cluster_depth.x + cluster_depth.y), 0.0, float(cluster_grid.z - 1u)));
+	return (z * cluster_grid.y + xy.y) * cluster_grid.x + xy.x;
+}
+
 vec3 cook_torrance() {
 	float roughness = material.m_r_aco_am.y * texture(roughness_metallic, in_uv).g;
 	float metallic = material.m_r_aco_am.x * texture(roughness_metallic, in_uv).b;
@@ -92,25 +157,26 @@ vec3 cook_torrance() {
 	vec3 N = in_normal;
 	for (int i = 0; i < dir_lights.length(); ++i) {
 		DirLight light = dir_lights[i];
-		vec3 L = -light.direction;
-		vec3 H = normalize(V + L);
-
-		float NdotL = max(dot(N, L), 0.0);
-		float NdotV = max(dot(N, V), 0.0);
-
-		float NDF = distribution_ggx(N, H, roughness);
-		float G = geometry_smith(NdotV, NdotL, roughness);
-		vec3 F = fresnel_schlick(max(dot(H, V), 0.0), f0);
-
-		vec3 kS = F;
-		vec3 kD = vec3(1.0) - kS;
-		kD *= 1.0 - metallic;
-
-		vec3 num = NDF * kS * G;
-		float denom = 4.0 * NdotV * NdotL + 0.0001;
-		vec3 spec = num / denom;
+		L0 += radiance(N, V, -light.direction, light.diffuse, roughness, metallic, f0);
+	}
 
-		L0 += (kD * vec3(material.albedo) / pi_v + spec) * light.diffuse * max(in_vpos_exposure.w, 0.0) * NdotL;
+	if (cluster_grid.w > 0u) {
+		uint cluster = cluster_index();
+		uint offset = cluster_data[2u * cluster];
+		uint count = cluster_data[2u * cluster + 1u];
+		for (uint i = 0u; i < count; ++i) {
+			LocalLight light = local_lights[cluster_data[offset + i]];
+			vec3 to_light = light.position_range.xyz - in_fpos.xyz;
+			float range = light.position_range.w;
+			float dist = length(to_light);
+			if (dist >= range) { continue; }
+			vec3 L = to_light / max(dist, 0.0001);
+			// inverse square, windowed to reach zero at range
+			float window = clamp(1.0 - pow(dist / range, 4.0), 0.0, 1.0);
+			float attenuation = window * window / (dist * dist + 1.0);
+			float cone = smoothstep(light.direction_outer.w, light.colour_inner.w, dot(-L, light.direction_outer.xyz));
+			L0 += radiance(N, V, L, light.colour_inner.rgb * attenuation * cone, roughness, metallic, f0);
+		}
 	}
 
 	vec3 colour = max(L0, 0.03 * vec3(material.albedo));
@@ -120,7 +186,15 @@ vec3 cook_torrance() {
 }
 
 float compute_visibility() {
-	vec3 projected = in_fpos_shadow.xyz / in_fpos_shadow.w;
+	// pick the nearest cascade covering this fragment's view space depth
+	uint cascade_count = uint(front_cascades.w);
+	float depth = dot(in_fpos.xyz - in_vpos_exposure.xyz, front_cascades.xyz);
+	uint cascade = 0;
+	while (cascade < cascade_count && depth > cascade_far[cascade]) { ++cascade; }
+	if (cascade >= cascade_count) { return 1.0; }
+
+	vec4 fpos_shadow = cascade_mats[cascade] * in_fpos;
+	vec3 projected = fpos_shadow.xyz / fpos_shadow.w;
 	// float bias = max(0.05 * (1.0 - dot(in_normal, -in_shadow_dir)), 0.005);
 	float slope = tan(acos(max(dot(in_normal, -in_shadow_dir), 0.0)));
 	float bias = clamp(0.005 * slope, 0.001, 0.05);
@@ -129,9 +203,14 @@ float compute_visibility() {
 	projected.y = 1.0 - projected.y;
 	float ret = 1.0;
 	vec2 texel_size = 1.0 / textureSize(shadow_map, 0);
+	vec4 rect = cascade_rects[cascade];
+	// keep filter taps inside this cascade's region of the atlas
+	vec2 uv_min = rect.xy + 0.5 * texel_size;
+	vec2 uv_max = rect.xy + rect.zw - 0.5 * texel_size;
+	vec2 uv = rect.xy + projected.xy * rect.zw;
 	for (int x = -1; x <= 1; ++x) {
 		for (int y = -1; y <= 1; ++y) {
-			float pcf_depth = texture(shadow_map, projected.xy + vec2(x, y) * texel_size).x;
+			float pcf_depth = texture(shadow_map, clamp(uv + vec2(x, y) * texel_size, uv_min, uv_max)).x;
 			float shadow = current_depth > pcf_depth ? 0.1 : 0.0;
 			ret -= shadow;
 		}
@@ -33,13 +33,14 @@ namespace {
 namespace fs = std::filesystem;
 
 struct TestUiPrimitive : ui::Primitive {
-	using ui::Primitive::Primitive;
+	TestUiPrimitive() { set_ticking(true); }
 
 	bool clicked{};
 
 	void tick(WindowInput const& window_input, Duration dt) override {
 		View::tick(window_input, dt);
-		if (world_frame().contains(window_input.cursor)) {
+		auto const* hit = Service<SceneManager>::locate().active_scene().ui_hit_grid.hit_test(window_input.cursor);
+		if (hit && (hit == this || contains(hit))) {
 			tint() = yellow_v;
 			if (window_input.mouse.is_pressed(MouseButton::e1)) { clicked = true; }
 		} else {
@@ -64,9 +64,12 @@ set(graphics_headers
   include/levk/graphics/drawable.hpp
   include/levk/graphics/geometry.hpp
   include/levk/graphics/image.hpp
+  include/levk/graphics/light_clusters.hpp
   include/levk/graphics/lights.hpp
   include/levk/graphics/material.hpp
   include/levk/graphics/mesh.hpp
+  include/levk/graphics/mipmapped_image.hpp
+  include/levk/graphics/occlusion_culler.hpp
   include/levk/graphics/primitive.hpp
   include/levk/graphics/render_device.hpp
   include/levk/graphics/render_list.hpp
@@ -153,6 +156,7 @@ set(level_headers
 )
 
 set(ui_headers
+  include/levk/ui/hit_grid.hpp
   include/levk/ui/primitive.hpp
   include/levk/ui/text.hpp
   include/levk/ui/view.hpp
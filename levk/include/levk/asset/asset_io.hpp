@@ -111,9 +111,15 @@ void to_json(dj::Json& out, Skeleton const& asset);
 struct Mesh3D {
 	enum class Type { eStatic, eSkinned };
 
+	struct Lod {
+		Uri<BinGeometry> geometry{};
+		float screen_size{};
+	};
+
 	struct Primitive {
 		Uri<BinGeometry> geometry{};
 		Uri<Material> material{};
+		std::vector<Lod> lods{};
 	};
 
 	std::vector<Primitive> primitives{};
@@ -121,6 +127,9 @@ struct Mesh3D {
 	Uri<Skeleton> skeleton{};
 	std::string name{};
 	Type type{};
+	VertexFormat vertex_format{};
+	// static meshes only: keep CPU geometry for software occlusion culling
+	bool occluder{};
 };
 
 void from_json(dj::Json const& json, Mesh3D& out);
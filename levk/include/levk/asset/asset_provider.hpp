@@ -100,6 +100,8 @@ class AssetProvider {
 		: m_logger(log_context), m_storage(std::make_unique<Storage>(data_source)) {}
 
 	virtual Payload load_payload(Uri<Type> const& uri, Stopwatch const& stopwatch) const = 0;
+	// called once a loaded asset is stored (and visible through find()), outside the storage lock
+	virtual void on_loaded(Uri<Type> const& /*uri*/, Type& /*asset*/) {}
 
 	Logger m_logger{};
 
@@ -118,9 +120,12 @@ class AssetProvider {
 					listeners.push_back(uri_monitor()->on_modified(dependency).connect([this, uri](Uri<> const&) { m_storage->out_of_date.insert(uri); }));
 				}
 			}
-			auto lock = std::scoped_lock{m_storage->mutex};
+			auto lock = std::unique_lock{m_storage->mutex};
 			auto [it, _] = m_storage->map.insert_or_assign(uri, Entry{std::move(payload.asset), std::move(listeners)});
-			return &*it->second.asset;
+			auto* ret = &*it->second.asset;
+			lock.unlock();
+			on_loaded(uri, *ret);
+			return ret;
 		}
 		return {};
 	}
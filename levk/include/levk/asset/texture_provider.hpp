@@ -5,14 +5,57 @@
 namespace levk {
 class ThreadPool;
 
+struct TextureStreamingInfo {
+	// streamed textures are first uploaded downsampled to fit this extent
+	std::uint32_t initial_extent{128u};
+	// for the images of all streamed textures: least recently used ones drop their top mips when exceeded
+	std::uint64_t vram_budget{256u * 1024u * 1024u};
+	// concurrent loads of higher resolutions on the thread pool
+	std::uint32_t max_jobs{2u};
+	bool enabled{};
+};
+
+///
+/// \brief Loads Textures from images (PNG, JPG, etc), or JSON referencing one.
+///
+/// A texture's format follows its image's channels and usage: from its JSON ("usage"), else as declared by
+/// set_usage() (eg by materials referencing it), else TextureUsage::eColour.
+///
+/// If streaming is enabled, textures loaded thereafter start with only their lowest mips resident, and higher ones
+/// are loaded on the thread pool as they are needed: prioritised by how large they are drawn and how often they are bound.
+/// Streamed textures exceeding the VRAM budget evict the top mips of the least recently used ones.
+///
 class TextureProvider : public GraphicsAssetProvider<Texture> {
   public:
+	using StreamingInfo = TextureStreamingInfo;
+
 	static constexpr ColourSpace to_colour_space(std::string_view const str) {
 		if (str == "linear") { return ColourSpace::eLinear; }
 		return ColourSpace::eSrgb;
 	}
 
-	TextureProvider(NotNull<RenderDevice*> render_device, NotNull<DataSource const*> data_source);
+	static constexpr TextureUsage to_texture_usage(std::string_view const str) {
+		if (str == "mask") { return TextureUsage::eMask; }
+		if (str == "normal") { return TextureUsage::eNormal; }
+		if (str == "data") { return TextureUsage::eData; }
+		return TextureUsage::eColour;
+	}
+
+	static constexpr std::string_view from(TextureUsage const usage) {
+		switch (usage) {
+		case TextureUsage::eMask: return "mask";
+		case TextureUsage::eNormal: return "normal";
+		case TextureUsage::eData: return "data";
+		default: return "colour";
+		}
+	}
+
+	// streaming requires a thread pool
+	TextureProvider(NotNull<RenderDevice*> render_device, NotNull<DataSource const*> data_source, Ptr<ThreadPool> thread_pool = {});
+	~TextureProvider();
+
+	TextureProvider(TextureProvider&&) noexcept;
+	TextureProvider& operator=(TextureProvider&&) noexcept;
 
 	Texture const& get(Uri<Texture> const& uri, Uri<Texture> const& fallback = "white") const;
 	void clear() override;
@@ -20,10 +63,29 @@ class TextureProvider : public GraphicsAssetProvider<Texture> {
 	Ptr<Texture const> white() const { return find("white"); }
 	Ptr<Texture const> black() const { return find("black"); }
 
+	// applies when the texture is next loaded (or reloaded); a usage in its JSON takes precedence
+	void set_usage(Uri<Texture> const& uri, TextureUsage usage);
+	TextureUsage usage_for(Uri<Texture> const& uri) const;
+
+	StreamingInfo const& streaming() const;
+	// applies to textures loaded subsequently; the budget applies immediately
+	void set_streaming(StreamingInfo const& info);
+	// bytes of streamed textures' resident images
+	std::uint64_t streamed_bytes() const;
+	// uploads completed loads, requests new ones and enforces the budget: call once per frame
+	void update_streaming();
+
   private:
+	struct Streamer;
+	struct Usages;
+
 	void add_default_textures();
 
 	Payload load_payload(Uri<Texture> const& uri, Stopwatch const& stopwatch) const override;
+	void on_loaded(Uri<Texture> const& uri, Texture& texture) override;
+
+	std::unique_ptr<Streamer> m_streamer;
+	std::unique_ptr<Usages> m_usages;
 };
 
 class CubemapProvider : public GraphicsAssetProvider<Cubemap> {
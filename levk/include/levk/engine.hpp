@@ -11,10 +11,14 @@ struct FontLibrary;
 class ThreadPool;
 class Scene;
 
+// eHeadless: no display, renders offscreen at window_extent; eNull: no display or GPU, assets only keep their metadata
+enum class EngineBackend : std::uint8_t { eWindowed, eHeadless, eNull };
+
 struct EngineCreateInfo {
 	glm::uvec2 window_extent{1280u, 720u};
 	char const* window_title{"levk"};
 	bool autoshow{};
+	EngineBackend backend{EngineBackend::eWindowed};
 
 	RenderDeviceCreateInfo render_device_create_info{};
 };
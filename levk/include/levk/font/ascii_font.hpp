@@ -2,6 +2,7 @@
 #include <levk/font/static_font_atlas.hpp>
 #include <levk/graphics/geometry.hpp>
 #include <levk/util/not_null.hpp>
+#include <array>
 
 namespace levk {
 enum struct Ascii : char {
@@ -12,10 +13,19 @@ class AsciiFont {
   public:
 	class Pen;
 	struct Out;
+	struct GlyphTable;
 
 	AsciiFont(std::unique_ptr<GlyphSlot::Factory> slot_factory, NotNull<TextureProvider*> texture_provider, Uri<Texture> uri_prefix);
 
 	FontGlyph const& glyph_for(Ascii ascii, TextHeight height);
+	///
+	/// \brief Obtain the glyphs of height, creating its atlas if needed.
+	/// \param height Height of glyphs
+	/// \returns Pointer to table (stable until the atlas is destroyed), null if the atlas couldn't be created
+	///
+	/// A table created after an atlas is destroyed may reuse the old one's address: compare generations to detect that.
+	///
+	Ptr<GlyphTable const> glyph_table(TextHeight height);
 
 	Ptr<StaticFontAtlas const> make_font_atlas(TextHeight height);
 	Ptr<StaticFontAtlas const> find_font_atlas(TextHeight height) const;
@@ -28,11 +38,33 @@ class AsciiFont {
 
   private:
 	std::unordered_map<TextHeight, StaticFontAtlas> m_atlases{};
+	std::unordered_map<TextHeight, GlyphTable> m_tables{};
+	// bumped whenever a table is destroyed
+	std::uint64_t m_generation{};
 	std::unique_ptr<GlyphSlot::Factory> m_slot_factory{};
 	Uri<Texture> m_uri_prefix{};
 	NotNull<TextureProvider*> m_texure_provider;
 };
 
+///
+/// \brief Glyphs of one height indexed by ASCII value, with missing ones (and non ASCII values) replaced by tofu.
+///
+/// Avoids a hash lookup per character when laying out text.
+///
+struct AsciiFont::GlyphTable {
+	static constexpr std::size_t size_v{128};
+
+	std::array<FontGlyph, size_v> glyphs{};
+	Uri<Texture> texture_uri{};
+	// generation of the owning AsciiFont when this table was created
+	std::uint64_t generation{};
+
+	FontGlyph const& operator[](char const ch) const {
+		auto const index = static_cast<unsigned char>(ch);
+		return glyphs[index < size_v ? index : static_cast<std::size_t>(Ascii::eTofu)];
+	}
+};
+
 struct AsciiFont::Out {
 	Ptr<Geometry> geometry{};
 	Ptr<Uri<Texture>> atlas{};
@@ -40,7 +72,7 @@ struct AsciiFont::Out {
 
 class AsciiFont::Pen {
   public:
-	Pen(AsciiFont& font, TextHeight height = TextHeight::eDefault) : m_font(font), m_height(clamp(height)) {}
+	Pen(AsciiFont& font, TextHeight height = TextHeight::eDefault) : m_height(clamp(height)), m_glyphs(font.glyph_table(m_height)) {}
 
 	Pen& write_line(std::string_view line, Out out);
 	glm::vec2 line_extent(std::string_view line) const;
@@ -53,7 +85,7 @@ class AsciiFont::Pen {
   private:
 	struct Writer;
 
-	AsciiFont& m_font;
 	TextHeight m_height;
+	Ptr<GlyphTable const> m_glyphs;
 };
 } // namespace levk
@@ -22,5 +22,8 @@ struct FrameProfile {
 	};
 
 	EnumArray<Type, Duration> profile{};
+	// GPU execution time of each render section's passes, and of the whole frame in eFrameTime
+	// from timestamp queries, a few frames behind profile; zero if the GPU doesn't support timestamps
+	EnumArray<Type, Duration> gpu{};
 };
 } // namespace levk
@@ -10,7 +10,15 @@ class Window;
 using Extent2D = glm::uvec2;
 
 enum class ColourSpace : std::uint8_t { eSrgb, eLinear };
+// picks a texture's format from its image's channels:
+// eColour: source channels are kept (grey / grey-alpha are sampled as RGB / RGBA)
+// eMask: first channel only, linear, sampled in every component (eg glyph coverage, single channel masks)
+// eNormal: first two channels only, linear (shaders must reconstruct z)
+// eData: source channels are kept, always linear (eg glTF metallic-roughness: roughness in G, metallic in B)
+enum class TextureUsage : std::uint8_t { eColour, eMask, eNormal, eData };
 enum class MeshType : std::uint8_t { eNone, eStatic, eSkinned };
+// ePacked: quantized positions, octahedral normals, unorm8 colours, half-float uvs, u8/u16 joints, unorm16 weights
+enum class VertexFormat : std::uint8_t { eFull, ePacked, eCOUNT_ };
 
 struct RenderMode {
 	enum class Type : std::uint8_t { eDefault, eFill, eLine, ePoint };
@@ -27,6 +35,7 @@ struct RenderMode {
 inline constexpr std::size_t max_sets_v{16};
 inline constexpr std::size_t max_bindings_v{16};
 inline constexpr std::size_t max_lights_v{4};
+inline constexpr std::size_t max_shadow_cascades_v{4};
 inline constexpr float render_scale_limit_v[] = {0.2f, 8.0f};
 inline constexpr Extent2D shadow_resolution_limit_v[] = {{256, 256}, {8192, 8192}};
 inline constexpr glm::vec2 shadow_frustum_limit_v[] = {{1.0f, 1.0f}, {1024.0f, 1024.0f}};
@@ -17,6 +17,7 @@ class DrawList {
 	struct Instances {
 		glm::mat4 parent{1.0f};
 		std::span<Transform const> instances{};
+		bool is_static{};
 	};
 
 	struct Skin {
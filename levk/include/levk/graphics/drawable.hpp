@@ -7,6 +7,7 @@
 
 namespace levk {
 class Material;
+struct Occluder;
 
 struct Drawable {
 	NotNull<vulkan::Primitive*> primitive;
@@ -19,5 +20,13 @@ struct Drawable {
 	glm::mat4 parent{1.0f};
 	std::span<Transform const> instances{};
 	Topology topology{Topology::eTriangleList};
+
+	// selected per instance by the renderer, using a bounding sphere of radius around each instance's origin
+	std::span<PrimitiveLod const> lods{};
+	float radius{};
+	// rasterized by the occlusion culler at each instance, if set
+	Ptr<Occluder const> occluder{};
+	// parent and instances never change: may be drawn into cached shadow layers
+	bool is_static{};
 };
 } // namespace levk
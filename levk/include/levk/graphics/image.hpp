@@ -5,7 +5,9 @@
 
 namespace levk {
 ///
-/// \brief Storage for uncompressed RGBA image data (as bytes)
+/// \brief Storage for uncompressed image data (as bytes)
+///
+/// The source's channel count is kept: grey (1), grey + alpha (2), or RGBA (4); RGB is expanded to RGBA.
 ///
 class Image {
   public:
@@ -42,6 +44,11 @@ class Image {
 	/// \returns The name
 	///
 	std::string_view name() const { return m_name; }
+	///
+	/// \brief Obtain the number of channels per pixel.
+	/// \returns 1, 2 or 4 (0 if empty)
+	///
+	std::uint8_t channels() const { return m_channels; }
 
 	operator View() const { return view(); }
 
@@ -66,6 +73,7 @@ class Image {
 	std::string m_name{};
 	Unique<Storage, Storage::Deleter> m_storage{};
 	glm::uvec2 m_extent{};
+	std::uint8_t m_channels{};
 };
 
 struct ImageWrite {
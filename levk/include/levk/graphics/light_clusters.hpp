@@ -0,0 +1,95 @@
+#pragma once
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <levk/graphics/camera.hpp>
+#include <levk/graphics/common.hpp>
+#include <span>
+#include <vector>
+
+namespace levk {
+class ThreadPool;
+
+///
+/// \brief Bounding sphere of a light's area of influence, in world space.
+///
+struct LightBounds {
+	glm::vec3 centre{};
+	float radius{};
+};
+
+///
+/// \brief Assigns lights to clusters of a view frustum: a 3D grid of screen space tiles, each sliced by view depth.
+///
+/// Fragments only shade the lights in their cluster's list, so the cost per fragment stays roughly constant however
+/// many lights a scene has. Slices are logarithmic in depth for perspective cameras and linear for orthographic ones;
+/// fragments beyond max_depth use the last slice. Built entirely on the CPU: slices are split among worker threads,
+/// and lights are tested against tile planes four at a time with SSE2 where available.
+///
+class LightClusters {
+  public:
+	// tiles in x and y are tracked in 32 bit masks
+	static constexpr std::uint32_t max_tiles_v{32u};
+	static constexpr glm::uvec3 default_grid_v{16u, 9u, 24u};
+	static constexpr float default_max_depth_v{500.0f};
+
+	explicit LightClusters(glm::uvec3 grid = default_grid_v, float max_depth = default_max_depth_v);
+
+	///
+	/// \brief Rebuild the light list of every cluster.
+	/// \param camera Camera to build clusters for
+	/// \param extent Viewport extent
+	/// \param lights Bounds of lights; lists store indices into this span
+	/// \param thread_pool ThreadPool to build slices on, if any
+	///
+	void build(Camera const& camera, Extent2D extent, std::span<LightBounds const> lights, Ptr<ThreadPool> thread_pool = {});
+
+	///
+	/// \brief Light lists: an [offset, count] pair per cluster (x fastest, then y, then z), followed by the light indices they refer to.
+	///
+	std::span<std::uint32_t const> data() const { return m_data; }
+	glm::uvec3 grid() const { return m_grid; }
+	///
+	/// \brief Parameters to map view depth to a slice: slice = d * x + y, where d is log(depth) if z is 1, depth otherwise.
+	///
+	glm::vec4 const& depth_params() const { return m_depth_params; }
+	std::size_t cluster_count() const { return std::size_t{m_grid.x} * m_grid.y * m_grid.z; }
+
+  private:
+	// tile edge planes in structure of arrays form, padded to a multiple of four
+	struct Planes {
+		std::vector<float> x{};
+		std::vector<float> y{};
+		std::vector<float> z{};
+		std::vector<float> w{};
+
+		void set(std::uint32_t tiles, glm::vec4 const& row, glm::vec4 const& w_row);
+		// bit i of the returned masks is set if the sphere reaches the positive / negative side of edge i
+		std::pair<std::uint64_t, std::uint64_t> sides(glm::vec3 const& centre, float radius) const;
+	};
+
+	// a light's rect of tiles in a slice
+	struct Span {
+		std::uint32_t light{};
+		std::uint32_t z{};
+		glm::uvec2 x{};
+		glm::uvec2 y{};
+	};
+
+	std::uint32_t slice_of(float depth) const;
+	void assign(std::span<LightBounds const> lights, glm::uvec2 slices, std::vector<Span>& out);
+	void fill(std::span<Span const> spans);
+
+	std::vector<std::uint32_t> m_data{};
+	// per cluster: assigned lights, then write cursor
+	std::vector<std::uint32_t> m_counts{};
+	std::vector<std::vector<Span>> m_spans{};
+	std::vector<float> m_slice_depths{};
+	Planes m_columns{};
+	Planes m_rows{};
+	glm::vec4 m_depth_params{};
+	glm::vec3 m_eye{};
+	glm::vec3 m_front{};
+	glm::uvec3 m_grid{};
+	float m_max_depth{};
+};
+} // namespace levk
@@ -2,6 +2,7 @@
 #include <glm/gtx/quaternion.hpp>
 #include <levk/graphics/rgba.hpp>
 #include <levk/util/nvec3.hpp>
+#include <levk/util/radians.hpp>
 #include <vector>
 
 namespace levk {
@@ -23,10 +24,74 @@ struct DirLight {
 	HdrRgba rgb{white_v, 5.0f};
 };
 
+///
+/// \brief Point light.
+///
+struct PointLight {
+	///
+	/// \brief World position.
+	///
+	glm::vec3 position{};
+	///
+	/// \brief Colour and intensity.
+	///
+	/// Alpha is ignored.
+	///
+	HdrRgba rgb{white_v, 5.0f};
+	///
+	/// \brief Distance at which the light's contribution falls to zero.
+	///
+	float range{10.0f};
+};
+
+///
+/// \brief Spot light: a point light restricted to a cone.
+///
+struct SpotLight {
+	///
+	/// \brief World position.
+	///
+	glm::vec3 position{};
+	///
+	/// \brief Direction of the cone's axis.
+	///
+	glm::quat direction{glm::angleAxis(glm::radians(180.0f), up_v)};
+	///
+	/// \brief Colour and intensity.
+	///
+	/// Alpha is ignored.
+	///
+	HdrRgba rgb{white_v, 5.0f};
+	///
+	/// \brief Distance at which the light's contribution falls to zero.
+	///
+	float range{10.0f};
+	///
+	/// \brief Half angle of the cone within which the light is at full intensity.
+	///
+	Radians inner_angle{Degrees{20.0f}};
+	///
+	/// \brief Half angle of the cone, the light fades out between inner_angle and this.
+	///
+	Radians outer_angle{Degrees{30.0f}};
+};
+
+///
+/// \brief Lights in a scene.
+///
+/// Directional lights are shaded for every fragment (up to max_lights_v including the primary); point and spot lights
+/// are assigned to clusters of the view frustum, and each fragment only shades those in its cluster.
+///
 struct Lights {
 	static constexpr std::uint32_t set_v{1u};
+	// point and spot lights
+	static constexpr std::uint32_t local_binding_v{2u};
+	// light lists per cluster
+	static constexpr std::uint32_t cluster_binding_v{3u};
 
 	DirLight primary{};
 	std::vector<DirLight> dir_lights{};
+	std::vector<PointLight> point_lights{};
+	std::vector<SpotLight> spot_lights{};
 };
 } // namespace levk
@@ -25,12 +25,14 @@ inline constexpr std::size_t max_textures_v{8};
 
 struct MaterialTextures : Serializable {
 	std::array<Uri<Texture>, max_textures_v> uris{};
+	// declared to the TextureProvider before loading, to pick each texture's format
+	std::array<TextureUsage, max_textures_v> usages{};
 
 	std::string_view type_name() const override { return "MaterialTextures"; }
 	bool serialize(dj::Json& out) const override;
 	bool deserialize(dj::Json const& json) override;
 
-	bool operator==(MaterialTextures const& rhs) const { return uris == rhs.uris; }
+	bool operator==(MaterialTextures const& rhs) const { return uris == rhs.uris && usages == rhs.usages; }
 };
 
 class Material : public Serializable, public Inspectable {
@@ -1,5 +1,6 @@
 #pragma once
 #include <glm/mat4x4.hpp>
+#include <levk/graphics/occlusion_culler.hpp>
 #include <levk/graphics/primitive.hpp>
 #include <levk/uri.hpp>
 
@@ -17,15 +18,25 @@ struct StaticMesh : Mesh {
 	struct Primitive {
 		StaticPrimitive primitive;
 		Uri<Material> material;
+		// ordered by decreasing screen_size
+		std::vector<PrimitiveLod> lods{};
+		// bounding sphere around the model space origin
+		float radius{};
 	};
 
 	std::vector<Primitive> primitives{};
+	// coarsest geometry of all primitives, if the mesh is an occluder
+	Occluder occluder{};
 };
 
 struct SkinnedMesh : Mesh {
 	struct Primitive {
 		SkinnedPrimitive primitive;
 		Uri<Material> material;
+		// ordered by decreasing screen_size
+		std::vector<PrimitiveLod> lods{};
+		// bounding sphere around the model space origin, in bind pose
+		float radius{};
 	};
 
 	std::vector<Primitive> primitives{};
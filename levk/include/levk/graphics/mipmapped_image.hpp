@@ -0,0 +1,82 @@
+#pragma once
+#include <levk/graphics/common.hpp>
+#include <levk/graphics/image.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace levk {
+enum class ImageFormat : std::uint8_t { eRgba8, eBc1, eBc3, eBc5, eBc7 };
+
+///
+/// \brief Storage for image data and its precomputed mip chain, parsed from a levk texture, KTX2 or DDS container.
+///
+/// Mip bytes are uploaded as they are in the file. Only single layer 2D images without supercompression are supported;
+/// KTX2 / DDS containers must be block compressed (BC1/3/5/7).
+///
+class MipmappedImage {
+  public:
+	struct Mip {
+		std::span<std::byte const> bytes{};
+		Extent2D extent{};
+	};
+
+	///
+	/// \brief Check if bytes begin with a levk texture, KTX2 or DDS identifier.
+	///
+	static bool is_container(std::span<std::byte const> bytes);
+
+	///
+	/// \brief Bake an image into a levk texture container.
+	/// \param image Image to bake (expanded to RGBA if it has fewer channels)
+	/// \param colour_space Colour space of image (sRGB mips are filtered in linear space)
+	/// \returns Container bytes: a header followed by every mip level, ready to copy into staging memory
+	///
+	static ByteArray bake(Image::View image, ColourSpace colour_space);
+
+	MipmappedImage() = default;
+
+	///
+	/// \brief Construct an instance and parse a container.
+	/// \param bytes Container bytes (owned by this instance)
+	/// \param name Name of the image (optional)
+	///
+	explicit MipmappedImage(ByteArray bytes, std::string name = {});
+
+	ImageFormat format() const { return m_format; }
+	///
+	/// \brief Obtain the colour space, if the container specifies one.
+	///
+	std::optional<ColourSpace> colour_space() const { return m_colour_space; }
+	Extent2D extent() const { return m_mips.empty() ? Extent2D{} : m_mips.front().extent; }
+	///
+	/// \brief Obtain the mip chain, largest first.
+	///
+	std::span<Mip const> mips() const { return m_mips; }
+	std::string_view name() const { return m_name; }
+
+	bool is_block_compressed() const { return m_format != ImageFormat::eRgba8; }
+	///
+	/// \brief Decode a mip into RGBA.
+	/// \returns Decoded pixels, empty if mip is out of range
+	///
+	DynPixelMap decode(std::size_t mip) const;
+
+	explicit operator bool() const { return !m_mips.empty(); }
+
+  private:
+	std::string m_name{};
+	ByteArray m_bytes{};
+	std::vector<Mip> m_mips{};
+	ImageFormat m_format{};
+	std::optional<ColourSpace> m_colour_space{};
+};
+
+///
+/// \brief Downsample an image to its next mip level with a 2x2 box filter.
+/// \param image Image to downsample (expanded to RGBA if it has fewer channels)
+/// \param colour_space Colour space of image (sRGB texels are averaged in linear space)
+/// \returns RGBA image of half the extent (at least 1x1)
+///
+DynPixelMap downsample(Image::View image, ColourSpace colour_space);
+} // namespace levk
@@ -0,0 +1,66 @@
+#pragma once
+#include <glm/mat4x4.hpp>
+#include <levk/graphics/common.hpp>
+#include <span>
+#include <vector>
+
+namespace levk {
+///
+/// \brief CPU side geometry rasterized by OcclusionCuller to hide what lies behind it.
+///
+struct Occluder {
+	std::vector<glm::vec3> positions{};
+	std::vector<std::uint32_t> indices{};
+};
+
+///
+/// \brief Software occlusion culler: rasterizes occluders into a low resolution depth buffer, and tests bounds against its Hi-Z pyramid.
+///
+/// Runs entirely on the CPU. Depth is stored reversed (1 at the near plane, 0 at the far plane / where nothing was drawn),
+/// so each pyramid level keeps the minimum, ie farthest, depth of the texels it covers.
+///
+class OcclusionCuller {
+  public:
+	static constexpr Extent2D default_extent_v{256u, 128u};
+
+	explicit OcclusionCuller(Extent2D extent = default_extent_v);
+
+	///
+	/// \brief Clear the depth buffer and set the view-projection matrix used by subsequent calls.
+	///
+	void begin(glm::mat4 const& view_projection);
+	///
+	/// \brief Rasterize an indexed triangle list (both windings). Triangles crossing the near plane are skipped.
+	///
+	void add_occluder(Occluder const& occluder, glm::mat4 const& model);
+	///
+	/// \brief Build the Hi-Z pyramid; must be called after all occluders are added and before testing.
+	///
+	void build_pyramid();
+
+	///
+	/// \brief Check whether a world space bounding sphere is entirely behind rasterized occluders.
+	/// Bounds crossing the near plane or leaving the viewport are never reported as occluded.
+	///
+	bool is_occluded(glm::vec3 const& centre, float radius) const;
+
+	Extent2D extent() const { return m_extent; }
+	std::span<float const> depth() const { return m_levels.empty() ? std::span<float const>{} : m_levels.front().texels; }
+	std::size_t occluder_triangles() const { return m_triangles; }
+
+  private:
+	struct Level {
+		std::vector<float> texels{};
+		Extent2D extent{};
+
+		float at(std::uint32_t x, std::uint32_t y) const { return texels[y * extent.x + x]; }
+	};
+
+	void rasterize(glm::vec3 a, glm::vec3 b, glm::vec3 c);
+
+	std::vector<Level> m_levels{};
+	glm::mat4 m_view_projection{1.0f};
+	Extent2D m_extent{};
+	std::size_t m_triangles{};
+};
+} // namespace levk
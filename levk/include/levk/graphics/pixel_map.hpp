@@ -79,4 +79,6 @@ class DynPixelMap : public PixelMap {
 };
 
 ByteArray to_byte_array(PixelMap const& pixel_map);
+// grey (1) and grey + alpha (2) channels are expanded, RGBA (4) is copied
+DynPixelMap to_rgba(PixelMap::View view);
 } // namespace levk
@@ -1,4 +1,5 @@
 #pragma once
+#include <levk/graphics/common.hpp>
 #include <levk/graphics/geometry.hpp>
 #include <levk/graphics/shader_code.hpp>
 #include <levk/uri.hpp>
@@ -8,12 +9,13 @@ namespace levk {
 enum class Topology : std::uint8_t { ePointList, eLineList, eLineStrip, eTriangleList, eTriangleStrip, eTriangleFan };
 
 namespace vulkan {
-struct Device;
 struct Primitive;
 class UploadedPrimitive;
 class HostPrimitive;
 } // namespace vulkan
 
+class RenderDevice;
+
 class Primitive {
   public:
 	virtual ~Primitive() = default;
@@ -28,7 +30,8 @@ class Primitive {
 
 class StaticPrimitive : public Primitive {
   public:
-	StaticPrimitive(vulkan::Device& device, Geometry::Packed const& geometry);
+	// with a null RenderDevice nothing is uploaded: counts are kept, draws are no-ops
+	StaticPrimitive(RenderDevice const& device, Geometry::Packed const& geometry, VertexFormat format = VertexFormat::eFull);
 
 	std::uint32_t vertex_count() const final;
 	std::uint32_t index_count() const final;
@@ -44,7 +47,7 @@ class StaticPrimitive : public Primitive {
 
 class SkinnedPrimitive : public Primitive {
   public:
-	SkinnedPrimitive(vulkan::Device& device, Geometry::Packed const& geometry, MeshJoints const& joints);
+	SkinnedPrimitive(RenderDevice const& device, Geometry::Packed const& geometry, MeshJoints const& joints, VertexFormat format = VertexFormat::eFull);
 
 	std::uint32_t vertex_count() const final;
 	std::uint32_t index_count() const final;
@@ -60,9 +63,14 @@ class SkinnedPrimitive : public Primitive {
 
 class DynamicPrimitive : public Primitive {
   public:
-	DynamicPrimitive(vulkan::Device& device);
+	DynamicPrimitive(RenderDevice const& device);
 
 	void set_geometry(Geometry::Packed geometry);
+	Geometry::Packed const& geometry() const;
+	///
+	/// \brief Obtain the geometry for modification in place (retains capacity); it is re-uploaded on the next draw.
+	///
+	Geometry::Packed& edit_geometry();
 
 	std::uint32_t vertex_count() const final;
 	std::uint32_t index_count() const final;
@@ -75,4 +83,13 @@ class DynamicPrimitive : public Primitive {
 
 	std::unique_ptr<vulkan::HostPrimitive, Deleter> m_primitive{};
 };
+
+///
+/// \brief Simplified geometry drawn in place of a full detail primitive while it is small on screen.
+///
+struct PrimitiveLod {
+	std::unique_ptr<Primitive> primitive{};
+	// used while the projected bounding sphere covers less than this fraction of the viewport height
+	float screen_size{};
+};
 } // namespace levk
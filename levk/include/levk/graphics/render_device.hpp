@@ -3,10 +3,14 @@
 #include <levk/graphics/camera.hpp>
 #include <levk/graphics/common.hpp>
 #include <levk/graphics/lights.hpp>
+#include <levk/graphics/pixel_map.hpp>
 #include <levk/graphics/primitive.hpp>
 #include <levk/graphics/render_list.hpp>
 #include <levk/util/ptr.hpp>
+#include <levk/util/time.hpp>
+#include <array>
 #include <memory>
+#include <optional>
 
 namespace levk {
 namespace vulkan {
@@ -15,11 +19,53 @@ struct Device;
 
 class AssetProviders;
 
+struct ShadowCascades {
+	// 1: a single shadow map of Scene::shadow_frustum around the camera; [2, max_shadow_cascades_v]: split the view by depth
+	std::uint32_t count{3u};
+	// view space depth covered by all cascades (clamped to the camera's far plane)
+	float distance{100.0f};
+	// blend of uniform (0) and logarithmic (1) split depths
+	float split_lambda{0.75f};
+	// resolution of each cascade, as a fraction of the shadow map resolution
+	std::array<float, max_shadow_cascades_v> resolution_scale{1.0f, 0.5f, 0.5f, 0.25f};
+
+	ShadowCascades clamped() const;
+};
+
+struct DynamicResolution {
+	// GPU time per frame to hold by adjusting the render scale (eg 16.0 for 60 FPS), 0 disables the controller
+	float budget_ms{};
+	// render scale drops when over budget, but only rises if the frame would still fit in budget * (1 - headroom)
+	float headroom{0.15f};
+	// render scale only takes multiples of step, so render targets are reallocated at most once per adjustment
+	float step{0.1f};
+	float min_scale{0.5f};
+	float max_scale{1.0f};
+	// GPU frame times averaged per adjustment
+	std::uint32_t frames{8u};
+
+	DynamicResolution clamped() const;
+};
+
 struct RenderDeviceCreateInfo {
 	bool validation{true};
 	ColourSpace swapchain{ColourSpace::eSrgb};
 	Vsync vsync{Vsync::eAdaptive};
 	AntiAliasing anti_aliasing{AntiAliasing::e2x};
+	// worker threads used to record render passes into secondary command buffers (< 2: record on render thread)
+	std::uint32_t recording_threads{4u};
+	// projected screen sizes are divided by this before selecting mesh LODs: > 1 switches to coarser LODs sooner, 0 disables LODs
+	float lod_bias{1.0f};
+	// rasterize occluder meshes on the CPU and skip drawing instances hidden behind them
+	bool occlusion_culling{true};
+	// keep static shadow casters in a separate depth layer, only re-rendered when they or the primary light change
+	bool static_shadow_cache{false};
+	ShadowCascades shadow_cascades{};
+	// skin vertices once per frame in a compute pass, drawn as static geometry by every view (including shadows) instead of skinning per vertex shader
+	bool compute_skinning{false};
+	DynamicResolution dynamic_resolution{};
+	// frames the CPU may record ahead of the GPU: [1, 3]; more smooths out spikes at the cost of input latency
+	std::uint32_t frames_in_flight{2u};
 };
 
 struct RenderDeviceInfo {
@@ -34,6 +80,39 @@ struct RenderDeviceInfo {
 	float render_scale{1.0f};
 	Rgba clear_colour{black_v};
 	Extent2D shadow_map_resolution{2048u, 2048u};
+	float lod_bias{1.0f};
+	bool occlusion_culling{};
+	bool static_shadow_cache{};
+	ShadowCascades shadow_cascades{};
+	bool compute_skinning{};
+	DynamicResolution dynamic_resolution{};
+	std::uint32_t frames_in_flight{};
+	// rendering into an offscreen target instead of a Window's swapchain
+	bool headless{};
+};
+
+// contents of a headless RenderDevice's offscreen target at the end of a frame
+struct OffscreenFrame {
+	// RGBA8: sRGB if RenderDeviceCreateInfo::swapchain was ColourSpace::eSrgb, linear otherwise
+	Bitmap<ByteArray> pixels{};
+	// number of frames rendered up to and including this one
+	std::uint64_t frame{};
+};
+
+struct GeometryArenaStats {
+	std::uint64_t capacity{};
+	std::uint64_t used{};
+	std::size_t blocks{};
+	std::size_t allocations{};
+	// fraction of free space outside the largest free range of each block: [0, 1]
+	float fragmentation{};
+};
+
+struct OcclusionStats {
+	std::uint64_t occluder_triangles{};
+	// instances tested against occluders / found hidden behind them
+	std::uint64_t tested{};
+	std::uint64_t culled{};
 };
 
 class RenderDevice {
@@ -42,21 +121,50 @@ class RenderDevice {
 	using CreateInfo = RenderDeviceCreateInfo;
 
 	RenderDevice(Window const& window, CreateInfo const& create_info = {});
+	// headless: no surface or swapchain, renders into an offscreen target of extent (vsync settings are ignored)
+	explicit RenderDevice(Extent2D extent, CreateInfo const& create_info = {});
+	// null backend: no GPU at all, render calls are no-ops; textures and primitives created with it keep only their metadata
+	static RenderDevice make_null(CreateInfo const& create_info = {});
 
 	Info const& info() const;
 	float set_render_scale(float desired);
 	std::uint64_t draw_calls_last_frame() const;
+	GeometryArenaStats geometry_arena_stats() const;
+	OcclusionStats occlusion_stats_last_frame() const;
+	// zero if the GPU doesn't support timestamps
+	Duration gpu_frame_time() const;
+	// time from submitting a frame to it being presented, if the GPU supports VK_KHR_present_wait
+	// else (and when headless): to the CPU observing its completion on the GPU, which excludes queueing for display
+	Duration frame_latency() const;
 	bool set_vsync(Vsync desired);
 	void set_clear(Rgba clear);
 	void set_shadow_resolution(Extent2D extent);
+	void set_lod_bias(float bias);
+	void set_occlusion_culling(bool enabled);
+	void set_static_shadow_cache(bool enabled);
+	void set_shadow_cascades(ShadowCascades const& cascades);
+	void set_compute_skinning(bool enabled);
+	void set_dynamic_resolution(DynamicResolution const& dynamic_resolution);
+	// takes effect from the next frame, clamped to [1, 3]
+	std::uint32_t set_frames_in_flight(std::uint32_t count);
+	// latest headless frame completed on the GPU since the last call, if any: never waits for the GPU
+	std::optional<OffscreenFrame> read_offscreen();
 
+	bool is_null() const { return !m_impl; }
+	// must not be null
 	vulkan::Device& vulkan_device() const;
 
   private:
+	RenderDevice() = default;
+
+	Info& device_info();
+
 	struct Deleter {
 		void operator()(vulkan::Device const*) const;
 	};
 
 	std::unique_ptr<vulkan::Device, Deleter> m_impl{};
+	// only used by the null backend
+	Info m_null_info{};
 };
 } // namespace levk
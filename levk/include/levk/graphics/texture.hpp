@@ -5,17 +5,22 @@
 #include <levk/rect.hpp>
 #include <levk/util/ptr.hpp>
 #include <memory>
+#include <span>
 
 namespace levk {
 namespace vulkan {
 struct Texture;
-struct Device;
 } // namespace vulkan
 
+class RenderDevice;
+class MipmappedImage;
+
 struct TextureCreateInfo {
 	std::string name{"(Unnamed)"};
 	bool mip_mapped{true};
 	ColourSpace colour_space{ColourSpace::eSrgb};
+	// ignored by compressed / mipmapped images
+	TextureUsage usage{TextureUsage::eColour};
 	TextureSampler sampler{};
 };
 
@@ -25,8 +30,12 @@ class Texture {
 	using Write = ImageWrite;
 	using Sampler = TextureSampler;
 
-	explicit Texture(vulkan::Device& device);
-	Texture(vulkan::Device& device, Image::View image, CreateInfo const& create_info);
+	// with a null RenderDevice only the metadata (extent, mip levels, etc) is kept
+	explicit Texture(RenderDevice const& device);
+	Texture(RenderDevice const& device, Image::View image, CreateInfo const& create_info);
+	// uploads the image's mips as they are, or decoded if the device cannot sample its format (or block compression);
+	// colour space is taken from the container if it specifies one, and mip_mapped is ignored
+	Texture(RenderDevice const& device, MipmappedImage const& image, CreateInfo const& create_info);
 
 	virtual ~Texture() = default;
 	Texture(Texture&&) = default;
@@ -54,7 +63,9 @@ class Texture {
 
 class Cubemap : public Texture {
   public:
-	explicit Cubemap(vulkan::Device& device);
-	Cubemap(vulkan::Device& device, std::array<Image::View, 6> const& images, CreateInfo const& create_info);
+	explicit Cubemap(RenderDevice const& device);
+	Cubemap(RenderDevice const& device, std::array<Image::View, 6> const& images, CreateInfo const& create_info);
+	// faces must share format, extent and mip count
+	Cubemap(RenderDevice const& device, std::span<MipmappedImage const, 6> images, CreateInfo const& create_info);
 };
 } // namespace levk
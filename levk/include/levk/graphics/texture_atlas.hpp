@@ -3,6 +3,8 @@
 #include <levk/rect.hpp>
 #include <levk/uri.hpp>
 #include <levk/util/not_null.hpp>
+#include <optional>
+#include <span>
 #include <vector>
 
 namespace levk {
@@ -11,14 +13,32 @@ class TextureProvider;
 struct TextureAtlasCreateInfo {
 	Extent2D initial_extent{512u, 512u};
 	glm::uvec2 padding{4u, 4u};
+	// every write must have the same channels (TextureUsage::eMask requires 1)
+	std::uint8_t channels{4};
+	TextureUsage usage{TextureUsage::eColour};
 };
 
+///
+/// \brief Packs images into cells of a single texture, growing it as needed.
+///
+/// Cells are placed bottom-left on a skyline (the top edge of the used area); cells that are removed are zeroed and
+/// their space reused by later writes that fit. All writes in a Writer's scope result in at most one resize of the
+/// texture, and writes are staged into the UploadService's per-frame batch rather than submitted individually.
+///
 class TextureAtlas {
   public:
 	using Cell = Rect2D<std::uint32_t>;
 	using CreateInfo = TextureAtlasCreateInfo;
 	class Writer;
 
+	///
+	/// \brief Obtain the smallest power-of-two extent that all of extents can be packed into.
+	/// \param extents Extents of images to be written
+	/// \param padding Padding around each cell
+	/// \returns Extent to use as initial_extent
+	///
+	static Extent2D extent_for(std::span<Extent2D const> extents, glm::uvec2 padding = CreateInfo{}.padding);
+
 	TextureAtlas(NotNull<TextureProvider*> texture_provider, Uri<Texture> texture_uri, CreateInfo const& create_info = {});
 
 	TextureProvider const& texture_provider() const { return *m_provider; }
@@ -26,14 +46,47 @@ class TextureAtlas {
 	Uri<Texture> const& texture_uri() const { return m_uri; }
 	UvRect uv_rect_for(Cell const& cell) const;
 
+	///
+	/// \brief Clear cell and make its space available for subsequent writes.
+	/// \param cell Cell returned by a previous write
+	///
+	/// Cells must not be removed while a Writer is active.
+	///
+	void remove(Cell const& cell);
+
   private:
+	// a horizontal span of the skyline: everything under y is (potentially) in use
+	struct Segment {
+		std::uint32_t x{};
+		std::uint32_t y{};
+		std::uint32_t width{};
+	};
+
+	struct Skyline {
+		std::vector<Segment> segments{};
+		Extent2D extent{};
+
+		static Skyline make(Extent2D extent) { return {.segments = {Segment{.width = extent.x}}, .extent = extent}; }
+		// smallest extent that a copy of base can be grown to for all of sizes to be packed
+		static Extent2D fit(Skyline const& base, std::span<Extent2D const> sizes);
+
+		std::optional<glm::uvec2> find(Extent2D size) const;
+		void insert(glm::uvec2 position, Extent2D size);
+		void resize(Extent2D new_extent);
+		// returns the first size that doesn't fit
+		std::optional<Extent2D> pack(std::span<Extent2D const> sizes);
+	};
+
 	Ptr<Texture> find_texture() const;
+	Cell allocate(Extent2D extent);
 
 	Uri<Texture> m_uri{};
 	NotNull<TextureProvider*> m_provider;
+	Skyline m_skyline{};
+	// padded regions of removed cells
+	std::vector<Cell> m_free{};
 	glm::uvec2 m_padding{};
-	glm::uvec2 m_cursor{};
-	std::uint32_t m_max_height{};
+	std::uint8_t m_channels{};
 };
 
 class TextureAtlas::Writer {
@@ -43,11 +96,18 @@ class TextureAtlas::Writer {
 	Writer(TextureAtlas& out) : m_out(out) {}
 	~Writer();
 
+	///
+	/// \brief Grow the atlas (once) to fit images of extents, if needed.
+	/// \param extents Extents of images about to be written
+	///
+	/// Writes grow the atlas on demand otherwise, which packs less tightly.
+	///
+	void reserve(std::span<Extent2D const> extents);
+
 	Cell write(PixelMap::View pixels);
 
   private:
 	TextureAtlas& m_out;
 	std::vector<ImageWrite> m_writes{};
-	Extent2D m_new_extent{};
 };
 } // namespace levk
@@ -28,6 +28,7 @@ struct ShapeAttachment : Attachment {
 struct MeshAttachment : Attachment {
 	Uri<Mesh> uri{};
 	std::vector<Transform> instances{};
+	bool is_static{};
 
 	std::string_view type_name() const final { return "MeshAttachment"; }
 	bool serialize(dj::Json& out) const final;
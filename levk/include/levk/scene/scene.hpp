@@ -6,6 +6,7 @@
 #include <levk/scene/collision.hpp>
 #include <levk/scene/entity.hpp>
 #include <levk/scene/scene_camera.hpp>
+#include <levk/ui/hit_grid.hpp>
 #include <levk/ui/view.hpp>
 #include <levk/uri.hpp>
 #include <levk/util/logger.hpp>
@@ -68,6 +69,7 @@ class Scene : public Pinned {
 	virtual void clear();
 
 	ui::View ui_root{};
+	ui::HitGrid ui_hit_grid{&ui_root};
 	SceneCamera camera{};
 	Lights lights{};
 	Collision collision{};
@@ -14,5 +14,7 @@ class StaticMeshRenderer : public RenderComponent {
 
 	std::vector<Transform> instances{};
 	Uri<StaticMesh> mesh_uri{};
+	// never moves: eligible for the cached static shadow layer
+	bool is_static{};
 };
 } // namespace levk
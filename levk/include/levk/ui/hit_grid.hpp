@@ -0,0 +1,42 @@
+#pragma once
+#include <levk/ui/view.hpp>
+#include <levk/util/not_null.hpp>
+
+namespace levk::ui {
+///
+/// \brief Uniform grid over the world frames of a View tree, for pointer hit testing.
+///
+/// Rebuilt lazily on the next query after the root's layout version changes. Views outside the root's world frame
+/// are clamped to its border cells.
+///
+class HitGrid {
+  public:
+	static constexpr float cell_size_v{64.0f};
+
+	explicit HitGrid(NotNull<View*> root, float cell_size = cell_size_v) : m_root(root), m_cell_size(cell_size) {}
+
+	///
+	/// \brief Find the topmost view whose world frame contains point.
+	/// \param point Point in world space
+	/// \returns Visible view with the highest z_index containing point (the last in tree order among equals), if any
+	///
+	Ptr<View> hit_test(glm::vec2 point);
+
+  private:
+	void rebuild();
+	glm::ivec2 cell_of(glm::vec2 point) const;
+
+	NotNull<View*> m_root;
+	// tree (draw) order
+	std::vector<Ptr<View>> m_views{};
+	// [offset, count] into m_cells per cell, row major
+	std::vector<std::uint32_t> m_offsets{};
+	// indices into m_views
+	std::vector<std::uint32_t> m_cells{};
+	Rect m_bounds{};
+	glm::ivec2 m_grid{};
+	float m_cell_size{};
+	std::uint64_t m_version{};
+	bool m_built{};
+};
+} // namespace levk::ui
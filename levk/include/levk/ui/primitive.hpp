@@ -7,6 +7,11 @@ namespace levk {
 class RenderDevice;
 
 namespace ui {
+///
+/// \brief View that renders a quad (or custom geometry).
+///
+/// Primitives don't tick (set_ticking(false)); subclasses that override tick() must call set_ticking(true).
+///
 class Primitive : public View {
   public:
 	Primitive();
@@ -26,6 +31,8 @@ class Primitive : public View {
   protected:
 	DynamicPrimitive m_primitive;
 	UnlitMaterial m_material{};
+	// offset of geometry from the centre of the frame
+	glm::vec2 m_origin{};
 };
 } // namespace ui
 } // namespace levk
@@ -1,19 +1,22 @@
 #pragma once
-#include <levk/font/common.hpp>
+#include <levk/font/ascii_font.hpp>
 #include <levk/ui/primitive.hpp>
 #include <levk/util/not_null.hpp>
 
-namespace levk {
-class AsciiFont;
-
-namespace ui {
+namespace levk::ui {
+///
+/// \brief Single line of text.
+///
+/// Quads are laid out from a per height glyph table, and only those past the prefix shared with the previous string are
+/// rewritten; geometry buffers retain their capacity, so short strings that change every frame don't allocate.
+///
 class Text : public Primitive {
   public:
 	Text(NotNull<AsciiFont*> font);
 
 	static std::unique_ptr<Text> try_make(Uri<AsciiFont> const& uri);
 
-	void set_string(std::string string);
+	void set_string(std::string_view string);
 	std::string_view get_string() const { return m_string; }
 
 	void set_height(TextHeight height);
@@ -25,6 +28,11 @@ class Text : public Primitive {
 	NotNull<AsciiFont*> m_font;
 	std::string m_string{};
 	TextHeight m_height{TextHeight::eDefault};
+
+  private:
+	// line currently in geometry, and the glyphs it was laid out with
+	std::string m_built{};
+	Ptr<AsciiFont::GlyphTable const> m_glyphs{};
+	std::uint64_t m_glyphs_generation{};
 };
-} // namespace ui
-} // namespace levk
+} // namespace levk::ui
@@ -2,6 +2,7 @@
 #include <levk/rect.hpp>
 #include <levk/util/ptr.hpp>
 #include <levk/util/time.hpp>
+#include <cstdint>
 #include <memory>
 #include <span>
 #include <vector>
@@ -13,6 +14,13 @@ class DrawList;
 namespace ui {
 using Rect = Rect2D<>;
 
+///
+/// \brief Node in a tree of UI views.
+///
+/// World frames are cached and only recomputed after a frame or anchor in their chain of super views changes.
+/// Views tick by default; those that opt out via set_ticking(false) are skipped, as are entire subtrees without any
+/// ticking views (or destroyed views to remove).
+///
 class View {
   public:
 	static constexpr auto frame_v{Rect::from_extent({100.0f, 100.0f})};
@@ -25,31 +33,66 @@ class View {
 
 	Ptr<View> super_view() const { return m_super_view; }
 	Rect const& frame() const { return m_frame; }
-	Rect world_frame() const;
+	Rect const& world_frame() const;
 	void set_frame(Rect frame);
 	void set_position(glm::vec2 position);
 	void set_extent(glm::vec2 extent);
 
+	///
+	/// \brief Normalized anchor of the frame's origin in the super view's frame (0 is its centre).
+	///
+	/// Set via set_n_anchor() (formerly a public member), which invalidates cached world frames.
+	///
+	glm::vec2 const& n_anchor() const { return m_n_anchor; }
+	void set_n_anchor(glm::vec2 n_anchor);
+
 	Ptr<View> add_sub_view(std::unique_ptr<View> view);
-	void set_destroyed() { m_destroyed = true; }
+	void set_destroyed();
 	bool is_destroyed() const { return m_destroyed; }
 	bool contains(Ptr<View const> view) const;
 
 	std::span<std::unique_ptr<View> const> sub_views() const { return m_sub_views; }
 
+	///
+	/// \brief Set whether tick() is called on this view (defaults to true).
+	///
+	/// Views that don't override tick() can opt out so that idle subtrees are skipped (Primitive and Text do);
+	/// sub views tick regardless.
+	///
+	void set_ticking(bool ticking);
+	bool is_ticking() const { return m_ticking; }
+
+	///
+	/// \brief Incremented on the root view whenever any world frame in its tree changes, or views are added / removed.
+	///
+	std::uint64_t layout_version() const { return m_layout_version; }
+
 	virtual void tick(WindowInput const& window_input, Duration dt);
 	virtual void render(DrawList& out) const;
 
-	void clear_sub_views() { m_sub_views.clear(); }
+	void clear_sub_views();
 
-	glm::vec2 n_anchor{};
 	float z_index{};
 	float z_rotation{};
 
   private:
+	void set_layout_dirty();
+	void bump_layout_version();
+	void add_ticking(std::int64_t delta);
+	void prune_sub_views();
+
 	Rect m_frame{};
+	glm::vec2 m_n_anchor{};
 	std::vector<std::unique_ptr<View>> m_sub_views{};
 	Ptr<View> m_super_view{};
+	mutable Rect m_world_frame{};
+	std::uint64_t m_layout_version{};
+	// ticking views in sub views' trees
+	std::uint64_t m_ticking_sub_views{};
+	mutable bool m_world_dirty{true};
+	bool m_ticking{true};
+	// destroyed views to remove in this tree
+	bool m_prune{};
 	bool m_destroyed{};
 };
 } // namespace ui
@@ -15,6 +15,9 @@ class Window {
 
 	Window(glm::uvec2 extent, char const* title);
 
+	// null backend: no display or input devices, state only tracks extent and close requests
+	static Window make_null(glm::uvec2 extent);
+
 	glm::uvec2 framebuffer_extent() const;
 	glm::uvec2 window_extent() const;
 	void show();
@@ -33,9 +36,12 @@ class Window {
 	void lock_aspect_ratio();
 	void unlock_aspect_ratio();
 
+	// null if the null backend
 	Ptr<glfw::Window> glfw_window() const { return m_impl.get(); }
 
   private:
+	Window() = default;
+
 	struct Deleter {
 		void operator()(glfw::Window const*) const;
 	};
@@ -380,6 +380,25 @@ void asset::from_json(dj::Json const& json, Lights& out) {
 		levk::from_json(in_dir_light["direction"], out_dir_light.direction);
 		from_json(in_dir_light["rgb"], out_dir_light.rgb);
 	}
+	auto const& in_point_lights = json["point_lights"];
+	if (!in_point_lights.array_view().empty()) { out.point_lights.clear(); }
+	for (auto const& in_point_light : in_point_lights.array_view()) {
+		auto& out_point_light = out.point_lights.emplace_back();
+		levk::from_json(in_point_light["position"], out_point_light.position);
+		from_json(in_point_light["rgb"], out_point_light.rgb);
+		out_point_light.range = in_point_light["range"].as<float>(out_point_light.range);
+	}
+	auto const& in_spot_lights = json["spot_lights"];
+	if (!in_spot_lights.array_view().empty()) { out.spot_lights.clear(); }
+	for (auto const& in_spot_light : in_spot_lights.array_view()) {
+		auto& out_spot_light = out.spot_lights.emplace_back();
+		levk::from_json(in_spot_light["position"], out_spot_light.position);
+		levk::from_json(in_spot_light["direction"], out_spot_light.direction);
+		from_json(in_spot_light["rgb"], out_spot_light.rgb);
+		out_spot_light.range = in_spot_light["range"].as<float>(out_spot_light.range);
+		out_spot_light.inner_angle = Degrees{in_spot_light["inner_angle"].as<float>(Degrees{out_spot_light.inner_angle}.value)};
+		out_spot_light.outer_angle = Degrees{in_spot_light["outer_angle"].as<float>(Degrees{out_spot_light.outer_angle}.value)};
+	}
 }
 
 void asset::to_json(dj::Json& out, Lights const& lights) {
@@ -395,6 +414,27 @@ void asset::to_json(dj::Json& out, Lights const& lights) {
 			levk::to_json(out_dir_light["rgb"], in_dir_light.rgb);
 		}
 	}
+	if (!lights.point_lights.empty()) {
+		auto& out_point_lights = out["point_lights"];
+		for (auto const& in_point_light : lights.point_lights) {
+			auto& out_point_light = out_point_lights.push_back({});
+			levk::to_json(out_point_light["position"], in_point_light.position);
+			levk::to_json(out_point_light["rgb"], in_point_light.rgb);
+			out_point_light["range"] = in_point_light.range;
+		}
+	}
+	if (!lights.spot_lights.empty()) {
+		auto& out_spot_lights = out["spot_lights"];
+		for (auto const& in_spot_light : lights.spot_lights) {
+			auto& out_spot_light = out_spot_lights.push_back({});
+			levk::to_json(out_spot_light["position"], in_spot_light.position);
+			levk::to_json(out_spot_light["direction"], in_spot_light.direction);
+			levk::to_json(out_spot_light["rgb"], in_spot_light.rgb);
+			out_spot_light["range"] = in_spot_light.range;
+			out_spot_light["inner_angle"] = in_spot_light.inner_angle.to_degrees().value;
+			out_spot_light["outer_angle"] = in_spot_light.outer_angle.to_degrees().value;
+		}
+	}
 }
 
 void asset::from_json(dj::Json const& json, NodeTree& out) {
@@ -506,10 +546,15 @@ void asset::from_json(dj::Json const& json, Mesh3D& out) {
 		auto primitive = Mesh3D::Primitive{};
 		primitive.geometry = std::string{in_primitive["geometry"].as_string()};
 		primitive.material = std::string{in_primitive["material"].as_string()};
+		for (auto const& in_lod : in_primitive["lods"].array_view()) {
+			primitive.lods.push_back({std::string{in_lod["geometry"].as_string()}, in_lod["screen_size"].as<float>()});
+		}
 		out.primitives.push_back(std::move(primitive));
 	}
 	for (auto const& in_ibm : json["inverse_bind_matrices"].array_view()) { levk::from_json(in_ibm, out.inverse_bind_matrices.emplace_back()); }
 	out.name = json["name"].as_string();
+	out.vertex_format = json["vertex_format"].as_string() == "packed" ? VertexFormat::ePacked : VertexFormat::eFull;
+	out.occluder = json["occluder"].as<bool>();
 }
 
 void asset::to_json(dj::Json& out, Mesh3D const& asset) {
@@ -520,6 +565,14 @@ void asset::to_json(dj::Json& out, Mesh3D const& asset) {
 			auto& out_primitive = primitives.push_back({});
 			out_primitive["geometry"] = in_primitive.geometry.value();
 			if (!in_primitive.material.value().empty()) { out_primitive["material"] = in_primitive.material.value(); }
+			if (!in_primitive.lods.empty()) {
+				auto& lods = out_primitive["lods"];
+				for (auto const& in_lod : in_primitive.lods) {
+					auto& out_lod = lods.push_back({});
+					out_lod["geometry"] = in_lod.geometry.value();
+					out_lod["screen_size"] = in_lod.screen_size;
+				}
+			}
 		}
 	}
 	if (!asset.skeleton.value().empty()) {
@@ -529,5 +582,7 @@ void asset::to_json(dj::Json& out, Mesh3D const& asset) {
 		for (auto const& in_ibm : asset.inverse_bind_matrices) { levk::to_json(ibm.push_back({}), in_ibm); }
 	}
 	out["name"] = asset.name;
+	if (asset.vertex_format == VertexFormat::ePacked) { out["vertex_format"] = "packed"; }
+	if (asset.occluder) { out["occluder"] = dj::Boolean{true}; }
 }
 } // namespace levk
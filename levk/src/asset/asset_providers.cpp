@@ -2,6 +2,7 @@
 #include <levk/asset/asset_providers.hpp>
 #include <levk/level/attachment.hpp>
 #include <levk/level/shape.hpp>
+#include <levk/util/enumerate.hpp>
 
 namespace levk {
 namespace {
@@ -12,7 +13,7 @@ AssetProviders::AssetProviders(CreateInfo const& create_info) {
 	m_providers.shader = &add(ShaderProvider{create_info.data_source});
 	m_providers.skeletal_animation = &add(SkeletalAnimationProvider{create_info.data_source});
 	m_providers.skeleton = &add(SkeletonProvider{m_providers.skeletal_animation, create_info.data_source});
-	m_providers.texture = &add(TextureProvider{create_info.render_device, create_info.data_source});
+	m_providers.texture = &add(TextureProvider{create_info.render_device, create_info.data_source, create_info.thread_pool});
 	m_providers.cubemap = &add(CubemapProvider{create_info.render_device, create_info.data_source, create_info.thread_pool});
 	m_providers.material = &add(MaterialProvider{m_providers.texture, create_info.serializer});
 	m_providers.static_mesh = &add(StaticMeshProvider{m_providers.material});
@@ -86,8 +87,11 @@ AssetList AssetProviders::build_asset_list(Uri<Level> const& uri) const {
 		asset::from_json(json, asset);
 		ret.shaders.insert(asset.vertex_shader);
 		ret.shaders.insert(asset.fragment_shader);
-		for (auto const& uri : asset.textures.uris) {
-			if (uri) { ret.textures.insert(uri); }
+		for (auto const [uri, index] : enumerate(asset.textures.uris)) {
+			if (!uri) { continue; }
+			// textures are loaded before materials
+			texture().set_usage(uri, asset.textures.usages[index]);
+			ret.textures.insert(uri);
 		}
 	}
 	return ret;
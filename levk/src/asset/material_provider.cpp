@@ -1,5 +1,6 @@
 #include <levk/asset/material_provider.hpp>
 #include <levk/asset/texture_provider.hpp>
+#include <levk/util/enumerate.hpp>
 
 namespace levk {
 MaterialProvider::MaterialProvider(NotNull<TextureProvider*> texture_provider, NotNull<Serializer const*> serializer)
@@ -18,8 +19,10 @@ MaterialProvider::Payload MaterialProvider::load_payload(Uri<UMaterial> const& u
 		m_logger.error("Failed to deserialize Material [{}]", uri.value());
 		return {};
 	}
-	for (auto const& tex_uri : mat.value->textures.uris) {
-		if (tex_uri) { m_texture_provider->load(tex_uri); }
+	for (auto const [tex_uri, index] : enumerate(mat.value->textures.uris)) {
+		if (!tex_uri) { continue; }
+		m_texture_provider->set_usage(tex_uri, mat.value->textures.usages[index]);
+		m_texture_provider->load(tex_uri);
 	}
 	ret.asset.emplace(std::move(mat.value));
 	ret.dependencies.push_back(uri);
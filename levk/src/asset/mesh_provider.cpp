@@ -3,8 +3,27 @@
 #include <levk/asset/mesh_provider.hpp>
 #include <levk/asset/skeleton_provider.hpp>
 #include <levk/graphics/render_device.hpp>
+#include <algorithm>
 
 namespace levk {
+namespace {
+float bounding_radius(std::span<glm::vec3 const> positions) {
+	auto ret = 0.0f;
+	for (auto const& position : positions) { ret = std::max(ret, glm::dot(position, position)); }
+	return std::sqrt(ret);
+}
+
+void sort_lods(std::vector<PrimitiveLod>& out) {
+	std::ranges::sort(out, [](PrimitiveLod const& a, PrimitiveLod const& b) { return a.screen_size > b.screen_size; });
+}
+
+void append(Occluder& out, Geometry::Packed const& geometry) {
+	auto const offset = static_cast<std::uint32_t>(out.positions.size());
+	out.positions.insert(out.positions.end(), geometry.positions.begin(), geometry.positions.end());
+	for (auto const index : geometry.indices) { out.indices.push_back(offset + index); }
+}
+} // namespace
+
 StaticMeshProvider::Payload StaticMeshProvider::load_payload(Uri<StaticMesh> const& uri, Stopwatch const& stopwatch) const {
 	auto ret = Payload{};
 	auto json = data_source().read_json(uri);
@@ -24,9 +43,29 @@ StaticMeshProvider::Payload StaticMeshProvider::load_payload(Uri<StaticMesh> con
 			continue;
 		}
 		ret.dependencies.push_back(in_primitive.geometry);
-		auto primitive = StaticPrimitive{render_device().vulkan_device(), bin_geometry.geometry};
+		auto primitive = StaticMesh::Primitive{
+			.primitive = StaticPrimitive{render_device(), bin_geometry.geometry, asset.vertex_format},
+			.material = in_primitive.material,
+			.radius = bounding_radius(bin_geometry.geometry.positions),
+		};
+		auto coarsest = asset::BinGeometry{};
+		for (auto const& in_lod : in_primitive.lods) {
+			auto lod_geometry = asset::BinGeometry{};
+			if (!lod_geometry.read(read_bytes(in_lod.geometry.value()).span())) {
+				m_logger.warn("Failed to read LOD geometry [{}]", in_lod.geometry.value());
+				continue;
+			}
+			ret.dependencies.push_back(in_lod.geometry);
+			auto lod = std::make_unique<StaticPrimitive>(render_device(), lod_geometry.geometry, asset.vertex_format);
+			primitive.lods.push_back({std::move(lod), in_lod.screen_size});
+			if (asset.occluder && (coarsest.geometry.indices.empty() || lod_geometry.geometry.indices.size() < coarsest.geometry.indices.size())) {
+				coarsest = std::move(lod_geometry);
+			}
+		}
+		sort_lods(primitive.lods);
+		if (asset.occluder) { append(ret.asset->occluder, coarsest.geometry.indices.empty() ? bin_geometry.geometry : coarsest.geometry); }
 		if (in_primitive.material) { material_provider().load(in_primitive.material); }
-		ret.asset->primitives.push_back({std::move(primitive), in_primitive.material});
+		ret.asset->primitives.push_back(std::move(primitive));
 	}
 	ret.dependencies.push_back(uri);
 	m_logger.info("[{:.3f}s] StaticMesh loaded [{}]", stopwatch().count(), uri.value());
@@ -55,9 +94,26 @@ SkinnedMeshProvider::Payload SkinnedMeshProvider::load_payload(Uri<SkinnedMesh>
 			continue;
 		}
 		ret.dependencies.push_back(in_primitive.geometry);
-		auto geometry = SkinnedPrimitive{render_device().vulkan_device(), bin_geometry.geometry, {bin_geometry.joints, bin_geometry.weights}};
+		auto const joints = MeshJoints{bin_geometry.joints, bin_geometry.weights};
+		auto primitive = SkinnedMesh::Primitive{
+			.primitive = SkinnedPrimitive{render_device(), bin_geometry.geometry, joints, asset.vertex_format},
+			.material = in_primitive.material,
+			.radius = bounding_radius(bin_geometry.geometry.positions),
+		};
+		for (auto const& in_lod : in_primitive.lods) {
+			auto lod_geometry = asset::BinGeometry{};
+			if (!lod_geometry.read(read_bytes(in_lod.geometry.value()).span())) {
+				m_logger.warn("Failed to read LOD geometry [{}]", in_lod.geometry.value());
+				continue;
+			}
+			ret.dependencies.push_back(in_lod.geometry);
+			auto const lod_joints = MeshJoints{lod_geometry.joints, lod_geometry.weights};
+			auto lod = std::make_unique<SkinnedPrimitive>(render_device(), lod_geometry.geometry, lod_joints, asset.vertex_format);
+			primitive.lods.push_back({std::move(lod), in_lod.screen_size});
+		}
+		sort_lods(primitive.lods);
 		if (in_primitive.material) { material_provider().load(in_primitive.material); }
-		ret.asset->primitives.push_back({std::move(geometry), in_primitive.material});
+		ret.asset->primitives.push_back(std::move(primitive));
 	}
 	ret.asset->inverse_bind_matrices = asset.inverse_bind_matrices;
 	if (auto const& skeleton = json["skeleton"]) {
@@ -11,7 +11,7 @@ namespace fs = std::filesystem;
 
 namespace {
 namespace compiler {
-constexpr std::string_view glsl_extensions_v[] = {".vert", ".frag"};
+constexpr std::string_view glsl_extensions_v[] = {".vert", ".frag", ".comp"};
 constexpr std::string_view spir_v_compiler_v = "glslc";
 constexpr std::string_view dev_null_v =
 #if defined(_WIN32)
@@ -1,18 +1,208 @@
+#include <graphics/vulkan/texture.hpp>
+#include <graphics/vulkan/upload_service.hpp>
 #include <levk/asset/texture_provider.hpp>
+#include <levk/graphics/mipmapped_image.hpp>
 #include <levk/graphics/render_device.hpp>
 #include <levk/util/enumerate.hpp>
 #include <levk/util/logger.hpp>
 #include <levk/util/thread_pool.hpp>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
 #include <filesystem>
 
 namespace levk {
 namespace fs = std::filesystem;
 
-TextureProvider::TextureProvider(NotNull<RenderDevice*> render_device, NotNull<DataSource const*> data_source)
-	: GraphicsAssetProvider<Texture>(render_device, data_source, "TextureProvider") {
+namespace {
+constexpr std::uint32_t max_dim(Extent2D const extent) { return std::max(extent.x, extent.y); }
+
+// halves extent until it fits max: always one of the full image's mip extents
+constexpr Extent2D fit(Extent2D extent, std::uint32_t const max) {
+	while (max_dim(extent) > max && max_dim(extent) > 1u) { extent = {std::max(extent.x / 2u, 1u), std::max(extent.y / 2u, 1u)}; }
+	return extent;
+}
+
+// RGBA8, full mip chain
+std::uint64_t image_bytes(Extent2D extent) {
+	auto ret = std::uint64_t{};
+	for (auto mips = vulkan::DeviceView::compute_mip_levels({extent.x, extent.y}); mips > 0u; --mips) {
+		ret += std::uint64_t{extent.x} * extent.y * 4u;
+		extent = {std::max(extent.x / 2u, 1u), std::max(extent.y / 2u, 1u)};
+	}
+	return ret;
+}
+
+// target must be one of the image's mip extents
+DynPixelMap downsample_to(Image::View const image, Extent2D const target, ColourSpace const colour_space) {
+	if (image.extent == target) {
+		auto ret = DynPixelMap{image.extent};
+		std::memcpy(ret.span().data(), image.storage.data(), std::min(ret.span().size_bytes(), image.storage.size()));
+		return ret;
+	}
+	auto ret = downsample(image, colour_space);
+	while (ret.extent() != target && max_dim(ret.extent()) > 1u) { ret = downsample(ret.view(), colour_space); }
+	return ret;
+}
+
+// replaces the image with a full mip chain generated from image
+void stream_in(vulkan::Texture& out, Image::View const image) {
+	out.create_info.mip_levels = vulkan::DeviceView::compute_mip_levels({image.extent.x, image.extent.y});
+	auto vk_image = out.device.vma.make_image(out.create_info, {image.extent.x, image.extent.y});
+	out.device.upload_service->upload(vk_image.get(), {&image, 1u});
+	out.image = {*out.device.defer, std::move(vk_image)};
+}
+
+// replaces the image with one without its top mip, copied from the existing one
+bool evict_top_mip(vulkan::Texture& out) {
+	auto const& src = out.image.get().get();
+	if (src.mip_levels < 2u) { return false; }
+	auto create_info = out.create_info;
+	create_info.mip_levels = src.mip_levels - 1u;
+	auto vk_image = out.device.vma.make_image(create_info, {std::max(src.extent.width / 2u, 1u), std::max(src.extent.height / 2u, 1u)});
+	out.device.upload_service->copy_mips(src, vk_image.get());
+	out.create_info = create_info;
+	out.image = {*out.device.defer, std::move(vk_image)};
+	return true;
+}
+} // namespace
+
+struct TextureProvider::Streamer {
+	struct Entry {
+		Ptr<vulkan::Texture> texture{};
+		std::string image_uri{};
+		Extent2D full_extent{};
+		ColourSpace colour_space{};
+		std::uint64_t binds{};
+		// binds in the frame the texture was last used in
+		std::uint64_t recent_binds{};
+		std::uint64_t last_used{};
+		std::uint32_t screen_extent{};
+		Extent2D requested{};
+		ScopedFuture<DynPixelMap> load{};
+
+		Extent2D resident() const {
+			auto const extent = texture->extent();
+			return {extent.width, extent.height};
+		}
+
+		bool is_loading() const { return load.future.valid(); }
+	};
+
+	StreamingInfo info{};
+	Ptr<ThreadPool> thread_pool{};
+	std::unordered_map<Uri<Texture>, Entry, Uri<>::Hasher> entries{};
+	// loaded but not yet stored in the provider: refresh() would drop them as stale, so they move to entries in on_loaded()
+	std::unordered_map<Uri<Texture>, Entry, Uri<>::Hasher> pending{};
+	std::uint64_t frame{};
+	std::uint64_t bytes{};
+	std::mutex mutex{};
+
+	bool should_stream(Extent2D const extent) const { return info.enabled && thread_pool && max_dim(extent) > info.initial_extent; }
+
+	// textures not used this frame can give up everything above their initial extent
+	std::uint64_t reclaimable() const {
+		auto ret = std::uint64_t{};
+		for (auto const& [_, entry] : entries) {
+			if (entry.last_used == frame || entry.is_loading()) { continue; }
+			ret += image_bytes(entry.resident()) - image_bytes(fit(entry.full_extent, info.initial_extent));
+		}
+		return ret;
+	}
+
+	void refresh(AssetProvider<Texture> const& provider) {
+		std::erase_if(entries, [&](auto const& pair) {
+			auto const* texture = provider.find(pair.first);
+			return !texture || texture->vulkan_texture() != pair.second.texture;
+		});
+		bytes = {};
+		for (auto& [_, entry] : entries) {
+			auto const binds = entry.texture->usage.binds.load(std::memory_order_relaxed);
+			if (binds != entry.binds) {
+				entry.recent_binds = binds - entry.binds;
+				entry.binds = binds;
+				entry.last_used = frame;
+				entry.screen_extent = entry.texture->usage.take_screen_extent();
+			}
+			if (entry.is_loading() && entry.load.future.wait_for(std::chrono::seconds{}) == std::future_status::ready) {
+				auto const& pixels = entry.load.future.get();
+				if (pixels.extent() == entry.requested && max_dim(pixels.extent()) > max_dim(entry.resident())) { stream_in(*entry.texture, pixels.view()); }
+				entry.load = {};
+			}
+			bytes += image_bytes(entry.resident());
+		}
+	}
+
+	void evict() {
+		auto const floor = info.initial_extent;
+		while (bytes > info.vram_budget) {
+			auto* victim = static_cast<Entry*>(nullptr);
+			for (auto& [_, entry] : entries) {
+				if (entry.is_loading() || max_dim(entry.resident()) <= floor) { continue; }
+				auto const older = [&] {
+					if (entry.last_used != victim->last_used) { return entry.last_used < victim->last_used; }
+					return entry.screen_extent < victim->screen_extent;
+				};
+				if (!victim || older()) { victim = &entry; }
+			}
+			if (!victim) { return; }
+			auto const before = image_bytes(victim->resident());
+			if (!evict_top_mip(*victim->texture)) { return; }
+			bytes -= before - image_bytes(victim->resident());
+		}
+	}
+
+	void request(DataSource const& data_source) {
+		auto loading = std::ranges::count_if(entries, [](auto const& pair) { return pair.second.is_loading(); });
+		if (static_cast<std::uint32_t>(loading) >= info.max_jobs) { return; }
+		auto candidates = std::vector<std::pair<Entry*, Extent2D>>{};
+		for (auto& [_, entry] : entries) {
+			if (entry.last_used != frame || entry.is_loading()) { continue; }
+			// the smallest mip at least as large as it appears on screen
+			auto const target = fit(entry.full_extent, std::max(std::bit_ceil(entry.screen_extent), info.initial_extent));
+			if (max_dim(target) > max_dim(entry.resident())) { candidates.emplace_back(&entry, target); }
+		}
+		std::ranges::sort(candidates, [](auto const& a, auto const& b) {
+			if (a.first->screen_extent != b.first->screen_extent) { return a.first->screen_extent > b.first->screen_extent; }
+			return a.first->recent_binds > b.first->recent_binds;
+		});
+		auto available = info.vram_budget + reclaimable();
+		auto committed = bytes;
+		for (auto const& [entry, target] : candidates) {
+			if (static_cast<std::uint32_t>(loading) >= info.max_jobs) { break; }
+			auto const required = image_bytes(target) - image_bytes(entry->resident());
+			if (committed + required > available) { continue; }
+			committed += required;
+			entry->requested = target;
+			entry->load = thread_pool->submit([source = &data_source, uri = entry->image_uri, target, colour_space = entry->colour_space] {
+				auto const data = source->read(uri);
+				if (!data) { return DynPixelMap{}; }
+				auto const image = Image{data.span(), uri};
+				if (!image) { return DynPixelMap{}; }
+				return downsample_to(image.view(), target, colour_space);
+			});
+			++loading;
+		}
+	}
+};
+
+struct TextureProvider::Usages {
+	std::unordered_map<Uri<Texture>, TextureUsage, Uri<>::Hasher> map{};
+	std::mutex mutex{};
+};
+
+TextureProvider::TextureProvider(NotNull<RenderDevice*> render_device, NotNull<DataSource const*> data_source, Ptr<ThreadPool> thread_pool)
+	: GraphicsAssetProvider<Texture>(render_device, data_source, "TextureProvider"), m_streamer(std::make_unique<Streamer>()),
+	  m_usages(std::make_unique<Usages>()) {
+	m_streamer->thread_pool = thread_pool;
 	add_default_textures();
 }
 
+TextureProvider::~TextureProvider() = default;
+TextureProvider::TextureProvider(TextureProvider&&) noexcept = default;
+TextureProvider& TextureProvider::operator=(TextureProvider&&) noexcept = default;
+
 Texture const& TextureProvider::get(Uri<Texture> const& uri, Uri<Texture> const& fallback) const {
 	if (auto* ret = find(uri)) { return *ret; }
 	if (auto* ret = find(fallback)) { return *ret; }
@@ -24,12 +214,58 @@ Texture const& TextureProvider::get(Uri<Texture> const& uri, Uri<Texture> const&
 void TextureProvider::clear() {
 	GraphicsAssetProvider<Texture>::clear();
 	add_default_textures();
+	auto lock = std::scoped_lock{m_streamer->mutex};
+	m_streamer->entries.clear();
+	m_streamer->pending.clear();
+	m_streamer->bytes = {};
+}
+
+void TextureProvider::set_usage(Uri<Texture> const& uri, TextureUsage const usage) {
+	if (!uri) { return; }
+	auto lock = std::scoped_lock{m_usages->mutex};
+	if (usage == TextureUsage::eColour) {
+		m_usages->map.erase(uri);
+	} else {
+		m_usages->map.insert_or_assign(uri, usage);
+	}
+}
+
+TextureUsage TextureProvider::usage_for(Uri<Texture> const& uri) const {
+	auto lock = std::scoped_lock{m_usages->mutex};
+	if (auto it = m_usages->map.find(uri); it != m_usages->map.end()) { return it->second; }
+	return TextureUsage::eColour;
+}
+
+auto TextureProvider::streaming() const -> StreamingInfo const& { return m_streamer->info; }
+
+void TextureProvider::set_streaming(StreamingInfo const& info) {
+	auto lock = std::scoped_lock{m_streamer->mutex};
+	m_streamer->info = info;
+	if (info.enabled && !m_streamer->thread_pool) {
+		m_logger.warn("Texture streaming requires a ThreadPool, disabling");
+		m_streamer->info.enabled = false;
+	}
+}
+
+std::uint64_t TextureProvider::streamed_bytes() const {
+	auto lock = std::scoped_lock{m_streamer->mutex};
+	return m_streamer->bytes;
+}
+
+void TextureProvider::update_streaming() {
+	auto lock = std::scoped_lock{m_streamer->mutex};
+	if (m_streamer->entries.empty()) { return; }
+	++m_streamer->frame;
+	m_streamer->refresh(*this);
+	m_streamer->evict();
+	if (m_streamer->info.enabled) { m_streamer->request(data_source()); }
 }
 
 TextureProvider::Payload TextureProvider::load_payload(Uri<Texture> const& uri, Stopwatch const& stopwatch) const {
 	auto ret = Payload{};
 	auto image_uri = std::string{};
 	auto colour_space = ColourSpace::eSrgb;
+	auto usage = usage_for(uri);
 	if (fs::path{uri.value()}.extension() == ".json") {
 		auto json = data_source().read_json(uri);
 		if (!json) {
@@ -38,30 +274,67 @@ TextureProvider::Payload TextureProvider::load_payload(Uri<Texture> const& uri,
 		}
 		image_uri = json["image"].as_string();
 		colour_space = to_colour_space(json["colour_space"].as_string());
+		if (json.contains("usage")) { usage = to_texture_usage(json["usage"].as_string()); }
 	} else {
 		image_uri = uri.value();
 	}
-	auto const bytes = read_bytes(image_uri);
+	auto bytes = read_bytes(image_uri);
 	if (!bytes) {
 		m_logger.error("Failed to load Image [{}]", image_uri);
 		return {};
 	}
+	if (MipmappedImage::is_container(bytes.span())) {
+		auto const mipmapped = MipmappedImage{std::move(bytes), std::string{image_uri}};
+		if (!mipmapped) {
+			m_logger.error("Failed to create MipmappedImage [{}]", image_uri);
+			return {};
+		}
+		ret.asset.emplace(render_device(), mipmapped, TextureCreateInfo{.colour_space = colour_space});
+		ret.dependencies = {uri, image_uri};
+		m_logger.info("[{:.3f}s] Texture loaded [{}]", stopwatch().count(), uri.value());
+		return ret;
+	}
 	auto image = Image{bytes.span(), std::string{image_uri}};
 	if (!image) {
 		m_logger.error("Failed to create Image [{}]", image_uri);
 		return {};
 	}
-	ret.asset.emplace(render_device().vulkan_device(), image, TextureCreateInfo{.colour_space = colour_space});
+	auto const create_info = TextureCreateInfo{.colour_space = colour_space, .usage = usage};
+	auto const extent = image.view().extent;
+	auto const initial_extent = [&] {
+		// streaming (downsampling) is RGBA only
+		if (usage != TextureUsage::eColour || image.channels() != 4) { return std::optional<Extent2D>{}; }
+		auto lock = std::scoped_lock{m_streamer->mutex};
+		return m_streamer->should_stream(extent) ? std::optional{fit(extent, m_streamer->info.initial_extent)} : std::nullopt;
+	}();
+	if (initial_extent && !render_device().is_null()) {
+		auto const initial = downsample_to(image.view(), *initial_extent, colour_space);
+		ret.asset.emplace(render_device(), initial.view(), create_info);
+		auto lock = std::scoped_lock{m_streamer->mutex};
+		auto entry = Streamer::Entry{.texture = ret.asset->vulkan_texture(), .image_uri = image_uri, .full_extent = extent, .colour_space = colour_space};
+		m_streamer->pending.insert_or_assign(uri, std::move(entry));
+	} else {
+		ret.asset.emplace(render_device(), image, create_info);
+	}
 	ret.dependencies = {uri, image_uri};
 	m_logger.info("[{:.3f}s] Texture loaded [{}]", stopwatch().count(), uri.value());
 	return ret;
 }
 
+void TextureProvider::on_loaded(Uri<Texture> const& uri, Texture& texture) {
+	auto lock = std::scoped_lock{m_streamer->mutex};
+	auto it = m_streamer->pending.find(uri);
+	// a concurrent load of the same uri may have replaced the pending entry: that load registers its own
+	if (it == m_streamer->pending.end() || it->second.texture != texture.vulkan_texture()) { return; }
+	m_streamer->entries.insert_or_assign(uri, std::move(it->second));
+	m_streamer->pending.erase(it);
+}
+
 void TextureProvider::add_default_textures() {
 	static constexpr auto white_image_v = FixedPixelMap<1, 1>{{white_v}};
-	add("white", Texture{render_device().vulkan_device(), white_image_v.view(), TextureCreateInfo{.name = "white", .mip_mapped = false}});
+	add("white", Texture{render_device(), white_image_v.view(), TextureCreateInfo{.name = "white", .mip_mapped = false}});
 	static constexpr auto black_image_v = FixedPixelMap<1, 1>{{black_v}};
-	add("black", Texture{render_device().vulkan_device(), black_image_v.view(), TextureCreateInfo{.name = "black", .mip_mapped = false}});
+	add("black", Texture{render_device(), black_image_v.view(), TextureCreateInfo{.name = "black", .mip_mapped = false}});
 }
 
 CubemapProvider::CubemapProvider(NotNull<RenderDevice*> render_device, NotNull<DataSource const*> data_source, NotNull<ThreadPool*> thread_pool)
@@ -111,6 +384,27 @@ CubemapProvider::Payload CubemapProvider::load_payload(Uri<Cubemap> const& uri,
 	for (auto const [image_uri, index] : enumerate(image_uris)) {
 		bytes[index] = m_thread_pool->submit([this, i = image_uri] { return read_bytes(i); });
 	}
+	auto const add_dependencies = [&] {
+		ret.dependencies.reserve(image_uris.size() + 1);
+		ret.dependencies.push_back(uri);
+		std::move(image_uris.begin(), image_uris.end(), std::back_inserter(ret.dependencies));
+	};
+
+	// baked faces are uploaded as they are, with their precomputed mips
+	if (std::ranges::all_of(bytes, [](auto const& future) { return future.future.get() && MipmappedImage::is_container(future.future.get().span()); })) {
+		auto faces = std::array<MipmappedImage, 6>{};
+		for (auto const [future, index] : enumerate(bytes)) {
+			faces[index] = MipmappedImage{ByteArray{future.future.get().span()}, image_uris[index]};
+			if (!faces[index]) {
+				m_logger.error("Failed to create Cubemap MipmappedImage {} [{}]", index, image_uris[index]);
+				return {};
+			}
+		}
+		ret.asset.emplace(render_device(), std::span<MipmappedImage const, 6>{faces}, TextureCreateInfo{.colour_space = colour_space});
+		add_dependencies();
+		m_logger.info("[{:.3f}s] Cubemap loaded [{}]", stopwatch().count(), uri.value());
+		return ret;
+	}
 
 	auto images = std::array<ScopedFuture<Image>, 6>{};
 	bool first{true};
@@ -139,10 +433,8 @@ CubemapProvider::Payload CubemapProvider::load_payload(Uri<Cubemap> const& uri,
 		}
 	}
 
-	ret.asset.emplace(render_device().vulkan_device(), image_views, TextureCreateInfo{.colour_space = colour_space});
-	ret.dependencies.reserve(image_uris.size() + 1);
-	ret.dependencies.push_back(uri);
-	std::move(image_uris.begin(), image_uris.end(), std::back_inserter(ret.dependencies));
+	ret.asset.emplace(render_device(), image_views, TextureCreateInfo{.colour_space = colour_space});
+	add_dependencies();
 	m_logger.info("[{:.3f}s] Cubemap loaded [{}]", stopwatch().count(), uri.value());
 	return ret;
 }
@@ -155,9 +447,9 @@ void CubemapProvider::add_default_cubemaps() {
 	};
 	static constexpr auto white_image_v = FixedPixelMap<1, 1>{{white_v}};
 	auto const white_cubemap = make_cubemap(white_image_v);
-	add("white", Cubemap{render_device().vulkan_device(), white_cubemap, TextureCreateInfo{.name = "white", .mip_mapped = false}});
+	add("white", Cubemap{render_device(), white_cubemap, TextureCreateInfo{.name = "white", .mip_mapped = false}});
 	static constexpr auto black_image_v = FixedPixelMap<1, 1>{{black_v}};
 	auto const black_cubemap = make_cubemap(black_image_v);
-	add("black", Cubemap{render_device().vulkan_device(), black_cubemap, TextureCreateInfo{.name = "black", .mip_mapped = false}});
+	add("black", Cubemap{render_device(), black_cubemap, TextureCreateInfo{.name = "black", .mip_mapped = false}});
 }
 } // namespace levk
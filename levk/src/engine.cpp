@@ -27,6 +27,19 @@ struct Fps {
 };
 
 auto const g_log{Logger{"Engine"}};
+
+Window make_window(EngineCreateInfo const& create_info) {
+	if (create_info.backend != EngineBackend::eWindowed) { return Window::make_null(create_info.window_extent); }
+	return Window{create_info.window_extent, create_info.window_title};
+}
+
+RenderDevice make_render_device(Window const& window, EngineCreateInfo const& create_info) {
+	switch (create_info.backend) {
+	case EngineBackend::eHeadless: return RenderDevice{create_info.window_extent, create_info.render_device_create_info};
+	case EngineBackend::eNull: return RenderDevice::make_null(create_info.render_device_create_info);
+	default: return RenderDevice{window, create_info.render_device_create_info};
+	}
+}
 } // namespace
 
 struct Engine::Impl {
@@ -39,8 +52,7 @@ struct Engine::Impl {
 	Fps fps{};
 
 	Impl(CreateInfo const& create_info)
-		: window(create_info.window_extent, create_info.window_title), render_device(window.get(), create_info.render_device_create_info),
-		  font_library(make_font_library()) {}
+		: window(make_window(create_info)), render_device(make_render_device(window.get(), create_info)), font_library(make_font_library()) {}
 };
 
 void Engine::Deleter::operator()(Impl* ptr) const {
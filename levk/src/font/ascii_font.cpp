@@ -8,12 +8,12 @@ struct AsciiFont::Pen::Writer {
 
 	template <typename Func>
 	void operator()(const std::string_view line, Func func) const {
+		if (!pen.m_glyphs) { return; }
 		for (char const ch : line) {
 			if (ch == '\n') { return; }
-			auto const* glyph = &pen.m_font.glyph_for(Ascii{ch}, pen.m_height);
-			if (!*glyph) { glyph = &pen.m_font.glyph_for(Ascii::eTofu, pen.m_height); }
-			if (!*glyph) { continue; }
-			func(*glyph);
+			auto const& glyph = (*pen.m_glyphs)[ch];
+			if (!glyph) { continue; }
+			func(glyph);
 		}
 	}
 };
@@ -30,6 +30,22 @@ FontGlyph const& AsciiFont::glyph_for(Ascii const ascii, TextHeight height) {
 	return null_v;
 }
 
+auto AsciiFont::glyph_table(TextHeight height) -> Ptr<GlyphTable const> {
+	height = clamp(height);
+	if (auto it = m_tables.find(height); it != m_tables.end()) { return &it->second; }
+	auto const* atlas = make_font_atlas(height);
+	if (!atlas) { return {}; }
+	auto ret = GlyphTable{.texture_uri = atlas->texture_uri(), .generation = m_generation};
+	auto const* tofu = atlas->glyph_for(static_cast<Codepoint>(Ascii::eTofu));
+	for (std::size_t i = 0; i < ret.glyphs.size(); ++i) {
+		auto const* glyph = atlas->glyph_for(static_cast<Codepoint>(i));
+		if (!glyph || !*glyph) { glyph = tofu; }
+		if (glyph) { ret.glyphs[i] = *glyph; }
+	}
+	auto [it, _] = m_tables.insert_or_assign(height, std::move(ret));
+	return &it->second;
+}
+
 Ptr<StaticFontAtlas const> AsciiFont::make_font_atlas(TextHeight height) {
 	if (auto* ret = find_font_atlas(height)) { return ret; }
 	if (!m_slot_factory) { return {}; }
@@ -52,7 +68,11 @@ Ptr<StaticFontAtlas const> AsciiFont::find_font_atlas(TextHeight const height) c
 	return {};
 }
 
-void AsciiFont::destroy_font_atlas(TextHeight height) { m_atlases.erase(height); }
+void AsciiFont::destroy_font_atlas(TextHeight height) {
+	height = clamp(height);
+	if (m_tables.erase(height) > 0) { ++m_generation; }
+	m_atlases.erase(height);
+}
 
 Uri<Texture> AsciiFont::texture_uri(TextHeight height) const {
 	height = clamp(height);
@@ -73,9 +93,7 @@ auto AsciiFont::Pen::write_line(const std::string_view line, Out out) -> Pen& {
 			cursor += glm::vec3{glyph.advance, 0.0f};
 		}
 	});
-	if (out.atlas) {
-		if (auto* atlas = m_font.find_font_atlas(m_height)) { *out.atlas = atlas->texture_uri(); }
-	}
+	if (out.atlas && m_glyphs) { *out.atlas = m_glyphs->texture_uri; }
 	return *this;
 }
 
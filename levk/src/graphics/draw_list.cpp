@@ -2,6 +2,7 @@
 #include <levk/graphics/draw_list.hpp>
 #include <levk/graphics/material.hpp>
 #include <memory>
+#include <utility>
 
 namespace levk {
 void DrawList::add(NotNull<StaticPrimitive const*> primitive, NotNull<Material const*> material, Instances const& instances) {
@@ -10,6 +11,7 @@ void DrawList::add(NotNull<StaticPrimitive const*> primitive, NotNull<Material c
 		.material = material,
 		.parent = instances.parent,
 		.instances = instances.instances,
+		.is_static = instances.is_static,
 	});
 }
 
@@ -23,6 +25,7 @@ void DrawList::add(NotNull<DynamicPrimitive const*> primitive, NotNull<Material
 		.material = material,
 		.parent = instances.parent,
 		.instances = instances.instances,
+		.is_static = instances.is_static,
 	});
 }
 
@@ -32,10 +35,21 @@ void DrawList::add(NotNull<DynamicPrimitive const*> primitive, NotNull<Material
 
 void DrawList::add(NotNull<StaticMesh const*> mesh, Instances const& instances, MaterialProvider& provider) {
 	static auto const s_default_mat{UnlitMaterial{}};
+	// the occluder covers the whole mesh: attach it to the first primitive only
+	auto const* occluder = mesh->occluder.indices.empty() ? nullptr : &mesh->occluder;
 	for (auto const& primitive : mesh->primitives) {
 		auto const* umaterial = provider.find(primitive.material);
 		auto const* material = umaterial ? umaterial->get() : &s_default_mat;
-		add(&primitive.primitive, material, instances);
+		m_drawables.push_back(Drawable{
+			.primitive = primitive.primitive.vulkan_primitive(),
+			.material = material,
+			.parent = instances.parent,
+			.instances = instances.instances,
+			.lods = primitive.lods,
+			.radius = primitive.radius,
+			.occluder = std::exchange(occluder, nullptr),
+			.is_static = instances.is_static,
+		});
 	}
 }
 
@@ -54,6 +68,8 @@ void DrawList::add(NotNull<SkinnedMesh const*> mesh, std::span<glm::mat4 const>
 			.skin_index = skin_index,
 			.parent = instances.parent,
 			.instances = instances.instances,
+			.lods = primitive.lods,
+			.radius = primitive.radius,
 		});
 	}
 }
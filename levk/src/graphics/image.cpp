@@ -6,35 +6,52 @@
 namespace levk {
 namespace {
 auto const g_log{Logger{"Image"}};
-}
+
+// RGB has no widely supported (sampled) 24 bit format
+constexpr int desired_channels(int const channels) { return channels == 1 || channels == 2 ? channels : 4; }
+} // namespace
 
 void Image::Storage::Deleter::operator()(Storage const& image) const {
 	if (image.data) { stbi_image_free(const_cast<std::byte*>(image.data)); }
 }
 
 Image::Image(std::span<std::byte const> compressed, std::string name) : m_name{std::move(name)} {
+	auto const* data = reinterpret_cast<stbi_uc const*>(compressed.data());
+	auto const size = static_cast<int>(compressed.size());
 	int x, y, channels;
-	auto ptr = stbi_load_from_memory(reinterpret_cast<stbi_uc const*>(compressed.data()), static_cast<int>(compressed.size()), &x, &y, &channels, 4);
+	if (!stbi_info_from_memory(data, size, &x, &y, &channels)) {
+		g_log.error("Failed to decompress [{}]", m_name);
+		return;
+	}
+	channels = desired_channels(channels);
+	auto ptr = stbi_load_from_memory(data, size, &x, &y, nullptr, channels);
 	if (!ptr) {
 		g_log.error("Failed to decompress [{}]", m_name);
 		return;
 	}
-	m_storage = Storage{static_cast<std::size_t>(x * y * 4), reinterpret_cast<std::byte const*>(ptr)};
+	m_storage = Storage{static_cast<std::size_t>(x * y * channels), reinterpret_cast<std::byte const*>(ptr)};
 	m_extent = glm::uvec2{glm::ivec2{x, y}};
+	m_channels = static_cast<std::uint8_t>(channels);
 }
 
 Image::Image(char const* file_path, std::string name) : m_name{std::move(name)} {
 	int x, y, channels;
-	auto ptr = stbi_load(file_path, &x, &y, &channels, 4);
+	if (!stbi_info(file_path, &x, &y, &channels)) {
+		g_log.error("Failed to decompress [{}]", m_name);
+		return;
+	}
+	channels = desired_channels(channels);
+	auto ptr = stbi_load(file_path, &x, &y, nullptr, channels);
 	if (!ptr) {
 		g_log.error("Failed to decompress [{}]", m_name);
 		return;
 	}
-	m_storage = Storage{static_cast<std::size_t>(x * y * 4), reinterpret_cast<std::byte const*>(ptr)};
+	m_storage = Storage{static_cast<std::size_t>(x * y * channels), reinterpret_cast<std::byte const*>(ptr)};
 	m_extent = glm::uvec2{glm::ivec2{x, y}};
+	m_channels = static_cast<std::uint8_t>(channels);
 }
 
-auto Image::view() const -> View { return View{.storage = m_storage.get().bytes(), .extent = m_extent}; }
+auto Image::view() const -> View { return View{.storage = m_storage.get().bytes(), .extent = m_extent, .channels = m_channels}; }
 
 Image::operator bool() const {
 	if (m_extent.x == 0 || m_extent.y == 0) { return false; }
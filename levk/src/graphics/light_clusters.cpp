@@ -0,0 +1,183 @@
+#include <levk/graphics/light_clusters.hpp>
+#include <levk/util/enumerate.hpp>
+#include <levk/util/thread_pool.hpp>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LEVK_CLUSTERS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace levk {
+namespace {
+// tile edges are tested four at a time
+constexpr std::size_t lanes_v{4u};
+
+constexpr std::uint64_t mask_of(std::uint32_t const bits) { return (std::uint64_t{1} << bits) - 1; }
+
+// bounds of set bits: first and last
+glm::uvec2 bit_range(std::uint64_t const bits) {
+	return {static_cast<std::uint32_t>(std::countr_zero(bits)), static_cast<std::uint32_t>(std::bit_width(bits) - 1)};
+}
+} // namespace
+
+void LightClusters::Planes::set(std::uint32_t const tiles, glm::vec4 const& row, glm::vec4 const& w_row) {
+	auto const edges = std::size_t{tiles} + 1;
+	auto const padded = (edges + lanes_v - 1) / lanes_v * lanes_v;
+	for (auto* out : {&x, &y, &z, &w}) { out->assign(padded, 0.0f); }
+	for (std::size_t i = 0; i < edges; ++i) {
+		// clip.x - a * clip.w >= 0 to the right of NDC x = a (likewise for y)
+		auto const a = -1.0f + 2.0f * static_cast<float>(i) / static_cast<float>(tiles);
+		auto plane = row - a * w_row;
+		if (auto const length = glm::length(glm::vec3{plane}); length > 0.0f) { plane /= length; }
+		x[i] = plane.x;
+		y[i] = plane.y;
+		z[i] = plane.z;
+		w[i] = plane.w;
+	}
+}
+
+auto LightClusters::Planes::sides(glm::vec3 const& centre, float const radius) const -> std::pair<std::uint64_t, std::uint64_t> {
+	auto positive = std::uint64_t{};
+	auto negative = std::uint64_t{};
+#if defined(LEVK_CLUSTERS_SSE2)
+	auto const cx = _mm_set1_ps(centre.x);
+	auto const cy = _mm_set1_ps(centre.y);
+	auto const cz = _mm_set1_ps(centre.z);
+	auto const r = _mm_set1_ps(radius);
+	auto const neg_r = _mm_set1_ps(-radius);
+	for (std::size_t i = 0; i < w.size(); i += lanes_v) {
+		auto distance = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(x.data() + i), cx), _mm_loadu_ps(w.data() + i));
+		distance = _mm_add_ps(distance, _mm_mul_ps(_mm_loadu_ps(y.data() + i), cy));
+		distance = _mm_add_ps(distance, _mm_mul_ps(_mm_loadu_ps(z.data() + i), cz));
+		positive |= static_cast<std::uint64_t>(_mm_movemask_ps(_mm_cmpge_ps(distance, neg_r))) << i;
+		negative |= static_cast<std::uint64_t>(_mm_movemask_ps(_mm_cmple_ps(distance, r))) << i;
+	}
+#else
+	for (std::size_t i = 0; i < w.size(); ++i) {
+		auto const distance = x[i] * centre.x + y[i] * centre.y + z[i] * centre.z + w[i];
+		if (distance >= -radius) { positive |= std::uint64_t{1} << i; }
+		if (distance <= radius) { negative |= std::uint64_t{1} << i; }
+	}
+#endif
+	return {positive, negative};
+}
+
+LightClusters::LightClusters(glm::uvec3 const grid, float const max_depth)
+	: m_grid(glm::max(glm::min(grid, glm::uvec3{max_tiles_v, max_tiles_v, grid.z}), glm::uvec3{1u})), m_max_depth(max_depth) {
+	m_slice_depths.resize(m_grid.z + 1);
+	m_data.assign(2 * cluster_count(), 0u);
+}
+
+void LightClusters::build(Camera const& camera, Extent2D const extent, std::span<LightBounds const> lights, Ptr<ThreadPool> thread_pool) {
+	m_eye = camera.transform.position();
+	m_front = camera.transform.orientation() * (camera.face == Camera::Face::ePositiveZ ? front_v : -front_v);
+	auto const slice_t = [this](std::uint32_t const z) { return static_cast<float>(z) / static_cast<float>(m_grid.z); };
+	if (auto const* perspective = std::get_if<Camera::Perspective>(&camera.type)) {
+		auto const near = std::max(perspective->view_plane.near, 0.001f);
+		auto const far = std::max(std::min(perspective->view_plane.far, m_max_depth), 2.0f * near);
+		// logarithmic: clusters stay roughly cubic in view space
+		auto const scale = static_cast<float>(m_grid.z) / std::log(far / near);
+		m_depth_params = {scale, -std::log(near) * scale, 1.0f, 0.0f};
+		for (std::uint32_t z = 0; z <= m_grid.z; ++z) { m_slice_depths[z] = near * std::pow(far / near, slice_t(z)); }
+	} else {
+		auto const& view_plane = std::get<Camera::Orthographic>(camera.type).view_plane;
+		auto const near = view_plane.near;
+		auto const far = std::max(std::min(view_plane.far, near + m_max_depth), near + 0.001f);
+		auto const scale = static_cast<float>(m_grid.z) / (far - near);
+		m_depth_params = {scale, -near * scale, 0.0f, 0.0f};
+		for (std::uint32_t z = 0; z <= m_grid.z; ++z) { m_slice_depths[z] = near + (far - near) * slice_t(z); }
+	}
+
+	auto const mat_vp = camera.projection(extent) * camera.view();
+	auto const row = [&mat_vp](int i) { return glm::vec4{mat_vp[0][i], mat_vp[1][i], mat_vp[2][i], mat_vp[3][i]}; };
+	m_columns.set(m_grid.x, row(0), row(3));
+	m_rows.set(m_grid.y, row(1), row(3));
+
+	auto const clusters = cluster_count();
+	m_counts.assign(clusters, 0u);
+	// each task owns a contiguous range of slices, and thus of clusters: no synchronization needed between them
+	auto const tasks = thread_pool ? std::min(thread_pool->thread_count() + 1, std::size_t{m_grid.z}) : std::size_t{1};
+	if (m_spans.size() < tasks) { m_spans.resize(tasks); }
+	auto const run = [&](auto const& task) {
+		auto futures = std::vector<ScopedFuture<void>>{};
+		futures.reserve(tasks - 1);
+		for (std::size_t i = 1; i < tasks; ++i) { futures.push_back(thread_pool->submit([&task, i] { task(i); })); }
+		task(0);
+		for (auto const& future : futures) { future.future.get(); }
+	};
+	run([&](std::size_t const i) {
+		auto const slices = glm::uvec2{m_grid.z * i / tasks, m_grid.z * (i + 1) / tasks};
+		m_spans[i].clear();
+		assign(lights, slices, m_spans[i]);
+	});
+
+	// headers, then each cluster's indices in order; counts become write cursors
+	auto const header = 2 * clusters;
+	auto total = std::size_t{};
+	for (auto const count : m_counts) { total += count; }
+	m_data.resize(header + total);
+	auto offset = static_cast<std::uint32_t>(header);
+	for (std::size_t i = 0; i < clusters; ++i) {
+		m_data[2 * i] = offset;
+		m_data[2 * i + 1] = m_counts[i];
+		m_counts[i] = offset;
+		offset += m_data[2 * i + 1];
+	}
+
+	run([&](std::size_t const i) { fill(m_spans[i]); });
+}
+
+std::uint32_t LightClusters::slice_of(float const depth) const {
+	auto const d = m_depth_params.z > 0.0f ? std::log(std::max(depth, std::numeric_limits<float>::min())) : depth;
+	auto const slice = std::floor(d * m_depth_params.x + m_depth_params.y);
+	if (!(slice > 0.0f)) { return 0u; }
+	return std::min(static_cast<std::uint32_t>(std::min(slice, static_cast<float>(m_grid.z))), m_grid.z - 1);
+}
+
+void LightClusters::assign(std::span<LightBounds const> lights, glm::uvec2 const slices, std::vector<Span>& out) {
+	auto const column_mask = mask_of(m_grid.x);
+	auto const row_mask = mask_of(m_grid.y);
+	for (auto const [light, index] : enumerate<std::uint32_t>(lights)) {
+		auto const depth = glm::dot(light.centre - m_eye, m_front);
+		// entirely nearer than the near plane
+		if (depth + light.radius < m_slice_depths.front()) { continue; }
+		auto const first = std::max(slice_of(depth - light.radius), slices.x);
+		auto const last = std::min(slice_of(depth + light.radius) + 1, slices.y);
+		for (auto z = first; z < last; ++z) {
+			// the part of the sphere within this slice (the last one extends to infinity), bounded by a smaller sphere
+			auto const far = z + 1 == m_grid.z ? std::numeric_limits<float>::max() : m_slice_depths[z + 1];
+			auto const offset = depth - std::clamp(depth, m_slice_depths[z], far);
+			auto const radius_sq = light.radius * light.radius - offset * offset;
+			if (radius_sq < 0.0f) { continue; }
+			auto const centre = light.centre - m_front * offset;
+			auto const radius = std::sqrt(radius_sq);
+			// a tile is reached if the sphere reaches the inside of both its edges
+			auto const [right, left] = m_columns.sides(centre, radius);
+			auto const [above, below] = m_rows.sides(centre, radius);
+			auto const columns = right & (left >> 1) & column_mask;
+			auto const rows = above & (below >> 1) & row_mask;
+			if (columns == 0 || rows == 0) { continue; }
+			auto const span = Span{.light = index, .z = z, .x = bit_range(columns), .y = bit_range(rows)};
+			for (auto y = span.y.x; y <= span.y.y; ++y) {
+				auto const row = (std::size_t{z} * m_grid.y + y) * m_grid.x;
+				for (auto x = span.x.x; x <= span.x.y; ++x) { ++m_counts[row + x]; }
+			}
+			out.push_back(span);
+		}
+	}
+}
+
+void LightClusters::fill(std::span<Span const> spans) {
+	for (auto const& span : spans) {
+		for (auto y = span.y.x; y <= span.y.y; ++y) {
+			auto const row = (std::size_t{span.z} * m_grid.y + y) * m_grid.x;
+			for (auto x = span.x.x; x <= span.x.y; ++x) { m_data[m_counts[row + x]++] = span.light; }
+		}
+	}
+}
+} // namespace levk
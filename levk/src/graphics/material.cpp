@@ -32,6 +32,7 @@ bool MaterialTextures::serialize(dj::Json& out) const {
 		auto& out_info = out.push_back({});
 		out_info["index"] = index;
 		out_info["uri"] = uri.value();
+		if (usages[index] != TextureUsage::eColour) { out_info["usage"] = TextureProvider::from(usages[index]); }
 	}
 	return true;
 }
@@ -41,6 +42,7 @@ bool MaterialTextures::deserialize(dj::Json const& json) {
 		auto const index = in_info["index"].as<std::size_t>();
 		if (index >= uris.size()) { continue; }
 		uris[index] = in_info["uri"].as<std::string>();
+		usages[index] = TextureProvider::to_texture_usage(in_info["usage"].as_string());
 	}
 	return true;
 }
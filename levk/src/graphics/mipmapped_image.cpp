@@ -0,0 +1,576 @@
+#include <levk/graphics/mipmapped_image.hpp>
+#include <levk/util/logger.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace levk {
+namespace {
+auto const g_log{Logger{"MipmappedImage"}};
+
+constexpr std::array<std::uint8_t, 12> ktx2_identifier_v{0xab, 0x4b, 0x54, 0x58, 0x20, 0x32, 0x30, 0xbb, 0x0d, 0x0a, 0x1a, 0x0a};
+constexpr std::array<std::uint8_t, 4> dds_identifier_v{'D', 'D', 'S', ' '};
+constexpr std::array<std::uint8_t, 4> levk_identifier_v{'L', 'V', 'K', 'T'};
+
+// levk texture container (little endian):
+// identifier, version, format, colour space, width, height, mip count, (reserved): u32 each
+// mip table: offset, size: u64 each, per mip (largest first); mips are aligned to levk_alignment_v
+constexpr std::uint32_t levk_version_v{1};
+constexpr std::size_t levk_header_size_v{32};
+constexpr std::size_t levk_mip_entry_size_v{16};
+constexpr std::size_t levk_alignment_v{16};
+
+constexpr std::size_t ktx2_header_size_v{80};
+constexpr std::size_t ktx2_level_size_v{24};
+constexpr std::size_t dds_header_size_v{128};
+constexpr std::size_t dds_dx10_header_size_v{20};
+
+template <std::size_t N>
+bool starts_with(std::span<std::byte const> bytes, std::array<std::uint8_t, N> const& identifier) {
+	if (bytes.size() < N) { return false; }
+	return std::equal(identifier.begin(), identifier.end(), bytes.begin(), [](std::uint8_t a, std::byte b) { return std::byte{a} == b; });
+}
+
+// containers are little endian, as are all supported hosts
+template <typename Type>
+Type read(std::span<std::byte const> bytes, std::size_t const offset) {
+	auto ret = Type{};
+	if (offset + sizeof(Type) <= bytes.size()) { std::memcpy(&ret, bytes.data() + offset, sizeof(Type)); }
+	return ret;
+}
+
+constexpr std::uint32_t four_cc(char const (&str)[5]) {
+	return static_cast<std::uint32_t>(str[0]) | static_cast<std::uint32_t>(str[1]) << 8 | static_cast<std::uint32_t>(str[2]) << 16 |
+		   static_cast<std::uint32_t>(str[3]) << 24;
+}
+
+template <typename Type>
+void write(std::span<std::byte> out, std::size_t const offset, Type const value) {
+	std::memcpy(out.data() + offset, &value, sizeof(Type));
+}
+
+// bytes per block
+constexpr std::size_t block_size(ImageFormat const format) {
+	switch (format) {
+	case ImageFormat::eRgba8: return 4u;
+	case ImageFormat::eBc1: return 8u;
+	default: return 16u;
+	}
+}
+
+// texels per block side
+constexpr std::uint32_t block_extent(ImageFormat const format) { return format == ImageFormat::eRgba8 ? 1u : 4u; }
+
+constexpr Extent2D mip_extent(Extent2D const extent, std::size_t const mip) { return {std::max(extent.x >> mip, 1u), std::max(extent.y >> mip, 1u)}; }
+
+constexpr std::size_t mip_size(ImageFormat const format, Extent2D const extent) {
+	auto const b = block_extent(format);
+	return (std::size_t{extent.x} + b - 1u) / b * ((std::size_t{extent.y} + b - 1u) / b) * block_size(format);
+}
+
+// levels in the full mip chain of extent (none if extent is empty)
+constexpr std::uint32_t max_levels(Extent2D const extent) {
+	if (extent.x == 0 || extent.y == 0) { return 0; }
+	return static_cast<std::uint32_t>(std::bit_width(std::max(extent.x, extent.y)));
+}
+
+// file offsets and sizes are untrusted: offset + size may wrap
+constexpr bool in_bounds(std::uint64_t const offset, std::uint64_t const size, std::size_t const total) { return offset <= total && size <= total - offset; }
+
+constexpr std::size_t align_up(std::size_t const value, std::size_t const alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+struct Format {
+	ImageFormat block{};
+	std::optional<ColourSpace> colour_space{};
+};
+
+// VkFormat values
+std::optional<Format> from_vk_format(std::uint32_t const format) {
+	switch (format) {
+	case 131: // BC1_RGB_UNORM
+	case 133: return Format{ImageFormat::eBc1, ColourSpace::eLinear};
+	case 132: // BC1_RGB_SRGB
+	case 134: return Format{ImageFormat::eBc1, ColourSpace::eSrgb};
+	case 137: return Format{ImageFormat::eBc3, ColourSpace::eLinear};
+	case 138: return Format{ImageFormat::eBc3, ColourSpace::eSrgb};
+	case 141: return Format{ImageFormat::eBc5, ColourSpace::eLinear};
+	case 145: return Format{ImageFormat::eBc7, ColourSpace::eLinear};
+	case 146: return Format{ImageFormat::eBc7, ColourSpace::eSrgb};
+	default: return {};
+	}
+}
+
+// DXGI_FORMAT values
+std::optional<Format> from_dxgi_format(std::uint32_t const format) {
+	switch (format) {
+	case 71: return Format{ImageFormat::eBc1, ColourSpace::eLinear};
+	case 72: return Format{ImageFormat::eBc1, ColourSpace::eSrgb};
+	case 77: return Format{ImageFormat::eBc3, ColourSpace::eLinear};
+	case 78: return Format{ImageFormat::eBc3, ColourSpace::eSrgb};
+	case 83: return Format{ImageFormat::eBc5, ColourSpace::eLinear};
+	case 98: return Format{ImageFormat::eBc7, ColourSpace::eLinear};
+	case 99: return Format{ImageFormat::eBc7, ColourSpace::eSrgb};
+	default: return {};
+	}
+}
+
+// legacy DDS: colour space is not specified
+std::optional<Format> from_four_cc(std::uint32_t const code) {
+	if (code == four_cc("DXT1")) { return Format{ImageFormat::eBc1}; }
+	if (code == four_cc("DXT5")) { return Format{ImageFormat::eBc3}; }
+	if (code == four_cc("ATI2") || code == four_cc("BC5U")) { return Format{ImageFormat::eBc5, ColourSpace::eLinear}; }
+	return {};
+}
+
+struct Parsed {
+	Format format{};
+	std::vector<MipmappedImage::Mip> mips{};
+};
+
+std::optional<Parsed> parse_levk(std::span<std::byte const> bytes) {
+	if (bytes.size() < levk_header_size_v || read<std::uint32_t>(bytes, 4) != levk_version_v) { return {}; }
+	auto const format = read<std::uint32_t>(bytes, 8);
+	auto const colour_space = read<std::uint32_t>(bytes, 12);
+	if (format > static_cast<std::uint32_t>(ImageFormat::eBc7) || colour_space > static_cast<std::uint32_t>(ColourSpace::eLinear)) { return {}; }
+	auto const extent = Extent2D{read<std::uint32_t>(bytes, 16), read<std::uint32_t>(bytes, 20)};
+	auto const levels = read<std::uint32_t>(bytes, 24);
+	if (levels == 0 || levels > max_levels(extent) || bytes.size() < levk_header_size_v + levels * levk_mip_entry_size_v) { return {}; }
+
+	auto ret = Parsed{.format = {static_cast<ImageFormat>(format), static_cast<ColourSpace>(colour_space)}};
+	for (std::uint32_t level = 0; level < levels; ++level) {
+		auto const index = levk_header_size_v + level * levk_mip_entry_size_v;
+		auto const offset = read<std::uint64_t>(bytes, index);
+		auto const size = read<std::uint64_t>(bytes, index + 8);
+		auto const mip = mip_extent(extent, level);
+		if (size != mip_size(ret.format.block, mip) || !in_bounds(offset, size, bytes.size())) { return {}; }
+		ret.mips.push_back({bytes.subspan(offset, size), mip});
+	}
+	return ret;
+}
+
+std::optional<Parsed> parse_ktx2(std::span<std::byte const> bytes) {
+	if (bytes.size() < ktx2_header_size_v) { return {}; }
+	auto const format = from_vk_format(read<std::uint32_t>(bytes, 12));
+	if (!format) { return {}; }
+	auto const extent = Extent2D{read<std::uint32_t>(bytes, 20), read<std::uint32_t>(bytes, 24)};
+	auto const depth = read<std::uint32_t>(bytes, 28);
+	auto const layers = read<std::uint32_t>(bytes, 32);
+	auto const faces = read<std::uint32_t>(bytes, 36);
+	auto const levels = std::max(read<std::uint32_t>(bytes, 40), 1u);
+	auto const supercompression = read<std::uint32_t>(bytes, 44);
+	if (depth > 1u || layers > 1u || faces != 1u || supercompression != 0u || levels > max_levels(extent)) { return {}; }
+	if (bytes.size() < ktx2_header_size_v + levels * ktx2_level_size_v) { return {}; }
+
+	auto ret = Parsed{.format = *format};
+	for (std::uint32_t level = 0; level < levels; ++level) {
+		auto const index = ktx2_header_size_v + level * ktx2_level_size_v;
+		auto const offset = read<std::uint64_t>(bytes, index);
+		auto const length = read<std::uint64_t>(bytes, index + 8);
+		auto const mip = mip_extent(extent, level);
+		if (length < mip_size(format->block, mip) || !in_bounds(offset, length, bytes.size())) { return {}; }
+		ret.mips.push_back({bytes.subspan(offset, mip_size(format->block, mip)), mip});
+	}
+	return ret;
+}
+
+std::optional<Parsed> parse_dds(std::span<std::byte const> bytes) {
+	static constexpr std::uint32_t fourcc_flag_v{0x4};
+	static constexpr std::uint32_t cubemap_flag_v{0x200};
+	static constexpr std::uint32_t texture_2d_v{3};
+
+	if (bytes.size() < dds_header_size_v || read<std::uint32_t>(bytes, 4) != 124u) { return {}; }
+	auto const extent = Extent2D{read<std::uint32_t>(bytes, 16), read<std::uint32_t>(bytes, 12)};
+	auto const levels = std::max(read<std::uint32_t>(bytes, 28), 1u);
+	if (levels > max_levels(extent)) { return {}; }
+	if ((read<std::uint32_t>(bytes, 80) & fourcc_flag_v) == 0 || (read<std::uint32_t>(bytes, 112) & cubemap_flag_v) != 0) { return {}; }
+
+	auto format = std::optional<Format>{};
+	auto offset = dds_header_size_v;
+	if (auto const code = read<std::uint32_t>(bytes, 84); code == four_cc("DX10")) {
+		if (bytes.size() < dds_header_size_v + dds_dx10_header_size_v) { return {}; }
+		if (read<std::uint32_t>(bytes, 132) != texture_2d_v || read<std::uint32_t>(bytes, 140) > 1u) { return {}; }
+		format = from_dxgi_format(read<std::uint32_t>(bytes, 128));
+		offset += dds_dx10_header_size_v;
+	} else {
+		format = from_four_cc(code);
+	}
+	if (!format) { return {}; }
+
+	auto ret = Parsed{.format = *format};
+	for (std::uint32_t level = 0; level < levels; ++level) {
+		auto const mip = mip_extent(extent, level);
+		auto const size = mip_size(format->block, mip);
+		if (!in_bounds(offset, size, bytes.size())) { return {}; }
+		ret.mips.push_back({bytes.subspan(offset, size), mip});
+		offset += size;
+	}
+	return ret;
+}
+
+// decoded BCn block: 4x4 texels
+using Block = std::array<glm::tvec4<std::uint8_t>, 16>;
+
+constexpr glm::uvec3 from_565(std::uint16_t const value) {
+	auto const r = (value >> 11) & 0x1fu;
+	auto const g = (value >> 5) & 0x3fu;
+	auto const b = value & 0x1fu;
+	return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+}
+
+// BC1 colour block; BC3 colour blocks are always in four colour mode
+void decode_colour(Block& out, std::span<std::byte const> block, bool const four_colour) {
+	auto const c0 = read<std::uint16_t>(block, 0);
+	auto const c1 = read<std::uint16_t>(block, 2);
+	auto const indices = read<std::uint32_t>(block, 4);
+	auto const rgb0 = from_565(c0);
+	auto const rgb1 = from_565(c1);
+	auto palette = std::array<glm::uvec4, 4>{glm::uvec4{rgb0, 0xffu}, glm::uvec4{rgb1, 0xffu}};
+	if (four_colour || c0 > c1) {
+		palette[2] = glm::uvec4{(2u * rgb0 + rgb1) / 3u, 0xffu};
+		palette[3] = glm::uvec4{(rgb0 + 2u * rgb1) / 3u, 0xffu};
+	} else {
+		palette[2] = glm::uvec4{(rgb0 + rgb1) / 2u, 0xffu};
+		palette[3] = glm::uvec4{0u};
+	}
+	for (std::size_t i = 0; i < out.size(); ++i) { out[i] = glm::tvec4<std::uint8_t>{palette[(indices >> (2u * i)) & 0x3u]}; }
+}
+
+// BC3 alpha block / BC4 channel: writes channel of each texel
+void decode_channel(Block& out, std::span<std::byte const> block, std::size_t const channel) {
+	auto const a0 = std::to_integer<std::uint32_t>(block[0]);
+	auto const a1 = std::to_integer<std::uint32_t>(block[1]);
+	auto palette = std::array<std::uint32_t, 8>{a0, a1};
+	if (a0 > a1) {
+		for (std::uint32_t i = 1; i < 7; ++i) { palette[i + 1] = ((7u - i) * a0 + i * a1) / 7u; }
+	} else {
+		for (std::uint32_t i = 1; i < 5; ++i) { palette[i + 1] = ((5u - i) * a0 + i * a1) / 5u; }
+		palette[6] = 0x00u;
+		palette[7] = 0xffu;
+	}
+	auto indices = std::uint64_t{};
+	std::memcpy(&indices, block.data() + 2, 6);
+	for (std::size_t i = 0; i < out.size(); ++i) { out[i][channel] = static_cast<std::uint8_t>(palette[(indices >> (3u * i)) & 0x7u]); }
+}
+
+// BC7: partition tables as subset per texel (1 bit per texel for 2 subsets, 2 bits for 3 subsets)
+constexpr std::array<std::uint16_t, 64> bc7_partitions_2_v{
+	0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80, 0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000,
+	0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce, 0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c,
+	0xaaaa, 0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a, 0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660,
+	0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6, 0x639c, 0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22,
+};
+
+constexpr std::array<std::uint32_t, 64> bc7_partitions_3_v{
+	0xaa685050, 0x6a5a5040, 0x5a5a4200, 0x5450a0a8, 0xa5a50000, 0xa0a05050, 0x5555a0a0, 0x5a5a5050,
+	0xaa550000, 0xaa555500, 0xaaaa5500, 0x90909090, 0x94949494, 0xa4a4a4a4, 0xa9a59450, 0x2a0a4250,
+	0xa5945040, 0x0a425054, 0xa5a5a500, 0x55a0a0a0, 0xa8a85454, 0x6a6a4040, 0xa4a45000, 0x1a1a0500,
+	0x0050a4a4, 0xaaa59090, 0x14696914, 0x69691400, 0xa08585a0, 0xaa821414, 0x50a4a450, 0x6a5a0200,
+	0xa9a58000, 0x5090a0a8, 0xa8a09050, 0x24242424, 0x00aa5500, 0x24924924, 0x24499224, 0x50a50a50,
+	0x500aa550, 0xaaaa4444, 0x66660000, 0xa5a0a5a0, 0x50a050a0, 0x69286928, 0x44aaaa44, 0x66666600,
+	0xaa444444, 0x54a854a8, 0x95809580, 0x96969600, 0xa85454a8, 0x80959580, 0xaa141414, 0x96960000,
+	0xaaaa1414, 0xa05050a0, 0xa0a5a5a0, 0x96000000, 0x40804080, 0xa9a8a9a8, 0xaaaaaa44, 0x2a4a5254,
+};
+
+constexpr std::array<std::uint8_t, 64> bc7_anchors_2_v{
+	15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+	15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6, 6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15,
+};
+
+constexpr std::array<std::uint8_t, 64> bc7_anchors_3_1_v{
+	3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3, 3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15,
+	8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15, 3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3,
+};
+
+constexpr std::array<std::uint8_t, 64> bc7_anchors_3_2_v{
+	15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8, 15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8,
+	15, 3, 15, 10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8, 15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8,
+};
+
+struct Bc7Mode {
+	std::uint32_t subsets{};
+	std::uint32_t partition_bits{};
+	std::uint32_t rotation_bits{};
+	std::uint32_t index_selection_bits{};
+	std::uint32_t colour_bits{};
+	std::uint32_t alpha_bits{};
+	std::uint32_t endpoint_pbits{};
+	std::uint32_t shared_pbits{};
+	std::uint32_t index_bits{};
+	std::uint32_t index_bits_2{};
+};
+
+constexpr std::array<Bc7Mode, 8> bc7_modes_v{{
+	{3, 4, 0, 0, 4, 0, 1, 0, 3, 0},
+	{2, 6, 0, 0, 6, 0, 0, 1, 3, 0},
+	{3, 6, 0, 0, 5, 0, 0, 0, 2, 0},
+	{2, 6, 0, 0, 7, 0, 1, 0, 2, 0},
+	{1, 0, 2, 1, 5, 6, 0, 0, 2, 3},
+	{1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+	{1, 0, 0, 0, 7, 7, 1, 0, 4, 0},
+	{2, 6, 0, 0, 5, 5, 1, 0, 2, 0},
+}};
+
+constexpr std::array<std::uint32_t, 4> bc7_weights_2_v{0, 21, 43, 64};
+constexpr std::array<std::uint32_t, 8> bc7_weights_3_v{0, 9, 18, 27, 37, 46, 55, 64};
+constexpr std::array<std::uint32_t, 16> bc7_weights_4_v{0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+// 128 bit block, read LSB first
+struct BitReader {
+	std::uint64_t lo{};
+	std::uint64_t hi{};
+	std::uint32_t position{};
+
+	std::uint32_t operator()(std::uint32_t const count) {
+		auto ret = std::uint32_t{};
+		for (std::uint32_t i = 0; i < count; ++i, ++position) {
+			auto const bit = position < 64u ? lo >> position : hi >> (position - 64u);
+			ret |= static_cast<std::uint32_t>(bit & 1u) << i;
+		}
+		return ret;
+	}
+};
+
+// replicate high bits into the low bits of an 8 bit value
+constexpr std::uint32_t expand_bits(std::uint32_t const value, std::uint32_t const bits) { return (value << (8u - bits)) | (value >> (2u * bits - 8u)); }
+
+constexpr std::uint32_t bc7_interpolate(std::uint32_t const e0, std::uint32_t const e1, std::uint32_t const index, std::uint32_t const index_bits) {
+	auto const weight = index_bits == 2u ? bc7_weights_2_v[index] : index_bits == 3u ? bc7_weights_3_v[index] : bc7_weights_4_v[index];
+	return ((64u - weight) * e0 + weight * e1 + 32u) >> 6u;
+}
+
+void decode_bc7(Block& out, std::span<std::byte const> block) {
+	auto bits = BitReader{read<std::uint64_t>(block, 0), read<std::uint64_t>(block, 8)};
+	auto mode_index = std::uint32_t{};
+	while (mode_index < bc7_modes_v.size() && bits(1) == 0) { ++mode_index; }
+	if (mode_index >= bc7_modes_v.size()) {
+		// reserved mode
+		out.fill({});
+		return;
+	}
+	auto const& mode = bc7_modes_v[mode_index];
+	auto const partition = bits(mode.partition_bits);
+	auto const rotation = bits(mode.rotation_bits);
+	auto const index_selection = bits(mode.index_selection_bits);
+
+	auto endpoints = std::array<glm::uvec4, 6>{};
+	auto const endpoint_count = mode.subsets * 2u;
+	for (glm::length_t c = 0; c < 3; ++c) {
+		for (std::uint32_t e = 0; e < endpoint_count; ++e) { endpoints[e][c] = bits(mode.colour_bits); }
+	}
+	for (std::uint32_t e = 0; e < endpoint_count; ++e) { endpoints[e].w = mode.alpha_bits > 0u ? bits(mode.alpha_bits) : 0xffu; }
+
+	auto colour_bits = mode.colour_bits;
+	auto alpha_bits = mode.alpha_bits;
+	if (mode.endpoint_pbits > 0u || mode.shared_pbits > 0u) {
+		auto pbits = std::array<std::uint32_t, 6>{};
+		if (mode.endpoint_pbits > 0u) {
+			for (std::uint32_t e = 0; e < endpoint_count; ++e) { pbits[e] = bits(1); }
+		} else {
+			for (std::uint32_t s = 0; s < mode.subsets; ++s) { pbits[2u * s] = pbits[2u * s + 1u] = bits(1); }
+		}
+		for (std::uint32_t e = 0; e < endpoint_count; ++e) {
+			for (glm::length_t c = 0; c < 3; ++c) { endpoints[e][c] = (endpoints[e][c] << 1u) | pbits[e]; }
+			if (alpha_bits > 0u) { endpoints[e].w = (endpoints[e].w << 1u) | pbits[e]; }
+		}
+		++colour_bits;
+		if (alpha_bits > 0u) { ++alpha_bits; }
+	}
+	for (std::uint32_t e = 0; e < endpoint_count; ++e) {
+		for (glm::length_t c = 0; c < 3; ++c) { endpoints[e][c] = expand_bits(endpoints[e][c], colour_bits); }
+		if (alpha_bits > 0u) { endpoints[e].w = expand_bits(endpoints[e].w, alpha_bits); }
+	}
+
+	auto const subset_of = [&](std::uint32_t const texel) -> std::uint32_t {
+		switch (mode.subsets) {
+		case 2: return (bc7_partitions_2_v[partition] >> texel) & 0x1u;
+		case 3: return (bc7_partitions_3_v[partition] >> (2u * texel)) & 0x3u;
+		default: return 0u;
+		}
+	};
+	// anchor texels store one less index bit
+	auto const is_anchor = [&](std::uint32_t const texel) {
+		if (texel == 0) { return true; }
+		if (mode.subsets == 2) { return texel == bc7_anchors_2_v[partition]; }
+		if (mode.subsets == 3) { return texel == bc7_anchors_3_1_v[partition] || texel == bc7_anchors_3_2_v[partition]; }
+		return false;
+	};
+	auto indices = std::array<std::uint32_t, 16>{};
+	for (std::uint32_t t = 0; t < 16; ++t) { indices[t] = bits(mode.index_bits - (is_anchor(t) ? 1u : 0u)); }
+	auto indices_2 = std::array<std::uint32_t, 16>{};
+	if (mode.index_bits_2 > 0u) {
+		for (std::uint32_t t = 0; t < 16; ++t) { indices_2[t] = bits(mode.index_bits_2 - (t == 0 ? 1u : 0u)); }
+	}
+
+	for (std::uint32_t t = 0; t < 16; ++t) {
+		auto const subset = subset_of(t);
+		auto const& e0 = endpoints[2u * subset];
+		auto const& e1 = endpoints[2u * subset + 1u];
+		auto colour_index = indices[t];
+		auto colour_index_bits = mode.index_bits;
+		auto alpha_index = indices[t];
+		auto alpha_index_bits = mode.index_bits;
+		if (mode.index_bits_2 > 0u) {
+			alpha_index = indices_2[t];
+			alpha_index_bits = mode.index_bits_2;
+			if (index_selection > 0u) {
+				std::swap(colour_index, alpha_index);
+				std::swap(colour_index_bits, alpha_index_bits);
+			}
+		}
+		auto texel = glm::uvec4{};
+		for (glm::length_t c = 0; c < 3; ++c) { texel[c] = bc7_interpolate(e0[c], e1[c], colour_index, colour_index_bits); }
+		texel.w = bc7_interpolate(e0.w, e1.w, alpha_index, alpha_index_bits);
+		if (rotation > 0u) { std::swap(texel.w, texel[static_cast<glm::length_t>(rotation - 1u)]); }
+		out[t] = glm::tvec4<std::uint8_t>{texel};
+	}
+}
+
+float to_linear(std::uint8_t const srgb) {
+	static auto const table = [] {
+		auto ret = std::array<float, 256>{};
+		for (std::size_t i = 0; i < ret.size(); ++i) {
+			auto const c = static_cast<float>(i) / 255.0f;
+			ret[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+		}
+		return ret;
+	}();
+	return table[srgb];
+}
+
+std::uint8_t to_unorm8(float const value) { return static_cast<std::uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f); }
+
+std::uint8_t to_srgb(float const linear) { return to_unorm8(linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f); }
+
+void decode_block(Block& out, ImageFormat const format, std::span<std::byte const> block) {
+	switch (format) {
+	case ImageFormat::eBc1: decode_colour(out, block, false); break;
+	case ImageFormat::eBc3:
+		decode_colour(out, block.subspan(8), true);
+		decode_channel(out, block, 3);
+		break;
+	case ImageFormat::eBc5:
+		for (auto& texel : out) { texel = {0x00, 0x00, 0x00, 0xff}; }
+		decode_channel(out, block, 0);
+		decode_channel(out, block.subspan(8), 1);
+		break;
+	case ImageFormat::eBc7: decode_bc7(out, block); break;
+	default: break;
+	}
+}
+} // namespace
+
+bool MipmappedImage::is_container(std::span<std::byte const> bytes) {
+	return starts_with(bytes, levk_identifier_v) || starts_with(bytes, ktx2_identifier_v) || starts_with(bytes, dds_identifier_v);
+}
+
+ByteArray MipmappedImage::bake(Image::View image, ColourSpace const colour_space) {
+	// the container only stores RGBA8
+	auto rgba = DynPixelMap{};
+	if (image.channels != 4) {
+		rgba = to_rgba(image);
+		image = rgba.view();
+	}
+	if (image.extent.x == 0 || image.extent.y == 0 || image.storage.size() < mip_size(ImageFormat::eRgba8, image.extent)) { return {}; }
+	auto const levels = static_cast<std::size_t>(std::floor(std::log2(std::max(image.extent.x, image.extent.y)))) + 1u;
+	auto mips = std::vector<DynPixelMap>{};
+	mips.reserve(levels);
+	auto views = std::vector<Image::View>{image};
+	for (std::size_t level = 1; level < levels; ++level) {
+		mips.push_back(downsample(views.back(), colour_space));
+		views.push_back(mips.back().view());
+	}
+
+	auto offset = align_up(levk_header_size_v + views.size() * levk_mip_entry_size_v, levk_alignment_v);
+	auto offsets = std::vector<std::size_t>{};
+	for (auto const& view : views) {
+		offsets.push_back(offset);
+		offset = align_up(offset + mip_size(ImageFormat::eRgba8, view.extent), levk_alignment_v);
+	}
+
+	auto ret = ByteArray{offset};
+	auto const out = ret.span();
+	std::fill(out.begin(), out.end(), std::byte{});
+	std::memcpy(out.data(), levk_identifier_v.data(), levk_identifier_v.size());
+	write(out, 4, levk_version_v);
+	write(out, 8, static_cast<std::uint32_t>(ImageFormat::eRgba8));
+	write(out, 12, static_cast<std::uint32_t>(colour_space));
+	write(out, 16, image.extent.x);
+	write(out, 20, image.extent.y);
+	write(out, 24, static_cast<std::uint32_t>(views.size()));
+	for (std::size_t level = 0; level < views.size(); ++level) {
+		auto const size = mip_size(ImageFormat::eRgba8, views[level].extent);
+		write(out, levk_header_size_v + level * levk_mip_entry_size_v, static_cast<std::uint64_t>(offsets[level]));
+		write(out, levk_header_size_v + level * levk_mip_entry_size_v + 8, static_cast<std::uint64_t>(size));
+		std::memcpy(out.data() + offsets[level], views[level].storage.data(), size);
+	}
+	return ret;
+}
+
+MipmappedImage::MipmappedImage(ByteArray bytes, std::string name) : m_name(std::move(name)), m_bytes(std::move(bytes)) {
+	auto const span = m_bytes.span();
+	auto parsed = [&]() -> std::optional<Parsed> {
+		if (starts_with(span, levk_identifier_v)) { return parse_levk(span); }
+		if (starts_with(span, ktx2_identifier_v)) { return parse_ktx2(span); }
+		if (starts_with(span, dds_identifier_v)) { return parse_dds(span); }
+		return {};
+	}();
+	if (!parsed || parsed->mips.empty() || parsed->mips.front().extent.x == 0 || parsed->mips.front().extent.y == 0) {
+		g_log.error("Failed to parse texture container [{}]", m_name);
+		return;
+	}
+	m_format = parsed->format.block;
+	m_colour_space = parsed->format.colour_space;
+	m_mips = std::move(parsed->mips);
+}
+
+DynPixelMap MipmappedImage::decode(std::size_t const mip) const {
+	if (mip >= m_mips.size()) { return {}; }
+	auto const& in = m_mips[mip];
+	auto ret = DynPixelMap{in.extent};
+	if (m_format == ImageFormat::eRgba8) {
+		std::memcpy(ret.span().data(), in.bytes.data(), in.bytes.size());
+		return ret;
+	}
+	auto const blocks = Extent2D{(in.extent.x + 3u) / 4u, (in.extent.y + 3u) / 4u};
+	auto const size = block_size(m_format);
+	auto block = Block{};
+	for (std::uint32_t by = 0; by < blocks.y; ++by) {
+		for (std::uint32_t bx = 0; bx < blocks.x; ++bx) {
+			decode_block(block, m_format, in.bytes.subspan((std::size_t{by} * blocks.x + bx) * size, size));
+			for (std::uint32_t y = 0; y < 4u && 4u * by + y < in.extent.y; ++y) {
+				for (std::uint32_t x = 0; x < 4u && 4u * bx + x < in.extent.x; ++x) { ret[{4u * bx + x, 4u * by + y}].channels = block[y * 4u + x]; }
+			}
+		}
+	}
+	return ret;
+}
+
+DynPixelMap downsample(Image::View const image, ColourSpace const colour_space) {
+	if (image.channels != 4) { return downsample(to_rgba(image).view(), colour_space); }
+	auto ret = DynPixelMap{Extent2D{std::max(image.extent.x / 2u, 1u), std::max(image.extent.y / 2u, 1u)}};
+	if (image.storage.size() < mip_size(ImageFormat::eRgba8, image.extent)) { return ret; }
+	bool const srgb = colour_space == ColourSpace::eSrgb;
+	auto const texel = [&](std::uint32_t x, std::uint32_t y) {
+		x = std::min(x, image.extent.x - 1u);
+		y = std::min(y, image.extent.y - 1u);
+		auto const* rgba = &image.storage[(std::size_t{y} * image.extent.x + x) * 4u];
+		auto value = glm::vec4{};
+		for (int c = 0; c < 4; ++c) {
+			auto const channel = std::to_integer<std::uint8_t>(rgba[c]);
+			// alpha is always linear
+			value[c] = srgb && c < 3 ? to_linear(channel) : Rgba::to_f32(channel);
+		}
+		return value;
+	};
+	for (std::uint32_t y = 0; y < ret.extent().y; ++y) {
+		for (std::uint32_t x = 0; x < ret.extent().x; ++x) {
+			auto const average = 0.25f * (texel(2u * x, 2u * y) + texel(2u * x + 1u, 2u * y) + texel(2u * x, 2u * y + 1u) + texel(2u * x + 1u, 2u * y + 1u));
+			auto& out = ret[{x, y}].channels;
+			for (int c = 0; c < 4; ++c) { out[c] = srgb && c < 3 ? to_srgb(average[c]) : to_unorm8(average[c]); }
+		}
+	}
+	return ret;
+}
+} // namespace levk
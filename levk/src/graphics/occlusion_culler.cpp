@@ -0,0 +1,177 @@
+#include <levk/graphics/occlusion_culler.hpp>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <optional>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LEVK_OCCLUSION_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace levk {
+namespace {
+// rows are rasterized four pixels at a time
+constexpr std::uint32_t lanes_v{4u};
+
+struct Edge {
+	float a{};
+	float b{};
+	float c{};
+
+	// positive to the left of v0 => v1
+	static Edge make(glm::vec2 const v0, glm::vec2 const v1) {
+		auto ret = Edge{v0.y - v1.y, v1.x - v0.x};
+		ret.c = -(ret.a * v0.x + ret.b * v0.y);
+		return ret;
+	}
+};
+
+constexpr float to_pixel(float const ndc, std::uint32_t const size) { return (ndc * 0.5f + 0.5f) * static_cast<float>(size); }
+} // namespace
+
+OcclusionCuller::OcclusionCuller(Extent2D extent) : m_extent(extent) {
+	m_extent.x = std::max((m_extent.x + lanes_v - 1) / lanes_v * lanes_v, lanes_v);
+	m_extent.y = std::max(m_extent.y, 1u);
+	for (auto level_extent = m_extent;; level_extent = glm::max((level_extent + 1u) / 2u, glm::uvec2{1u})) {
+		m_levels.push_back(Level{.texels = std::vector<float>(level_extent.x * level_extent.y), .extent = level_extent});
+		if (level_extent.x == 1u && level_extent.y == 1u) { break; }
+	}
+}
+
+void OcclusionCuller::begin(glm::mat4 const& view_projection) {
+	m_view_projection = view_projection;
+	m_triangles = {};
+	for (auto& level : m_levels) { std::fill(level.texels.begin(), level.texels.end(), 0.0f); }
+}
+
+void OcclusionCuller::add_occluder(Occluder const& occluder, glm::mat4 const& model) {
+	auto const mvp = m_view_projection * model;
+	// x, y in pixels, z reversed depth; nullopt if in front of the near plane
+	auto const project = [&](glm::vec3 const& position) -> std::optional<glm::vec3> {
+		auto const clip = mvp * glm::vec4{position, 1.0f};
+		if (clip.w <= 0.0f || clip.z < 0.0f) { return {}; }
+		auto const ndc = glm::vec3{clip} / clip.w;
+		return glm::vec3{to_pixel(ndc.x, m_extent.x), to_pixel(ndc.y, m_extent.y), 1.0f - ndc.z};
+	};
+	for (std::size_t i = 0; i + 2 < occluder.indices.size(); i += 3) {
+		auto const a = project(occluder.positions[occluder.indices[i]]);
+		auto const b = project(occluder.positions[occluder.indices[i + 1]]);
+		auto const c = project(occluder.positions[occluder.indices[i + 2]]);
+		// clipping would only add occlusion: skipping keeps results conservative
+		if (!a || !b || !c) { continue; }
+		rasterize(*a, *b, *c);
+	}
+}
+
+void OcclusionCuller::build_pyramid() {
+	for (std::size_t i = 1; i < m_levels.size(); ++i) {
+		auto const& src = m_levels[i - 1];
+		auto& dst = m_levels[i];
+		for (std::uint32_t y = 0; y < dst.extent.y; ++y) {
+			auto const y0 = std::min(y * 2u, src.extent.y - 1u);
+			auto const y1 = std::min(y * 2u + 1u, src.extent.y - 1u);
+			for (std::uint32_t x = 0; x < dst.extent.x; ++x) {
+				auto const x0 = std::min(x * 2u, src.extent.x - 1u);
+				auto const x1 = std::min(x * 2u + 1u, src.extent.x - 1u);
+				// farthest of the four: anything nearer than that is in front of every occluder in the footprint
+				dst.texels[y * dst.extent.x + x] = std::min({src.at(x0, y0), src.at(x1, y0), src.at(x0, y1), src.at(x1, y1)});
+			}
+		}
+	}
+}
+
+bool OcclusionCuller::is_occluded(glm::vec3 const& centre, float const radius) const {
+	auto lo = glm::vec2{std::numeric_limits<float>::max()};
+	auto hi = glm::vec2{std::numeric_limits<float>::lowest()};
+	auto nearest = 0.0f;
+	for (int i = 0; i < 8; ++i) {
+		auto const corner = centre + radius * glm::vec3{i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f};
+		auto const clip = m_view_projection * glm::vec4{corner, 1.0f};
+		if (clip.w <= 0.0f || clip.z < 0.0f) { return false; }
+		auto const ndc = glm::vec3{clip} / clip.w;
+		lo = glm::min(lo, glm::vec2{ndc});
+		hi = glm::max(hi, glm::vec2{ndc});
+		nearest = std::max(nearest, 1.0f - ndc.z);
+	}
+	if (hi.x < -1.0f || hi.y < -1.0f || lo.x > 1.0f || lo.y > 1.0f) { return false; }
+
+	auto const to_texel = [](float const ndc, std::uint32_t const size) {
+		return static_cast<std::uint32_t>(std::clamp(to_pixel(ndc, size), 0.0f, static_cast<float>(size - 1u)));
+	};
+	auto min_texel = glm::uvec2{to_texel(lo.x, m_extent.x), to_texel(lo.y, m_extent.y)};
+	auto max_texel = glm::uvec2{to_texel(hi.x, m_extent.x), to_texel(hi.y, m_extent.y)};
+
+	// descend until the footprint spans at most 2x2 texels
+	auto level = std::size_t{};
+	while (level + 1 < m_levels.size() && (max_texel.x - min_texel.x > 1u || max_texel.y - min_texel.y > 1u)) {
+		min_texel /= 2u;
+		max_texel /= 2u;
+		++level;
+	}
+	auto const& texels = m_levels[level];
+	for (auto y = min_texel.y; y <= max_texel.y; ++y) {
+		for (auto x = min_texel.x; x <= max_texel.x; ++x) {
+			if (nearest >= texels.at(x, y)) { return false; }
+		}
+	}
+	return true;
+}
+
+void OcclusionCuller::rasterize(glm::vec3 a, glm::vec3 b, glm::vec3 c) {
+	auto area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+	if (std::abs(area) <= std::numeric_limits<float>::epsilon()) { return; }
+	// occluders are rasterized double sided: reorder clockwise triangles
+	if (area < 0.0f) {
+		std::swap(b, c);
+		area = -area;
+	}
+
+	auto const x_min = std::max(std::floor(std::min({a.x, b.x, c.x})), 0.0f);
+	auto const x_max = std::min(std::ceil(std::max({a.x, b.x, c.x})), static_cast<float>(m_extent.x - 1u));
+	auto const y_min = std::max(std::floor(std::min({a.y, b.y, c.y})), 0.0f);
+	auto const y_max = std::min(std::ceil(std::max({a.y, b.y, c.y})), static_cast<float>(m_extent.y - 1u));
+	if (x_min > x_max || y_min > y_max) { return; }
+	++m_triangles;
+
+	auto const edges = std::array{Edge::make(glm::vec2{a}, glm::vec2{b}), Edge::make(glm::vec2{b}, glm::vec2{c}), Edge::make(glm::vec2{c}, glm::vec2{a})};
+	auto const dzdx = ((b.z - a.z) * (c.y - a.y) - (c.z - a.z) * (b.y - a.y)) / area;
+	auto const dzdy = ((c.z - a.z) * (b.x - a.x) - (b.z - a.z) * (c.x - a.x)) / area;
+	auto const dz = a.z - dzdx * a.x - dzdy * a.y;
+
+	auto& depth = m_levels.front();
+	auto const begin = static_cast<std::uint32_t>(x_min) / lanes_v * lanes_v;
+	auto const end = static_cast<std::uint32_t>(x_max);
+	for (auto y = static_cast<std::uint32_t>(y_min); y <= static_cast<std::uint32_t>(y_max); ++y) {
+		auto const py = static_cast<float>(y) + 0.5f;
+		auto* row = depth.texels.data() + y * m_extent.x;
+		// per row constant terms of each edge function and the depth plane
+		auto const e0 = edges[0].b * py + edges[0].c;
+		auto const e1 = edges[1].b * py + edges[1].c;
+		auto const e2 = edges[2].b * py + edges[2].c;
+		auto const z = dzdy * py + dz;
+#if defined(LEVK_OCCLUSION_SSE2)
+		auto const zero = _mm_setzero_ps();
+		auto const offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+		for (auto x = begin; x <= end; x += lanes_v) {
+			auto const px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+			auto inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(edges[0].a), px), _mm_set1_ps(e0)), zero);
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(edges[1].a), px), _mm_set1_ps(e1)), zero));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(edges[2].a), px), _mm_set1_ps(e2)), zero));
+			if (_mm_movemask_ps(inside) == 0) { continue; }
+			auto const src = _mm_loadu_ps(row + x);
+			auto const nearer = _mm_max_ps(src, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(dzdx), px), _mm_set1_ps(z)));
+			_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, src)));
+		}
+#else
+		for (auto x = begin; x <= end; ++x) {
+			auto const px = static_cast<float>(x) + 0.5f;
+			if (edges[0].a * px + e0 < 0.0f || edges[1].a * px + e1 < 0.0f || edges[2].a * px + e2 < 0.0f) { continue; }
+			row[x] = std::max(row[x], dzdx * px + z);
+		}
+#endif
+	}
+}
+} // namespace levk
@@ -1,4 +1,5 @@
 #include <levk/graphics/pixel_map.hpp>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <utility>
@@ -15,6 +16,23 @@ Rgba const& PixelMap::operator[](Index2D index) const {
 PixelMap::View PixelMap::view() const {
 	return View{.storage = {reinterpret_cast<std::byte const*>(m_pixels.data()), m_pixels.size_bytes()}, .extent = m_extent};
 }
+
+DynPixelMap to_rgba(PixelMap::View const view) {
+	auto ret = DynPixelMap{view.extent};
+	auto const pixels = ret.span();
+	if (view.channels == 4) {
+		std::memcpy(pixels.data(), view.storage.data(), std::min(pixels.size_bytes(), view.storage.size()));
+		return ret;
+	}
+	if (view.channels == 0 || pixels.size() * view.channels > view.storage.size()) { return ret; }
+	for (std::size_t i = 0; i < pixels.size(); ++i) {
+		auto const* in = &view.storage[i * view.channels];
+		auto const grey = std::to_integer<std::uint8_t>(in[0]);
+		auto const alpha = view.channels > 1 ? std::to_integer<std::uint8_t>(in[1]) : std::uint8_t{0xff};
+		pixels[i].channels = {grey, grey, grey, alpha};
+	}
+	return ret;
+}
 } // namespace levk
 
 levk::ByteArray levk::to_byte_array(PixelMap const& pixel_map) {
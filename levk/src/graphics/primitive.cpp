@@ -5,8 +5,8 @@
 namespace levk {
 void StaticPrimitive::Deleter::operator()(vulkan::UploadedPrimitive const* ptr) const { delete ptr; }
 
-StaticPrimitive::StaticPrimitive(vulkan::Device& device, Geometry::Packed const& geometry)
-	: m_primitive(new vulkan::UploadedPrimitive{vulkan::UploadedPrimitive::make_static(device.view(), geometry)}) {}
+StaticPrimitive::StaticPrimitive(RenderDevice const& device, Geometry::Packed const& geometry, VertexFormat format)
+	: m_primitive(new vulkan::UploadedPrimitive{vulkan::UploadedPrimitive::make_static(vulkan::view_of(device), geometry, format)}) {}
 
 std::uint32_t StaticPrimitive::vertex_count() const { return m_primitive->layout().vertices; }
 std::uint32_t StaticPrimitive::index_count() const { return m_primitive->layout().indices; }
@@ -15,8 +15,8 @@ Ptr<vulkan::Primitive> StaticPrimitive::vulkan_primitive() const { return m_prim
 
 void SkinnedPrimitive::Deleter::operator()(vulkan::UploadedPrimitive const* ptr) const { delete ptr; }
 
-SkinnedPrimitive::SkinnedPrimitive(vulkan::Device& device, Geometry::Packed const& geometry, MeshJoints const& joints)
-	: m_primitive(new vulkan::UploadedPrimitive{vulkan::UploadedPrimitive::make_skinned(device.view(), geometry, joints)}) {}
+SkinnedPrimitive::SkinnedPrimitive(RenderDevice const& device, Geometry::Packed const& geometry, MeshJoints const& joints, VertexFormat format)
+	: m_primitive(new vulkan::UploadedPrimitive{vulkan::UploadedPrimitive::make_skinned(vulkan::view_of(device), geometry, joints, format)}) {}
 
 std::uint32_t SkinnedPrimitive::vertex_count() const { return m_primitive->layout().vertices; }
 std::uint32_t SkinnedPrimitive::index_count() const { return m_primitive->layout().indices; }
@@ -25,14 +25,27 @@ Ptr<vulkan::Primitive> SkinnedPrimitive::vulkan_primitive() const { return m_pri
 
 void DynamicPrimitive::Deleter::operator()(vulkan::HostPrimitive const* ptr) const { delete ptr; }
 
-DynamicPrimitive::DynamicPrimitive(vulkan::Device& device) : m_primitive(new vulkan::HostPrimitive{device.view()}) {}
+DynamicPrimitive::DynamicPrimitive(RenderDevice const& device) : m_primitive(new vulkan::HostPrimitive{vulkan::view_of(device)}) {}
 
-std::uint32_t DynamicPrimitive::vertex_count() const { return m_primitive->layout().vertices; }
-std::uint32_t DynamicPrimitive::index_count() const { return m_primitive->layout().indices; }
+// the layout is only refreshed when drawn
+std::uint32_t DynamicPrimitive::vertex_count() const { return static_cast<std::uint32_t>(m_primitive->geometry.positions.size()); }
+std::uint32_t DynamicPrimitive::index_count() const { return static_cast<std::uint32_t>(m_primitive->geometry.indices.size()); }
 
 void DynamicPrimitive::set_geometry(Geometry::Packed geometry) {
 	assert(m_primitive);
 	m_primitive->geometry = std::move(geometry);
+	++m_primitive->version;
+}
+
+Geometry::Packed const& DynamicPrimitive::geometry() const {
+	assert(m_primitive);
+	return m_primitive->geometry;
+}
+
+Geometry::Packed& DynamicPrimitive::edit_geometry() {
+	assert(m_primitive);
+	++m_primitive->version;
+	return m_primitive->geometry;
 }
 
 Ptr<vulkan::Primitive> DynamicPrimitive::vulkan_primitive() const { return m_primitive.get(); }
@@ -1,5 +1,6 @@
 #include <graphics/vulkan/device.hpp>
 #include <levk/graphics/render_device.hpp>
+#include <algorithm>
 #include <cassert>
 
 namespace levk {
@@ -12,44 +13,133 @@ glm::tvec2<Type> clamp_vec(glm::tvec2<Type> in, glm::tvec2<Type> const (&limits)
 }
 } // namespace
 
+ShadowCascades ShadowCascades::clamped() const {
+	auto ret = *this;
+	ret.count = std::clamp(ret.count, 1u, static_cast<std::uint32_t>(max_shadow_cascades_v));
+	ret.distance = std::max(ret.distance, 1.0f);
+	ret.split_lambda = std::clamp(ret.split_lambda, 0.0f, 1.0f);
+	for (auto& scale : ret.resolution_scale) { scale = std::clamp(scale, 1.0f / 16.0f, 1.0f); }
+	return ret;
+}
+
+DynamicResolution DynamicResolution::clamped() const {
+	auto ret = *this;
+	ret.budget_ms = std::max(ret.budget_ms, 0.0f);
+	ret.headroom = std::clamp(ret.headroom, 0.0f, 0.9f);
+	ret.step = std::clamp(ret.step, 0.01f, 1.0f);
+	ret.min_scale = std::clamp(ret.min_scale, render_scale_limit_v[0], render_scale_limit_v[1]);
+	ret.max_scale = std::clamp(ret.max_scale, ret.min_scale, render_scale_limit_v[1]);
+	ret.frames = std::max(ret.frames, 1u);
+	return ret;
+}
+
 void RenderDevice::Deleter::operator()(vulkan::Device const* ptr) const { delete ptr; }
 
 RenderDevice::RenderDevice(Window const& window, CreateInfo const& create_info)
 	: m_impl(std::unique_ptr<vulkan::Device, Deleter>(new vulkan::Device{window, create_info})) {}
 
-auto RenderDevice::info() const -> Info const& {
-	assert(m_impl);
-	return m_impl->device_info;
+RenderDevice::RenderDevice(Extent2D extent, CreateInfo const& create_info)
+	: m_impl(std::unique_ptr<vulkan::Device, Deleter>(new vulkan::Device{extent, create_info})) {}
+
+RenderDevice RenderDevice::make_null(CreateInfo const& create_info) {
+	auto ret = RenderDevice{};
+	auto& info = ret.m_null_info;
+	info.name = "null";
+	info.swapchain = create_info.swapchain;
+	info.current_vsync = create_info.vsync;
+	info.current_aa = create_info.anti_aliasing;
+	info.lod_bias = std::max(create_info.lod_bias, 0.0f);
+	info.occlusion_culling = create_info.occlusion_culling;
+	info.static_shadow_cache = create_info.static_shadow_cache;
+	info.shadow_cascades = create_info.shadow_cascades.clamped();
+	info.compute_skinning = create_info.compute_skinning;
+	info.dynamic_resolution = create_info.dynamic_resolution.clamped();
+	info.frames_in_flight = std::clamp(create_info.frames_in_flight, 1u, static_cast<std::uint32_t>(vulkan::max_frames_in_flight_v));
+	return ret;
 }
 
+auto RenderDevice::info() const -> Info const& { return m_impl ? m_impl->device_info : m_null_info; }
+
 float RenderDevice::set_render_scale(float desired) {
-	assert(m_impl);
-	m_impl->device_info.render_scale = std::clamp(desired, render_scale_limit_v[0], render_scale_limit_v[1]);
-	return m_impl->device_info.render_scale;
+	device_info().render_scale = std::clamp(desired, render_scale_limit_v[0], render_scale_limit_v[1]);
+	return device_info().render_scale;
 }
 
 std::uint64_t RenderDevice::draw_calls_last_frame() const {
-	assert(m_impl);
-	return m_impl->draw_calls();
+	return m_impl ? m_impl->draw_calls() : 0u;
+}
+
+GeometryArenaStats RenderDevice::geometry_arena_stats() const {
+	return m_impl ? m_impl->geometry_arena_stats() : GeometryArenaStats{};
+}
+
+OcclusionStats RenderDevice::occlusion_stats_last_frame() const {
+	return m_impl ? m_impl->occlusion_stats() : OcclusionStats{};
+}
+
+Duration RenderDevice::gpu_frame_time() const {
+	return m_impl ? m_impl->gpu_frame_time() : Duration{};
+}
+
+Duration RenderDevice::frame_latency() const {
+	return m_impl ? m_impl->frame_latency() : Duration{};
 }
 
 bool RenderDevice::set_vsync(Vsync desired) {
-	assert(m_impl);
-	return m_impl->set_vsync(desired);
+	return m_impl && m_impl->set_vsync(desired);
 }
 
 void RenderDevice::set_clear(Rgba clear) {
-	assert(m_impl);
-	m_impl->device_info.clear_colour = clear;
+	device_info().clear_colour = clear;
 }
 
 void RenderDevice::set_shadow_resolution(Extent2D extent) {
-	assert(m_impl);
-	m_impl->device_info.shadow_map_resolution = clamp_vec(extent, shadow_resolution_limit_v);
+	device_info().shadow_map_resolution = clamp_vec(extent, shadow_resolution_limit_v);
+}
+
+void RenderDevice::set_lod_bias(float bias) {
+	device_info().lod_bias = std::max(bias, 0.0f);
+}
+
+void RenderDevice::set_occlusion_culling(bool enabled) {
+	device_info().occlusion_culling = enabled;
+}
+
+void RenderDevice::set_static_shadow_cache(bool enabled) {
+	device_info().static_shadow_cache = enabled;
+}
+
+void RenderDevice::set_shadow_cascades(ShadowCascades const& cascades) {
+	device_info().shadow_cascades = cascades.clamped();
+}
+
+void RenderDevice::set_compute_skinning(bool enabled) {
+	device_info().compute_skinning = enabled;
+}
+
+void RenderDevice::set_dynamic_resolution(DynamicResolution const& dynamic_resolution) {
+	device_info().dynamic_resolution = dynamic_resolution.clamped();
+}
+
+std::uint32_t RenderDevice::set_frames_in_flight(std::uint32_t count) {
+	if (!m_impl) { return m_null_info.frames_in_flight = std::clamp(count, 1u, static_cast<std::uint32_t>(vulkan::max_frames_in_flight_v)); }
+	return m_impl->set_frames_in_flight(count);
+}
+
+std::optional<OffscreenFrame> RenderDevice::read_offscreen() {
+	if (!m_impl) { return {}; }
+	return m_impl->read_offscreen();
 }
 
 vulkan::Device& RenderDevice::vulkan_device() const {
 	assert(m_impl);
 	return *m_impl;
 }
+
+auto RenderDevice::device_info() -> Info& { return m_impl ? m_impl->device_info : m_null_info; }
 } // namespace levk
+
+auto levk::vulkan::view_of(RenderDevice const& render_device) -> DeviceView {
+	if (render_device.is_null()) { return {}; }
+	return render_device.vulkan_device().view();
+}
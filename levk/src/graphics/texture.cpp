@@ -1,8 +1,10 @@
-#include <graphics/vulkan/ad_hoc_cmd.hpp>
 #include <graphics/vulkan/device.hpp>
 #include <graphics/vulkan/texture.hpp>
+#include <graphics/vulkan/upload_service.hpp>
+#include <levk/graphics/mipmapped_image.hpp>
 #include <levk/graphics/texture.hpp>
 #include <levk/util/logger.hpp>
+#include <algorithm>
 #include <cmath>
 
 namespace levk {
@@ -20,42 +22,209 @@ std::array<Image::View, 6> const& white_cubemap() {
 
 auto const g_log{Logger{"Texture"}};
 
+// grey (+ alpha) expands into RGBA, otherwise leading channels are kept (and missing ones are opaque)
+ByteArray repack(Image::View const image, std::uint8_t const channels) {
+	if (channels == 4 && image.channels < 4) { return to_byte_array(to_rgba(image)); }
+	auto const count = std::size_t{image.extent.x} * image.extent.y;
+	auto ret = ByteArray{count * channels};
+	if (image.storage.size() < count * image.channels) { return ret; }
+	for (std::size_t i = 0; i < count; ++i) {
+		for (std::uint8_t c = 0; c < channels; ++c) {
+			ret[i * channels + c] = c < image.channels ? image.storage[i * image.channels + c] : std::byte{0xff};
+		}
+	}
+	return ret;
+}
+
 bool init_texture(vulkan::Texture& out_texture, TextureCreateInfo const& create_info, std::span<Image::View const> images, bool mip_mapped) {
-	out_texture.create_info.format = create_info.colour_space == ColourSpace::eLinear ? vk::Format::eR8G8B8A8Unorm : vk::Format::eR8G8B8A8Srgb;
 	assert(!images.empty());
 	bool first{true};
 	auto extent = Extent2D{};
+	auto channels = std::uint8_t{};
 	for (auto const& image : images) {
-		if (image.extent.x == 0 || image.extent.y == 0 || image.storage.empty()) { return false; }
+		if (image.extent.x == 0 || image.extent.y == 0 || image.storage.empty() || image.channels == 0) { return false; }
 		if (first) {
 			extent = image.extent;
 		} else if (image.extent != extent) {
 			return false;
 		}
+		channels = std::max(channels, image.channels);
+	}
+	auto layout = vulkan::make_layout(create_info.usage, channels, create_info.colour_space);
+	// null backend: metadata only
+	bool const null = !out_texture.device.device;
+	bool const rgba_fallback = [&] {
+		if (null || layout.channels == 4) { return false; }
+		if (!out_texture.device.can_sample(layout.format)) { return true; }
+		return mip_mapped && !out_texture.device.can_mip(layout.format);
+	}();
+	auto const packed_layout = layout;
+	if (rgba_fallback) {
+		// masks stay linear in RGBA too
+		auto const colour_space = create_info.usage == TextureUsage::eMask ? ColourSpace::eLinear : create_info.colour_space;
+		layout = vulkan::make_layout(create_info.usage == TextureUsage::eData ? TextureUsage::eData : TextureUsage::eColour, 4, colour_space);
 	}
-	if (mip_mapped && out_texture.device.can_mip(out_texture.create_info.format)) {
+	out_texture.fallback_channels = rgba_fallback ? packed_layout.channels : std::uint8_t{};
+	out_texture.fallback_components = rgba_fallback ? packed_layout.components : vk::ComponentMapping{};
+	out_texture.create_info.format = layout.format;
+	out_texture.create_info.components = layout.components;
+	if (mip_mapped && (null || out_texture.device.can_mip(out_texture.create_info.format))) {
 		out_texture.create_info.mip_levels = out_texture.device.compute_mip_levels({extent.x, extent.y});
 	}
 	out_texture.create_info.array_layers = static_cast<std::uint32_t>(images.size());
+	if (null) {
+		out_texture.null_extent = vk::Extent2D{extent.x, extent.y};
+		return true;
+	}
+
+	auto repacked = std::vector<ByteArray>{};
+	auto layers = std::vector<Image::View>{};
+	layers.reserve(images.size());
+	for (auto const& image : images) {
+		if (image.channels == layout.channels && !rgba_fallback) {
+			layers.push_back(image);
+			continue;
+		}
+		auto bytes = repack(image, packed_layout.channels);
+		if (rgba_fallback) { bytes = vulkan::swizzle_to_rgba(bytes.span(), packed_layout); }
+		layers.push_back(Image::View{.storage = bytes.span(), .extent = image.extent, .channels = layout.channels});
+		repacked.push_back(std::move(bytes));
+	}
 	auto const image_view_type = out_texture.create_info.array_layers == 6u ? vk::ImageViewType::eCube : vk::ImageViewType::e2D;
 	auto vk_image = out_texture.device.vma.make_image(out_texture.create_info, {extent.x, extent.y}, image_view_type);
 
-	auto cmd = vulkan::AdHocCmd{out_texture.device};
-	cmd.scratch_buffers.push_back(out_texture.device.vma.copy_to_image(cmd.cb, vk_image.get(), images));
+	out_texture.device.upload_service->upload(vk_image.get(), layers);
+	out_texture.image = {*out_texture.device.defer, std::move(vk_image)};
+	return true;
+}
+
+constexpr vk::Format to_vk_format(ImageFormat const format, ColourSpace const colour_space) {
+	bool const srgb = colour_space == ColourSpace::eSrgb;
+	switch (format) {
+	case ImageFormat::eRgba8: return srgb ? vk::Format::eR8G8B8A8Srgb : vk::Format::eR8G8B8A8Unorm;
+	case ImageFormat::eBc1: return srgb ? vk::Format::eBc1RgbaSrgbBlock : vk::Format::eBc1RgbaUnormBlock;
+	case ImageFormat::eBc3: return srgb ? vk::Format::eBc3SrgbBlock : vk::Format::eBc3UnormBlock;
+	case ImageFormat::eBc5: return vk::Format::eBc5UnormBlock;
+	case ImageFormat::eBc7: return srgb ? vk::Format::eBc7SrgbBlock : vk::Format::eBc7UnormBlock;
+	default: return vk::Format::eUndefined;
+	}
+}
+
+constexpr bool is_srgb_texture(vk::Format const format) {
+	switch (format) {
+	case vk::Format::eR8Srgb:
+	case vk::Format::eR8G8Srgb:
+	case vk::Format::eR8G8B8A8Srgb:
+	case vk::Format::eBc1RgbaSrgbBlock:
+	case vk::Format::eBc3SrgbBlock:
+	case vk::Format::eBc7SrgbBlock: return true;
+	default: return false;
+	}
+}
+
+// every layer must have the same format and extent
+bool init_texture(vulkan::Texture& out_texture, TextureCreateInfo const& create_info, std::span<MipmappedImage const> layers) {
+	assert(!layers.empty());
+	auto const& first = layers.front();
+	for (auto const& layer : layers) {
+		if (!layer || layer.format() != first.format() || layer.extent() != first.extent() || layer.mips().size() != first.mips().size()) { return false; }
+	}
+	auto const colour_space = first.colour_space().value_or(create_info.colour_space);
+	auto const mip_levels = first.mips().size();
+	auto const extent = first.extent();
+	out_texture.create_info.format = to_vk_format(first.format(), colour_space);
+	out_texture.create_info.components = {};
+	out_texture.create_info.mip_levels = static_cast<std::uint32_t>(mip_levels);
+	out_texture.create_info.array_layers = static_cast<std::uint32_t>(layers.size());
+	// null backend: metadata only
+	if (!out_texture.device.device) {
+		out_texture.null_extent = vk::Extent2D{extent.x, extent.y};
+		return true;
+	}
+
+	auto bytes = std::vector<std::span<std::byte const>>{};
+	auto decoded = std::vector<DynPixelMap>{};
+	bool const supported = out_texture.device.gpu->features.texture_compression_bc && out_texture.device.can_sample(out_texture.create_info.format);
+	if (first.is_block_compressed() && !supported) {
+		out_texture.create_info.format = to_vk_format(ImageFormat::eRgba8, colour_space);
+		decoded.reserve(layers.size() * mip_levels);
+		for (auto const& layer : layers) {
+			for (std::size_t mip = 0; mip < mip_levels; ++mip) { decoded.push_back(layer.decode(mip)); }
+		}
+		for (auto const& pixels : decoded) { bytes.push_back(pixels.view().storage); }
+	} else {
+		bytes.reserve(layers.size() * mip_levels);
+		for (auto const& layer : layers) {
+			for (auto const& mip : layer.mips()) { bytes.push_back(mip.bytes); }
+		}
+	}
+	auto const image_view_type = layers.size() == 6u ? vk::ImageViewType::eCube : vk::ImageViewType::e2D;
+	auto vk_image = out_texture.device.vma.make_image(out_texture.create_info, {extent.x, extent.y}, image_view_type);
+	out_texture.device.upload_service->upload_mips(vk_image.get(), bytes);
 	out_texture.image = {*out_texture.device.defer, std::move(vk_image)};
 	return true;
 }
 } // namespace
 
+vulkan::TextureLayout vulkan::make_layout(TextureUsage const usage, std::uint8_t const channels, ColourSpace const colour_space) {
+	using Swizzle = vk::ComponentSwizzle;
+	// data is never sRGB decoded
+	bool const srgb = usage != TextureUsage::eData && colour_space == ColourSpace::eSrgb;
+	auto const rgba = TextureLayout{srgb ? vk::Format::eR8G8B8A8Srgb : vk::Format::eR8G8B8A8Unorm};
+	switch (usage) {
+	// masks are coverage / data: never sRGB decoded
+	case TextureUsage::eMask: return {vk::Format::eR8Unorm, {Swizzle::eR, Swizzle::eR, Swizzle::eR, Swizzle::eR}, 1};
+	case TextureUsage::eNormal: return {vk::Format::eR8G8Unorm, {}, 2};
+	default: break;
+	}
+	switch (channels) {
+	case 1: return {srgb ? vk::Format::eR8Srgb : vk::Format::eR8Unorm, {Swizzle::eR, Swizzle::eR, Swizzle::eR, Swizzle::eOne}, 1};
+	// sRGB two channel formats also decode the second (alpha) channel
+	case 2: return srgb ? rgba : TextureLayout{vk::Format::eR8G8Unorm, {Swizzle::eR, Swizzle::eR, Swizzle::eR, Swizzle::eG}, 2};
+	default: return rgba;
+	}
+}
+
+ByteArray vulkan::swizzle_to_rgba(std::span<std::byte const> packed, TextureLayout const& layout) {
+	using Swizzle = vk::ComponentSwizzle;
+	auto const count = packed.size() / layout.channels;
+	auto const mapping = std::array{layout.components.r, layout.components.g, layout.components.b, layout.components.a};
+	auto ret = ByteArray{count * 4};
+	for (std::size_t i = 0; i < count; ++i) {
+		for (std::size_t c = 0; c < 4; ++c) {
+			auto const swizzle = mapping[c] == Swizzle::eIdentity ? static_cast<Swizzle>(static_cast<int>(Swizzle::eR) + static_cast<int>(c)) : mapping[c];
+			auto value = std::byte{};
+			if (swizzle == Swizzle::eOne) {
+				value = std::byte{0xff};
+			} else if (swizzle != Swizzle::eZero) {
+				auto const index = static_cast<std::size_t>(static_cast<int>(swizzle) - static_cast<int>(Swizzle::eR));
+				// components missing from the format read as 0, alpha as 1
+				if (index < layout.channels) {
+					value = packed[i * layout.channels + index];
+				} else if (index == 3) {
+					value = std::byte{0xff};
+				}
+			}
+			ret[i * 4 + c] = value;
+		}
+	}
+	return ret;
+}
+
+ByteArray vulkan::to_fallback_rgba(Texture const& texture, Image::View const image) {
+	if (texture.fallback_channels == 0 || image.channels != texture.fallback_channels) { return {}; }
+	return swizzle_to_rgba(image.storage, TextureLayout{.components = texture.fallback_components, .channels = texture.fallback_channels});
+}
+
 void Texture::Deleter::operator()(vulkan::Texture const* ptr) const { delete ptr; }
 
 Texture::Texture() : m_impl(new vulkan::Texture{}) {}
 
-Texture::Texture(vulkan::Device& device) : Texture(device, white_image_v.view(), CreateInfo{}) {}
+Texture::Texture(RenderDevice const& device) : Texture(device, white_image_v.view(), CreateInfo{}) {}
 
-Texture::Texture(vulkan::Device& device, Image::View image, CreateInfo const& create_info) : Texture() {
+Texture::Texture(RenderDevice const& device, Image::View image, CreateInfo const& create_info) : Texture() {
 	assert(m_impl);
-	m_impl->device = device.view();
+	m_impl->device = vulkan::view_of(device);
 	static constexpr auto magenta_pixmap_v = FixedPixelMap<1, 1>{{magenta_v}};
 	bool mip_mapped = create_info.mip_mapped;
 	if (image.extent.x == 0 || image.extent.y == 0) {
@@ -75,12 +244,22 @@ Texture::Texture(vulkan::Device& device, Image::View image, CreateInfo const& cr
 	}
 }
 
+Texture::Texture(RenderDevice const& device, MipmappedImage const& image, CreateInfo const& create_info) : Texture() {
+	assert(m_impl);
+	m_impl->device = vulkan::view_of(device);
+	if (!init_texture(*m_impl, create_info, {&image, 1u})) {
+		g_log.error("Texture creation failed!");
+		auto const fallback = white_image_v.view();
+		init_texture(*m_impl, create_info, {&fallback, 1u}, false);
+	}
+}
+
 std::uint32_t Texture::mip_levels() const { return m_impl->create_info.mip_levels; }
-ColourSpace Texture::colour_space() const { return vulkan::is_srgb(m_impl->create_info.format) ? ColourSpace::eSrgb : ColourSpace::eLinear; }
+ColourSpace Texture::colour_space() const { return is_srgb_texture(m_impl->create_info.format) ? ColourSpace::eSrgb : ColourSpace::eLinear; }
 
 Extent2D Texture::extent() const {
-	auto const view = m_impl->image.get().get().image_view();
-	return {view.extent.width, view.extent.height};
+	auto const extent = m_impl->extent();
+	return {extent.width, extent.height};
 }
 
 TextureSampler const& Texture::sampler() const {
@@ -93,14 +272,23 @@ void Texture::set_sampler(Sampler value) {
 	m_impl->sampler = value;
 }
 
-Cubemap::Cubemap(vulkan::Device& device) : Cubemap(device, white_cubemap(), {}) {}
+Cubemap::Cubemap(RenderDevice const& device) : Cubemap(device, white_cubemap(), {}) {}
 
-Cubemap::Cubemap(vulkan::Device& device, std::array<Image::View, 6> const& images, CreateInfo const& create_info) {
+Cubemap::Cubemap(RenderDevice const& device, std::array<Image::View, 6> const& images, CreateInfo const& create_info) {
 	assert(m_impl);
-	m_impl->device = device.view();
+	m_impl->device = vulkan::view_of(device);
 	if (!init_texture(*m_impl, create_info, images, create_info.mip_mapped)) {
 		g_log.error("Cubemap creation failed!");
 		init_texture(*m_impl, create_info, white_cubemap(), false);
 	}
 }
+
+Cubemap::Cubemap(RenderDevice const& device, std::span<MipmappedImage const, 6> images, CreateInfo const& create_info) {
+	assert(m_impl);
+	m_impl->device = vulkan::view_of(device);
+	if (!init_texture(*m_impl, create_info, images)) {
+		g_log.error("Cubemap creation failed!");
+		init_texture(*m_impl, create_info, white_cubemap(), false);
+	}
+}
 } // namespace levk
@@ -1,9 +1,9 @@
-#include <graphics/vulkan/ad_hoc_cmd.hpp>
 #include <graphics/vulkan/texture.hpp>
+#include <graphics/vulkan/upload_service.hpp>
 #include <levk/asset/texture_provider.hpp>
 #include <levk/graphics/render_device.hpp>
 #include <levk/graphics/texture_atlas.hpp>
-#include <optional>
+#include <algorithm>
 
 namespace levk {
 namespace {
@@ -15,62 +15,182 @@ constexpr std::uint32_t next_pot(std::uint32_t const in) {
 	return ret;
 }
 
-constexpr Extent2D make_new_extent(Extent2D existing, std::optional<std::uint32_t> x, std::optional<std::uint32_t> y) {
-	if (x) { existing.x = *x; }
-	if (y) { existing.y = *y; }
-	return existing;
+// one step of growth for size to (potentially) fit: jumps to fit either dimension, doubles the smaller one otherwise
+constexpr Extent2D grow_extent(Extent2D const current, Extent2D const size) {
+	auto ret = glm::max(current, Extent2D{1u, 1u});
+	if (size.x > ret.x) { ret.x = next_pot(size.x); }
+	if (size.y > ret.y) { ret.y = next_pot(size.y); }
+	if (ret != current) { return ret; }
+	if (ret.x <= ret.y) {
+		ret.x *= 2u;
+	} else {
+		ret.y *= 2u;
+	}
+	return ret;
+}
+
+// tallest first packs tighter on a skyline
+std::vector<Extent2D> sorted_padded(std::span<Extent2D const> extents, glm::uvec2 const padding) {
+	auto ret = std::vector<Extent2D>{};
+	ret.reserve(extents.size());
+	for (auto const& extent : extents) { ret.push_back(extent + padding); }
+	std::sort(ret.begin(), ret.end(), [](Extent2D const& a, Extent2D const& b) { return a.y == b.y ? a.x > b.x : a.y > b.y; });
+	return ret;
 }
 
-Texture make_texture(RenderDevice& device, Extent2D extent) {
-	auto image = DynPixelMap{extent};
-	for (auto& rgba : image.span()) { rgba = blank_v; }
+constexpr Extent2D size_of(TextureAtlas::Cell const& rect) { return rect.rb - rect.lt; }
+
+Texture make_texture(RenderDevice& device, TextureAtlas::CreateInfo const& create_info) {
+	auto const& extent = create_info.initial_extent;
+	// zero initialized, as blank_v
+	auto const bytes = ByteArray{std::size_t{extent.x} * extent.y * create_info.channels};
 	auto sampler = TextureSampler{};
 	sampler.wrap_s = sampler.wrap_t = TextureSampler::Wrap::eClampEdge;
 	sampler.min = sampler.mag = TextureSampler::Filter::eLinear;
-	return {device.vulkan_device(), image.view(), Texture::CreateInfo{.mip_mapped = false, .sampler = sampler}};
+	auto const image = Image::View{.storage = bytes.span(), .extent = extent, .channels = create_info.channels};
+	// glyph coverage (and other masks / data) is linear
+	bool const linear = create_info.usage == TextureUsage::eMask || create_info.usage == TextureUsage::eData;
+	auto const colour_space = linear ? ColourSpace::eLinear : ColourSpace::eSrgb;
+	auto const texture_ci = Texture::CreateInfo{.mip_mapped = false, .colour_space = colour_space, .usage = create_info.usage, .sampler = sampler};
+	return {device, image, texture_ci};
 }
 
 bool resize_canvas(vulkan::Texture& out, Extent2D new_extent, Rgba background, glm::uvec2 top_left = {}) {
 	if (new_extent.x == 0 || new_extent.y == 0) { return false; }
-	auto const extent = out.image.get().get().extent;
+	auto const extent = out.extent();
 	if (new_extent == Extent2D{extent.width, extent.height}) { return true; }
 	if (top_left.x + extent.width > new_extent.x || top_left.y + extent.height > new_extent.y) { return false; }
+	// null backend
+	if (!out.device.device) {
+		out.null_extent = vk::Extent2D{new_extent.x, new_extent.y};
+		return true;
+	}
 
 	assert(out.image.get().get().type == vk::ImageViewType::e2D);
-	auto pixels = DynPixelMap{new_extent};
-	for (Rgba& rgba : pixels.span()) { rgba = background; }
-	auto const image_view = pixels.view();
-	auto new_image = out.device.vma.make_image(out.create_info, {image_view.extent.x, image_view.extent.y});
-
-	auto cmd = vulkan::AdHocCmd{out.device};
-	cmd.scratch_buffers.push_back(out.device.vma.copy_to_image(cmd.cb, new_image.get(), {&image_view, 1}));
-	auto src = vulkan::Vma::Copy{out.image.get().get(), vk::ImageLayout::eShaderReadOnlyOptimal};
-	auto dst = vulkan::Vma::Copy{new_image.get(), vk::ImageLayout::eShaderReadOnlyOptimal, top_left};
-	out.device.vma.copy_image(cmd.cb, src, dst, extent);
+	auto new_image = out.device.vma.make_image(out.create_info, {new_extent.x, new_extent.y});
+	out.device.upload_service->copy(out.image.get().get(), new_image.get(), top_left, background);
 	out.image = {*out.device.defer, std::move(new_image)};
 
 	return true;
 }
 
 bool write_images(vulkan::Texture& out, std::span<ImageWrite const> writes) {
-	auto const extent = out.image.get().get().extent;
+	auto const extent = out.extent();
 	for (auto const& write : writes) {
 		auto const bottom_right = write.offset + write.image.extent;
 		if (bottom_right.x > extent.width || bottom_right.y > extent.height) { return false; }
 	}
 
-	auto cmd = vulkan::AdHocCmd{out.device};
-	auto scratch = out.device.vma.write_images(cmd.cb, out.image.get(), writes);
-	if (!scratch.get().buffer) { return false; }
-
-	cmd.scratch_buffers.push_back(std::move(scratch));
+	if (out.create_info.array_layers > 1u || writes.empty()) { return false; }
+	if (!out.device.device) { return true; }
+	if (out.fallback_channels > 0) {
+		// the texture was created as RGBA8: expand writes likewise
+		auto bytes = std::vector<ByteArray>{};
+		auto expanded = std::vector<ImageWrite>{};
+		bytes.reserve(writes.size());
+		expanded.reserve(writes.size());
+		for (auto const& write : writes) {
+			auto const& rgba = bytes.emplace_back(vulkan::to_fallback_rgba(out, write.image));
+			if (rgba.empty()) { return false; }
+			expanded.push_back(ImageWrite{.image = Image::View{.storage = rgba.span(), .extent = write.image.extent}, .offset = write.offset});
+		}
+		out.device.upload_service->write(out.image.get().get(), expanded);
+		return true;
+	}
+	out.device.upload_service->write(out.image.get().get(), writes);
 	return true;
 }
 } // namespace
 
+Extent2D TextureAtlas::Skyline::fit(Skyline const& base, std::span<Extent2D const> sizes) {
+	auto ret = base.extent;
+	while (true) {
+		auto trial = base;
+		trial.resize(ret);
+		auto const failed = trial.pack(sizes);
+		if (!failed) { return ret; }
+		ret = grow_extent(ret, *failed);
+	}
+}
+
+auto TextureAtlas::Skyline::find(Extent2D const size) const -> std::optional<glm::uvec2> {
+	auto ret = std::optional<glm::uvec2>{};
+	// bottom-left: lowest position, leftmost among equals
+	for (auto it = segments.begin(); it != segments.end(); ++it) {
+		if (it->x + size.x > extent.x) { break; }
+		auto y = std::uint32_t{};
+		auto spanned = std::uint32_t{};
+		for (auto s = it; spanned < size.x; ++s) {
+			y = std::max(y, s->y);
+			spanned += s->width;
+		}
+		if (y + size.y > extent.y) { continue; }
+		if (!ret || y < ret->y) { ret = glm::uvec2{it->x, y}; }
+	}
+	return ret;
+}
+
+void TextureAtlas::Skyline::insert(glm::uvec2 const position, Extent2D const size) {
+	auto it = std::find_if(segments.begin(), segments.end(), [x = position.x](Segment const& s) { return s.x == position.x; });
+	assert(it != segments.end());
+	it = segments.insert(it, Segment{.x = position.x, .y = position.y + size.y, .width = size.x});
+	// trim / drop the segments now under the new one
+	auto const right = position.x + size.x;
+	auto next = it + 1;
+	while (next != segments.end() && next->x < right) {
+		if (next->x + next->width <= right) {
+			next = segments.erase(next);
+			continue;
+		}
+		next->width -= right - next->x;
+		next->x = right;
+		break;
+	}
+	// merge neighbours at the same height
+	for (auto i = segments.begin(); i + 1 != segments.end();) {
+		if (i->y == (i + 1)->y) {
+			i->width += (i + 1)->width;
+			segments.erase(i + 1);
+		} else {
+			++i;
+		}
+	}
+}
+
+void TextureAtlas::Skyline::resize(Extent2D const new_extent) {
+	assert(new_extent.x >= extent.x && new_extent.y >= extent.y);
+	if (new_extent.x > extent.x) {
+		auto const width = new_extent.x - extent.x;
+		if (!segments.empty() && segments.back().y == 0) {
+			segments.back().width += width;
+		} else {
+			segments.push_back(Segment{.x = extent.x, .width = width});
+		}
+	}
+	extent = new_extent;
+}
+
+auto TextureAtlas::Skyline::pack(std::span<Extent2D const> sizes) -> std::optional<Extent2D> {
+	for (auto const& size : sizes) {
+		if (size.x == 0 || size.y == 0) { continue; }
+		auto const position = find(size);
+		if (!position) { return size; }
+		insert(*position, size);
+	}
+	return {};
+}
+
+Extent2D TextureAtlas::extent_for(std::span<Extent2D const> extents, glm::uvec2 const padding) {
+	auto const sizes = sorted_padded(extents, padding);
+	auto start = Extent2D{1u, 1u};
+	for (auto const& size : sizes) { start = glm::max(start, size); }
+	return Skyline::fit(Skyline::make({next_pot(start.x), next_pot(start.y)}), sizes);
+}
+
 TextureAtlas::TextureAtlas(NotNull<TextureProvider*> provider, Uri<Texture> uri, CreateInfo const& create_info)
-	: m_uri(std::move(uri)), m_provider(provider), m_padding(create_info.padding), m_cursor(create_info.padding) {
-	provider->add(m_uri, make_texture(provider->render_device(), create_info.initial_extent));
+	: m_uri(std::move(uri)), m_provider(provider), m_skyline(Skyline::make(create_info.initial_extent)), m_padding(create_info.padding),
+	  m_channels(create_info.channels) {
+	provider->add(m_uri, make_texture(provider->render_device(), create_info));
 }
 
 UvRect TextureAtlas::uv_rect_for(Cell const& cell) const {
@@ -83,33 +203,69 @@ UvRect TextureAtlas::uv_rect_for(Cell const& cell) const {
 	return UvRect{.lt = top_left / image_extent, .rb = (top_left + cell_extent) / image_extent};
 }
 
+void TextureAtlas::remove(Cell const& cell) {
+	auto* texture = find_texture();
+	if (!texture) { return; }
+	auto const extent = size_of(cell);
+	if (extent.x == 0 || extent.y == 0) { return; }
+	// zero initialized, as blank_v
+	auto const bytes = ByteArray{std::size_t{extent.x} * extent.y * m_channels};
+	auto const write = ImageWrite{.image = Image::View{.storage = bytes.span(), .extent = extent, .channels = m_channels}, .offset = cell.top_left()};
+	write_images(*texture->vulkan_texture(), {&write, 1u});
+	m_free.push_back(Cell{.lt = cell.lt - m_padding, .rb = cell.rb});
+}
+
 Ptr<Texture> TextureAtlas::find_texture() const { return m_provider->find(m_uri); }
 
+auto TextureAtlas::allocate(Extent2D const extent) -> Cell {
+	auto const size = extent + m_padding;
+	if (size.x == 0 || size.y == 0) { return {}; }
+	auto const to_cell = [&](glm::uvec2 const position) { return Cell{.lt = position + m_padding, .rb = position + size}; };
+
+	// best area fit among removed cells, splitting off the remainder
+	auto best = m_free.end();
+	for (auto it = m_free.begin(); it != m_free.end(); ++it) {
+		auto const free_size = size_of(*it);
+		if (free_size.x < size.x || free_size.y < size.y) { continue; }
+		if (best == m_free.end() || free_size.x * free_size.y < size_of(*best).x * size_of(*best).y) { best = it; }
+	}
+	if (best != m_free.end()) {
+		auto const region = *best;
+		m_free.erase(best);
+		auto const right = Cell{.lt = {region.lt.x + size.x, region.lt.y}, .rb = {region.rb.x, region.lt.y + size.y}};
+		auto const below = Cell{.lt = {region.lt.x, region.lt.y + size.y}, .rb = region.rb};
+		for (auto const& rect : {right, below}) {
+			if (rect.rb.x > rect.lt.x && rect.rb.y > rect.lt.y) { m_free.push_back(rect); }
+		}
+		return to_cell(region.lt);
+	}
+
+	auto position = m_skyline.find(size);
+	while (!position) {
+		m_skyline.resize(grow_extent(m_skyline.extent, size));
+		position = m_skyline.find(size);
+	}
+	m_skyline.insert(*position, size);
+	return to_cell(*position);
+}
+
 TextureAtlas::Writer::~Writer() {
 	auto* texture = m_out.find_texture();
 	if (!texture) { return; }
-	if (m_new_extent.x > 0 && !resize_canvas(*texture->vulkan_texture(), m_new_extent, blank_v)) { return; }
+	// at most one resize for all the writes
+	if (m_out.m_skyline.extent != texture->extent() && !resize_canvas(*texture->vulkan_texture(), m_out.m_skyline.extent, blank_v)) { return; }
 	write_images(*texture->vulkan_texture(), m_writes);
 }
 
+void TextureAtlas::Writer::reserve(std::span<Extent2D const> extents) {
+	auto const sizes = sorted_padded(extents, m_out.m_padding);
+	m_out.m_skyline.resize(Skyline::fit(m_out.m_skyline, sizes));
+}
+
 auto TextureAtlas::Writer::write(Image::View const image) -> Cell {
-	auto* texture = m_out.find_texture();
-	if (!texture) { return {}; }
-	auto const current_extent = m_new_extent.x == 0 ? texture->extent() : m_new_extent;
-	auto const required_extent = image.extent + m_out.m_padding;
-	if (m_out.m_cursor.x + required_extent.x > texture->extent().x) {
-		m_out.m_cursor.y += m_out.m_max_height + m_out.m_padding.y; // line break
-		m_out.m_cursor.x = m_out.m_padding.x;						// carriage return
-		m_out.m_max_height = {};
-	}
-	auto new_width = std::optional<std::uint32_t>{};
-	auto new_height = std::optional<std::uint32_t>{};
-	if (m_out.m_cursor.x + required_extent.x > current_extent.x) { new_width = next_pot(image.extent.x); }
-	if (m_out.m_cursor.y + required_extent.y > current_extent.y) { new_height = next_pot(current_extent.y + required_extent.y); }
-	if (new_width || new_height) { m_new_extent = make_new_extent(current_extent, new_width, new_height); }
-	auto const ret = Cell{.lt = m_out.m_cursor, .rb = m_out.m_cursor + image.extent};
-	m_out.m_cursor.x += required_extent.x;
-	m_out.m_max_height = std::max(m_out.m_max_height, required_extent.y);
+	assert(image.channels == m_out.m_channels);
+	if (!m_out.find_texture()) { return {}; }
+	auto const ret = m_out.allocate(image.extent);
 	m_writes.push_back(ImageWrite{image, ret.top_left()});
 	return ret;
 }
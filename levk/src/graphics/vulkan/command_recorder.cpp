@@ -0,0 +1,113 @@
+#include <graphics/vulkan/command_recorder.hpp>
+#include <algorithm>
+
+namespace levk::vulkan {
+CommandRecorder::CommandRecorder(DeviceView const& device, std::uint32_t threads) : m_device(device) {
+	if (threads < 2) { return; }
+	m_pool = std::make_unique<ThreadPool>(threads);
+	if (m_pool->thread_count() < 2) {
+		m_pool.reset();
+		return;
+	}
+	// one lane per worker thread, and one for the render thread
+	m_lanes.resize(m_pool->thread_count() + 1);
+	for (auto& lane : m_lanes) {
+		for (auto& frame : lane.frames) {
+			frame.allocator = device.make_command_allocator();
+			frame.set_allocator.device = device.device;
+			frame.scratch_buffer_allocator.vma = device.vma;
+		}
+	}
+}
+
+vk::RenderingFlags CommandRecorder::rendering_flags() const {
+	if (!is_parallel()) { return {}; }
+	return vk::RenderingFlagBits::eContentsSecondaryCommandBuffers;
+}
+
+void CommandRecorder::next_frame() {
+	for (auto& lane : m_lanes) {
+		auto& frame = lane.frames[*m_device.buffered_index];
+		m_device.device.resetCommandPool(*frame.allocator.pool);
+		frame.next = {};
+		frame.set_allocator.reset_all();
+		frame.scratch_buffer_allocator.clear();
+	}
+}
+
+void CommandRecorder::begin(vk::CommandBuffer primary, PipelineFormat const& format) {
+	assert(!m_primary && m_pending.empty());
+	m_primary = primary;
+	m_format = format;
+}
+
+void CommandRecorder::record(Record const& func) {
+	assert(m_primary);
+	if (!is_parallel()) { return func(Context{m_primary, m_device}); }
+	auto const context = begin_secondary(m_lanes.back());
+	func(context);
+	context.cb.end();
+	m_pending.push_back(context.cb);
+}
+
+void CommandRecorder::record(std::size_t count, RecordRange const& func) {
+	assert(m_primary);
+	if (count == 0) { return; }
+	if (!is_parallel()) { return func(Context{m_primary, m_device}, 0, count); }
+
+	auto const chunks = std::clamp(count / min_chunk_size_v, std::size_t{1}, m_pool->thread_count());
+	if (chunks < 2) {
+		return record([&func, count](Context const& context) { func(context, 0, count); });
+	}
+
+	auto const chunk_size = (count + chunks - 1) / chunks;
+	auto const first = m_pending.size();
+	m_pending.resize(first + chunks);
+	auto futures = std::vector<std::future<void>>{};
+	futures.reserve(chunks);
+	for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+		auto const begin = chunk * chunk_size;
+		auto const end = std::min(begin + chunk_size, count);
+		// each chunk gets a dedicated lane: no two tasks in flight share allocators
+		futures.push_back(m_pool->submit([this, &func, chunk, begin, end, slot = first + chunk] {
+			auto const context = begin_secondary(m_lanes[chunk]);
+			if (begin < end) { func(context, begin, end); }
+			context.cb.end();
+			m_pending[slot] = context.cb;
+		}));
+	}
+	for (auto const& future : futures) { future.wait(); }
+	for (auto& future : futures) { future.get(); }
+}
+
+void CommandRecorder::end() {
+	assert(m_primary);
+	if (!m_pending.empty()) { m_primary.executeCommands(m_pending); }
+	m_pending.clear();
+	for (auto& lane : m_lanes) { *m_device.draw_calls += std::exchange(lane.draw_calls, 0); }
+	m_primary = vk::CommandBuffer{};
+}
+
+auto CommandRecorder::begin_secondary(Lane& lane) -> Context {
+	auto& frame = lane.frames[*m_device.buffered_index];
+	if (frame.next >= frame.cbs.size()) { frame.cbs.push_back(frame.allocator.allocate(vk::CommandBufferLevel::eSecondary)); }
+	auto ret = Context{.cb = frame.cbs[frame.next++], .device = m_device};
+	ret.device.set_allocator = &frame.set_allocator;
+	ret.device.scratch_buffer_allocator = &frame.scratch_buffer_allocator;
+	ret.device.draw_calls = &lane.draw_calls;
+	assert(ret.device.draw_calls != m_device.draw_calls);
+
+	auto cbiri = vk::CommandBufferInheritanceRenderingInfo{};
+	if (m_format.colour != vk::Format{}) {
+		cbiri.colorAttachmentCount = 1u;
+		cbiri.pColorAttachmentFormats = &m_format.colour;
+	}
+	cbiri.depthAttachmentFormat = m_format.depth;
+	cbiri.rasterizationSamples = m_format.samples;
+	auto cbii = vk::CommandBufferInheritanceInfo{};
+	cbii.pNext = &cbiri;
+	static constexpr auto flags_v = vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+	ret.cb.begin(vk::CommandBufferBeginInfo{flags_v, &cbii});
+	return ret;
+}
+} // namespace levk::vulkan
@@ -0,0 +1,64 @@
+#pragma once
+#include <graphics/vulkan/common.hpp>
+#include <levk/util/thread_pool.hpp>
+#include <functional>
+#include <memory>
+
+namespace levk::vulkan {
+///
+/// \brief Records the contents of a render pass, optionally into secondary command buffers on worker threads.
+///
+/// Each worker thread owns its own CommandAllocator, SetAllocator and ScratchBufferAllocator (per buffered frame),
+/// so chunks of draws can be recorded concurrently. Secondary command buffers are executed in submission order.
+/// With fewer than two threads, everything is recorded directly into the primary command buffer.
+///
+class CommandRecorder {
+  public:
+	struct Context {
+		vk::CommandBuffer cb{};
+		DeviceView device{};
+	};
+
+	using Record = std::function<void(Context const&)>;
+	using RecordRange = std::function<void(Context const&, std::size_t begin, std::size_t end)>;
+
+	static constexpr std::size_t min_chunk_size_v{64};
+
+	CommandRecorder() = default;
+	CommandRecorder(DeviceView const& device, std::uint32_t threads);
+
+	bool is_parallel() const { return m_pool != nullptr; }
+	vk::RenderingFlags rendering_flags() const;
+
+	void next_frame();
+
+	void begin(vk::CommandBuffer primary, PipelineFormat const& format);
+	void record(Record const& func);
+	void record(std::size_t count, RecordRange const& func);
+	void end();
+
+  private:
+	struct Lane {
+		struct Frame {
+			CommandAllocator allocator{};
+			std::vector<vk::CommandBuffer> cbs{};
+			std::size_t next{};
+			SetAllocator set_allocator{};
+			ScratchBufferAllocator scratch_buffer_allocator{};
+		};
+
+		Buffered<Frame> frames{};
+		// incremented by the lane's thread only, summed on the render thread in end()
+		alignas(64) std::uint64_t draw_calls{};
+	};
+
+	Context begin_secondary(Lane& lane);
+
+	DeviceView m_device{};
+	std::unique_ptr<ThreadPool> m_pool{};
+	std::vector<Lane> m_lanes{};
+	std::vector<vk::CommandBuffer> m_pending{};
+	vk::CommandBuffer m_primary{};
+	PipelineFormat m_format{};
+};
+} // namespace levk::vulkan
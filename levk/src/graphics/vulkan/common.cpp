@@ -1,12 +1,12 @@
 #include <glm/mat4x4.hpp>
-#include <graphics/vulkan/ad_hoc_cmd.hpp>
 #include <graphics/vulkan/common.hpp>
 #include <graphics/vulkan/image_barrier.hpp>
+#include <graphics/vulkan/upload_service.hpp>
+#include <graphics/vulkan/vertex_format.hpp>
 #include <levk/graphics/geometry.hpp>
 #include <levk/util/error.hpp>
 #include <levk/util/hash_combine.hpp>
 #include <cmath>
-#include <numeric>
 
 namespace levk::vulkan {
 namespace {
@@ -115,6 +115,10 @@ void Vma::Deleter::operator()(Image const& image) const {
 	if (image.image && allocation.allocation) { vmaDestroyImage(allocation.vma.allocator, image.image, allocation.allocation); }
 }
 
+void Vma::Deleter::operator()(Allocation const& allocation) const {
+	if (allocation.allocation) { vmaFreeMemory(allocation.vma.allocator, allocation.allocation); }
+}
+
 UniqueVma Vma::make(vk::Instance instance, vk::PhysicalDevice gpu, vk::Device device) {
 	assert(instance && gpu && device);
 	auto vaci = VmaAllocatorCreateInfo{};
@@ -132,11 +136,16 @@ UniqueVma Vma::make(vk::Instance instance, vk::PhysicalDevice gpu, vk::Device de
 	return ret;
 }
 
-UniqueBuffer Vma::make_buffer(vk::BufferUsageFlags const usage, vk::DeviceSize const size, bool host_visible) const {
+UniqueBuffer Vma::make_buffer(vk::BufferUsageFlags const usage, vk::DeviceSize const size, bool host_visible,
+							  std::span<std::uint32_t const> queue_families) const {
 	auto vaci = VmaAllocationCreateInfo{};
 	vaci.usage = VMA_MEMORY_USAGE_AUTO;
 	if (host_visible) { vaci.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT; }
-	auto const bci = vk::BufferCreateInfo{{}, size, usage};
+	auto bci = vk::BufferCreateInfo{{}, size, usage};
+	if (queue_families.size() > 1) {
+		bci.sharingMode = vk::SharingMode::eConcurrent;
+		bci.setQueueFamilyIndices(queue_families);
+	}
 	auto vbci = static_cast<VkBufferCreateInfo>(bci);
 	auto buffer = VkBuffer{};
 	auto ret = Buffer{};
@@ -152,6 +161,35 @@ UniqueBuffer Vma::make_buffer(vk::BufferUsageFlags const usage, vk::DeviceSize c
 	return UniqueBuffer{std::move(ret)};
 }
 
+UniqueBuffer Vma::make_readback_buffer(vk::DeviceSize const size) const {
+	auto vaci = VmaAllocationCreateInfo{};
+	vaci.usage = VMA_MEMORY_USAGE_AUTO;
+	vaci.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+	auto const vbci = static_cast<VkBufferCreateInfo>(vk::BufferCreateInfo{{}, size, vk::BufferUsageFlagBits::eTransferDst});
+	auto buffer = VkBuffer{};
+	auto ret = Buffer{};
+	auto alloc_info = VmaAllocationInfo{};
+	if (vmaCreateBuffer(allocator, &vbci, &vaci, &buffer, &ret.allocation.allocation, &alloc_info) != VK_SUCCESS) {
+		throw Error{"Failed to allocate Vulkan Buffer"};
+	}
+	ret.buffer = buffer;
+	ret.allocation.vma = *this;
+	ret.size = size;
+	ret.mapped = alloc_info.pMappedData;
+	assert(ret.mapped);
+	return UniqueBuffer{std::move(ret)};
+}
+
+UniqueAllocation Vma::allocate(vk::MemoryRequirements const& requirements) const {
+	auto vaci = VmaAllocationCreateInfo{};
+	vaci.requiredFlags = static_cast<VkMemoryPropertyFlags>(vk::MemoryPropertyFlagBits::eDeviceLocal);
+	auto const vmr = static_cast<VkMemoryRequirements>(requirements);
+	auto ret = Allocation{};
+	if (vmaAllocateMemory(allocator, &vmr, &vaci, &ret.allocation, {}) != VK_SUCCESS) { throw Error{"Failed to allocate Vulkan Memory"}; }
+	ret.vma = *this;
+	return UniqueAllocation{ret};
+}
+
 UniqueImage Vma::make_image(ImageCreateInfo const& info, vk::Extent2D const extent, vk::ImageViewType type) const {
 	if (extent.width == 0 || extent.height == 0) { throw Error{"Attempt to allocate 0-sized image"}; }
 	auto vaci = VmaAllocationCreateInfo{};
@@ -170,7 +208,7 @@ UniqueImage Vma::make_image(ImageCreateInfo const& info, vk::Extent2D const exte
 	auto image = VkImage{};
 	auto ret = Image{};
 	if (vmaCreateImage(allocator, &vici, &vaci, &image, &ret.allocation.allocation, {}) != VK_SUCCESS) { throw Error{"Failed to allocate Vulkan Image"}; }
-	ret.view = make_image_view(image, info.format, {info.aspect, 0, info.mip_levels, 0, info.array_layers}, type);
+	ret.view = make_image_view(image, info.format, {info.aspect, 0, info.mip_levels, 0, info.array_layers}, type, info.components);
 	ret.image = image;
 	ret.allocation.vma = *this;
 	ret.format = info.format;
@@ -181,11 +219,12 @@ UniqueImage Vma::make_image(ImageCreateInfo const& info, vk::Extent2D const exte
 	return UniqueImage{std::move(ret)};
 }
 
-vk::UniqueImageView Vma::make_image_view(vk::Image const image, vk::Format const format, vk::ImageSubresourceRange isr, vk::ImageViewType type) const {
+vk::UniqueImageView Vma::make_image_view(vk::Image const image, vk::Format const format, vk::ImageSubresourceRange isr, vk::ImageViewType type,
+										 vk::ComponentMapping const components) const {
 	vk::ImageViewCreateInfo info;
 	info.viewType = type;
 	info.format = format;
-	info.components.r = info.components.g = info.components.b = info.components.a = vk::ComponentSwizzle::eIdentity;
+	info.components = components;
 	info.subresourceRange = isr;
 	info.image = image;
 	return device.createImageViewUnique(info);
@@ -211,70 +250,13 @@ void Vma::copy_image(vk::CommandBuffer cb, Copy const& src, Copy const& dst, vk:
 	barriers[1] = ImageBarrier{dst.image}.set_full_barrier(vk::ImageLayout::eTransferDstOptimal, layout).barrier;
 	ImageBarrier::transition(cb, barriers);
 
-	if (dst.image.mip_levels > 1) {
-		auto barrier = ImageBarrier{dst.image};
-		MipMapWriter{barrier, dst.image.extent, cb, dst.image.mip_levels, dst.image.array_layers}();
-	}
+	write_mips(cb, dst.image);
 }
 
-UniqueBuffer Vma::copy_to_image(vk::CommandBuffer cb, Image const& out, std::span<levk::Image::View const> images, glm::ivec2 const offset) const {
-	assert(std::all_of(images.begin(), images.end(), [images](levk::Image::View const& view) { return view.extent == images[0].extent; }));
-	assert(out.array_layers == images.size());
-	auto const accumulate_size = [](std::size_t total, levk::Image::View const& i) { return total + i.storage.size(); };
-	auto const size = std::accumulate(images.begin(), images.end(), std::size_t{}, accumulate_size);
-	auto staging = make_buffer(vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst, size, true);
-	if (!staging.get().buffer || !staging.get().mapped) { throw Error{"Failed to write create Vulkan staging buffer"}; }
-
-	auto* ptr = static_cast<std::byte*>(staging.get().mapped);
-	for (auto const& image : images) {
-		std::memcpy(ptr, image.storage.data(), image.storage.size());
-		ptr += image.storage.size();
-	}
-
-	auto const vk_extent = vk::Extent3D{images[0].extent.x, images[0].extent.y, 1u};
-	auto const vk_offset = vk::Offset3D{offset.x, offset.y, 0};
-	auto isrl = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, out.array_layers);
-	auto bic = vk::BufferImageCopy({}, {}, {}, isrl, vk_offset, vk_extent);
-	auto barrier = ImageBarrier{out};
-	barrier.set_full_barrier(vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal).transition(cb);
-	cb.copyBufferToImage(staging.get().buffer, out.image, vk::ImageLayout::eTransferDstOptimal, bic);
-	barrier.set_full_barrier(vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal).transition(cb);
-	if (out.mip_levels > 1) { MipMapWriter{barrier, out.extent, cb, out.mip_levels, out.array_layers}(); }
-
-	return staging;
-}
-
-UniqueBuffer Vma::write_images(vk::CommandBuffer cb, Image const& out, std::span<ImageWrite const> writes) const {
-	if (out.array_layers > 1u || writes.empty()) { return {}; }
-	auto const accumulate_size = [](std::size_t total, ImageWrite const& tw) { return total + tw.image.storage.size(); };
-	auto const size = std::accumulate(writes.begin(), writes.end(), std::size_t{}, accumulate_size);
-	auto staging = make_buffer(vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst, size, true);
-	if (!staging.get().buffer || !staging.get().mapped) { throw Error{"Failed to write create Vulkan staging buffer"}; }
-
-	auto* ptr = static_cast<std::byte*>(staging.get().mapped);
-	for (auto const& image : writes) {
-		std::memcpy(ptr, image.image.storage.data(), image.image.storage.size());
-		ptr += image.image.storage.size();
-	}
-
-	auto isrl = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, out.array_layers);
-	auto bics = std::vector<vk::BufferImageCopy>{};
-	bics.reserve(writes.size());
-	auto buffer_offset = vk::DeviceSize{};
-	for (auto const& image : writes) {
-		auto offset = glm::ivec2{image.offset};
-		auto const vk_offset = vk::Offset3D{offset.x, offset.y, 0};
-		auto const extent = vk::Extent3D{image.image.extent.x, image.image.extent.y, 1u};
-		auto bic = vk::BufferImageCopy{buffer_offset, {}, {}, isrl, vk_offset, extent};
-		bics.push_back(bic);
-		buffer_offset += image.image.storage.size();
-	}
-	auto barrier = ImageBarrier{out};
-	barrier.set_full_barrier(vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal).transition(cb);
-	cb.copyBufferToImage(staging.get().buffer, out.image, vk::ImageLayout::eTransferDstOptimal, bics);
-	barrier.set_full_barrier(vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal).transition(cb);
-	if (out.mip_levels > 1) { MipMapWriter{barrier, out.extent, cb, out.mip_levels, out.array_layers}(); }
-	return staging;
+void Vma::write_mips(vk::CommandBuffer cb, Image const& image) const {
+	if (image.mip_levels < 2) { return; }
+	auto barrier = ImageBarrier{image};
+	MipMapWriter{barrier, image.extent, cb, image.mip_levels, image.array_layers}();
 }
 
 void Vma::full_blit(vk::CommandBuffer cb, Blit src, Blit dst, vk::Filter filter) const {
@@ -315,14 +297,14 @@ vk::DescriptorSet SetAllocator::allocate(vk::DescriptorSetLayout layout) {
 }
 
 void SetAllocator::reset_all() {
-	for (auto& [_, page] : pools.pages) {
+	for (auto& [_, page] : pools[frame ? frame->value : 0u].pages) {
 		for (auto& pool : page.values) { device.resetDescriptorPool(*pool); }
 		page.next_free = {};
 	}
 }
 
 vk::DescriptorPool SetAllocator::get_free_pool(vk::DescriptorSetLayout layout) {
-	auto& ret = pools.next(layout);
+	auto& ret = pools[frame ? frame->value : 0u].next(layout);
 	if (!ret) { ret = make_descriptor_pool(device); }
 	return *ret;
 }
@@ -342,60 +324,18 @@ std::size_t VertexInput::make_hash() const {
 	return hash;
 }
 
-VertexInput VertexInput::for_shadow() {
-	auto ret = VertexInput{};
-
-	// position
-	ret.bindings.insert(vk::VertexInputBindingDescription{0, sizeof(glm::vec3)});
-	ret.attributes.insert(vk::VertexInputAttributeDescription{0, 0, vk::Format::eR32G32B32Sfloat});
-
-	// instance matrix
-	ret.bindings.insert(vk::VertexInputBindingDescription{4, sizeof(glm::mat4), vk::VertexInputRate::eInstance});
-	ret.attributes.insert(vk::VertexInputAttributeDescription{4, 4, vk::Format::eR32G32B32A32Sfloat, 0 * sizeof(glm::vec4)});
-	ret.attributes.insert(vk::VertexInputAttributeDescription{5, 4, vk::Format::eR32G32B32A32Sfloat, 1 * sizeof(glm::vec4)});
-	ret.attributes.insert(vk::VertexInputAttributeDescription{6, 4, vk::Format::eR32G32B32A32Sfloat, 2 * sizeof(glm::vec4)});
-	ret.attributes.insert(vk::VertexInputAttributeDescription{7, 4, vk::Format::eR32G32B32A32Sfloat, 3 * sizeof(glm::vec4)});
-
-	return ret;
-}
-
-VertexInput VertexInput::for_static() {
-	auto ret = for_shadow();
-
-	// rgb
-	ret.bindings.insert(vk::VertexInputBindingDescription{1, sizeof(glm::vec3)});
-	ret.attributes.insert(vk::VertexInputAttributeDescription{1, 1, vk::Format::eR32G32B32Sfloat});
+VertexInput VertexInput::for_shadow() { return VertexStreams::make(VertexFormat::eFull, false).shadow_input(); }
 
-	// normal
-	ret.bindings.insert(vk::VertexInputBindingDescription{2, sizeof(glm::vec3)});
-	ret.attributes.insert(vk::VertexInputAttributeDescription{2, 2, vk::Format::eR32G32B32Sfloat});
+VertexInput VertexInput::for_static() { return VertexStreams::make(VertexFormat::eFull, false).vertex_input(); }
 
-	// uv
-	ret.bindings.insert(vk::VertexInputBindingDescription{3, sizeof(glm::vec2)});
-	ret.attributes.insert(vk::VertexInputAttributeDescription{3, 3, vk::Format::eR32G32Sfloat});
-
-	return ret;
-}
-
-VertexInput VertexInput::for_skinned() {
-	auto ret = for_static();
-
-	// joints
-	ret.bindings.insert(vk::VertexInputBindingDescription{8, sizeof(glm::uvec4)});
-	ret.attributes.insert(vk::VertexInputAttributeDescription{8, 8, vk::Format::eR32G32B32A32Uint});
-
-	// weights
-	ret.bindings.insert(vk::VertexInputBindingDescription{9, sizeof(glm::vec4)});
-	ret.attributes.insert(vk::VertexInputAttributeDescription{9, 9, vk::Format::eR32G32B32A32Sfloat});
-
-	return ret;
-}
+VertexInput VertexInput::for_skinned() { return VertexStreams::make(VertexFormat::eFull, true).vertex_input(); }
 
 std::size_t SamplerStorage::Hasher::operator()(TextureSampler const& sampler) const {
 	return make_combined_hash(sampler.min, sampler.mag, sampler.wrap_s, sampler.wrap_t, sampler.border);
 }
 
 vk::Sampler SamplerStorage::get(vk::Device device, TextureSampler const& sampler) {
+	auto lock = std::scoped_lock{mutex};
 	if (auto it = map.find(sampler); it != map.end()) { return *it->second; }
 	auto sci = vk::SamplerCreateInfo{};
 	sci.minFilter = from(sampler.min);
@@ -412,6 +352,17 @@ vk::Sampler SamplerStorage::get(vk::Device device, TextureSampler const& sampler
 	return *it->second;
 }
 
+void IndirectDraw::record(vk::CommandBuffer cb) const {
+	if (!*this) { return; }
+	if (count.buffer) {
+		cb.drawIndexedIndirectCount(commands.buffer, commands.offset, count.buffer, count.offset, draw_count, stride_v);
+	} else if (multi_draw) {
+		cb.drawIndexedIndirect(commands.buffer, commands.offset, draw_count, stride_v);
+	} else {
+		for (std::uint32_t i = 0; i < draw_count; ++i) { cb.drawIndexedIndirect(commands.buffer, commands.offset + i * stride_v, 1u, stride_v); }
+	}
+}
+
 std::uint32_t DeviceView::compute_mip_levels(vk::Extent2D extent) {
 	return static_cast<std::uint32_t>(std::floor(std::log2(std::max(extent.width, extent.height)))) + 1u;
 }
@@ -425,12 +376,9 @@ DeviceBuffer DeviceBuffer::make(DeviceView device, vk::BufferUsageFlags usage) {
 }
 
 void DeviceBuffer::write(void const* data, std::size_t size, std::size_t count) {
-	auto staging = device.vma.make_buffer(vk::BufferUsageFlagBits::eTransferSrc, size, true);
 	if (buffer.get().get().size < size) { buffer.get() = device.vma.make_buffer(vk::BufferUsageFlagBits::eTransferDst | usage, size, false); }
-	if (!staging.get().buffer || !staging.get().mapped) { throw Error{"Failed to write create Vulkan staging buffer"}; }
-	std::memcpy(staging.get().mapped, data, size);
-	auto cmd = AdHocCmd{device};
-	cmd.cb.copyBuffer(staging.get().buffer, buffer.get().get().buffer, vk::BufferCopy{{}, {}, size});
+	auto const copy = vk::BufferCopy{{}, {}, size};
+	device.upload_service->upload(buffer.get().get().buffer, {static_cast<std::byte const*>(data), size}, {&copy, 1u});
 	this->count = static_cast<std::uint32_t>(count);
 }
 
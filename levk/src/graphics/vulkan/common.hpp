@@ -1,5 +1,6 @@
 #pragma once
 #include <vk_mem_alloc.h>
+#include <glm/mat4x4.hpp>
 #include <levk/graphics/common.hpp>
 #include <levk/graphics/image.hpp>
 #include <levk/graphics/shader_code.hpp>
@@ -17,23 +18,28 @@
 
 namespace levk::vulkan {
 struct PipelineStorage;
+struct GeometryArena;
+class UploadService;
 
 inline constexpr vk::Format srgb_formats_v[] = {vk::Format::eR8G8B8A8Srgb, vk::Format::eB8G8R8A8Srgb, vk::Format::eA8B8G8R8SrgbPack32};
 inline constexpr vk::Format linear_formats_v[] = {vk::Format::eR8G8B8A8Unorm, vk::Format::eB8G8R8A8Unorm};
 
-template <std::integral Type = std::size_t>
-constexpr auto buffering_v = Type{1};
+// the number of frames in flight is chosen at runtime, up to this
+inline constexpr std::size_t max_frames_in_flight_v{3};
 
-using DeferQueue = levk::DeferQueue<buffering_v<>>;
+// destruction is deferred one frame longer than frames can be in flight: resources replaced during a frame may still be used by its commands
+using DeferQueue = levk::DeferQueue<max_frames_in_flight_v + 1>;
 
 struct Index {
 	std::size_t value{};
+	std::size_t count{max_frames_in_flight_v};
 	constexpr operator std::size_t() const { return value; }
-	constexpr void next() { value = (value + 1) % buffering_v<>; }
+	constexpr void next() { value = (value + 1) % count; }
 };
 
+// one Type per frame in flight, indexed by DeviceView::buffered_index
 template <typename Type>
-using Buffered = std::array<Type, buffering_v<>>;
+using Buffered = std::array<Type, max_frames_in_flight_v>;
 
 bool is_srgb(vk::Format format);
 
@@ -88,6 +94,19 @@ struct BufferView {
 	std::uint32_t count{1};
 };
 
+struct IndirectDraw {
+	static constexpr auto stride_v = static_cast<std::uint32_t>(sizeof(vk::DrawIndexedIndirectCommand));
+
+	BufferView commands{};
+	BufferView count{};
+	std::uint32_t draw_count{};
+	bool multi_draw{};
+
+	explicit operator bool() const { return commands.buffer && draw_count > 0; }
+
+	void record(vk::CommandBuffer cb) const;
+};
+
 struct ImageView {
 	vk::Image image{};
 	vk::ImageView view{};
@@ -105,6 +124,8 @@ struct ImageCreateInfo {
 	std::uint32_t mip_levels{1};
 	std::uint32_t array_layers{1};
 	vk::SampleCountFlagBits samples{vk::SampleCountFlagBits::e1};
+	// swizzle of the image's view
+	vk::ComponentMapping components{};
 };
 
 struct Vma {
@@ -137,15 +158,20 @@ struct Vma {
 	vk::Device device{};
 	VmaAllocator allocator{};
 
-	Unique<Buffer, Deleter> make_buffer(vk::BufferUsageFlags usage, vk::DeviceSize size, bool host_visible) const;
+	// shared concurrently if more than one queue family is passed
+	Unique<Buffer, Deleter> make_buffer(vk::BufferUsageFlags usage, vk::DeviceSize size, bool host_visible,
+										std::span<std::uint32_t const> queue_families = {}) const;
+	// host visible and cached, for reading back transfer writes: invalidate before reading
+	Unique<Buffer, Deleter> make_readback_buffer(vk::DeviceSize size) const;
 	Unique<Image, Deleter> make_image(ImageCreateInfo const& info, vk::Extent2D extent, vk::ImageViewType type = vk::ImageViewType::e2D) const;
+	// device local memory for resources bound manually (eg aliased images)
+	Unique<Allocation, Deleter> allocate(vk::MemoryRequirements const& requirements) const;
 	vk::UniqueImageView make_image_view(vk::Image const image, vk::Format const format, vk::ImageSubresourceRange isr = isr_v,
-										vk::ImageViewType type = vk::ImageViewType::e2D) const;
+										vk::ImageViewType type = vk::ImageViewType::e2D, vk::ComponentMapping components = {}) const;
 
 	void copy_image(vk::CommandBuffer cb, Copy const& src, Copy const& dst, vk::Extent2D const extent) const;
-	[[nodiscard]] Unique<Buffer, Deleter> copy_to_image(vk::CommandBuffer cb, Image const& out, std::span<levk::Image::View const> images,
-														glm::ivec2 const offset = {}) const;
-	[[nodiscard]] Unique<Buffer, Deleter> write_images(vk::CommandBuffer cb, Image const& out, std::span<ImageWrite const> writes) const;
+	// blits mip 0 (in shader read only layout) down the chain
+	void write_mips(vk::CommandBuffer cb, Image const& image) const;
 
 	void full_blit(vk::CommandBuffer cb, Blit src, Blit dst, vk::Filter filter = vk::Filter::eLinear) const;
 };
@@ -159,6 +185,7 @@ struct Vma::Deleter {
 	void operator()(Vma const& vma) const;
 	void operator()(Buffer const& buffer) const;
 	void operator()(Image const& image) const;
+	void operator()(Allocation const& allocation) const;
 };
 
 using UniqueVma = Unique<Vma, Vma::Deleter>;
@@ -192,11 +219,24 @@ struct Vma::Image {
 
 using UniqueBuffer = Unique<Vma::Buffer, Vma::Deleter>;
 using UniqueImage = Unique<Vma::Image, Vma::Deleter>;
+using UniqueAllocation = Unique<Vma::Allocation, Vma::Deleter>;
 
 struct Gpu {
+	struct Features {
+		bool multi_draw_indirect{};
+		bool draw_indirect_first_instance{};
+		bool draw_indirect_count{};
+		bool texture_compression_bc{};
+		// VK_KHR_present_id + VK_KHR_present_wait
+		bool present_wait{};
+	};
+
 	vk::PhysicalDevice device{};
 	vk::PhysicalDeviceProperties properties{};
 	std::uint32_t queue_family{};
+	// a transfer-only family if the GPU has one, else queue_family
+	std::uint32_t transfer_family{};
+	Features features{};
 
 	explicit operator bool() const { return !!device; }
 };
@@ -256,14 +296,14 @@ struct CommandAllocator {
 		return ret;
 	}
 
-	vk::Result allocate(std::span<vk::CommandBuffer> out) const {
-		auto cbai = vk::CommandBufferAllocateInfo{*pool, vk::CommandBufferLevel::ePrimary, static_cast<std::uint32_t>(out.size())};
+	vk::Result allocate(std::span<vk::CommandBuffer> out, vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary) const {
+		auto cbai = vk::CommandBufferAllocateInfo{*pool, level, static_cast<std::uint32_t>(out.size())};
 		return device.allocateCommandBuffers(&cbai, out.data());
 	}
 
-	vk::CommandBuffer allocate() const {
+	vk::CommandBuffer allocate(vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary) const {
 		auto ret = vk::CommandBuffer{};
-		allocate({&ret, 1});
+		allocate({&ret, 1}, level);
 		return ret;
 	}
 };
@@ -294,7 +334,9 @@ struct SetAllocator {
 	static vk::UniqueDescriptorPool make_descriptor_pool(vk::Device device, std::uint32_t max_sets = 32);
 
 	vk::Device device{};
-	MappedPool<vk::DescriptorSetLayout, vk::UniqueDescriptorPool> pools{};
+	Buffered<MappedPool<vk::DescriptorSetLayout, vk::UniqueDescriptorPool>> pools{};
+	// selects the current frame's pools; null if this allocator is only used by one frame
+	Ptr<Index const> frame{};
 
 	vk::DescriptorSet allocate(vk::DescriptorSetLayout layout);
 	void reset_all();
@@ -347,14 +389,18 @@ struct BufferWriter {
 
 struct ScratchBufferAllocator {
 	Vma vma{};
-	std::vector<UniqueBuffer> buffers{};
+	Buffered<std::vector<UniqueBuffer>> buffers{};
+	// selects the current frame's buffers; null if this allocator is only used by one frame
+	Ptr<Index const> frame{};
 
 	Vma::Buffer& allocate(vk::DeviceSize size, vk::BufferUsageFlags usage = vk::BufferUsageFlagBits::eUniformBuffer) {
 		assert(vma.allocator);
-		return buffers.emplace_back(vma.make_buffer(usage, size, true)).get();
+		return current().emplace_back(vma.make_buffer(usage, size, true)).get();
 	}
 
-	void clear() { buffers.clear(); }
+	void clear() { current().clear(); }
+
+	std::vector<UniqueBuffer>& current() { return buffers[frame ? frame->value : 0u]; }
 };
 
 struct SamplerStorage {
@@ -363,6 +409,7 @@ struct SamplerStorage {
 	};
 
 	std::unordered_map<TextureSampler, vk::UniqueSampler, Hasher> map{};
+	std::mutex mutex{};
 	float anisotropy{};
 
 	vk::Sampler get(vk::Device device, TextureSampler const& sampler);
@@ -382,7 +429,10 @@ struct DeviceView {
 	Ptr<ScratchBufferAllocator> scratch_buffer_allocator{};
 	Ptr<PipelineStorage> pipeline_storage{};
 	Ptr<SamplerStorage> sampler_storage{};
+	Ptr<GeometryArena> geometry_arena{};
+	Ptr<UploadService> upload_service{};
 	Ptr<Index const> buffered_index{};
+	// not synchronized: recording threads point this at a per-lane counter (see CommandRecorder)
 	Ptr<std::uint64_t> draw_calls{};
 
 	CommandAllocator make_command_allocator(vk::CommandPoolCreateFlags flags = CommandAllocator::flags_v) const {
@@ -397,6 +447,12 @@ struct DeviceView {
 		return (fsrc.optimalTilingFeatures & flags_v) != vk::FormatFeatureFlags{};
 	}
 
+	// block compressed formats also require the GPU feature
+	bool can_sample(vk::Format const format) const {
+		auto const fsrc = gpu->device.getFormatProperties(format);
+		return (fsrc.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImage) == vk::FormatFeatureFlagBits::eSampledImage;
+	}
+
 	static std::uint32_t compute_mip_levels(vk::Extent2D extent);
 };
 
@@ -408,6 +464,8 @@ struct GeometryOffsets {
 	std::size_t joints{};
 	std::size_t weights{};
 	std::size_t indices{};
+
+	bool operator==(GeometryOffsets const&) const = default;
 };
 
 struct GeometryLayout {
@@ -418,6 +476,14 @@ struct GeometryLayout {
 	std::uint32_t vertices{};
 	std::uint32_t indices{};
 	std::uint32_t joints{};
+	std::uint32_t first_index{};
+	std::int32_t vertex_offset{};
+	vk::IndexType index_type{vk::IndexType::eUint32};
+	VertexFormat format{};
+	// maps quantized positions back to model space: folded into instance matrices
+	std::optional<glm::mat4> dequant{};
+	// skinned by SkinningPass: drawn with the material's static sibling vertex shader
+	bool pre_skinned{};
 };
 
 struct DeviceBuffer {
@@ -2,15 +2,19 @@
 #include <backends/imgui_impl_vulkan.h>
 #include <glm/gtc/color_space.hpp>
 #include <graphics/vulkan/ad_hoc_cmd.hpp>
+#include <graphics/vulkan/command_recorder.hpp>
 #include <graphics/vulkan/device.hpp>
 #include <graphics/vulkan/framebuffer.hpp>
-#include <graphics/vulkan/image_barrier.hpp>
+#include <graphics/vulkan/geometry_arena.hpp>
+#include <graphics/vulkan/gpu_profiler.hpp>
 #include <graphics/vulkan/material.hpp>
 #include <graphics/vulkan/pipeline.hpp>
 #include <graphics/vulkan/primitive.hpp>
+#include <graphics/vulkan/render_graph.hpp>
 #include <graphics/vulkan/render_target.hpp>
 #include <graphics/vulkan/shader.hpp>
 #include <graphics/vulkan/texture.hpp>
+#include <graphics/vulkan/upload_service.hpp>
 #include <impl/frame_profiler.hpp>
 #include <levk/asset/asset_providers.hpp>
 #include <levk/asset/shader_provider.hpp>
@@ -27,7 +31,11 @@
 #include <levk/util/zip_ranges.hpp>
 #include <levk/window/window.hpp>
 #include <window/glfw/window.hpp>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
 #include <ranges>
+#include <thread>
 
 namespace levk::vulkan {
 namespace {
@@ -219,19 +227,30 @@ Gpu select_gpu(vk::Instance const instance, vk::SurfaceKHR const surface) {
 		auto const properties = device.getQueueFamilyProperties();
 		for (std::size_t i = 0; i < properties.size(); ++i) {
 			auto const family = static_cast<std::uint32_t>(i);
-			if (!device.getSurfaceSupportKHR(family, surface)) { continue; }
+			// headless: no surface to present to
+			if (surface && !device.getSurfaceSupportKHR(family, surface)) { continue; }
 			if (!(properties[i].queueFlags & queue_flags_v)) { continue; }
 			out_family = family;
 			return true;
 		}
 		return false;
 	};
+	// DMA queues: no graphics / compute, so copies on them run alongside rendering
+	auto const get_transfer_family = [](vk::PhysicalDevice const& device, std::uint32_t const fallback) {
+		static constexpr auto exclude_v = vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute;
+		auto const properties = device.getQueueFamilyProperties();
+		for (std::size_t i = 0; i < properties.size(); ++i) {
+			if ((properties[i].queueFlags & vk::QueueFlagBits::eTransfer) && !(properties[i].queueFlags & exclude_v)) { return static_cast<std::uint32_t>(i); }
+		}
+		return fallback;
+	};
 	auto const devices = instance.enumeratePhysicalDevices();
 	auto entries = std::vector<Entry>{};
 	for (auto const& device : devices) {
 		auto entry = Entry{.gpu = {device}};
 		entry.gpu.properties = device.getProperties();
 		if (!get_queue_family(device, entry.gpu.queue_family)) { continue; }
+		entry.gpu.transfer_family = get_transfer_family(device, entry.gpu.queue_family);
 		if (entry.gpu.properties.deviceType == vk::PhysicalDeviceType::eDiscreteGpu) { entry.rank -= 100; }
 		entries.push_back(std::move(entry));
 	}
@@ -240,10 +259,9 @@ Gpu select_gpu(vk::Instance const instance, vk::SurfaceKHR const surface) {
 	return std::move(entries.front().gpu);
 }
 
-vk::UniqueDevice make_device(Gpu const& gpu) {
+vk::UniqueDevice make_device(Gpu& gpu, bool const swapchain) {
 	static constexpr float priority_v = 1.0f;
 	static constexpr std::array required_extensions_v = {
-		VK_KHR_SWAPCHAIN_EXTENSION_NAME,
 		VK_KHR_MAINTENANCE1_EXTENSION_NAME,
 
 #if defined(__APPLE__)
@@ -254,7 +272,9 @@ vk::UniqueDevice make_device(Gpu const& gpu) {
 		VK_KHR_MAINTENANCE_4_EXTENSION_NAME,
 	};
 
-	auto qci = vk::DeviceQueueCreateInfo{{}, gpu.queue_family, 1, &priority_v};
+	auto qcis = FlexArray<vk::DeviceQueueCreateInfo, 2>{};
+	qcis.insert(vk::DeviceQueueCreateInfo{{}, gpu.queue_family, 1, &priority_v});
+	if (gpu.transfer_family != gpu.queue_family) { qcis.insert(vk::DeviceQueueCreateInfo{{}, gpu.transfer_family, 1, &priority_v}); }
 	auto dci = vk::DeviceCreateInfo{};
 	auto enabled = vk::PhysicalDeviceFeatures{};
 	auto available_features = gpu.device.getFeatures();
@@ -262,26 +282,62 @@ vk::UniqueDevice make_device(Gpu const& gpu) {
 	enabled.wideLines = available_features.wideLines;
 	enabled.samplerAnisotropy = available_features.samplerAnisotropy;
 	enabled.sampleRateShading = available_features.sampleRateShading;
+	enabled.multiDrawIndirect = available_features.multiDrawIndirect;
+	enabled.drawIndirectFirstInstance = available_features.drawIndirectFirstInstance;
+	enabled.textureCompressionBC = available_features.textureCompressionBC;
+	auto const available_features_12 = gpu.device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+	auto vulkan_12_features = vk::PhysicalDeviceVulkan12Features{};
+	vulkan_12_features.drawIndirectCount = available_features_12.get<vk::PhysicalDeviceVulkan12Features>().drawIndirectCount;
+	if (!available_features_12.get<vk::PhysicalDeviceVulkan12Features>().timelineSemaphore) {
+		throw Error{fmt::format("Timeline semaphores not supported by selected GPU [{}]", gpu.properties.deviceName)};
+	}
+	vulkan_12_features.timelineSemaphore = true;
+	gpu.features = Gpu::Features{
+		.multi_draw_indirect = enabled.multiDrawIndirect == VK_TRUE,
+		.draw_indirect_first_instance = enabled.drawIndirectFirstInstance == VK_TRUE,
+		.draw_indirect_count = vulkan_12_features.drawIndirectCount == VK_TRUE,
+		.texture_compression_bc = enabled.textureCompressionBC == VK_TRUE,
+	};
 	auto extensions = FlexArray<char const*, 8>{};
 	auto const available_extensions = gpu.device.enumerateDeviceExtensionProperties();
-	for (auto const* ext : required_extensions_v) {
+	auto const supported = [&](char const* ext) {
 		auto const found = [ext](vk::ExtensionProperties const& e) { return std::string_view{e.extensionName} == ext; };
-		if (std::ranges::find_if(available_extensions, found) == available_extensions.end()) {
-			throw Error{fmt::format("Required extension [{}] not supported by selected GPU [{}]", ext, gpu.properties.deviceName)};
-		}
+		return std::ranges::find_if(available_extensions, found) != available_extensions.end();
+	};
+	auto const require = [&](char const* ext) {
+		if (!supported(ext)) { throw Error{fmt::format("Required extension [{}] not supported by selected GPU [{}]", ext, gpu.properties.deviceName)}; }
 		extensions.insert(ext);
-	}
+	};
+	if (swapchain) { require(VK_KHR_SWAPCHAIN_EXTENSION_NAME); }
+	for (auto const* ext : required_extensions_v) { require(ext); }
 	for (auto const* ext : desired_extensions_v) {
-		auto const found = [ext](vk::ExtensionProperties const& e) { return std::string_view{e.extensionName} == ext; };
-		if (std::ranges::find_if(available_extensions, found) != available_extensions.end()) { extensions.insert(ext); }
+		if (supported(ext)) { extensions.insert(ext); }
+	}
+
+	// optional: observes when frames are actually presented, for frame latency
+	auto present_id_feature = vk::PhysicalDevicePresentIdFeaturesKHR{};
+	auto present_wait_feature = vk::PhysicalDevicePresentWaitFeaturesKHR{};
+	if (swapchain && supported(VK_KHR_PRESENT_ID_EXTENSION_NAME) && supported(VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+		auto const available =
+			gpu.device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDevicePresentIdFeaturesKHR, vk::PhysicalDevicePresentWaitFeaturesKHR>();
+		if (available.get<vk::PhysicalDevicePresentIdFeaturesKHR>().presentId && available.get<vk::PhysicalDevicePresentWaitFeaturesKHR>().presentWait) {
+			extensions.insert(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+			extensions.insert(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+			present_id_feature.presentId = true;
+			present_wait_feature.presentWait = true;
+			present_id_feature.pNext = &present_wait_feature;
+			vulkan_12_features.pNext = &present_id_feature;
+			gpu.features.present_wait = true;
+		}
 	}
 
 	auto dynamic_rendering_feature = vk::PhysicalDeviceDynamicRenderingFeatures{true};
 	auto synchronization_2_feature = vk::PhysicalDeviceSynchronization2FeaturesKHR{true};
 	synchronization_2_feature.pNext = &dynamic_rendering_feature;
+	dynamic_rendering_feature.pNext = &vulkan_12_features;
 
-	dci.queueCreateInfoCount = 1;
-	dci.pQueueCreateInfos = &qci;
+	dci.queueCreateInfoCount = static_cast<std::uint32_t>(qcis.size());
+	dci.pQueueCreateInfos = qcis.span().data();
 	dci.enabledExtensionCount = static_cast<std::uint32_t>(extensions.size());
 	dci.ppEnabledExtensionNames = extensions.span().data();
 	dci.pEnabledFeatures = &enabled;
@@ -299,6 +355,82 @@ vk::PresentModeKHR ideal_present_mode(std::unordered_set<vk::PresentModeKHR> con
 	return vk::PresentModeKHR::eFifo;
 }
 
+// Observes presentation through VK_KHR_present_wait, in present order, on a dedicated thread. The swapchain must be externally
+// synchronized with acquire / present, so waits are polled (without blocking) under the queue lock that those take.
+class PresentWaiter {
+  public:
+	explicit PresentWaiter(Ptr<Queue> queue, vk::Device device)
+		: m_queue(queue), m_device(device), m_thread([this](std::stop_token const& stop) { run(stop); }) {}
+
+	void push(vk::SwapchainKHR swapchain, std::uint64_t id, Clock::time_point submit_time) {
+		{
+			auto lock = std::scoped_lock{m_mutex};
+			m_pending.push_back(Present{swapchain, id, submit_time});
+		}
+		m_wake.notify_one();
+	}
+
+	// drops pending presents and returns once no poll is in progress: call before retiring a swapchain
+	void flush() {
+		auto lock = std::unique_lock{m_mutex};
+		m_pending.clear();
+		m_idle.wait(lock, [this] { return !m_polling; });
+	}
+
+	// submit to present of the latest frame observed on screen; zero until the first one
+	Duration latency() const { return m_latency.load(std::memory_order_relaxed); }
+
+  private:
+	static constexpr auto poll_interval_v = std::chrono::microseconds{250};
+	// presents that never complete (eg minimized window) are dropped after this long
+	static constexpr auto give_up_v = std::chrono::seconds{1};
+
+	struct Present {
+		vk::SwapchainKHR swapchain{};
+		std::uint64_t id{};
+		Clock::time_point submit_time{};
+	};
+
+	VkResult poll(Present const& present) const {
+		// the C entry point: reports out of date / timeout as results instead of throwing
+		auto const& dispatch = VULKAN_HPP_DEFAULT_DISPATCHER;
+		auto const swapchain = static_cast<VkSwapchainKHR>(present.swapchain);
+		return m_queue->with([&](vk::Queue) { return dispatch.vkWaitForPresentKHR(static_cast<VkDevice>(m_device), swapchain, present.id, 0u); });
+	}
+
+	void run(std::stop_token const& stop) {
+		auto lock = std::unique_lock{m_mutex};
+		while (m_wake.wait(lock, stop, [this] { return !m_pending.empty(); }) && !stop.stop_requested()) {
+			auto const present = m_pending.front();
+			m_polling = true;
+			lock.unlock();
+			auto const result = poll(present);
+			auto const now = Clock::now();
+			lock.lock();
+			m_polling = false;
+			m_idle.notify_all();
+			// flushed while polling: the present (and its swapchain) is gone
+			if (m_pending.empty() || m_pending.front().id != present.id || m_pending.front().swapchain != present.swapchain) { continue; }
+			if (result == VK_TIMEOUT && now - present.submit_time < give_up_v) {
+				m_wake.wait_for(lock, stop, poll_interval_v, [] { return false; });
+				continue;
+			}
+			m_pending.pop_front();
+			if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR) { m_latency.store(now - present.submit_time, std::memory_order_relaxed); }
+		}
+	}
+
+	Ptr<Queue> m_queue{};
+	vk::Device m_device{};
+	std::mutex m_mutex{};
+	std::condition_variable_any m_wake{};
+	std::condition_variable m_idle{};
+	std::deque<Present> m_pending{};
+	bool m_polling{};
+	std::atomic<Duration> m_latency{};
+	std::jthread m_thread{};
+};
+
 struct Swapchain {
 	struct CreateInfo {
 		Device::View device;
@@ -340,6 +472,9 @@ struct Swapchain {
 	vk::SwapchainCreateInfoKHR info{};
 
 	Storage storage{};
+	// null if present wait is not supported; declared after storage: must stop waiting before the swapchain is destroyed
+	std::unique_ptr<PresentWaiter> present_waiter{};
+	std::uint64_t present_id{};
 
 	static Swapchain make(CreateInfo const& create_info) {
 		auto ret = Swapchain{};
@@ -349,6 +484,9 @@ struct Swapchain {
 		ret.formats = Formats::make(create_info.device.gpu->device.getSurfaceFormatsKHR(create_info.device.surface));
 		auto const present_mode = ideal_present_mode(ret.modes, from(create_info.vsync));
 		ret.info = ret.make_swci(create_info.colour_space, present_mode);
+		if (create_info.device.gpu->features.present_wait) {
+			ret.present_waiter = std::make_unique<PresentWaiter>(create_info.device.queue, create_info.device.device);
+		}
 		return ret;
 	}
 
@@ -385,6 +523,7 @@ struct Swapchain {
 		auto create_info = info;
 		create_info.minImageCount = image_count(caps);
 		create_info.oldSwapchain = storage.swapchain.get();
+		if (present_waiter) { present_waiter->flush(); }
 		auto vk_swapchain = vk::SwapchainKHR{};
 		auto const ret = device.device.createSwapchainKHR(&create_info, nullptr, &vk_swapchain);
 		if (ret != vk::Result::eSuccess) { throw Error{"Failed to create Vulkan Swapchain"}; }
@@ -428,7 +567,7 @@ struct Swapchain {
 		return {};
 	}
 
-	bool present(glm::uvec2 extent, vk::Semaphore wait) {
+	bool present(glm::uvec2 extent, vk::Semaphore wait, Clock::time_point submit_time) {
 		assert(storage.image_index);
 		auto pi = vk::PresentInfoKHR{};
 		auto const image_index = static_cast<std::uint32_t>(*storage.image_index);
@@ -437,8 +576,14 @@ struct Swapchain {
 		pi.pImageIndices = &image_index;
 		pi.pSwapchains = &*storage.swapchain;
 		pi.swapchainCount = 1u;
+		auto const id = ++present_id;
+		auto const pid = vk::PresentIdKHR{1u, &id};
+		if (present_waiter) { pi.pNext = &pid; }
 		auto const result = device.queue->with([pi](vk::Queue queue) { return queue.presentKHR(&pi); });
 		storage.image_index.reset();
+		if (present_waiter && (result == vk::Result::eSuccess || result == vk::Result::eSuboptimalKHR)) {
+			present_waiter->push(*storage.swapchain, id, submit_time);
+		}
 		switch (result) {
 		case vk::Result::eSuccess: return true;
 		case vk::Result::eSuboptimalKHR:
@@ -452,19 +597,19 @@ struct Swapchain {
 struct RenderSync {
 	vk::UniqueSemaphore draw{};
 	vk::UniqueSemaphore present{};
-	vk::UniqueFence drawn{};
+	// value of the device timeline signalled when this frame's last submission completes (0: never submitted)
+	std::uint64_t submitted{};
+	Clock::time_point submit_time{};
 
 	struct View {
 		vk::Semaphore draw{};
 		vk::Semaphore present{};
-		vk::Fence drawn{};
 	};
 
 	static RenderSync make(Device::View const& device) {
 		return RenderSync{
 			.draw = device.device.createSemaphoreUnique({}),
 			.present = device.device.createSemaphoreUnique({}),
-			.drawn = device.device.createFenceUnique({vk::FenceCreateFlagBits::eSignaled}),
 		};
 	}
 
@@ -472,19 +617,26 @@ struct RenderSync {
 		return View{
 			.draw = *draw,
 			.present = *present,
-			.drawn = *drawn,
 		};
 	}
 };
 
+vk::UniqueSemaphore make_timeline(vk::Device device) {
+	auto const stci = vk::SemaphoreTypeCreateInfo{vk::SemaphoreType::eTimeline, 0u};
+	return device.createSemaphoreUnique(vk::SemaphoreCreateInfo{{}, &stci});
+}
+
 struct DearImGui {
 	enum class State { eNewFrame, eEndFrame };
 
 	vk::UniqueDescriptorPool pool{};
 	State state{};
+	// headless: no platform backend, display size is the offscreen extent
+	bool glfw{};
+	vk::Extent2D display_size{};
 
-	static DearImGui make(glfw::Window const& window, DeviceView const& device, vk::Format colour, vk::Format depth) {
-		auto ret = DearImGui{};
+	static DearImGui make(Ptr<glfw::Window const> window, DeviceView const& device, vk::Format colour, vk::Format depth) {
+		auto ret = DearImGui{.glfw = window != nullptr};
 		vk::DescriptorPoolSize pool_sizes[] = {
 			{vk::DescriptorType::eSampledImage, 1000},		   {vk::DescriptorType::eCombinedImageSampler, 1000},
 			{vk::DescriptorType::eSampledImage, 1000},		   {vk::DescriptorType::eStorageImage, 1000},
@@ -523,7 +675,7 @@ struct DearImGui {
 			return (*gf)(name);
 		};
 		ImGui_ImplVulkan_LoadFunctions(lambda, &get_fn);
-		ImGui_ImplGlfw_InitForVulkan(window.window, true);
+		if (window) { ImGui_ImplGlfw_InitForVulkan(window->window, true); }
 		ImGui_ImplVulkan_InitInfo init_info = {};
 		init_info.Instance = device.instance;
 		init_info.PhysicalDevice = device.gpu->device;
@@ -533,7 +685,8 @@ struct DearImGui {
 		init_info.DescriptorPool = *ret.pool;
 		init_info.Subpass = 0;
 		init_info.MinImageCount = 2;
-		init_info.ImageCount = 2;
+		// vertex / index buffers are rotated per frame: one for each frame that can be in flight
+		init_info.ImageCount = static_cast<std::uint32_t>(max_frames_in_flight_v);
 		init_info.MSAASamples = static_cast<VkSampleCountFlagBits>(vk::SampleCountFlagBits::e1);
 
 		ImGui_ImplVulkan_Init(&init_info, static_cast<VkFormat>(colour), static_cast<VkFormat>(depth));
@@ -550,7 +703,14 @@ struct DearImGui {
 	void new_frame() {
 		if (state == State::eEndFrame) { end_frame(); }
 		ImGui_ImplVulkan_NewFrame();
-		ImGui_ImplGlfw_NewFrame();
+		if (glfw) {
+			ImGui_ImplGlfw_NewFrame();
+		} else {
+			auto& io = ImGui::GetIO();
+			io.DisplaySize = ImVec2{static_cast<float>(display_size.width), static_cast<float>(display_size.height)};
+			// fixed timestep: keeps offscreen frames deterministic
+			io.DeltaTime = 1.0f / 60.0f;
+		}
 		ImGui::NewFrame();
 		state = State::eEndFrame;
 	}
@@ -568,19 +728,76 @@ struct DearImGui {
 	}
 };
 
-struct RenderCb {
-	vk::CommandBuffer cb_shadow{};
-	vk::CommandBuffer cb_3d{};
-	vk::CommandBuffer cb_ui{};
+// headless render target: each frame is copied into its slot's readback buffer, complete once the slot's submission is
+struct Offscreen {
+	static constexpr vk::DeviceSize bytes_per_pixel_v{4u};
+
+	struct Readback {
+		UniqueBuffer buffer{};
+		vk::Extent2D extent{};
+		// 0: nothing copied yet
+		std::uint64_t frame{};
+	};
+
+	RenderTarget target{};
+	Buffered<Readback> readbacks{};
+	// shared by all frames: the next frame must wait for the previous copy to finish reading it
+	vk::ImageLayout layout{vk::ImageLayout::eUndefined};
+	std::uint64_t frames{};
+	// latest frame returned by read()
+	std::uint64_t last_read{};
+
+	explicit operator bool() const { return static_cast<bool>(target.colour); }
+
+	ImageView image() const { return target.colour.get().image_view(); }
+
+	// target must be in transfer src layout
+	void copy(vk::CommandBuffer cb, std::size_t const slot) {
+		auto& readback = readbacks[slot];
+		auto const extent = target.create_info.extent;
+		auto const size = static_cast<vk::DeviceSize>(extent.width) * extent.height * bytes_per_pixel_v;
+		if (!readback.buffer || readback.buffer.get().size < size) {
+			if (readback.buffer) { target.device.defer->push(std::move(readback.buffer)); }
+			readback.buffer = target.device.vma.make_readback_buffer(size);
+		}
+		readback.extent = extent;
+		readback.frame = ++frames;
+		auto const isrl = vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, 0u, 0u, 1u};
+		auto const region = vk::BufferImageCopy{0u, 0u, 0u, isrl, {}, vk::Extent3D{extent, 1u}};
+		auto const buffer = readback.buffer.get().buffer;
+		cb.copyImageToBuffer(target.colour.get().image, vk::ImageLayout::eTransferSrcOptimal, buffer, region);
+		layout = vk::ImageLayout::eTransferSrcOptimal;
+		// read on the host after waiting for the frame's timeline value
+		auto bmb = vk::BufferMemoryBarrier2{};
+		bmb.srcStageMask = vk::PipelineStageFlagBits2::eTransfer;
+		bmb.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+		bmb.dstStageMask = vk::PipelineStageFlagBits2::eHost;
+		bmb.dstAccessMask = vk::AccessFlagBits2::eHostRead;
+		bmb.buffer = buffer;
+		bmb.size = size;
+		cb.pipelineBarrier2(vk::DependencyInfo{{}, {}, bmb, {}});
+	}
+
+	OffscreenFrame read(Readback const& readback) {
+		auto const& buffer = readback.buffer.get();
+		vmaInvalidateAllocation(buffer.allocation.vma.allocator, buffer.allocation.allocation, 0u, VK_WHOLE_SIZE);
+		auto const size = static_cast<std::size_t>(readback.extent.width * readback.extent.height * bytes_per_pixel_v);
+		auto ret = OffscreenFrame{.frame = readback.frame};
+		ret.pixels.storage = ByteArray{std::span{static_cast<std::byte const*>(buffer.mapped), size}};
+		ret.pixels.extent = {readback.extent.width, readback.extent.height};
+		last_read = readback.frame;
+		return ret;
+	}
 };
 
 struct Waiter {
 	DeviceView device{};
+	bool glfw{};
 	~Waiter() {
 		device.device.waitIdle();
 		device.defer->clear();
 		ImGui_ImplVulkan_Shutdown();
-		ImGui_ImplGlfw_Shutdown();
+		if (glfw) { ImGui_ImplGlfw_Shutdown(); }
 		ImGui::DestroyContext();
 	}
 
@@ -592,19 +809,33 @@ struct Device::Impl {
 	Ptr<glfw::Window> window{};
 	Gpu gpu{};
 	Swapchain swapchain{};
-	std::array<RenderSync, buffering_v<>> render_sync{};
+	// headless only: rendered into instead of swapchain images
+	Offscreen offscreen{};
+	Buffered<RenderSync> render_sync{};
+	// signalled with increasing values by each frame's submission
+	vk::UniqueSemaphore timeline{};
+	std::uint64_t timeline_value{};
+	// latest submission whose latency has been sampled
+	std::uint64_t latency_value{};
+	Duration frame_latency{};
 	PipelineStorage pipeline_storage{};
 	SamplerStorage sampler_storage{};
+	GeometryArena geometry_arena{};
+	// only used if the GPU has a transfer-only queue family
+	Queue transfer_queue{};
+	std::optional<UploadService> upload_service{};
 
 	CommandAllocator cmd_allocator{};
 
-	Buffered<SetAllocator> set_allocators{};
-	Buffered<ScratchBufferAllocator> scratch_buffer_allocators{};
+	// hold a set of pools / buffers per frame in flight, selected by buffered_index
+	SetAllocator set_allocator{};
+	ScratchBufferAllocator scratch_buffer_allocator{};
 
-	Buffered<RenderCb> render_cbs{};
-	DepthTarget rt_shadow{};
-	RenderTarget rt_3d{};
-	RenderTarget rt_ui{};
+	Buffered<vk::CommandBuffer> render_cbs{};
+	CommandRecorder recorder{};
+	RenderGraph render_graph{};
+	DepthTarget rt_shadow_static{};
+	vk::Format depth_format{};
 
 	DearImGui dear_imgui{};
 	DeferQueue defer{};
@@ -612,9 +843,76 @@ struct Device::Impl {
 	Index buffered_index{};
 	RenderMode default_render_mode{};
 	std::uint64_t draw_calls{};
+	OcclusionStats occlusion_stats{};
+	// hash of the scene in rt_shadow_static, if up to date
+	std::optional<std::size_t> static_shadow_hash{};
+	GpuProfiler gpu_profiler{};
+	ResolutionController resolution_controller{};
+	// render scale each buffered frame was last drawn at
+	Buffered<float> frame_scales{};
 	Waiter waiter{};
+
+	vk::Extent2D extent() const { return offscreen ? offscreen.target.create_info.extent : swapchain.info.imageExtent; }
+	vk::Format colour_format() const { return offscreen ? offscreen.target.create_info.colour : swapchain.info.imageFormat; }
 };
 
+ShadowAtlas ShadowAtlas::make(Extent2D const resolution, ShadowCascades const& cascades, std::uint32_t const max_extent) {
+	auto ret = ShadowAtlas{};
+	auto extents = FlexArray<glm::uvec2, max_shadow_cascades_v>{};
+	for (std::uint32_t i = 0; i < cascades.count; ++i) {
+		extents.insert(glm::max(glm::uvec2{glm::vec2{resolution} * cascades.resolution_scale[i]}, glm::uvec2{1u}));
+	}
+	auto const pack = [&ret, &extents] {
+		// even cascades in the left column, odd ones in the right; first two in the top row
+		auto widths = glm::uvec2{};
+		auto heights = glm::uvec2{};
+		for (std::size_t i = 0; i < extents.size(); ++i) {
+			widths[i % 2] = std::max(widths[i % 2], extents.span()[i].x);
+			heights[i / 2] = std::max(heights[i / 2], extents.span()[i].y);
+		}
+		ret.cascades.clear();
+		for (std::size_t i = 0; i < extents.size(); ++i) {
+			auto const offset = vk::Offset2D{static_cast<std::int32_t>(i % 2 ? widths[0] : 0u), static_cast<std::int32_t>(i / 2 ? heights[0] : 0u)};
+			ret.cascades.insert(vk::Rect2D{offset, {extents.span()[i].x, extents.span()[i].y}});
+		}
+		ret.extent = vk::Extent2D{widths[0] + widths[1], heights[0] + heights[1]};
+	};
+	pack();
+	auto const largest = std::max(ret.extent.width, ret.extent.height);
+	if (max_extent > 0 && largest > max_extent) {
+		auto const scale = static_cast<float>(max_extent) / static_cast<float>(largest);
+		for (auto& extent : extents.span()) { extent = glm::max(glm::uvec2{glm::vec2{extent} * scale}, glm::uvec2{1u}); }
+		pack();
+	}
+	return ret;
+}
+
+float ResolutionController::update(DynamicResolution const& config, float const scale, float const sample_scale, Duration const gpu_time) {
+	if (config.budget_ms <= 0.0f) { return scale; }
+	if (sample_scale != scale) {
+		// drawn before the last scale change: averaging it in would judge the new scale by the old cost
+		total_ms = {};
+		frames = {};
+		return scale;
+	}
+	total_ms += gpu_time.count() * 1000.0f;
+	if (++frames < config.frames) { return scale; }
+	auto const average_ms = std::exchange(total_ms, 0.0f) / static_cast<float>(std::exchange(frames, 0u));
+	auto const clamp = [&config](float const s) { return std::clamp(s, config.min_scale, config.max_scale); };
+	auto const current = clamp(std::round(scale / config.step) * config.step);
+	// GPU time grows roughly with pixel count: the square of render scale
+	auto const cost_ms = [&](float const s) { return average_ms * (s * s) / (scale * scale); };
+	if (average_ms > config.budget_ms) {
+		// drop straight to the largest step that fits the budget
+		auto const ideal = scale * std::sqrt(config.budget_ms / average_ms);
+		return clamp(std::min(std::floor(ideal / config.step) * config.step, current - config.step));
+	}
+	// rise one step at a time, and only with headroom to spare: avoids oscillating around the budget
+	auto const next = current + config.step;
+	if (next <= config.max_scale && cost_ms(next) < config.budget_ms * (1.0f - config.headroom)) { return next; }
+	return current;
+}
+
 void Device::Deleter::operator()(Impl const* ptr) const { delete ptr; }
 
 Device::Device(Window const& window, RenderDeviceCreateInfo const& create_info) {
@@ -629,64 +927,102 @@ Device::Device(Window const& window, RenderDeviceCreateInfo const& create_info)
 	if (!surface) { throw Error{"Failed to create Vulkan Surface"}; }
 
 	impl = std::unique_ptr<Impl, Deleter>(new Impl{.window = glfw_window});
+	init(create_info);
+}
+
+Device::Device(Extent2D const extent, RenderDeviceCreateInfo const& create_info) {
+	if (extent.x == 0 || extent.y == 0) { throw Error{"Invalid offscreen extent"}; }
+
+	instance = make_instance({}, create_info, device_info);
+
+	if (device_info.validation) { debug = make_debug_messenger(*instance); }
+
+	impl = std::unique_ptr<Impl, Deleter>(new Impl{});
+	impl->offscreen.target.create_info.extent = vk::Extent2D{extent.x, extent.y};
+	device_info.headless = true;
+	init(create_info);
+}
+
+void Device::init(RenderDeviceCreateInfo const& create_info) {
+	bool const headless = !surface;
 	impl->gpu = select_gpu(*instance, *surface);
+	if (!impl->gpu.device) { throw Error{"No suitable GPU found"}; }
 
-	device = make_device(impl->gpu);
+	device = make_device(impl->gpu, !headless);
 	Queue::make(queue, *device, impl->gpu.queue_family);
 
 	vma = Vma::make(*instance, impl->gpu.device, *device);
+	impl->geometry_arena.vma = vma.get();
+	auto* transfer_queue = &queue;
+	if (impl->gpu.transfer_family != impl->gpu.queue_family) {
+		Queue::make(impl->transfer_queue, *device, impl->gpu.transfer_family);
+		transfer_queue = &impl->transfer_queue;
+	}
+	impl->upload_service.emplace(view(), transfer_queue);
 
 	auto const view_ = view();
-	auto const sci = Swapchain::CreateInfo{
-		.device = view_,
-		.colour_space = create_info.swapchain,
-		.vsync = create_info.vsync,
-	};
-	impl->swapchain = Swapchain::make(sci);
-	impl->swapchain.refresh(impl->window->framebuffer_extent());
+	if (headless) {
+		// copied out as RGBA8 by readbacks, so not the swapchain formats
+		auto const colour = create_info.swapchain == ColourSpace::eSrgb ? vk::Format::eR8G8B8A8Srgb : vk::Format::eR8G8B8A8Unorm;
+		impl->offscreen.target = RenderTarget::make_off_screen(view_, {.extent = impl->offscreen.target.create_info.extent, .colour = colour});
+		g_log.info("Offscreen extent: [{}x{}] | colour space: [{}]", impl->extent().width, impl->extent().height, is_srgb(colour) ? "sRGB" : "linear");
+	} else {
+		auto const sci = Swapchain::CreateInfo{
+			.device = view_,
+			.colour_space = create_info.swapchain,
+			.vsync = create_info.vsync,
+		};
+		impl->swapchain = Swapchain::make(sci);
+		impl->swapchain.refresh(impl->window->framebuffer_extent());
+	}
 
 	for (auto& sync : impl->render_sync) { sync = RenderSync::make(view_); }
-	for (auto& buffer : impl->scratch_buffer_allocators) { buffer.vma = vma.get(); }
-	for (auto& set_allocator : impl->set_allocators) { set_allocator.device = *device; }
+	impl->timeline = make_timeline(*device);
+	impl->scratch_buffer_allocator = {.vma = vma.get(), .frame = &impl->buffered_index};
+	impl->set_allocator = {.device = *device, .frame = &impl->buffered_index};
 
-	auto const dtci = DepthTarget::CreateInfo{
-		.extent = {device_info.shadow_map_resolution.x, device_info.shadow_map_resolution.y},
-		.format = depth_format(impl->gpu.device),
-	};
-	impl->rt_shadow = DepthTarget::make(view_, dtci);
-
-	auto const rtci = RenderTarget::CreateInfo{
-		.extent = impl->swapchain.info.imageExtent,
-		.colour = impl->swapchain.info.imageFormat,
-		.depth = dtci.format,
-		.samples = from(device_info.current_aa),
-	};
-	impl->rt_3d = RenderTarget::make_off_screen(view_, rtci);
+	impl->depth_format = depth_format(impl->gpu.device);
+	impl->render_graph = RenderGraph{view_};
 
 	auto const flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer | vk::CommandPoolCreateFlagBits::eTransient;
 	impl->cmd_allocator = CommandAllocator::make(*device, impl->gpu.queue_family, flags);
-	for (auto& cb : impl->render_cbs) {
-		auto cbs = std::array<vk::CommandBuffer, 3>{};
-		impl->cmd_allocator.allocate(cbs);
-		cb.cb_shadow = cbs[0];
-		cb.cb_3d = cbs[1];
-		cb.cb_ui = cbs[2];
-	}
+	impl->cmd_allocator.allocate(impl->render_cbs);
+	impl->recorder = CommandRecorder{view_, create_info.recording_threads};
 
-	impl->dear_imgui = DearImGui::make(*glfw_window, view_, rtci.colour, {});
+	impl->dear_imgui = DearImGui::make(impl->window, view_, impl->colour_format(), {});
+	impl->dear_imgui.display_size = impl->extent();
 	impl->dear_imgui.new_frame();
 
-	device_info.supported_vsync = make_vsync(impl->gpu.device.getSurfacePresentModesKHR(*surface));
-	device_info.current_vsync = from(impl->swapchain.info.presentMode);
+	if (!headless) {
+		device_info.supported_vsync = make_vsync(impl->gpu.device.getSurfacePresentModesKHR(*surface));
+		device_info.current_vsync = from(impl->swapchain.info.presentMode);
+	}
 	device_info.supported_aa = make_aa(impl->gpu.properties);
 	device_info.current_aa = get_samples(device_info.supported_aa, create_info.anti_aliasing);
 	device_info.name = impl->gpu.properties.deviceName;
+	device_info.lod_bias = std::max(create_info.lod_bias, 0.0f);
+	device_info.occlusion_culling = create_info.occlusion_culling;
+	device_info.static_shadow_cache = create_info.static_shadow_cache;
+	device_info.shadow_cascades = create_info.shadow_cascades.clamped();
+	device_info.compute_skinning = create_info.compute_skinning;
+	device_info.dynamic_resolution = create_info.dynamic_resolution.clamped();
+	set_frames_in_flight(create_info.frames_in_flight);
+	impl->gpu_profiler = GpuProfiler{view_};
 
 	impl->waiter.device = view_;
+	impl->waiter.glfw = !headless;
 }
 
 std::uint64_t Device::draw_calls() const { return impl->draw_calls; }
 
+OcclusionStats Device::occlusion_stats() const { return impl->occlusion_stats; }
+
+GeometryArenaStats Device::geometry_arena_stats() const { return impl->geometry_arena.stats(); }
+
+Duration Device::gpu_frame_time() const { return impl->gpu_profiler.profile()[FrameProfile::Type::eFrameTime]; }
+
+Duration Device::frame_latency() const { return impl->frame_latency; }
+
 bool Device::set_vsync(Vsync desired) {
 	if (!device_info.supported_vsync.test(desired)) { return false; }
 	impl->swapchain.refresh({}, desired);
@@ -694,76 +1030,220 @@ bool Device::set_vsync(Vsync desired) {
 	return true;
 }
 
+std::uint32_t Device::set_frames_in_flight(std::uint32_t count) {
+	count = std::clamp(count, 1u, static_cast<std::uint32_t>(max_frames_in_flight_v));
+	// takes effect from the next frame: each frame waits for the previous submission from its own slot, so the GPU needn't be idle
+	impl->buffered_index.count = count;
+	device_info.frames_in_flight = count;
+	return count;
+}
+
 bool Device::render(Renderer& renderer, AssetProviders const& asset_providers) {
 	assert(impl);
 
-	auto const framebuffer_extent = impl->window->framebuffer_extent();
+	auto const framebuffer_extent = impl->window ? impl->window->framebuffer_extent() : glm::uvec2{impl->extent().width, impl->extent().height};
 	if (framebuffer_extent.x == 0 || framebuffer_extent.y == 0) { return false; }
 
 	FrameProfiler::instance().profile(FrameProfile::Type::eAcquireFrame);
-	auto sync = impl->render_sync[impl->buffered_index].view();
-	auto acquired = impl->swapchain.acquire(framebuffer_extent, sync.draw);
+	auto& render_sync = impl->render_sync[impl->buffered_index];
+	// this frame's semaphores, command buffers and per-frame resources are free once their last submission completes
+	if (render_sync.submitted > 0) {
+		auto const swi = vk::SemaphoreWaitInfo{{}, *impl->timeline, render_sync.submitted};
+		if (device->waitSemaphores(swi, std::numeric_limits<std::uint64_t>::max()) != vk::Result::eSuccess) { return false; }
+	}
+	auto const completed = device->getSemaphoreCounterValue(*impl->timeline);
+	if (impl->swapchain.present_waiter) {
+		if (auto const latency = impl->swapchain.present_waiter->latency(); latency > Duration{}) { impl->frame_latency = latency; }
+	} else if (completed > impl->latency_value) {
+		// fallback (headless, or no present wait): sampled once per frame, the latest submission found complete on the GPU
+		auto const now = Clock::now();
+		for (auto const& sync : impl->render_sync) {
+			if (sync.submitted > impl->latency_value && sync.submitted <= completed) {
+				impl->latency_value = sync.submitted;
+				impl->frame_latency = now - sync.submit_time;
+			}
+		}
+	}
+
+	auto sync = render_sync.view();
+	bool const headless = static_cast<bool>(impl->offscreen);
+	auto const acquired = headless ? impl->offscreen.image() : impl->swapchain.acquire(framebuffer_extent, sync.draw);
 	if (!acquired) { return false; }
 
-	if (device->waitForFences(sync.drawn, true, std::numeric_limits<std::uint64_t>::max()) != vk::Result::eSuccess) { return false; }
-	device->resetFences(sync.drawn);
+	// this frame's previous submission has completed: its timestamps are available
+	if (impl->gpu_profiler.resolve()) {
+		auto const& gpu_profile = impl->gpu_profiler.profile();
+		FrameProfiler::instance().gpu_profile = gpu_profile;
+		auto const gpu_frame_time = gpu_profile[FrameProfile::Type::eFrameTime];
+		auto const frame_scale = impl->frame_scales[impl->buffered_index];
+		device_info.render_scale = impl->resolution_controller.update(device_info.dynamic_resolution, device_info.render_scale, frame_scale, gpu_frame_time);
+	}
 
 	impl->draw_calls = {};
-	impl->scratch_buffer_allocators[impl->buffered_index].clear();
-	impl->set_allocators[impl->buffered_index].reset_all();
+	impl->scratch_buffer_allocator.clear();
+	impl->set_allocator.reset_all();
+	impl->recorder.next_frame();
 
 	renderer.asset_providers = &asset_providers;
+	renderer.lod_bias = device_info.lod_bias;
+	renderer.occlusion_culling = device_info.occlusion_culling;
+	renderer.static_shadow_cache = device_info.static_shadow_cache;
+	renderer.shadow_cascades = device_info.shadow_cascades;
+	auto const max_extent = impl->gpu.properties.limits.maxImageDimension2D;
+	renderer.shadow_atlas = ShadowAtlas::make(device_info.shadow_map_resolution, device_info.shadow_cascades, max_extent);
+	renderer.framebuffer_extent = {impl->extent().width, impl->extent().height};
+	renderer.compute_skinning = device_info.compute_skinning;
 	renderer.next_frame();
+	impl->occlusion_stats = renderer.occlusion_stats;
+
+	using Access = RenderGraph::Access;
+	auto& graph = impl->render_graph;
+	auto& recorder = impl->recorder;
+	auto const clear_colour = device_info.clear_colour.to_vec4();
+	// several graph passes may record one profiled section
+	auto const profile = [](FrameProfile::Type const type) {
+		auto& profiler = FrameProfiler::instance();
+		if (profiler.previous_type != type) { profiler.profile(type); }
+	};
 
-	auto render_cb = impl->render_cbs[impl->buffered_index];
-	auto cbis = FlexArray<vk::CommandBufferSubmitInfo, 4>{};
-	auto shadow_image = asset_providers.texture().white()->vulkan_texture()->image.get().get().image_view();
+	graph.begin();
+	// headless: the target is copied into a readback buffer after the graph, and that copy (from the previous frame) is its last access
+	auto const backbuffer = graph.import({
+		.image = *acquired,
+		.initial = headless ? impl->offscreen.layout : vk::ImageLayout::eUndefined,
+		.final = headless ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::ePresentSrcKHR,
+		.stages = headless ? vk::PipelineStageFlagBits2::eTransfer : vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+	});
+
+	auto skinned = std::optional<RenderGraph::Buffer>{};
+	if (device_info.compute_skinning) {
+		skinned = graph.buffer();
+		graph.add_pass([&renderer](RenderGraph::Context const& context) { renderer.render_skinning(context.cb); }).use(*skinned, Access::eStorageWrite);
+	}
+	auto const draws_skinned = [&skinned](RenderGraph::Pass& pass) {
+		if (skinned) { pass.use(*skinned, Access::eVertexInput); }
+	};
+
+	auto shadow_map = std::optional<RenderGraph::Image>{};
 	bool const draw_shadow = device_info.shadow_map_resolution.x > 0u && device_info.shadow_map_resolution.y > 0u;
 	if (draw_shadow) {
-		FrameProfiler::instance().profile(FrameProfile::Type::eRenderShadowMap);
-		auto fb_shadow = impl->rt_shadow.refresh({device_info.shadow_map_resolution.x, device_info.shadow_map_resolution.y});
-		render_cb.cb_shadow.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
-		fb_shadow.undef_to_optimal(render_cb.cb_shadow);
-		fb_shadow.begin_render(render_cb.cb_shadow);
-		renderer.render_shadow(render_cb.cb_shadow, fb_shadow);
-		fb_shadow.end_render(render_cb.cb_shadow);
-		fb_shadow.optimal_to_read_only(render_cb.cb_shadow);
-		render_cb.cb_shadow.end();
-		cbis.insert(render_cb.cb_shadow);
-		shadow_image = fb_shadow.image;
-	}
-
-	FrameProfiler::instance().profile(FrameProfile::Type::eRender3D);
-	auto fb_3d = impl->rt_3d.refresh(scaled(impl->swapchain.info.imageExtent, device_info.render_scale));
-	render_cb.cb_3d.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
-	fb_3d.undef_to_optimal(render_cb.cb_3d);
-	fb_3d.begin_render(device_info.clear_colour.to_vec4(), render_cb.cb_3d);
-	renderer.render_3d(render_cb.cb_3d, fb_3d, shadow_image);
-	fb_3d.end_render(render_cb.cb_3d);
-	fb_3d.optimal_to_read_only(render_cb.cb_3d);
-	render_cb.cb_3d.end();
-	cbis.insert(render_cb.cb_3d);
-
-	FrameProfiler::instance().profile(FrameProfile::Type::eRenderUI);
-	auto fb_ui = Framebuffer{.colour = *acquired};
-	render_cb.cb_ui.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
-	fb_ui.undef_to_optimal(render_cb.cb_ui);
-	fb_ui.begin_render(device_info.clear_colour.to_vec4(), render_cb.cb_ui);
-	renderer.render_ui(render_cb.cb_ui, fb_ui, fb_3d.output());
-	impl->dear_imgui.render(render_cb.cb_ui);
-	fb_ui.end_render(render_cb.cb_ui);
-	fb_ui.optimal_to_present(render_cb.cb_ui);
-	render_cb.cb_ui.end();
-	cbis.insert(render_cb.cb_ui);
+		auto const shadow_extent = renderer.shadow_atlas.extent;
+		shadow_map = graph.create({.extent = shadow_extent, .format = impl->depth_format});
+		auto const record_shadow = [&](RenderGraph::Context const& context, RenderGraph::Image image, bool clear, Renderer::ShadowLayer layer) {
+			profile(FrameProfile::Type::eRenderShadowMap);
+			auto depthbuffer = Depthbuffer{.image = context.image(image)};
+			depthbuffer.begin_render(context.cb, recorder.rendering_flags(), clear);
+			recorder.begin(context.cb, depthbuffer.pipeline_format());
+			renderer.render_shadow(recorder, depthbuffer, layer);
+			recorder.end();
+			depthbuffer.end_render(context.cb);
+		};
+		if (device_info.static_shadow_cache) {
+			if (!impl->rt_shadow_static.device.device) {
+				impl->rt_shadow_static = DepthTarget::make(view(), {.extent = shadow_extent, .format = impl->depth_format});
+			}
+			// a resized target has lost its contents
+			if (impl->rt_shadow_static.create_info.extent != shadow_extent) { impl->static_shadow_hash.reset(); }
+			auto const fb_static = impl->rt_shadow_static.refresh(shadow_extent);
+			bool const stale = impl->static_shadow_hash != renderer.static_shadow_hash;
+			// kept in transfer src layout between frames
+			auto const static_layer = graph.import({
+				.image = fb_static.image,
+				.initial = stale ? vk::ImageLayout::eUndefined : vk::ImageLayout::eTransferSrcOptimal,
+				.final = vk::ImageLayout::eTransferSrcOptimal,
+			});
+			if (stale) {
+				auto pass = graph.add_pass([record_shadow, static_layer](RenderGraph::Context const& context) {
+					record_shadow(context, static_layer, true, Renderer::ShadowLayer::eStatic);
+				});
+				pass.use(static_layer, Access::eDepthAttachment).profile(FrameProfile::Type::eRenderShadowMap);
+				draws_skinned(pass);
+				impl->static_shadow_hash = renderer.static_shadow_hash;
+			}
+			auto copy = graph.add_pass([&](RenderGraph::Context const& context) {
+				Depthbuffer{.image = context.image(*shadow_map)}.copy_from(context.cb, Depthbuffer{.image = context.image(static_layer)});
+			});
+			copy.use(static_layer, Access::eTransferSrc).use(*shadow_map, Access::eTransferDst).profile(FrameProfile::Type::eRenderShadowMap);
+			auto pass = graph.add_pass([&](RenderGraph::Context const& context) {
+				record_shadow(context, *shadow_map, false, Renderer::ShadowLayer::eDynamic);
+			});
+			pass.use(*shadow_map, Access::eDepthAttachment).profile(FrameProfile::Type::eRenderShadowMap);
+			draws_skinned(pass);
+		} else {
+			impl->static_shadow_hash.reset();
+			auto pass = graph.add_pass([&](RenderGraph::Context const& context) { record_shadow(context, *shadow_map, true, Renderer::ShadowLayer::eAll); });
+			pass.use(*shadow_map, Access::eDepthAttachment).profile(FrameProfile::Type::eRenderShadowMap);
+			draws_skinned(pass);
+		}
+	}
+
+	auto const extent_3d = scaled(impl->extent(), device_info.render_scale);
+	impl->frame_scales[impl->buffered_index] = device_info.render_scale;
+	auto const samples = from(device_info.current_aa);
+	auto const colour_3d = graph.create({.extent = extent_3d, .format = impl->colour_format(), .samples = samples});
+	auto const depth_3d = graph.create({.extent = extent_3d, .format = impl->depth_format, .samples = samples});
+	auto resolve_3d = std::optional<RenderGraph::Image>{};
+	if (samples > vk::SampleCountFlagBits::e1) { resolve_3d = graph.create({.extent = extent_3d, .format = impl->colour_format()}); }
+	auto const output_3d = resolve_3d.value_or(colour_3d);
+	auto const white = asset_providers.texture().white()->vulkan_texture()->image.get().get().image_view();
+	auto pass_3d = graph.add_pass([&](RenderGraph::Context const& context) {
+		profile(FrameProfile::Type::eRender3D);
+		auto fb_3d = Framebuffer{.colour = context.image(colour_3d), .depth = context.image(depth_3d), .samples = samples};
+		if (resolve_3d) { fb_3d.resolve = context.image(*resolve_3d); }
+		fb_3d.begin_render(clear_colour, context.cb, recorder.rendering_flags());
+		recorder.begin(context.cb, fb_3d.pipeline_format());
+		renderer.render_3d(recorder, fb_3d, shadow_map ? context.image(*shadow_map) : white);
+		recorder.end();
+		fb_3d.end_render(context.cb);
+	});
+	pass_3d.use(colour_3d, Access::eColourAttachment).use(depth_3d, Access::eDepthAttachment).profile(FrameProfile::Type::eRender3D);
+	if (resolve_3d) { pass_3d.use(*resolve_3d, Access::eColourAttachment); }
+	if (shadow_map) { pass_3d.use(*shadow_map, Access::eSampled); }
+	draws_skinned(pass_3d);
+
+	auto pass_ui = graph.add_pass([&](RenderGraph::Context const& context) {
+		profile(FrameProfile::Type::eRenderUI);
+		auto fb_ui = Framebuffer{.colour = context.image(backbuffer)};
+		fb_ui.begin_render(clear_colour, context.cb, recorder.rendering_flags());
+		recorder.begin(context.cb, fb_ui.pipeline_format());
+		renderer.render_ui(recorder, fb_ui, context.image(output_3d));
+		recorder.record([this](CommandRecorder::Context const& context) { impl->dear_imgui.render(context.cb); });
+		recorder.end();
+		fb_ui.end_render(context.cb);
+	});
+	pass_ui.use(output_3d, Access::eSampled).use(backbuffer, Access::eColourAttachment).profile(FrameProfile::Type::eRenderUI);
+
+	graph.compile();
+	auto const cb = impl->render_cbs[impl->buffered_index];
+	cb.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+	impl->gpu_profiler.begin_frame(cb);
+	graph.execute(cb, &impl->gpu_profiler);
+	if (headless) { impl->offscreen.copy(cb, impl->buffered_index); }
+	impl->gpu_profiler.end_frame(cb);
+	cb.end();
 
 	FrameProfiler::instance().profile(FrameProfile::Type::eRenderSubmit);
-	auto const wsi = vk::SemaphoreSubmitInfo{sync.draw, {}, vk::PipelineStageFlagBits2::eColorAttachmentOutput};
-	auto const ssi = vk::SemaphoreSubmitInfo{sync.present, {}, vk::PipelineStageFlagBits2::eColorAttachmentOutput};
-	auto submit_info = vk::SubmitInfo2{{}, wsi, cbis, ssi};
-	queue.with([&](vk::Queue queue) { queue.submit2(submit_info, sync.drawn); });
+	// uploads recorded up to now are submitted, and waited on by the GPU instead of the render thread
+	auto const uploaded = impl->upload_service->flush();
+	auto const wsis = std::array{
+		vk::SemaphoreSubmitInfo{sync.draw, {}, vk::PipelineStageFlagBits2::eColorAttachmentOutput},
+		vk::SemaphoreSubmitInfo{impl->upload_service->timeline(), uploaded, vk::PipelineStageFlagBits2::eAllCommands},
+	};
+	render_sync.submitted = ++impl->timeline_value;
+	auto const ssis = std::array{
+		vk::SemaphoreSubmitInfo{sync.present, {}, vk::PipelineStageFlagBits2::eColorAttachmentOutput},
+		vk::SemaphoreSubmitInfo{*impl->timeline, render_sync.submitted, vk::PipelineStageFlagBits2::eAllCommands},
+	};
+	// headless: nothing was acquired and nothing will be presented, only the timelines are used
+	auto const waits = std::span{wsis}.subspan(headless ? 1u : 0u);
+	auto const signals = std::span{ssis}.subspan(headless ? 1u : 0u);
+	auto const cbsi = vk::CommandBufferSubmitInfo{cb};
+	auto submit_info = vk::SubmitInfo2{{}, waits, cbsi, signals};
+	render_sync.submit_time = Clock::now();
+	queue.with([&](vk::Queue queue) { queue.submit2(submit_info); });
 
 	FrameProfiler::instance().profile(FrameProfile::Type::eRenderPresent);
-	auto const ret = impl->swapchain.present(framebuffer_extent, sync.present);
+	auto const ret = headless || impl->swapchain.present(framebuffer_extent, sync.present, render_sync.submit_time);
 
 	FrameProfiler::instance().finish();
 
@@ -774,6 +1254,20 @@ bool Device::render(Renderer& renderer, AssetProviders const& asset_providers) {
 	return ret;
 }
 
+std::optional<OffscreenFrame> Device::read_offscreen() {
+	if (!impl->offscreen) { return {}; }
+	auto const completed = device->getSemaphoreCounterValue(*impl->timeline);
+	auto latest = Ptr<Offscreen::Readback const>{};
+	// a slot's readback is overwritten together with its submitted value, so the pair is always consistent
+	for (auto const [sync, index] : enumerate(impl->render_sync)) {
+		auto const& readback = impl->offscreen.readbacks[index];
+		if (sync.submitted == 0 || sync.submitted > completed || readback.frame <= impl->offscreen.last_read) { continue; }
+		if (!latest || readback.frame > latest->frame) { latest = &readback; }
+	}
+	if (!latest) { return {}; }
+	return impl->offscreen.read(*latest);
+}
+
 auto Device::view() -> View {
 	return View{
 		.instance = *instance,
@@ -784,10 +1278,12 @@ auto Device::view() -> View {
 		.default_render_mode = impl->default_render_mode,
 		.queue = &queue,
 		.defer = &impl->defer,
-		.set_allocator = &impl->set_allocators[impl->buffered_index],
-		.scratch_buffer_allocator = &impl->scratch_buffer_allocators[impl->buffered_index],
+		.set_allocator = &impl->set_allocator,
+		.scratch_buffer_allocator = &impl->scratch_buffer_allocator,
 		.pipeline_storage = &impl->pipeline_storage,
 		.sampler_storage = &impl->sampler_storage,
+		.geometry_arena = &impl->geometry_arena,
+		.upload_service = impl->upload_service ? &*impl->upload_service : nullptr,
 		.buffered_index = &impl->buffered_index,
 		.draw_calls = &impl->draw_calls,
 	};
@@ -14,19 +14,53 @@ struct CopyImage {
 
 struct Framebuffer;
 struct Depthbuffer;
+class CommandRecorder;
+
+// shadow cascades packed two per row into a single depth image
+struct ShadowAtlas {
+	FlexArray<vk::Rect2D, max_shadow_cascades_v> cascades{};
+	vk::Extent2D extent{};
+
+	// cascades are scaled down uniformly if the atlas would exceed max_extent
+	static ShadowAtlas make(Extent2D resolution, ShadowCascades const& cascades, std::uint32_t max_extent);
+};
+
+// moves render scale toward a GPU frame time budget, in whole steps
+struct ResolutionController {
+	float total_ms{};
+	std::uint32_t frames{};
+
+	// sample_scale: render scale the timed frame was drawn at, which lags scale by the frames in flight
+	float update(DynamicResolution const& config, float scale, float sample_scale, Duration gpu_time);
+};
 
 struct Device {
 	using View = DeviceView;
 
 	struct Renderer {
+		// eAll: every caster, eStatic / eDynamic: cached static layer / casters composited on top of it
+		enum class ShadowLayer { eAll, eStatic, eDynamic };
+
 		virtual ~Renderer() = default;
 
 		Ptr<AssetProviders const> asset_providers{};
+		float lod_bias{1.0f};
+		bool occlusion_culling{};
+		glm::uvec2 framebuffer_extent{};
+		OcclusionStats occlusion_stats{};
+		bool static_shadow_cache{};
+		ShadowCascades shadow_cascades{};
+		ShadowAtlas shadow_atlas{};
+		// set by next_frame: the cached static shadow layer is re-rendered whenever this changes
+		std::size_t static_shadow_hash{};
+		bool compute_skinning{};
 
 		virtual void next_frame() = 0;
-		virtual void render_shadow(vk::CommandBuffer cb, Depthbuffer& depthbuffer) = 0;
-		virtual void render_3d(vk::CommandBuffer cb, Framebuffer& framebuffer, ImageView const& shadow_map) = 0;
-		virtual void render_ui(vk::CommandBuffer cb, Framebuffer& framebuffer, ImageView const& output_3d) = 0;
+		// recorded before every pass that draws geometry, if compute_skinning is set
+		virtual void render_skinning(vk::CommandBuffer cb) = 0;
+		virtual void render_shadow(CommandRecorder& recorder, Depthbuffer& depthbuffer, ShadowLayer layer) = 0;
+		virtual void render_3d(CommandRecorder& recorder, Framebuffer& framebuffer, ImageView const& shadow_map) = 0;
+		virtual void render_ui(CommandRecorder& recorder, Framebuffer& framebuffer, ImageView const& output_3d) = 0;
 	};
 
 	struct Impl;
@@ -35,6 +69,8 @@ struct Device {
 	};
 
 	Device(Window const& window, RenderDeviceCreateInfo const& create_info);
+	// headless
+	Device(Extent2D extent, RenderDeviceCreateInfo const& create_info);
 
 	RenderDeviceInfo device_info{};
 
@@ -50,10 +86,23 @@ struct Device {
 
 	RenderDeviceInfo const& info() const { return device_info; }
 	std::uint64_t draw_calls() const;
+	OcclusionStats occlusion_stats() const;
+	GeometryArenaStats geometry_arena_stats() const;
+	Duration gpu_frame_time() const;
+	Duration frame_latency() const;
 
 	bool set_vsync(Vsync desired);
+	std::uint32_t set_frames_in_flight(std::uint32_t count);
 	bool render(Renderer& renderer, AssetProviders const& asset_providers);
+	std::optional<OffscreenFrame> read_offscreen();
 
 	View view();
+
+  private:
+	// everything after instance / surface creation
+	void init(RenderDeviceCreateInfo const& create_info);
 };
+
+// a null view for a null RenderDevice: resources created with it keep their metadata, without any GPU objects
+DeviceView view_of(RenderDevice const& render_device);
 } // namespace levk::vulkan
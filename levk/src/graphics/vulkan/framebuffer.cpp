@@ -1,6 +1,7 @@
 #include <graphics/vulkan/framebuffer.hpp>
 #include <graphics/vulkan/image_barrier.hpp>
 #include <levk/util/flex_array.hpp>
+#include <array>
 
 namespace levk::vulkan {
 PipelineFormat Framebuffer::pipeline_format() const {
@@ -50,8 +51,9 @@ void Framebuffer::set_output(ImageView acquired) {
 	}
 }
 
-void Framebuffer::begin_render(std::optional<glm::vec4> const& clear, vk::CommandBuffer cb) {
+void Framebuffer::begin_render(std::optional<glm::vec4> const& clear, vk::CommandBuffer cb, vk::RenderingFlags flags) {
 	auto ri = vk::RenderingInfo{};
+	ri.flags = flags;
 	ri.renderArea = vk::Rect2D{{}, output().extent};
 	ri.layerCount = 1u;
 
@@ -93,13 +95,21 @@ PipelineFormat Depthbuffer::pipeline_format() const {
 void Depthbuffer::undef_to_optimal(vk::CommandBuffer cb) const { ImageBarrier{image.image}.set_undef_to_optimal(true).transition(cb); }
 void Depthbuffer::optimal_to_read_only(vk::CommandBuffer cb) const { ImageBarrier{image.image}.set_optimal_to_read_only(true).transition(cb); }
 
-void Depthbuffer::begin_render(vk::CommandBuffer cb) {
+void Depthbuffer::copy_from(vk::CommandBuffer cb, Depthbuffer const& src) const {
+	assert(src.image.extent == image.extent);
+	auto const isrl = vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eDepth, 0, 0, 1};
+	auto const ic = vk::ImageCopy{isrl, {}, isrl, {}, vk::Extent3D{image.extent, 1}};
+	cb.copyImage(src.image.image, vk::ImageLayout::eTransferSrcOptimal, image.image, vk::ImageLayout::eTransferDstOptimal, ic);
+}
+
+void Depthbuffer::begin_render(vk::CommandBuffer cb, vk::RenderingFlags flags, bool clear) {
 	auto ri = vk::RenderingInfo{};
+	ri.flags = flags;
 	ri.renderArea = vk::Rect2D{{}, image.extent};
 	ri.layerCount = 1u;
 
 	auto depth_attachment = vk::RenderingAttachmentInfo{image.view, vk::ImageLayout::eAttachmentOptimal};
-	depth_attachment.loadOp = vk::AttachmentLoadOp::eClear;
+	depth_attachment.loadOp = clear ? vk::AttachmentLoadOp::eClear : vk::AttachmentLoadOp::eLoad;
 	depth_attachment.storeOp = vk::AttachmentStoreOp::eStore;
 	depth_attachment.clearValue = vk::ClearDepthStencilValue{1.0f, 0};
 	ri.pDepthAttachment = &depth_attachment;
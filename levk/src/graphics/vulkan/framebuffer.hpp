@@ -21,7 +21,7 @@ struct Framebuffer {
 	void transfer_dst_to_present(vk::CommandBuffer cb) const;
 
 	void set_output(ImageView acquired);
-	void begin_render(std::optional<glm::vec4> const& clear, vk::CommandBuffer cb);
+	void begin_render(std::optional<glm::vec4> const& clear, vk::CommandBuffer cb, vk::RenderingFlags flags = {});
 	void end_render(vk::CommandBuffer cb);
 };
 
@@ -33,8 +33,10 @@ struct Depthbuffer {
 
 	void undef_to_optimal(vk::CommandBuffer cb) const;
 	void optimal_to_read_only(vk::CommandBuffer cb) const;
+	// overwrites this image with src's depth: src must be in transfer src, this in transfer dst layout
+	void copy_from(vk::CommandBuffer cb, Depthbuffer const& src) const;
 
-	void begin_render(vk::CommandBuffer cb);
+	void begin_render(vk::CommandBuffer cb, vk::RenderingFlags flags = {}, bool clear = true);
 	void end_render(vk::CommandBuffer cb);
 };
 } // namespace levk::vulkan
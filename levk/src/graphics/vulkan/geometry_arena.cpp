@@ -0,0 +1,160 @@
+#include <graphics/vulkan/geometry_arena.hpp>
+#include <levk/util/error.hpp>
+#include <algorithm>
+
+namespace levk::vulkan {
+namespace {
+constexpr std::uint32_t word_size_v{sizeof(std::uint32_t)};
+} // namespace
+
+FreeList::FreeList(std::uint32_t capacity) : m_capacity(capacity) {
+	if (capacity > 0) { m_free.push_back({0, capacity}); }
+}
+
+std::optional<std::uint32_t> FreeList::allocate(std::uint32_t size) {
+	if (size == 0) { return 0u; }
+	// first fit: keeps allocations packed towards the front
+	auto it = std::ranges::find_if(m_free, [size](Range const& range) { return range.size >= size; });
+	if (it == m_free.end()) { return {}; }
+	auto const ret = it->offset;
+	if (it->size == size) {
+		m_free.erase(it);
+	} else {
+		it->offset += size;
+		it->size -= size;
+	}
+	return ret;
+}
+
+void FreeList::release(Range range) {
+	if (range.size == 0) { return; }
+	assert(range.offset + range.size <= m_capacity);
+	auto it = std::ranges::lower_bound(m_free, range.offset, {}, &Range::offset);
+	it = m_free.insert(it, range);
+	// coalesce with next and previous neighbours
+	if (auto next = it + 1; next != m_free.end() && it->offset + it->size == next->offset) {
+		it->size += next->size;
+		m_free.erase(next);
+	}
+	if (it != m_free.begin()) {
+		if (auto prev = it - 1; prev->offset + prev->size == it->offset) {
+			prev->size += it->size;
+			m_free.erase(it);
+		}
+	}
+}
+
+std::uint32_t FreeList::free_size() const {
+	auto ret = std::uint32_t{};
+	for (auto const& range : m_free) { ret += range.size; }
+	return ret;
+}
+
+std::uint32_t FreeList::largest_free() const {
+	auto ret = std::uint32_t{};
+	for (auto const& range : m_free) { ret = std::max(ret, range.size); }
+	return ret;
+}
+
+void GeometryArena::Deleter::operator()(Allocation const& allocation) const {
+	if (allocation.arena) { allocation.arena->release(allocation); }
+}
+
+auto GeometryArena::allocate(GeometryLayout& out_layout, VertexStreams const& streams) -> UniqueAllocation {
+	auto const vertices = out_layout.vertices;
+	auto const size = index_size(out_layout.index_type);
+	auto const index_words = (out_layout.indices * size + word_size_v - 1) / word_size_v;
+
+	auto lock = std::scoped_lock{mutex};
+	auto ret = std::optional<Allocation>{};
+	for (std::size_t i = 0; i < blocks.size() && !ret; ++i) {
+		if (blocks[i].streams != streams) { continue; }
+		ret = try_allocate(i, vertices, index_words);
+	}
+	if (!ret) {
+		blocks.push_back(make_block(streams, std::max(vertices, block_vertices_v), std::max(index_words, block_index_words_v)));
+		ret = try_allocate(blocks.size() - 1, vertices, index_words);
+		if (!ret) { throw Error{"Failed to allocate geometry from arena"}; }
+	}
+
+	auto const& block = blocks[ret->block];
+	out_layout.offsets = block.offsets;
+	out_layout.vertex_offset = static_cast<std::int32_t>(ret->vertices.offset);
+	out_layout.first_index = ret->index_words.offset * (word_size_v / size);
+	return UniqueAllocation{*ret, Deleter{}};
+}
+
+void GeometryArena::release(Allocation const& allocation) {
+	auto lock = std::scoped_lock{mutex};
+	assert(allocation.block < blocks.size());
+	auto& block = blocks[allocation.block];
+	block.vertices.release(allocation.vertices);
+	block.index_words.release(allocation.index_words);
+	assert(block.allocations > 0);
+	--block.allocations;
+}
+
+GeometryArenaStats GeometryArena::stats() const {
+	auto lock = std::scoped_lock{mutex};
+	auto ret = GeometryArenaStats{.blocks = blocks.size()};
+	auto free_bytes = std::uint64_t{};
+	auto largest_bytes = std::uint64_t{};
+	for (auto const& block : blocks) {
+		ret.capacity += block.buffer.get().size;
+		ret.allocations += block.allocations;
+		auto const vertex_stride = std::uint64_t{block.streams.vertex_stride()};
+		auto const vertex_free = std::uint64_t{block.vertices.free_size()} * vertex_stride;
+		auto const index_free = std::uint64_t{block.index_words.free_size()} * word_size_v;
+		ret.used += block.buffer.get().size - vertex_free - index_free;
+		free_bytes += vertex_free + index_free;
+		largest_bytes += std::uint64_t{block.vertices.largest_free()} * vertex_stride;
+		largest_bytes += std::uint64_t{block.index_words.largest_free()} * word_size_v;
+	}
+	if (free_bytes > 0) { ret.fragmentation = 1.0f - static_cast<float>(static_cast<double>(largest_bytes) / static_cast<double>(free_bytes)); }
+	return ret;
+}
+
+auto GeometryArena::try_allocate(std::size_t index, std::uint32_t vertices, std::uint32_t index_words) -> std::optional<Allocation> {
+	auto& block = blocks[index];
+	auto const vertex_offset = block.vertices.allocate(vertices);
+	if (!vertex_offset) { return {}; }
+	auto const word_offset = block.index_words.allocate(index_words);
+	if (!word_offset) {
+		block.vertices.release({*vertex_offset, vertices});
+		return {};
+	}
+	++block.allocations;
+	return Allocation{
+		.arena = this,
+		.buffer = block.buffer.get().buffer,
+		.block = index,
+		.vertices = {*vertex_offset, vertices},
+		.index_words = {*word_offset, index_words},
+	};
+}
+
+auto GeometryArena::make_block(VertexStreams const& streams, std::uint32_t vertices, std::uint32_t index_words) const -> Block {
+	// skinned blocks are also read as storage buffers by SkinningPass
+	static constexpr auto usage_v = vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst |
+									vk::BufferUsageFlagBits::eStorageBuffer;
+	auto ret = Block{
+		.streams = streams,
+		.vertices = FreeList{vertices},
+		.index_words = FreeList{index_words},
+	};
+	// one stream per attribute, each large enough for every vertex in the block: vertexOffset indexes all of them
+	auto offset = std::size_t{};
+	auto const stream = [&offset, vertices](VertexStreams::Stream const& stream) { return std::exchange(offset, offset + stream.stride * vertices); };
+	ret.offsets.positions = stream(streams.positions);
+	ret.offsets.rgbs = stream(streams.rgbs);
+	ret.offsets.normals = stream(streams.normals);
+	ret.offsets.uvs = stream(streams.uvs);
+	ret.offsets.joints = stream(streams.joints);
+	ret.offsets.weights = stream(streams.weights);
+	ret.offsets.indices = offset;
+	offset += std::size_t{index_words} * word_size_v;
+	ret.buffer = vma.make_buffer(usage_v, offset, false);
+	if (!ret.buffer.get().buffer) { throw Error{"Failed to create Vulkan geometry buffer"}; }
+	return ret;
+}
+} // namespace levk::vulkan
@@ -0,0 +1,74 @@
+#pragma once
+#include <graphics/vulkan/common.hpp>
+#include <graphics/vulkan/vertex_format.hpp>
+#include <levk/graphics/render_device.hpp>
+#include <mutex>
+
+namespace levk::vulkan {
+class FreeList {
+  public:
+	struct Range {
+		std::uint32_t offset{};
+		std::uint32_t size{};
+
+		bool operator==(Range const&) const = default;
+	};
+
+	FreeList(std::uint32_t capacity = {});
+
+	std::optional<std::uint32_t> allocate(std::uint32_t size);
+	void release(Range range);
+
+	std::uint32_t capacity() const { return m_capacity; }
+	std::uint32_t free_size() const;
+	std::uint32_t largest_free() const;
+
+  private:
+	std::vector<Range> m_free{};
+	std::uint32_t m_capacity{};
+};
+
+struct GeometryArena {
+	static constexpr std::uint32_t block_vertices_v{1u << 18};
+	// index ranges are tracked in 32-bit words, so 16-bit and 32-bit index buffers can share a block
+	static constexpr std::uint32_t block_index_words_v{1u << 20};
+
+	struct Block {
+		UniqueBuffer buffer{};
+		VertexStreams streams{};
+		GeometryOffsets offsets{};
+		FreeList vertices{};
+		FreeList index_words{};
+		std::size_t allocations{};
+	};
+
+	struct Allocation {
+		Ptr<GeometryArena> arena{};
+		vk::Buffer buffer{};
+		std::size_t block{};
+		FreeList::Range vertices{};
+		FreeList::Range index_words{};
+
+		bool operator==(Allocation const&) const = default;
+	};
+
+	struct Deleter {
+		void operator()(Allocation const& allocation) const;
+	};
+
+	using UniqueAllocation = Unique<Allocation, Deleter>;
+
+	Vma vma{};
+	std::vector<Block> blocks{};
+	mutable std::mutex mutex{};
+
+	UniqueAllocation allocate(GeometryLayout& out_layout, VertexStreams const& streams);
+	void release(Allocation const& allocation);
+
+	GeometryArenaStats stats() const;
+
+  private:
+	std::optional<Allocation> try_allocate(std::size_t block, std::uint32_t vertices, std::uint32_t index_words);
+	Block make_block(VertexStreams const& streams, std::uint32_t vertices, std::uint32_t index_words) const;
+};
+} // namespace levk::vulkan
@@ -0,0 +1,72 @@
+#include <graphics/vulkan/gpu_profiler.hpp>
+
+namespace levk::vulkan {
+namespace {
+constexpr auto max_queries_v = 2u + 2u * GpuProfiler::max_sections_v;
+} // namespace
+
+GpuProfiler::GpuProfiler(DeviceView const& device) : m_device(device) {
+	auto const bits = device.gpu->device.getQueueFamilyProperties()[device.gpu->queue_family].timestampValidBits;
+	auto const period = device.gpu->properties.limits.timestampPeriod;
+	if (bits == 0 || period <= 0.0f) { return; }
+	for (auto& frame : m_frames) { frame.pool = device.device.createQueryPoolUnique(vk::QueryPoolCreateInfo{{}, vk::QueryType::eTimestamp, max_queries_v}); }
+	m_period = period;
+	m_mask = bits >= 64 ? ~std::uint64_t{} : (std::uint64_t{1} << bits) - 1;
+}
+
+bool GpuProfiler::resolve() {
+	if (!*this) { return false; }
+	auto& frame = current();
+	if (frame.queries == 0) { return false; }
+	auto ticks = std::array<std::uint64_t, max_queries_v>{};
+	auto const size = frame.queries * sizeof(std::uint64_t);
+	auto const flags = vk::QueryResultFlagBits::e64;
+	if (m_device.device.getQueryPoolResults(*frame.pool, 0u, frame.queries, size, ticks.data(), sizeof(std::uint64_t), flags) != vk::Result::eSuccess) {
+		return false;
+	}
+	auto const elapsed = [&](std::uint32_t const first) {
+		auto const ns = static_cast<float>((ticks[first + 1] - ticks[first]) & m_mask) * m_period;
+		return Duration{ns * 1e-9f};
+	};
+	m_profile = {};
+	m_profile[Type::eFrameTime] = elapsed(0u);
+	for (auto const [type, index] : enumerate(frame.sections)) { m_profile[type] += elapsed(2u + 2u * static_cast<std::uint32_t>(index)); }
+	frame.queries = 0;
+	return true;
+}
+
+void GpuProfiler::begin_frame(vk::CommandBuffer cb) {
+	if (!*this) { return; }
+	auto& frame = current();
+	frame.sections.clear();
+	frame.queries = 2u;
+	cb.resetQueryPool(*frame.pool, 0u, max_queries_v);
+	cb.writeTimestamp2(vk::PipelineStageFlagBits2::eNone, *frame.pool, 0u);
+}
+
+void GpuProfiler::end_frame(vk::CommandBuffer cb) {
+	if (!*this) { return; }
+	cb.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, *current().pool, 1u);
+}
+
+void GpuProfiler::begin(vk::CommandBuffer cb, Type const type) {
+	if (!*this) { return; }
+	auto& frame = current();
+	if (frame.sections.size() >= max_sections_v) { return; }
+	frame.sections.push_back(type);
+	write(cb, vk::PipelineStageFlagBits2::eNone);
+}
+
+void GpuProfiler::end(vk::CommandBuffer cb) {
+	if (!*this) { return; }
+	auto const& frame = current();
+	// section was dropped in begin()
+	if (frame.queries % 2 == 0) { return; }
+	write(cb, vk::PipelineStageFlagBits2::eAllCommands);
+}
+
+void GpuProfiler::write(vk::CommandBuffer cb, vk::PipelineStageFlags2 const stage) {
+	auto& frame = current();
+	cb.writeTimestamp2(stage, *frame.pool, frame.queries++);
+}
+} // namespace levk::vulkan
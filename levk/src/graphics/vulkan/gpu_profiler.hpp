@@ -0,0 +1,53 @@
+#pragma once
+#include <graphics/vulkan/common.hpp>
+#include <levk/frame_profile.hpp>
+
+namespace levk::vulkan {
+///
+/// \brief Measures GPU execution time of each frame and of its profiled sections with timestamp queries.
+///
+/// Each frame in flight writes into its own query pool, read back by resolve() once the frame's slot comes around again
+/// (after its submission has completed). Sections of the same type are summed. A no-op if the graphics queue family
+/// doesn't support timestamps.
+///
+class GpuProfiler {
+  public:
+	using Type = FrameProfile::Type;
+
+	static constexpr std::uint32_t max_sections_v{32u};
+
+	GpuProfiler() = default;
+	GpuProfiler(DeviceView const& device);
+
+	explicit operator bool() const { return m_period > 0.0f; }
+
+	// reads the current frame's queries, from its previous submission; returns false if there were none
+	bool resolve();
+
+	void begin_frame(vk::CommandBuffer cb);
+	void end_frame(vk::CommandBuffer cb);
+	// must be recorded outside render pass instances
+	void begin(vk::CommandBuffer cb, Type type);
+	void end(vk::CommandBuffer cb);
+
+	// last resolved frame: eFrameTime holds the whole frame
+	EnumArray<Type, Duration> const& profile() const { return m_profile; }
+
+  private:
+	struct Frame {
+		vk::UniqueQueryPool pool{};
+		// one begin / end pair of queries each, after the frame's pair
+		std::vector<Type> sections{};
+		std::uint32_t queries{};
+	};
+
+	Frame& current() { return m_frames[*m_device.buffered_index]; }
+	void write(vk::CommandBuffer cb, vk::PipelineStageFlags2 stage);
+
+	DeviceView m_device{};
+	Buffered<Frame> m_frames{};
+	EnumArray<Type, Duration> m_profile{};
+	float m_period{};
+	std::uint64_t m_mask{};
+};
+} // namespace levk::vulkan
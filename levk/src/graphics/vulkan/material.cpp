@@ -1,12 +1,32 @@
 #include <graphics/vulkan/material.hpp>
 #include <graphics/vulkan/pipeline.hpp>
 #include <levk/asset/shader_provider.hpp>
+#include <filesystem>
 
 namespace levk::vulkan {
-bool Material::build_layout(PipelineBuilder& pipeline_builder, Uri<ShaderCode> const& vert, Uri<ShaderCode> const& frag) {
-	auto* pipeline_layout = pipeline_builder.try_build_layout(vert, frag);
+namespace {
+Uri<ShaderCode> sibling(Uri<ShaderCode> const& vert, std::string_view const suffix) {
+	auto path = std::filesystem::path{vert.value()};
+	auto const extension = path.extension();
+	path.replace_extension();
+	path += suffix;
+	path += extension;
+	return path.generic_string();
+}
+} // namespace
+
+bool Material::build_layout(PipelineBuilder& pipeline_builder, Uri<ShaderCode> const& vert, Uri<ShaderCode> const& frag, VertexFormat format,
+							bool pre_skinned) {
+	auto* pipeline_layout = pipeline_builder.try_build_layout(vertex_shader_for(vert, format, pre_skinned), frag);
 	if (!pipeline_layout) { return false; }
-	shader_layout = pipeline_layout->shader_layout();
+	(pre_skinned ? pre_skinned_layout : shader_layouts[format]) = pipeline_layout->shader_layout();
 	return true;
 }
+
+Uri<ShaderCode> vertex_shader_for(Uri<ShaderCode> const& vert, VertexFormat format, bool pre_skinned) {
+	if (vert.is_empty()) { return vert; }
+	if (pre_skinned) { return sibling(vert, "_static"); }
+	if (format != VertexFormat::ePacked) { return vert; }
+	return sibling(vert, "_packed");
+}
 } // namespace levk::vulkan
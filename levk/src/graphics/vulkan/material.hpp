@@ -1,12 +1,23 @@
 #pragma once
 #include <graphics/vulkan/common.hpp>
+#include <levk/util/enum_array.hpp>
 
 namespace levk::vulkan {
 struct PipelineBuilder;
 
 struct Material {
-	ShaderLayout shader_layout{};
+	EnumArray<VertexFormat, ShaderLayout> shader_layouts{};
+	ShaderLayout pre_skinned_layout{};
 
-	bool build_layout(PipelineBuilder& pipeline_builder, Uri<ShaderCode> const& vert, Uri<ShaderCode> const& frag);
+	bool build_layout(PipelineBuilder& pipeline_builder, Uri<ShaderCode> const& vert, Uri<ShaderCode> const& frag, VertexFormat format = {},
+					  bool pre_skinned = false);
+
+	ShaderLayout const& shader_layout(VertexFormat format = {}, bool pre_skinned = false) const {
+		return pre_skinned ? pre_skinned_layout : shader_layouts[format];
+	}
 };
+
+// packed geometry is drawn with a sibling vertex shader that decodes it: "shaders/lit.vert" => "shaders/lit_packed.vert"
+// geometry skinned by SkinningPass (always full format) with one that skips joints: "shaders/skinned.vert" => "shaders/skinned_static.vert"
+Uri<ShaderCode> vertex_shader_for(Uri<ShaderCode> const& vert, VertexFormat format, bool pre_skinned = false);
 } // namespace levk::vulkan
@@ -199,6 +199,7 @@ PipelineBuilder::PipelineBuilder(PipelineStorage& out, ShaderProvider& shader_pr
 }
 
 Pipeline PipelineBuilder::try_build(VertexInput::View vertex_input, PipelineState state, ShaderHash shader_hash) {
+	auto lock = std::scoped_lock{out.mutex};
 	auto const it = out.maps.find(shader_hash);
 	if (it == out.maps.end()) { return {}; }
 	auto& map = it->second;
@@ -231,6 +232,7 @@ Ptr<PipelineLayout> PipelineBuilder::try_build_layout(Uri<ShaderCode> const& ver
 	};
 	if (!shader.vert || !shader.frag) { return {}; }
 	auto const shader_hash = PipelineLayout::make_hash(shader);
+	auto lock = std::scoped_lock{out.mutex};
 	auto& map = out.maps[shader_hash];
 	if (!map.layout.pipeline_layout) { map.layout = PipelineLayout::make(device, shader); }
 	return &map.layout;
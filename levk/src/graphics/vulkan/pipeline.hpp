@@ -89,6 +89,7 @@ struct PipelineMap {
 
 struct PipelineStorage {
 	std::unordered_map<ShaderHash, PipelineMap, ShaderHash::Hasher> maps{};
+	std::mutex mutex{};
 	bool sample_rate_shading{};
 };
 
@@ -1,6 +1,7 @@
-#include <graphics/vulkan/ad_hoc_cmd.hpp>
 #include <graphics/vulkan/primitive.hpp>
 #include <graphics/vulkan/render_object.hpp>
+#include <graphics/vulkan/upload_service.hpp>
+#include <graphics/vulkan/vertex_format.hpp>
 #include <levk/util/error.hpp>
 
 namespace levk::vulkan {
@@ -11,8 +12,6 @@ struct GeometryUploader {
 
 	Vma const& vma;
 
-	FlexArray<UniqueBuffer, 2> staging_buffers{};
-
 	void write_to(GeometryLayout& out_layout, UniqueBuffer& out_buffer, Geometry::Packed const& geometry) const {
 		auto const indices = std::span<std::uint32_t const>{geometry.indices};
 		out_layout.vertices = static_cast<std::uint32_t>(geometry.positions.size());
@@ -30,71 +29,106 @@ struct GeometryUploader {
 		out_layout.instances_binding = RenderObject::Instances::vertex_binding_v;
 	}
 
-	void write_to(GeometryLayout& out_layout, UniqueBuffer& out_buffer, MeshJoints const& joints) const {
-		assert(joints.joints.size() >= joints.weights.size());
-		auto const size = joints.joints.size_bytes() + joints.weights.size_bytes();
-		if (out_buffer.get().size < size) { out_buffer = vma.make_buffer(v_flags_v, size, false); }
-		if (!out_buffer.get().buffer || !out_buffer.get().mapped) { throw Error{"Failed to write create Vulkan staging buffer"}; }
-		auto writer = BufferWriter{out_buffer};
-		out_layout.offsets.joints = writer(joints.joints);
-		out_layout.offsets.weights = writer(joints.weights);
-		out_layout.vertex_input = VertexInput::for_skinned();
-		out_layout.joints_binding = RenderObject::Joints::vertex_binding_v;
-		out_layout.joints = static_cast<std::uint32_t>(joints.joints.size());
-	}
+	void upload(GeometryLayout& out_layout, VertexStreams const& streams, vk::Buffer dst, UploadService& upload_service, Geometry::Packed const& geometry,
+				Ptr<MeshJoints const> joints) const {
+		auto const vertices = std::size_t{out_layout.vertices};
+		auto const index_bytes = std::size_t{out_layout.indices} * index_size(out_layout.index_type);
+		auto const size = vertices * streams.vertex_stride() + index_bytes;
+		if (size == 0) { return; }
+		auto staging = std::vector<std::byte>(size);
 
-	[[nodiscard]] UniqueBuffer upload(GeometryLayout& out_result, vk::CommandBuffer cb, Geometry::Packed const& geometry) {
-		auto const size = geometry.size_bytes();
-		auto staging = vma.make_buffer(vk::BufferUsageFlagBits::eTransferSrc, size, true);
-		auto ret = vma.make_buffer(vk::BufferUsageFlagBits::eTransferDst | vi_flags_v, size, false);
-		write_to(out_result, staging, geometry);
-		cb.copyBuffer(staging.get().buffer, ret.get().buffer, vk::BufferCopy{{}, {}, size});
-		staging_buffers.insert(std::move(staging));
-		return ret;
-	}
+		// each stream is encoded into staging and copied into its own region of the arena block, at the allocated vertex / index offset
+		auto* const mapped = staging.data();
+		auto src_offset = std::size_t{};
+		auto copies = FlexArray<vk::BufferCopy, 8>{};
+		auto const vertex_offset = static_cast<vk::DeviceSize>(out_layout.vertex_offset);
+		auto const stage = [&](auto encoder, VertexStreams::Stream const& stream, auto data, vk::DeviceSize dst_offset) {
+			data = data.first(std::min(data.size(), vertices));
+			if (data.empty()) { return; }
+			encoder(stream, data, mapped + src_offset);
+			auto const stream_size = data.size() * stream.stride;
+			copies.insert(vk::BufferCopy{src_offset, dst_offset + vertex_offset * stream.stride, stream_size});
+			src_offset += stream_size;
+		};
+		auto const encode_positions_ = [&out_layout](VertexStreams::Stream const& stream, std::span<glm::vec3 const> in, std::byte* out) {
+			out_layout.dequant = encode_positions(stream, in, out);
+		};
+		stage(encode_positions_, streams.positions, std::span<glm::vec3 const>{geometry.positions}, out_layout.offsets.positions);
+		stage(&encode_rgbs, streams.rgbs, std::span<glm::vec3 const>{geometry.rgbs}, out_layout.offsets.rgbs);
+		stage(&encode_normals, streams.normals, std::span<glm::vec3 const>{geometry.normals}, out_layout.offsets.normals);
+		stage(&encode_uvs, streams.uvs, std::span<glm::vec2 const>{geometry.uvs}, out_layout.offsets.uvs);
+		if (joints) {
+			stage(&encode_joints, streams.joints, joints->joints, out_layout.offsets.joints);
+			stage(&encode_weights, streams.weights, joints->weights, out_layout.offsets.weights);
+		}
+		if (index_bytes > 0) {
+			encode_indices(out_layout.index_type, geometry.indices, mapped + src_offset);
+			auto const dst_offset = out_layout.offsets.indices + vk::DeviceSize{out_layout.first_index} * index_size(out_layout.index_type);
+			copies.insert(vk::BufferCopy{src_offset, dst_offset, index_bytes});
+		}
 
-	[[nodiscard]] UniqueBuffer upload(GeometryLayout& out_result, vk::CommandBuffer cb, MeshJoints const& joints) {
-		auto const size = joints.joints.size_bytes() + joints.weights.size_bytes();
-		auto staging = vma.make_buffer(vk::BufferUsageFlagBits::eTransferSrc, size, true);
-		auto ret = vma.make_buffer(vk::BufferUsageFlagBits::eTransferDst | v_flags_v, size, false);
-		write_to(out_result, staging, joints);
-		cb.copyBuffer(staging.get().buffer, ret.get().buffer, vk::BufferCopy{{}, {}, size});
-		staging_buffers.insert(std::move(staging));
-		return ret;
+		upload_service.upload(dst, staging, copies.span());
 	}
 };
-} // namespace
 
-auto UploadedPrimitive::make_static(DeviceView const& device, Geometry::Packed const& geometry) -> UploadedPrimitive {
-	auto ret = UploadedPrimitive{};
-	ret.m_vibo = DeviceBuffer::make(device, vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer);
-	auto uploader = GeometryUploader{device.vma};
-	auto cmd = AdHocCmd{device};
-	ret.m_vibo.buffer.get() = uploader.upload(ret.m_layout, cmd.cb, geometry);
+std::size_t joint_count(MeshJoints const& joints) {
+	auto ret = std::uint32_t{};
+	for (auto const& joint : joints.joints) { ret = std::max({ret, joint.x + 1, joint.y + 1, joint.z + 1, joint.w + 1}); }
 	return ret;
 }
+} // namespace
+
+auto UploadedPrimitive::make_static(DeviceView const& device, Geometry::Packed const& geometry, VertexFormat format) -> UploadedPrimitive {
+	return make(device, geometry, {}, format);
+}
 
-auto UploadedPrimitive::make_skinned(DeviceView const& device, Geometry::Packed const& geometry, MeshJoints const& joints) -> UploadedPrimitive {
+auto UploadedPrimitive::make_skinned(DeviceView const& device, Geometry::Packed const& geometry, MeshJoints const& joints, VertexFormat format)
+	-> UploadedPrimitive {
 	assert(!joints.joints.empty());
+	return make(device, geometry, &joints, format);
+}
+
+auto UploadedPrimitive::make(DeviceView const& device, Geometry::Packed const& geometry, Ptr<MeshJoints const> joints, VertexFormat format)
+	-> UploadedPrimitive {
 	auto ret = UploadedPrimitive{};
-	ret.m_vibo = DeviceBuffer::make(device, vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer);
-	ret.m_jwbo = DeviceBuffer::make(device, vk::BufferUsageFlagBits::eVertexBuffer);
-	auto uploader = GeometryUploader{device.vma};
-	auto cmd = AdHocCmd{device};
-	ret.m_vibo.buffer.get() = uploader.upload(ret.m_layout, cmd.cb, geometry);
-	ret.m_jwbo.buffer.get() = uploader.upload(ret.m_layout, cmd.cb, joints);
+	ret.m_layout.vertices = static_cast<std::uint32_t>(geometry.positions.size());
+	ret.m_layout.indices = static_cast<std::uint32_t>(geometry.indices.size());
+	ret.m_layout.index_type = index_type_for(geometry.positions.size());
+	ret.m_layout.format = format;
+	ret.m_layout.instances_binding = RenderObject::Instances::vertex_binding_v;
+	auto const streams = VertexStreams::make(format, joints != nullptr, joints ? joint_count(*joints) : 0);
+	ret.m_layout.vertex_input = streams.vertex_input();
+	ret.m_streams = streams;
+	if (joints) {
+		assert(joints->joints.size() >= joints->weights.size());
+		ret.m_layout.joints_binding = RenderObject::Joints::vertex_binding_v;
+		ret.m_layout.joints = static_cast<std::uint32_t>(joints->joints.size());
+	}
+	// null backend: layout only, draws are no-ops without a buffer
+	if (!device.device) { return ret; }
+
+	assert(device.geometry_arena);
+	auto allocation = device.geometry_arena->allocate(ret.m_layout, streams);
+	ret.m_buffer = allocation.get().buffer;
+	ret.m_allocation = {*device.defer, std::move(allocation)};
+
+	GeometryUploader{device.vma}.upload(ret.m_layout, streams, ret.m_buffer, *device.upload_service, geometry, joints);
 	return ret;
 }
 
-HostPrimitive::HostPrimitive(DeviceView const& device)
-	: m_vibo(HostBuffer::make(device, vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer)), m_device(device) {
+HostPrimitive::HostPrimitive(DeviceView const& device) : m_device(device) {
+	if (device.device) { m_vibo = HostBuffer::make(device, vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer); }
 	m_layout.vertex_input = VertexInput::for_static();
 	m_layout.instances_binding = RenderObject::Instances::vertex_binding_v;
 }
 
 Vma::Buffer const& HostPrimitive::refresh() {
-	auto& v = m_vibo.buffers.get()[*m_device.buffered_index];
+	auto const index = *m_device.buffered_index;
+	auto& v = m_vibo.buffers.get()[index];
+	// the layout written last belongs to the same geometry
+	if (m_written[index] == version) { return v.get(); }
 	GeometryUploader{m_device.vma}.write_to(m_layout, v, geometry);
+	m_written[index] = version;
 	return v.get();
 }
 } // namespace levk::vulkan
@@ -1,12 +1,19 @@
 #pragma once
 #include <glm/mat4x4.hpp>
 #include <graphics/vulkan/common.hpp>
+#include <graphics/vulkan/geometry_arena.hpp>
 #include <levk/graphics/primitive.hpp>
 
 namespace levk::vulkan {
 class UploadedPrimitive;
 class HostPrimitive;
 
+// device local geometry of a skinned primitive, read by SkinningPass
+struct SkinningSource {
+	vk::Buffer buffer{};
+	VertexStreams streams{};
+};
+
 struct Primitive {
 	virtual ~Primitive() = default;
 
@@ -16,23 +23,33 @@ struct Primitive {
 
 	GeometryLayout const& layout() const { return m_layout; }
 
-	void draw(Vma::Buffer const& vibo, vk::CommandBuffer cb, std::uint32_t instances = 1u) const {
-		if (!vibo.buffer) { return; }
-		vk::Buffer const vbos[] = {vibo.buffer, vibo.buffer, vibo.buffer, vibo.buffer};
+	void bind(vk::Buffer vibo, vk::CommandBuffer cb) const {
+		vk::Buffer const vbos[] = {vibo, vibo, vibo, vibo};
 		vk::DeviceSize const vbo_offsets[] = {m_layout.offsets.positions, m_layout.offsets.rgbs, m_layout.offsets.normals, m_layout.offsets.uvs};
 		cb.bindVertexBuffers(0u, vbos, vbo_offsets);
+		if (m_layout.indices > 0) { cb.bindIndexBuffer(vibo, m_layout.offsets.indices, m_layout.index_type); }
+	}
+
+	void draw(vk::Buffer vibo, vk::CommandBuffer cb, std::uint32_t instances = 1u) const {
+		if (!vibo) { return; }
+		bind(vibo, cb);
 		if (m_layout.indices > 0) {
-			cb.bindIndexBuffer(vibo.buffer, m_layout.offsets.indices, vk::IndexType::eUint32);
-			cb.drawIndexed(m_layout.indices, instances, 0u, 0u, 0u);
+			cb.drawIndexed(m_layout.indices, instances, m_layout.first_index, m_layout.vertex_offset, 0u);
 		} else {
-			cb.draw(m_layout.vertices, instances, 0u, 0u);
+			cb.draw(m_layout.vertices, instances, static_cast<std::uint32_t>(m_layout.vertex_offset), 0u);
 		}
 	}
 
-	void draw(Vma::Buffer const& vibo, Vma::Buffer const& jwbo, vk::CommandBuffer cb, std::uint32_t instances = 1u) const {
-		if (!vibo.buffer) { return; }
+	void draw(vk::Buffer vibo, vk::CommandBuffer cb, IndirectDraw const& indirect) const {
+		if (!vibo || m_layout.indices == 0) { return; }
+		bind(vibo, cb);
+		indirect.record(cb);
+	}
+
+	void draw(vk::Buffer vibo, vk::Buffer jwbo, vk::CommandBuffer cb, std::uint32_t instances = 1u) const {
+		if (!vibo) { return; }
 		assert(m_layout.joints_binding > 0);
-		vk::Buffer const jbos[] = {jwbo.buffer, jwbo.buffer};
+		vk::Buffer const jbos[] = {jwbo, jwbo};
 		vk::DeviceSize const jbo_offsets[] = {m_layout.offsets.joints, m_layout.offsets.weights};
 		cb.bindVertexBuffers(*m_layout.joints_binding, jbos, jbo_offsets);
 		draw(vibo, cb, instances);
@@ -40,29 +57,54 @@ struct Primitive {
 
 	virtual void draw(vk::CommandBuffer cb, std::uint32_t instances = 1u) = 0;
 
+	// buffer shared by all draws that can be batched into one indirect draw (null if not batchable)
+	virtual vk::Buffer indirect_buffer() const { return {}; }
+	virtual void draw(vk::CommandBuffer, IndirectDraw const&) {}
+
+	virtual std::optional<SkinningSource> skinning_source() const { return {}; }
+
   protected:
 	GeometryLayout m_layout{};
 };
 
 class UploadedPrimitive : public Primitive {
   public:
-	static UploadedPrimitive make_static(DeviceView const& device, Geometry::Packed const& geometry);
-	static UploadedPrimitive make_skinned(DeviceView const& device, Geometry::Packed const& geometry, MeshJoints const& joints);
+	static UploadedPrimitive make_static(DeviceView const& device, Geometry::Packed const& geometry, VertexFormat format = VertexFormat::eFull);
+	static UploadedPrimitive make_skinned(DeviceView const& device, Geometry::Packed const& geometry, MeshJoints const& joints,
+										  VertexFormat format = VertexFormat::eFull);
 
   private:
 	UploadedPrimitive() = default;
 
+	static UploadedPrimitive make(DeviceView const& device, Geometry::Packed const& geometry, Ptr<MeshJoints const> joints, VertexFormat format);
+
+	// vertices, joints/weights, and indices all live in one shared arena block
 	void draw(vk::CommandBuffer cb, std::uint32_t instances = 1u) final {
 		if (m_layout.joints_binding) {
-			assert(m_jwbo.buffer.get());
-			Primitive::draw(m_vibo.buffer.get().get(), m_jwbo.buffer.get().get(), cb, instances);
+			Primitive::draw(m_buffer, m_buffer, cb, instances);
 		} else {
-			Primitive::draw(m_vibo.buffer.get().get(), cb, instances);
+			Primitive::draw(m_buffer, cb, instances);
 		}
 	}
 
-	DeviceBuffer m_vibo{};
-	DeviceBuffer m_jwbo{};
+	vk::Buffer indirect_buffer() const final {
+		if (m_layout.joints_binding || m_layout.indices == 0) { return {}; }
+		return m_buffer;
+	}
+
+	void draw(vk::CommandBuffer cb, IndirectDraw const& indirect) final {
+		assert(!m_layout.joints_binding);
+		Primitive::draw(m_buffer, cb, indirect);
+	}
+
+	std::optional<SkinningSource> skinning_source() const final {
+		if (!m_layout.joints_binding) { return {}; }
+		return SkinningSource{m_buffer, m_streams};
+	}
+
+	Defer<GeometryArena::UniqueAllocation> m_allocation{};
+	VertexStreams m_streams{};
+	vk::Buffer m_buffer{};
 };
 
 class HostPrimitive : public Primitive {
@@ -70,16 +112,19 @@ class HostPrimitive : public Primitive {
 	HostPrimitive(DeviceView const& device);
 
 	Geometry::Packed geometry{};
+	// bump after modifying geometry: each buffer is only rewritten when it is out of date
+	std::uint64_t version{1};
 
   private:
 	void draw(vk::CommandBuffer cb, std::uint32_t instances = 1u) final {
-		if (geometry.positions.empty()) { return; }
-		Primitive::draw(refresh(), cb, instances);
+		if (geometry.positions.empty() || !m_device.device) { return; }
+		Primitive::draw(refresh().buffer, cb, instances);
 	}
 
 	Vma::Buffer const& refresh();
 
 	HostBuffer m_vibo{};
+	Buffered<std::uint64_t> m_written{};
 	DeviceView m_device{};
 };
 } // namespace levk::vulkan
@@ -0,0 +1,333 @@
+#include <graphics/vulkan/image_barrier.hpp>
+#include <graphics/vulkan/render_graph.hpp>
+#include <levk/util/enumerate.hpp>
+#include <levk/util/error.hpp>
+#include <levk/util/hash_combine.hpp>
+#include <levk/util/logger.hpp>
+#include <algorithm>
+#include <ranges>
+
+namespace levk::vulkan {
+namespace {
+auto const g_log{Logger{"RenderGraph"}};
+
+struct AccessInfo {
+	vk::ImageLayout layout{};
+	vk::PipelineStageFlags2 stages{};
+	vk::AccessFlags2 access{};
+	vk::ImageUsageFlags usage{};
+	bool write{};
+};
+
+constexpr AccessInfo access_info(RenderGraph::Access const access) {
+	using Access = RenderGraph::Access;
+	using Stage = vk::PipelineStageFlagBits2;
+	using Flag = vk::AccessFlagBits2;
+	using Usage = vk::ImageUsageFlagBits;
+	switch (access) {
+	case Access::eColourAttachment:
+		return {vk::ImageLayout::eAttachmentOptimal, Stage::eColorAttachmentOutput, Flag::eColorAttachmentWrite | Flag::eColorAttachmentRead,
+				Usage::eColorAttachment, true};
+	case Access::eDepthAttachment:
+		return {vk::ImageLayout::eAttachmentOptimal, Stage::eEarlyFragmentTests | Stage::eLateFragmentTests,
+				Flag::eDepthStencilAttachmentWrite | Flag::eDepthStencilAttachmentRead, Usage::eDepthStencilAttachment, true};
+	case Access::eSampled: return {vk::ImageLayout::eReadOnlyOptimal, Stage::eFragmentShader, Flag::eShaderSampledRead, Usage::eSampled, false};
+	case Access::eTransferSrc: return {vk::ImageLayout::eTransferSrcOptimal, Stage::eTransfer, Flag::eTransferRead, Usage::eTransferSrc, false};
+	case Access::eTransferDst: return {vk::ImageLayout::eTransferDstOptimal, Stage::eTransfer, Flag::eTransferWrite, Usage::eTransferDst, true};
+	case Access::eStorageRead: return {vk::ImageLayout::eGeneral, Stage::eComputeShader, Flag::eShaderStorageRead, Usage::eStorage, false};
+	case Access::eStorageWrite: return {vk::ImageLayout::eGeneral, Stage::eComputeShader, Flag::eShaderStorageWrite, Usage::eStorage, true};
+	case Access::eVertexInput: return {vk::ImageLayout::eUndefined, Stage::eVertexAttributeInput, Flag::eVertexAttributeRead, {}, false};
+	}
+	return {};
+}
+
+constexpr vk::ImageAspectFlags aspect_for(vk::Format const format) {
+	switch (format) {
+	case vk::Format::eD16Unorm:
+	case vk::Format::eX8D24UnormPack32:
+	case vk::Format::eD32Sfloat: return vk::ImageAspectFlagBits::eDepth;
+	case vk::Format::eD16UnormS8Uint:
+	case vk::Format::eD24UnormS8Uint:
+	case vk::Format::eD32SfloatS8Uint: return vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
+	default: return vk::ImageAspectFlagBits::eColor;
+	}
+}
+
+vk::ImageCreateInfo image_create_info(RenderGraph::ImageInfo const& info, vk::ImageUsageFlags const usage) {
+	auto ret = vk::ImageCreateInfo{};
+	ret.imageType = vk::ImageType::e2D;
+	ret.format = info.format;
+	ret.extent = vk::Extent3D{info.extent, 1};
+	ret.mipLevels = 1u;
+	ret.arrayLayers = 1u;
+	ret.samples = info.samples;
+	ret.tiling = vk::ImageTiling::eOptimal;
+	ret.usage = usage;
+	return ret;
+}
+
+constexpr vk::DeviceSize align(vk::DeviceSize const size, vk::DeviceSize const alignment) { return (size + alignment - 1) / alignment * alignment; }
+} // namespace
+
+auto RenderGraph::Pass::use(Image const image, Access const access) -> Pass& {
+	m_graph.m_passes[m_index].uses.push_back(Use{.resource = image.index, .access = access, .image = true});
+	m_graph.m_images[image.index].usage |= access_info(access).usage;
+	return *this;
+}
+
+auto RenderGraph::Pass::use(Buffer const buffer, Access const access) -> Pass& {
+	m_graph.m_passes[m_index].uses.push_back(Use{.resource = buffer.index, .access = access});
+	return *this;
+}
+
+auto RenderGraph::Pass::profile(FrameProfile::Type const type) -> Pass& {
+	m_graph.m_passes[m_index].profile = type;
+	return *this;
+}
+
+void RenderGraph::begin() {
+	m_passes.clear();
+	m_images.clear();
+	m_buffers = {};
+	m_order.clear();
+	m_image_barriers.clear();
+	m_memory_barriers.clear();
+	m_final_barriers.clear();
+}
+
+auto RenderGraph::create(ImageInfo const& info) -> Image {
+	m_images.push_back(ImageData{.info = info});
+	return Image{m_images.size() - 1};
+}
+
+auto RenderGraph::import(Import const& image) -> Image {
+	m_images.push_back(ImageData{.info = {image.image.extent, image.image.format}, .imported = image, .physical = image.image});
+	return Image{m_images.size() - 1};
+}
+
+auto RenderGraph::buffer() -> Buffer { return Buffer{m_buffers++}; }
+
+auto RenderGraph::add_pass(Execute execute) -> Pass {
+	m_passes.push_back(PassData{.execute = std::move(execute)});
+	return Pass{*this, m_passes.size() - 1};
+}
+
+void RenderGraph::compile() {
+	m_stats = {.passes = m_passes.size()};
+
+	// walk back from the imported images, keeping every pass that writes something a kept pass uses
+	auto needed_images = std::vector<bool>(m_images.size());
+	auto needed_buffers = std::vector<bool>(m_buffers);
+	for (auto const [image, index] : enumerate(m_images)) { needed_images[index] = image.imported.has_value(); }
+	auto const needed = [&](Use const& use) -> std::vector<bool>::reference { return (use.image ? needed_images : needed_buffers)[use.resource]; };
+	for (auto& pass : std::views::reverse(m_passes)) {
+		pass.alive = std::ranges::any_of(pass.uses, [&](Use const& use) { return access_info(use.access).write && needed(use); });
+		if (!pass.alive) {
+			++m_stats.culled;
+			continue;
+		}
+		// attachments may load earlier contents: every use keeps the resource's earlier writers
+		for (auto const& use : pass.uses) { needed(use) = true; }
+	}
+	for (auto const [pass, index] : enumerate(m_passes)) {
+		if (pass.alive) { m_order.push_back(index); }
+	}
+
+	// lifetime of each transient image: first / last position in m_order
+	static constexpr auto unused_v = std::numeric_limits<std::size_t>::max();
+	auto first = std::vector<std::size_t>(m_images.size(), unused_v);
+	auto last = std::vector<std::size_t>(m_images.size());
+	for (auto const [index, position] : enumerate(m_order)) {
+		for (auto const& use : m_passes[index].uses) {
+			if (!use.image) { continue; }
+			first[use.resource] = std::min(first[use.resource], position);
+			last[use.resource] = std::max(last[use.resource], position);
+		}
+	}
+	auto transients = std::vector<std::size_t>{};
+	for (auto const [image, index] : enumerate(m_images)) {
+		if (!image.imported && first[index] != unused_v) { transients.push_back(index); }
+	}
+	std::ranges::sort(transients, [&first](std::size_t a, std::size_t b) { return first[a] < first[b]; });
+
+	// greedily place each transient image in the block that grows the least, once its previous occupant is done with it
+	auto blocks = std::vector<Block>{};
+	auto occupants = std::vector<std::size_t>{};
+	auto keys = std::vector<Key>{};
+	auto aliases = std::vector<std::optional<std::size_t>>(m_images.size());
+	for (auto const index : transients) {
+		auto& image = m_images[index];
+		auto const reqs = requirements(image.info, image.usage);
+		m_stats.unaliased_bytes += reqs.size;
+		auto best = std::optional<std::size_t>{};
+		auto best_growth = vk::DeviceSize{};
+		for (auto const [block, block_index] : enumerate(blocks)) {
+			if (block.free_after >= first[index] || !(block.requirements.memoryTypeBits & reqs.memoryTypeBits)) { continue; }
+			auto const growth = reqs.size > block.requirements.size ? reqs.size - block.requirements.size : 0u;
+			if (!best || growth < best_growth) {
+				best = block_index;
+				best_growth = growth;
+			}
+		}
+		if (best) {
+			auto& block = blocks[*best];
+			block.requirements.size = std::max(block.requirements.size, reqs.size);
+			block.requirements.alignment = std::max(block.requirements.alignment, reqs.alignment);
+			block.requirements.memoryTypeBits &= reqs.memoryTypeBits;
+			block.free_after = last[index];
+			aliases[index] = std::exchange(occupants[*best], index);
+		} else {
+			best = blocks.size();
+			blocks.push_back(Block{.requirements = reqs, .free_after = last[index]});
+			occupants.push_back(index);
+		}
+		keys.push_back(Key{.info = image.info, .usage = image.usage, .block = *best});
+	}
+	for (auto& block : blocks) { block.requirements.size = align(block.requirements.size, block.requirements.alignment); }
+
+	m_stats.transient_images = transients.size();
+	for (auto const& block : blocks) { m_stats.transient_bytes += block.requirements.size; }
+
+	auto& physical = m_physical[*m_device.buffered_index];
+	if (physical.keys != keys) { allocate(physical, std::move(keys), blocks); }
+	for (auto const [index, slot] : enumerate(transients)) {
+		auto const& key = physical.keys[slot];
+		m_images[index].physical = ImageView{*physical.images[slot], *physical.views[slot], key.info.extent, key.info.format};
+	}
+
+	record_barriers(aliases);
+}
+
+void RenderGraph::execute(vk::CommandBuffer cb, Ptr<GpuProfiler> profiler) const {
+	for (auto const [index, position] : enumerate(m_order)) {
+		auto const& image_barriers = m_image_barriers[position];
+		auto const& memory_barrier = m_memory_barriers[position];
+		auto di = vk::DependencyInfo{};
+		di.imageMemoryBarrierCount = static_cast<std::uint32_t>(image_barriers.size());
+		di.pImageMemoryBarriers = image_barriers.data();
+		if (memory_barrier.srcStageMask || memory_barrier.dstStageMask) {
+			di.memoryBarrierCount = 1u;
+			di.pMemoryBarriers = &memory_barrier;
+		}
+		if (di.imageMemoryBarrierCount > 0 || di.memoryBarrierCount > 0) { cb.pipelineBarrier2(di); }
+		auto const& pass = m_passes[index];
+		if (profiler && pass.profile) { profiler->begin(cb, *pass.profile); }
+		pass.execute(Context{.cb = cb, .graph = this});
+		if (profiler && pass.profile) { profiler->end(cb); }
+	}
+	ImageBarrier::transition(cb, m_final_barriers);
+}
+
+ImageView RenderGraph::image(Image const image) const {
+	assert(image.index < m_images.size());
+	return m_images[image.index].physical;
+}
+
+vk::MemoryRequirements RenderGraph::requirements(ImageInfo const& info, vk::ImageUsageFlags const usage) {
+	auto const format = static_cast<std::uint32_t>(info.format);
+	auto const samples = static_cast<std::uint32_t>(info.samples);
+	auto const key = make_combined_hash(info.extent.width, info.extent.height, format, samples, static_cast<VkImageUsageFlags>(usage));
+	if (auto const it = m_requirements.find(key); it != m_requirements.end()) { return it->second; }
+	// a throwaway image: its memory requirements are all that's needed to plan aliasing
+	auto const image = m_device.device.createImageUnique(image_create_info(info, usage));
+	auto const ret = m_device.device.getImageMemoryRequirements(*image);
+	m_requirements.insert_or_assign(key, ret);
+	return ret;
+}
+
+void RenderGraph::allocate(Physical& out, std::vector<Key> keys, std::span<Block const> blocks) {
+	// the previous images may still be in use by frames in flight
+	m_device.defer->push(std::move(out));
+	out = {};
+	out.keys = std::move(keys);
+	for (auto const& block : blocks) { out.blocks.push_back(m_device.vma.allocate(block.requirements)); }
+	for (auto const& key : out.keys) {
+		auto image = m_device.device.createImageUnique(image_create_info(key.info, key.usage));
+		auto const& memory = out.blocks[key.block].get();
+		if (vmaBindImageMemory(memory.vma.allocator, memory.allocation, *image) != VK_SUCCESS) { throw Error{"Failed to bind Vulkan Image memory"}; }
+		auto const isr = vk::ImageSubresourceRange{aspect_for(key.info.format), 0, 1, 0, 1};
+		out.views.push_back(m_device.vma.make_image_view(*image, key.info.format, isr));
+		out.images.push_back(std::move(image));
+	}
+	static constexpr auto mib_v = 1024.0f * 1024.0f;
+	g_log.info("Transient images: [{}] | blocks: [{}] | memory: [{:.1f}MiB] | unaliased: [{:.1f}MiB]", out.keys.size(), out.blocks.size(),
+			   static_cast<float>(m_stats.transient_bytes) / mib_v, static_cast<float>(m_stats.unaliased_bytes) / mib_v);
+}
+
+void RenderGraph::record_barriers(std::span<std::optional<std::size_t> const> aliases) {
+	auto image_syncs = std::vector<Sync>(m_images.size());
+	auto buffer_syncs = std::vector<Sync>(m_buffers);
+	auto touched = std::vector<bool>(m_images.size());
+	for (auto const [image, index] : enumerate(m_images)) {
+		if (!image.imported) { continue; }
+		auto const& imported = *image.imported;
+		auto const writes = imported.initial == vk::ImageLayout::eUndefined ? vk::AccessFlags2{} : vk::AccessFlagBits2::eMemoryWrite;
+		image_syncs[index] = Sync{.layout = imported.initial, .stages = imported.stages, .writes = writes};
+	}
+
+	// returns the source scope of the barrier needed before next, if any
+	auto const advance = [](Sync& sync, AccessInfo const& next, bool const image) -> std::optional<Sync> {
+		bool const layout_change = image && sync.layout != next.layout;
+		if (!next.write && !layout_change && (sync.readers & next.stages) == next.stages) {
+			sync.stages |= next.stages;
+			return {};
+		}
+		auto const ret = sync;
+		if (next.write) {
+			sync = Sync{.layout = next.layout, .stages = next.stages, .writes = next.access};
+		} else {
+			auto const readers = layout_change ? next.stages : sync.readers | next.stages;
+			sync = Sync{.layout = next.layout, .stages = readers, .readers = readers};
+		}
+		return ret;
+	};
+
+	m_image_barriers.resize(m_order.size());
+	m_memory_barriers.resize(m_order.size());
+	for (auto const [index, position] : enumerate(m_order)) {
+		auto& image_barriers = m_image_barriers[position];
+		auto& memory_barrier = m_memory_barriers[position];
+		for (auto const& use : m_passes[index].uses) {
+			auto const next = access_info(use.access);
+			if (!use.image) {
+				auto const src = advance(buffer_syncs[use.resource], next, false);
+				if (!src || !src->stages) { continue; }
+				memory_barrier.srcStageMask |= src->stages;
+				memory_barrier.srcAccessMask |= src->writes;
+				memory_barrier.dstStageMask |= next.stages;
+				memory_barrier.dstAccessMask |= next.access;
+				continue;
+			}
+			auto& sync = image_syncs[use.resource];
+			if (!touched[use.resource] && aliases[use.resource]) {
+				// wait for the previous occupant of this image's memory
+				auto const& previous = image_syncs[*aliases[use.resource]];
+				sync.stages = previous.stages | previous.readers;
+				sync.writes = previous.writes;
+			}
+			touched[use.resource] = true;
+			auto const src = advance(sync, next, true);
+			if (!src || (!src->stages && src->layout == next.layout)) { continue; }
+			auto const& image = m_images[use.resource];
+			auto const isr = vk::ImageSubresourceRange{aspect_for(image.info.format), 0, 1, 0, 1};
+			image_barriers.push_back(vk::ImageMemoryBarrier2{src->stages, src->writes, next.stages, next.access, src->layout, next.layout,
+															  VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, image.physical.image, isr});
+		}
+	}
+
+	for (auto const [image, index] : enumerate(m_images)) {
+		if (!image.imported || image.imported->final == vk::ImageLayout::eUndefined) { continue; }
+		auto const& sync = image_syncs[index];
+		auto const final_layout = image.imported->final;
+		if (sync.layout == final_layout) { continue; }
+		// presentation is ordered by the render semaphore instead
+		bool const present = final_layout == vk::ImageLayout::ePresentSrcKHR;
+		auto const dst_stages = present ? vk::PipelineStageFlags2{} : vk::PipelineStageFlagBits2::eAllCommands;
+		// later commands in the same submission (eg readback copies) must see the contents
+		auto const dst_access = present ? vk::AccessFlags2{} : vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite;
+		auto const isr = vk::ImageSubresourceRange{aspect_for(image.info.format), 0, 1, 0, 1};
+		m_final_barriers.push_back(vk::ImageMemoryBarrier2{sync.stages | sync.readers, sync.writes, dst_stages, dst_access, sync.layout, final_layout,
+															VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, image.physical.image, isr});
+	}
+}
+} // namespace levk::vulkan
@@ -0,0 +1,176 @@
+#pragma once
+#include <graphics/vulkan/gpu_profiler.hpp>
+#include <functional>
+
+namespace levk::vulkan {
+///
+/// \brief Per-frame graph of GPU passes and the images / buffers they access.
+///
+/// Passes are added in submission order and declare every resource they use; a use sees the latest write by an earlier pass.
+/// compile() culls passes whose writes never reach an imported image, and places transient images whose lifetimes
+/// (first to last surviving pass) don't overlap in shared memory. execute() records the surviving passes, preceded by
+/// the minimal barriers / layout transitions each one needs.
+///
+class RenderGraph {
+  public:
+	enum class Access : std::uint8_t {
+		eColourAttachment,
+		eDepthAttachment,
+		eSampled,
+		eTransferSrc,
+		eTransferDst,
+		eStorageRead,
+		eStorageWrite,
+		eVertexInput,
+	};
+
+	struct Image {
+		std::size_t index{};
+	};
+
+	struct Buffer {
+		std::size_t index{};
+	};
+
+	// owned by the graph: contents are undefined at the first use every frame
+	struct ImageInfo {
+		vk::Extent2D extent{};
+		vk::Format format{};
+		vk::SampleCountFlagBits samples{vk::SampleCountFlagBits::e1};
+
+		bool operator==(ImageInfo const&) const = default;
+	};
+
+	// owned externally: transitioned from initial to final layout over the frame
+	struct Import {
+		ImageView image{};
+		vk::ImageLayout initial{vk::ImageLayout::eUndefined};
+		vk::ImageLayout final{vk::ImageLayout::eUndefined};
+		// earlier work on the image the first use waits on (eg the swapchain acquire semaphore's wait stage)
+		vk::PipelineStageFlags2 stages{vk::PipelineStageFlagBits2::eAllCommands};
+	};
+
+	struct Context {
+		vk::CommandBuffer cb{};
+		Ptr<RenderGraph const> graph{};
+
+		ImageView image(Image const image) const { return graph->image(image); }
+	};
+
+	using Execute = std::function<void(Context const&)>;
+
+	class Pass {
+	  public:
+		Pass& use(Image image, Access access);
+		Pass& use(Buffer buffer, Access access);
+		// GPU time of the pass is added to type's section
+		Pass& profile(FrameProfile::Type type);
+
+	  private:
+		Pass(RenderGraph& graph, std::size_t index) : m_graph(graph), m_index(index) {}
+
+		RenderGraph& m_graph;
+		std::size_t m_index;
+
+		friend class RenderGraph;
+	};
+
+	struct Stats {
+		std::size_t passes{};
+		std::size_t culled{};
+		std::size_t transient_images{};
+		vk::DeviceSize transient_bytes{};
+		// total size if every transient image had its own memory
+		vk::DeviceSize unaliased_bytes{};
+	};
+
+	RenderGraph() = default;
+	RenderGraph(DeviceView const& device) : m_device(device) {}
+
+	// drops last frame's passes and resources
+	void begin();
+
+	Image create(ImageInfo const& info);
+	Image import(Import const& image);
+	// a logical buffer: dependencies through it are synchronized with global memory barriers
+	Buffer buffer();
+
+	Pass add_pass(Execute execute);
+
+	void compile();
+	void execute(vk::CommandBuffer cb, Ptr<GpuProfiler> profiler = {}) const;
+
+	// only valid between compile() and the next begin()
+	ImageView image(Image image) const;
+	Stats const& stats() const { return m_stats; }
+
+  private:
+	struct Use {
+		std::size_t resource{};
+		Access access{};
+		bool image{};
+	};
+
+	struct PassData {
+		Execute execute{};
+		std::vector<Use> uses{};
+		std::optional<FrameProfile::Type> profile{};
+		bool alive{};
+	};
+
+	struct ImageData {
+		ImageInfo info{};
+		std::optional<Import> imported{};
+		vk::ImageUsageFlags usage{};
+		ImageView physical{};
+	};
+
+	struct Sync {
+		vk::ImageLayout layout{};
+		// stages / unflushed writes the next conflicting access waits on
+		vk::PipelineStageFlags2 stages{};
+		vk::AccessFlags2 writes{};
+		// stages that already see the latest write
+		vk::PipelineStageFlags2 readers{};
+	};
+
+	struct Key {
+		ImageInfo info{};
+		vk::ImageUsageFlags usage{};
+		std::size_t block{};
+
+		bool operator==(Key const&) const = default;
+	};
+
+	struct Block {
+		vk::MemoryRequirements requirements{};
+		std::size_t free_after{};
+	};
+
+	struct Physical {
+		std::vector<Key> keys{};
+		// images are destroyed before the memory they alias
+		std::vector<UniqueAllocation> blocks{};
+		std::vector<vk::UniqueImage> images{};
+		std::vector<vk::UniqueImageView> views{};
+	};
+
+	vk::MemoryRequirements requirements(ImageInfo const& info, vk::ImageUsageFlags usage);
+	void allocate(Physical& out, std::vector<Key> keys, std::span<Block const> blocks);
+	void record_barriers(std::span<std::optional<std::size_t> const> aliases);
+
+	DeviceView m_device{};
+	std::vector<PassData> m_passes{};
+	std::vector<ImageData> m_images{};
+	std::size_t m_buffers{};
+	std::vector<std::size_t> m_order{};
+	// barriers to record before each pass in m_order, and after the last one
+	std::vector<std::vector<vk::ImageMemoryBarrier2>> m_image_barriers{};
+	std::vector<vk::MemoryBarrier2> m_memory_barriers{};
+	std::vector<vk::ImageMemoryBarrier2> m_final_barriers{};
+
+	Buffered<Physical> m_physical{};
+	std::unordered_map<std::size_t, vk::MemoryRequirements> m_requirements{};
+	Stats m_stats{};
+};
+} // namespace levk::vulkan
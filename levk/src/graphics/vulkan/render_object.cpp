@@ -2,6 +2,31 @@
 #include <graphics/vulkan/render_object.hpp>
 
 namespace levk::vulkan {
+namespace {
+bool can_batch(Drawable const& a, Drawable const& b) {
+	if (a.material.get() != b.material.get() || a.topology != b.topology) { return false; }
+	auto const& pa = *a.primitive.get();
+	auto const& pb = *b.primitive.get();
+	if (!pa.indirect_buffer() || pa.indirect_buffer() != pb.indirect_buffer()) { return false; }
+	if (pa.layout().index_type != pb.layout().index_type) { return false; }
+	return pa.layout().offsets == pb.layout().offsets && pa.layout().vertex_input.view().hash == pb.layout().vertex_input.view().hash;
+}
+
+glm::mat4 model_matrix(glm::mat4 const& parent, glm::mat4 const& instance, GeometryLayout const& layout) {
+	if (layout.dequant) { return parent * instance * *layout.dequant; }
+	return parent * instance;
+}
+
+std::size_t batch_size(std::span<Drawable const> drawables, Gpu const& gpu) {
+	assert(!drawables.empty());
+	// batched draws index into a shared instance buffer via firstInstance
+	if (!gpu.features.draw_indirect_first_instance) { return 1; }
+	auto ret = std::size_t{1};
+	while (ret < drawables.size() && can_batch(drawables.front(), drawables[ret])) { ++ret; }
+	return ret;
+}
+} // namespace
+
 std::vector<RenderObject> RenderObject::build_objects(DrawList const& draw_list, HostBuffer::Pool& buffer_pool) {
 	auto joints_mats = std::vector<BufferView>{};
 	joints_mats.reserve(draw_list.skins().size());
@@ -14,10 +39,16 @@ std::vector<RenderObject> RenderObject::build_objects(DrawList const& draw_list,
 
 	auto ret = std::vector<RenderObject>{};
 	ret.reserve(draw_list.drawables().size());
-	for (auto const& drawable : draw_list.drawables()) {
-		auto const* primitive = drawable.primitive.get();
-		if (!primitive) { continue; }
-		ret.push_back(build(drawable, *primitive, buffer_pool, joints_mats));
+	auto drawables = draw_list.drawables();
+	while (!drawables.empty()) {
+		auto const batch = batch_size(drawables, *buffer_pool.device.gpu);
+		if (batch > 1) {
+			ret.push_back(build_indirect(drawables.subspan(0, batch), buffer_pool));
+		} else {
+			auto const& drawable = drawables.front();
+			if (auto const* primitive = drawable.primitive.get()) { ret.push_back(build(drawable, *primitive, buffer_pool, joints_mats)); }
+		}
+		drawables = drawables.subspan(batch);
 	}
 	return ret;
 }
@@ -32,7 +63,9 @@ RenderObject RenderObject::build(Drawable drawable, Primitive const& primitive,
 			transform_instances = {&default_instance, 1};
 		}
 		auto& instance_buffer = buffer_pool.next(vk::BufferUsageFlagBits::eVertexBuffer);
-		auto const write_instances = [&](glm::mat4& out, std::size_t i) { out = drawable.parent * transform_instances[i].matrix(); };
+		auto const write_instances = [&](glm::mat4& out, std::size_t i) {
+			out = model_matrix(drawable.parent, transform_instances[i].matrix(), primitive.layout());
+		};
 		write_array<glm::mat4>(transform_instances.size(), instance_buffer, write_instances);
 		ret.instances.mats_vbo = instance_buffer.view();
 		ret.instances.count = static_cast<std::uint32_t>(transform_instances.size());
@@ -46,4 +79,47 @@ RenderObject RenderObject::build(Drawable drawable, Primitive const& primitive,
 
 	return ret;
 }
+
+RenderObject RenderObject::build_indirect(std::span<Drawable const> drawables, HostBuffer::Pool& buffer_pool) {
+	assert(!drawables.empty());
+	auto ret = RenderObject{drawables.front()};
+
+	auto mats = std::vector<glm::mat4>{};
+	auto commands = std::vector<vk::DrawIndexedIndirectCommand>{};
+	commands.reserve(drawables.size());
+	for (auto const& drawable : drawables) {
+		auto const& layout = drawable.primitive->layout();
+		auto const first_instance = static_cast<std::uint32_t>(mats.size());
+		if (drawable.instances.empty()) {
+			mats.push_back(model_matrix(drawable.parent, glm::mat4{1.0f}, layout));
+		} else {
+			for (auto const& instance : drawable.instances) { mats.push_back(model_matrix(drawable.parent, instance.matrix(), layout)); }
+		}
+		auto const instance_count = static_cast<std::uint32_t>(mats.size()) - first_instance;
+		commands.push_back(vk::DrawIndexedIndirectCommand{layout.indices, instance_count, layout.first_index, layout.vertex_offset, first_instance});
+	}
+
+	auto& instance_buffer = buffer_pool.next(vk::BufferUsageFlagBits::eVertexBuffer);
+	instance_buffer.write(mats.data(), std::span{mats}.size_bytes(), mats.size());
+	ret.instances.mats_vbo = instance_buffer.view();
+	ret.instances.count = static_cast<std::uint32_t>(mats.size());
+
+	// commands followed by the draw count (consumed by drawIndexedIndirectCount)
+	auto const draw_count = static_cast<std::uint32_t>(commands.size());
+	auto const commands_size = std::span{commands}.size_bytes();
+	auto bytes = std::vector<std::byte>(commands_size + sizeof(draw_count));
+	std::memcpy(bytes.data(), commands.data(), commands_size);
+	std::memcpy(bytes.data() + commands_size, &draw_count, sizeof(draw_count));
+	auto& command_buffer = buffer_pool.next(vk::BufferUsageFlagBits::eIndirectBuffer);
+	command_buffer.write(bytes.data(), bytes.size(), draw_count);
+	auto const& features = buffer_pool.device.gpu->features;
+	ret.indirect = IndirectDraw{
+		.commands = command_buffer.view(),
+		.draw_count = draw_count,
+		.multi_draw = features.multi_draw_indirect,
+	};
+	if (features.draw_indirect_count) { ret.indirect.count = {.buffer = ret.indirect.commands.buffer, .size = sizeof(draw_count), .offset = commands_size}; }
+
+	return ret;
+}
 } // namespace levk::vulkan
@@ -26,9 +26,11 @@ struct RenderObject {
 
 	static std::vector<RenderObject> build_objects(DrawList const& draw_list, HostBuffer::Pool& buffer_pool);
 	static RenderObject build(Drawable drawable, Primitive const& primitive, HostBuffer::Pool& buffer_pool, std::span<BufferView const> joints_mats);
+	static RenderObject build_indirect(std::span<Drawable const> drawables, HostBuffer::Pool& buffer_pool);
 
 	Drawable drawable;
 	Instances instances{};
 	Joints joints{};
+	IndirectDraw indirect{};
 };
 } // namespace levk::vulkan
@@ -117,7 +117,9 @@ struct DepthTarget {
 	UniqueImage make_target() const {
 		auto const ici = ImageCreateInfo{
 			.format = create_info.format,
-			.usage = vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled,
+			// transfer: cached shadow layers are copied between depth targets
+			.usage = vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferSrc |
+					 vk::ImageUsageFlagBits::eTransferDst,
 			.aspect = vk::ImageAspectFlagBits::eDepth,
 			.samples = create_info.samples,
 		};
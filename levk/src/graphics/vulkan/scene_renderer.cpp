@@ -1,17 +1,249 @@
+#include <graphics/vulkan/command_recorder.hpp>
 #include <graphics/vulkan/material.hpp>
 #include <graphics/vulkan/primitive.hpp>
 #include <graphics/vulkan/scene_renderer.hpp>
 #include <graphics/vulkan/shader.hpp>
+#include <graphics/vulkan/texture.hpp>
+#include <graphics/vulkan/vertex_format.hpp>
 #include <levk/asset/asset_providers.hpp>
 #include <levk/defines.hpp>
 #include <levk/graphics/material.hpp>
 #include <levk/scene/scene.hpp>
+#include <levk/util/hash_combine.hpp>
 #include <levk/util/logger.hpp>
+#include <algorithm>
+#include <array>
+#include <limits>
 
 namespace levk::vulkan {
 namespace {
 auto const g_log{Logger{"SceneRenderer"}};
 
+float world_radius(float const radius, glm::mat4 const& model) {
+	auto const max_scale = std::max({glm::length2(glm::vec3{model[0]}), glm::length2(glm::vec3{model[1]}), glm::length2(glm::vec3{model[2]})});
+	return radius * std::sqrt(max_scale);
+}
+
+struct Frustum {
+	// xyz: inward normal, w: distance
+	std::array<glm::vec4, 6> planes{};
+
+	// Gribb / Hartmann, for 0 - 1 clip space depth
+	static Frustum make(glm::mat4 const& view_projection) {
+		auto const& m = view_projection;
+		auto const row = [&m](int i) { return glm::vec4{m[0][i], m[1][i], m[2][i], m[3][i]}; };
+		auto ret = Frustum{{row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1), row(2), row(3) - row(2)}};
+		for (auto& plane : ret.planes) { plane /= glm::length(glm::vec3{plane}); }
+		return ret;
+	}
+
+	bool intersects(glm::vec3 const& centre, float const radius) const {
+		return std::ranges::all_of(planes, [&](glm::vec4 const& plane) { return glm::dot(glm::vec3{plane}, centre) + plane.w >= -radius; });
+	}
+};
+
+// Splits each drawable's instances by selected LOD and by visibility (frustum, then occlusion).
+// Split drawables point into instances, so it must have enough capacity reserved up front.
+struct InstanceSplitter {
+	LodSelector lod_selector{};
+	Ptr<Frustum const> frustum{};
+	Ptr<OcclusionCuller const> culler{};
+	std::vector<Transform> instances{};
+	std::vector<std::size_t> keys{};
+	OcclusionStats stats{};
+
+	// skinned bounds are only known in bind pose: never cull those
+	bool can_cull(Drawable const& drawable) const { return (frustum || culler) && drawable.radius > 0.0f && !drawable.skin_index; }
+
+	// [0, levels): visible at LOD; [levels, 2 * levels): culled at LOD - levels
+	std::size_t key(Drawable const& drawable, glm::mat4 const& model) {
+		auto const level = lod_selector.select(drawable, model);
+		if (!can_cull(drawable)) { return level; }
+		auto const centre = glm::vec3{model[3]};
+		auto const radius = world_radius(drawable.radius, model);
+		auto const culled = level + drawable.lods.size() + 1;
+		if (frustum && !frustum->intersects(centre, radius)) { return culled; }
+		if (!culler) { return level; }
+		++stats.tested;
+		if (!culler->is_occluded(centre, radius)) { return level; }
+		++stats.culled;
+		return culled;
+	}
+
+	// culled instances are dropped
+	void add(DrawList& out, Drawable const& drawable) {
+		if (drawable.lods.empty() && !can_cull(drawable)) { return out.add(drawable); }
+		auto const levels = drawable.lods.size() + 1;
+		auto const add_key = [&](std::size_t const k, std::span<Transform const> split) {
+			auto ret = drawable;
+			auto const level = k % levels;
+			ret.lods = {};
+			ret.instances = split;
+			if (level > 0) { ret.primitive = drawable.lods[level - 1].primitive->vulkan_primitive(); }
+			if (k < levels) { out.add(ret); }
+		};
+		if (drawable.instances.empty()) { return add_key(key(drawable, drawable.parent), {}); }
+
+		keys.clear();
+		for (auto const& instance : drawable.instances) { keys.push_back(key(drawable, drawable.parent * instance.matrix())); }
+		auto const [lowest, highest] = std::ranges::minmax(keys);
+		if (lowest == highest) { return add_key(lowest, drawable.instances); }
+
+		for (auto k = lowest; k <= highest; ++k) {
+			auto const begin = instances.size();
+			for (std::size_t i = 0; i < keys.size(); ++i) {
+				if (keys[i] == k) { instances.push_back(drawable.instances[i]); }
+			}
+			if (instances.size() == begin) { continue; }
+			add_key(k, std::span<Transform const>{instances}.subspan(begin));
+		}
+	}
+};
+
+// rasterizes all occluders in the scene; returns false if there are none to cull against
+bool rasterize_occluders(OcclusionCuller& out, Camera const& camera, glm::uvec2 const extent, std::span<Drawable const> drawables) {
+	if (extent.x == 0 || extent.y == 0) { return false; }
+	out.begin(camera.projection(extent) * camera.view());
+	for (auto const& drawable : drawables) {
+		if (!drawable.occluder) { continue; }
+		if (drawable.instances.empty()) {
+			out.add_occluder(*drawable.occluder, drawable.parent);
+			continue;
+		}
+		for (auto const& instance : drawable.instances) { out.add_occluder(*drawable.occluder, drawable.parent * instance.matrix()); }
+	}
+	if (out.occluder_triangles() == 0) { return false; }
+	out.build_pyramid();
+	return true;
+}
+
+struct CascadeView {
+	Camera camera{};
+	glm::mat4 mat{1.0f};
+	// far view space depth
+	float far{};
+};
+
+struct CascadeCasters {
+	Frustum frustum{};
+	InstanceSplitter splitter{};
+	DrawList static_casters{};
+	DrawList shadow_casters{};
+};
+
+Camera make_light_camera(glm::quat const& orientation, ViewPlane const view_plane) {
+	auto ret = Camera{.type = Camera::Orthographic{.view_plane = view_plane}, .face = Camera::Face::ePositiveZ};
+	ret.transform.set_orientation(orientation);
+	return ret;
+}
+
+// moves out to centre, rounded to a grid of step along the light view's axes
+void snap_to_light_grid(Camera& out, glm::vec3 const& centre, glm::vec3 const& step) {
+	out.transform.set_position({});
+	auto const view = out.view();
+	auto const local = glm::vec3{view * glm::vec4{centre, 1.0f}};
+	out.transform.set_position(glm::vec3{glm::inverse(view) * glm::vec4{glm::round(local / step) * step, 1.0f}});
+}
+
+// single shadow map: orthographic view of shadow_frustum along the primary light, centred on the camera
+CascadeView make_shadow_view(Scene const& scene, bool const snap) {
+	auto const view_plane = ViewPlane{.near = -0.5f * scene.shadow_frustum.z, .far = 0.5f * scene.shadow_frustum.z};
+	auto ret = CascadeView{.camera = make_light_camera(scene.lights.primary.direction, view_plane), .far = std::numeric_limits<float>::max()};
+	if (snap) {
+		// a cached layer would be invalidated by every camera move: follow it in steps of an eighth of the frustum instead
+		snap_to_light_grid(ret.camera, scene.camera.transform.position(), scene.shadow_frustum / 8.0f);
+	} else {
+		ret.camera.transform.set_position(scene.camera.transform.position());
+	}
+	ret.mat = ret.camera.projection(glm::vec2{scene.shadow_frustum}) * ret.camera.view();
+	return ret;
+}
+
+// splits the view frustum by depth, and fits an orthographic light view around the bounding sphere of each slice
+FlexArray<CascadeView, max_shadow_cascades_v> make_cascade_views(Scene const& scene, SceneRenderer const& renderer) {
+	auto ret = FlexArray<CascadeView, max_shadow_cascades_v>{};
+	auto const rects = renderer.shadow_atlas.cascades.span();
+	auto const* perspective = std::get_if<Camera::Perspective>(&scene.camera.type);
+	if (rects.empty()) { return ret; }
+	if (!perspective || rects.size() < 2) {
+		ret.insert(make_shadow_view(scene, renderer.static_shadow_cache));
+		return ret;
+	}
+
+	auto const& cascades = renderer.shadow_cascades;
+	auto const near = std::max(perspective->view_plane.near, 0.001f);
+	auto const far = std::max(std::min(perspective->view_plane.far, cascades.distance), 2.0f * near);
+	auto const extent = glm::vec2{renderer.framebuffer_extent};
+	auto const aspect = extent.y > 0.0f ? extent.x / extent.y : 1.0f;
+	auto const tan_y = std::tan(0.5f * perspective->field_of_view.value);
+	// squared half diagonal of a slice at unit depth
+	auto const diagonal = tan_y * tan_y * (1.0f + aspect * aspect);
+	auto const& eye = scene.camera.transform;
+	auto const front = eye.orientation() * (scene.camera.face == Camera::Face::ePositiveZ ? front_v : -front_v);
+	auto begin = near;
+	for (std::size_t i = 0; i < rects.size(); ++i) {
+		auto const t = static_cast<float>(i + 1) / static_cast<float>(rects.size());
+		auto const end = glm::mix(near + (far - near) * t, near * std::pow(far / near, t), cascades.split_lambda);
+		// the smallest sphere around a slice is centred on the view axis: its radius does not change as the camera turns
+		auto const centre_depth = std::min(0.5f * (begin + end) * (1.0f + diagonal), end);
+		auto const distance = [&](float depth) { return std::sqrt((centre_depth - depth) * (centre_depth - depth) + depth * depth * diagonal); };
+		// quantized, else float noise in the fit would move the light view every frame
+		auto const radius = std::ceil(std::max(distance(begin), distance(end)) * 16.0f) / 16.0f;
+		auto const resolution = static_cast<float>(std::max(std::min(rects[i].extent.width, rects[i].extent.height), 16u));
+		// texel sized steps keep shadow edges from shimmering; a cached static layer needs coarser ones to survive camera moves
+		auto const step = renderer.static_shadow_cache ? 0.25f * radius : 2.0f * radius / (resolution - 2.0f);
+		auto const half_extent = radius + step;
+		auto const view_plane = ViewPlane{.near = -std::max(half_extent, 0.5f * scene.shadow_frustum.z), .far = half_extent};
+		auto view = CascadeView{.camera = make_light_camera(scene.lights.primary.direction, view_plane), .far = end};
+		snap_to_light_grid(view.camera, eye.position() + front * centre_depth, glm::vec3{step});
+		view.mat = view.camera.projection(glm::vec2{2.0f * half_extent}) * view.camera.view();
+		ret.insert(view);
+		begin = end;
+	}
+	return ret;
+}
+
+// replaces skinned drawables with their output from the compute pre-pass, at the LOD selected for the main camera: every view draws the same vertices
+std::vector<Drawable> pre_skin(SkinningPass& out, DrawList const& draw_list, LodSelector const& lod_selector, HostBuffer::Pool& buffer_pool,
+							   ShaderProvider& shader_provider) {
+	out.begin(draw_list.skins(), buffer_pool, shader_provider);
+	if (draw_list.skins().empty()) { return {}; }
+	auto ret = std::vector<Drawable>{};
+	ret.reserve(draw_list.drawables().size());
+	for (auto drawable : draw_list.drawables()) {
+		if (drawable.skin_index) {
+			auto const model = drawable.instances.empty() ? drawable.parent : drawable.parent * drawable.instances.front().matrix();
+			auto const level = lod_selector.select(drawable, model);
+			auto const& primitive = level > 0 ? *drawable.lods[level - 1].primitive->vulkan_primitive() : *drawable.primitive;
+			if (auto* skinned = out.add(primitive, *drawable.skin_index)) {
+				drawable.primitive = skinned;
+				drawable.lods = {};
+			}
+		}
+		ret.push_back(drawable);
+	}
+	return ret;
+}
+
+std::size_t hash_static_casters(glm::mat4 const& light_mat, std::span<Drawable const> drawables) {
+	auto ret = std::size_t{};
+	auto const hash_mat = [&ret](glm::mat4 const& mat) {
+		for (int i = 0; i < 4; ++i) { hash_combine(ret, mat[i].x, mat[i].y, mat[i].z, mat[i].w); }
+	};
+	hash_mat(light_mat);
+	for (auto const& drawable : drawables) {
+		hash_combine(ret, drawable.primitive.get(), drawable.instances.size());
+		hash_mat(drawable.parent);
+		for (auto const& instance : drawable.instances) { hash_mat(instance.matrix()); }
+	}
+	return ret;
+}
+
+// instance matrices have been copied into each object's mats_vbo: the spans point into locals of build_render_frame
+void drop_instances(std::span<RenderObject> objects) {
+	for (auto& object : objects) { object.drawable.instances = {}; }
+}
+
 SceneRenderer::Frame build_render_frame(SceneRenderer& scene_renderer, Scene const& scene, RenderList const& render_list) {
 	auto ret = SceneRenderer::Frame{
 		.primary_light_direction = scene.lights.primary.direction,
@@ -30,6 +262,31 @@ SceneRenderer::Frame build_render_frame(SceneRenderer& scene_renderer, Scene con
 	}
 	scene_renderer.xbos[SceneRenderer::Xbo::eDirLights].write(dir_lights.span().data(), dir_lights.span().size_bytes());
 
+	using Std430LocalLight = SceneRenderer::Frame::Std430LocalLight;
+
+	auto local_lights = std::vector<Std430LocalLight>{};
+	auto light_bounds = std::vector<LightBounds>{};
+	local_lights.reserve(scene.lights.point_lights.size() + scene.lights.spot_lights.size());
+	light_bounds.reserve(local_lights.capacity());
+	for (auto const& light : scene.lights.point_lights) {
+		local_lights.push_back(Std430LocalLight::make(light));
+		light_bounds.push_back({light.position, light.range});
+	}
+	for (auto const& light : scene.lights.spot_lights) {
+		local_lights.push_back(Std430LocalLight::make(light));
+		light_bounds.push_back(spot_bounds(light));
+	}
+	ret.local_lights = static_cast<std::uint32_t>(local_lights.size());
+	// lit.frag skips clusters without local lights, but storage buffers must not be empty
+	if (local_lights.empty()) {
+		local_lights.emplace_back();
+	} else {
+		scene_renderer.light_clusters.build(scene.camera, scene_renderer.framebuffer_extent, light_bounds, &scene_renderer.worker_pool);
+	}
+	auto const clusters = scene_renderer.light_clusters.data();
+	scene_renderer.xbos[SceneRenderer::Xbo::eLocalLights].write(local_lights.data(), local_lights.size() * sizeof(Std430LocalLight));
+	scene_renderer.xbos[SceneRenderer::Xbo::eClusters].write(clusters.data(), clusters.size_bytes());
+
 	auto& buffer_pool = scene_renderer.buffer_pools[*scene_renderer.device.buffered_index];
 
 	if (scene.skybox) {
@@ -41,21 +298,90 @@ SceneRenderer::Frame build_render_frame(SceneRenderer& scene_renderer, Scene con
 		ret.skybox.emplace(RenderObject::build(drawable, scene_renderer.skybox_cube, buffer_pool, {}));
 	}
 
+	auto splitter = InstanceSplitter{.lod_selector = LodSelector::make(scene.camera, scene_renderer.lod_bias)};
+	auto drawables = render_list.scene.drawables();
+	auto pre_skinned = std::vector<Drawable>{};
+	if (scene_renderer.compute_skinning) {
+		auto& shader_provider = scene_renderer.asset_providers->shader();
+		pre_skinned = pre_skin(scene_renderer.skinning_pass, render_list.scene, splitter.lod_selector, buffer_pool, shader_provider);
+		if (!pre_skinned.empty()) { drawables = pre_skinned; }
+	}
+	auto& culler = scene_renderer.occlusion_culler;
+	if (scene_renderer.occlusion_culling && rasterize_occluders(culler, scene.camera, scene_renderer.framebuffer_extent, drawables)) {
+		splitter.culler = &culler;
+		splitter.stats.occluder_triangles = culler.occluder_triangles();
+	}
+
+	auto split_instances = std::size_t{};
+	for (auto const& drawable : drawables) {
+		if (!drawable.lods.empty() || drawable.radius > 0.0f) { split_instances += drawable.instances.size(); }
+	}
+	splitter.instances.reserve(split_instances);
+
 	auto opaque = DrawList{};
 	auto transparent = DrawList{};
 	opaque.import_skins(render_list.scene.skins());
 	transparent.import_skins(render_list.scene.skins());
-	for (auto const& drawable : render_list.scene.drawables()) {
-		if (drawable.material->is_opaque()) {
-			opaque.add(drawable);
-		} else {
-			transparent.add(drawable);
-		}
-	}
+	for (auto const& drawable : drawables) { splitter.add(drawable.material->is_opaque() ? opaque : transparent, drawable); }
+	assert(splitter.instances.size() <= split_instances);
+	scene_renderer.occlusion_stats = splitter.stats;
 
 	opaque.sort_by([](Drawable const& a, Drawable const& b) { return a.material.get() < b.material.get(); });
 	ret.opaque = RenderObject::build_objects(opaque, buffer_pool);
 
+	auto const static_cache = scene_renderer.static_shadow_cache;
+	auto const cascade_views = make_cascade_views(scene, scene_renderer);
+	if (!cascade_views.empty()) { ret.primary_light_mat = cascade_views.span().front().mat; }
+	// instance matrices are computed lazily: resolve them here, before worker threads read them
+	for (auto const& drawable : drawables) {
+		for (auto const& instance : drawable.instances) { instance.matrix(); }
+	}
+	auto casters = std::array<CascadeCasters, max_shadow_cascades_v>{};
+	auto const cull_cascade = [&](std::size_t const index) {
+		auto const& view = cascade_views.span()[index];
+		auto& out = casters[index];
+		out.frustum = Frustum::make(view.mat);
+		out.splitter.frustum = &out.frustum;
+		out.splitter.instances.reserve(split_instances);
+		// static casters select LODs from the snapped light origin, so the cached layer survives small camera moves
+		auto static_lods = splitter.lod_selector;
+		if (static_cache && static_lods.scale > 0.0f) { static_lods.eye = view.camera.transform.position(); }
+		for (auto const& drawable : drawables) {
+			// the shadow pass does not skin vertices: skinned meshes only cast shadows once skinned by the compute pre-pass
+			if (!drawable.material->is_opaque() || drawable.primitive->layout().joints_binding) { continue; }
+			auto const is_static = static_cache && drawable.is_static;
+			out.splitter.lod_selector = is_static ? static_lods : splitter.lod_selector;
+			out.splitter.add(is_static ? out.static_casters : out.shadow_casters, drawable);
+		}
+		assert(out.splitter.instances.size() <= split_instances);
+	};
+	{
+		auto tasks = std::array<ScopedFuture<void>, max_shadow_cascades_v>{};
+		for (std::size_t i = 1; i < cascade_views.size(); ++i) { tasks[i] = scene_renderer.worker_pool.submit([&cull_cascade, i] { cull_cascade(i); }); }
+		if (!cascade_views.empty()) { cull_cascade(0); }
+		for (auto const& task : tasks) {
+			if (task.future.valid()) { task.future.get(); }
+		}
+	}
+
+	auto static_hash = std::size_t{};
+	for (std::size_t i = 0; i < cascade_views.size(); ++i) {
+		auto const& view = cascade_views.span()[i];
+		auto const& rect = scene_renderer.shadow_atlas.cascades.span()[i];
+		if (static_cache) {
+			hash_combine(static_hash, rect.offset.x, rect.offset.y, rect.extent.width, rect.extent.height);
+			hash_combine(static_hash, hash_static_casters(view.mat, casters[i].static_casters.drawables()));
+		}
+		ret.cascades.push_back(SceneRenderer::Frame::Cascade{
+			.mat = view.mat,
+			.rect = rect,
+			.far = view.far,
+			.static_casters = RenderObject::build_objects(casters[i].static_casters, buffer_pool),
+			.shadow_casters = RenderObject::build_objects(casters[i].shadow_casters, buffer_pool),
+		});
+	}
+	if (static_cache) { scene_renderer.static_shadow_hash = static_hash; }
+
 	transparent.sort_by([camera_position = scene.camera.transform.position()](Drawable const& a, Drawable const& b) {
 		auto const transform_a = Transform::from(a.parent);
 		auto const transform_b = Transform::from(b.parent);
@@ -65,13 +391,20 @@ SceneRenderer::Frame build_render_frame(SceneRenderer& scene_renderer, Scene con
 	});
 	ret.transparent = RenderObject::build_objects(transparent, buffer_pool);
 
-	ret.ui = RenderObject::build_objects(render_list.ui, buffer_pool);
+	auto ui = DrawList{};
+	scene_renderer.ui_batcher.batch(render_list.ui.drawables(), ui);
+	ret.ui = RenderObject::build_objects(ui, buffer_pool);
 
 	opaque.clear();
 	scene_renderer.collision_renderer.render(opaque);
 	opaque.sort_by([](Drawable const& a, Drawable const& b) { return a.material.get() < b.material.get(); });
 	ret.overlay = RenderObject::build_objects(opaque, buffer_pool);
 
+	for (auto* objects : {&ret.opaque, &ret.transparent, &ret.ui, &ret.overlay}) { drop_instances(*objects); }
+	for (auto& cascade : ret.cascades) {
+		drop_instances(cascade.static_casters);
+		drop_instances(cascade.shadow_casters);
+	}
 	return ret;
 }
 
@@ -135,6 +468,12 @@ UploadedPrimitive make_skybox_cube(DeviceView const& device) {
 	return UploadedPrimitive::make_static(device, geometry);
 }
 
+struct LightBuffers {
+	BufferView dir_lights{};
+	BufferView local_lights{};
+	BufferView clusters{};
+};
+
 struct Drawer {
 	DeviceView device;
 	AssetProviders const& asset_providers;
@@ -142,13 +481,26 @@ struct Drawer {
 	vk::Extent2D extent;
 	vk::CommandBuffer cb;
 
-	BufferView dir_lights_ssbo{};
+	LightBuffers lights{};
 	ImageView shadow_map{};
+	// unbiased: estimates how large each object's textures appear on screen, for streaming
+	LodSelector coverage{};
 
 	Ptr<Material const> previous_material{};
+	std::vector<Ptr<Texture const>> material_textures{};
+	bool layouts_built{};
+
+	// objects without bounds (or outside a perspective view) are assumed to fill it
+	std::uint32_t screen_extent(Drawable const& drawable) const {
+		auto const size = coverage.screen_size(drawable.radius, drawable.parent);
+		if (size <= 0.0f || size >= 1.0f) { return extent.height; }
+		return static_cast<std::uint32_t>(size * static_cast<float>(extent.height));
+	}
 
 	void write_per_mat_sets(RenderObject const& object, Shader& shader) const {
-		if (dir_lights_ssbo.buffer) { shader.update(Lights::set_v, DirLight::binding_v, dir_lights_ssbo); }
+		if (lights.dir_lights.buffer) { shader.update(Lights::set_v, DirLight::binding_v, lights.dir_lights); }
+		if (lights.local_lights.buffer) { shader.update(Lights::set_v, Lights::local_binding_v, lights.local_lights); }
+		if (lights.clusters.buffer) { shader.update(Lights::set_v, Lights::cluster_binding_v, lights.clusters); }
 		if (shadow_map.view) {
 			static constexpr auto shadow_sampler_v = TextureSampler{
 				.wrap_s = TextureSampler::Wrap::eClampEdge,
@@ -164,31 +516,98 @@ struct Drawer {
 		auto* primitive = object.drawable.primitive.get();
 		auto* material = object.drawable.material->vulkan_material();
 		if (!primitive || !material) { return; }
-		if (!material->build_layout(pipeline_builder, object.drawable.material->vertex_shader, object.drawable.material->fragment_shader)) { return; }
+		auto const format = primitive->layout().format;
+		auto const pre_skinned = primitive->layout().pre_skinned;
+		auto const& vert = object.drawable.material->vertex_shader;
+		auto const& frag = object.drawable.material->fragment_shader;
+		if (!layouts_built && !material->build_layout(pipeline_builder, vert, frag, format, pre_skinned)) { return; }
 		auto rm = combine(object.drawable.material->render_mode, device.default_render_mode);
 		auto const pipeline_state = PipelineState{
 			.mode = from(rm.type),
 			.topology = from(object.drawable.topology),
 			.depth_test = rm.depth_test,
 		};
-		auto pipeline = pipeline_builder.try_build(primitive->layout().vertex_input, pipeline_state, material->shader_layout.hash);
+		auto pipeline = pipeline_builder.try_build(primitive->layout().vertex_input, pipeline_state, material->shader_layout(format, pre_skinned).hash);
 		if (!pipeline) { return; }
 
 		pipeline.bind(cb, extent, rm.line_width);
 		auto shader = Shader{device, pipeline};
 		if (material != previous_material) {
+			material_textures.clear();
+			shader.bound_textures = &material_textures;
 			write_per_mat_sets(object, shader);
+			shader.bound_textures = {};
 			previous_material = material;
 		}
+		auto const pixels = screen_extent(object.drawable);
+		for (auto const* texture : material_textures) { texture->usage.record(pixels); }
 		if (object.instances.mats_vbo.buffer) { cb.bindVertexBuffers(object.instances.vertex_binding_v, object.instances.mats_vbo.buffer, vk::DeviceSize{0}); }
 		if (object.joints.mats_ssbo.buffer) { shader.update(object.joints.descriptor_set_v, object.joints.descriptor_binding_v, object.joints.mats_ssbo); }
 		shader.bind(pipeline.layout, cb);
-		primitive->draw(cb, object.instances.count);
+		if (object.indirect) {
+			primitive->draw(cb, object.indirect);
+		} else {
+			primitive->draw(cb, object.instances.count);
+		}
 		++*device.draw_calls;
 	}
 };
+
+// material layouts are shared state: build them on the render thread before recording draws on workers
+void build_layouts(std::span<RenderObject const> objects, PipelineBuilder& pipeline_builder) {
+	auto previous = Ptr<levk::Material const>{};
+	auto previous_format = VertexFormat{};
+	auto previous_pre_skinned = false;
+	for (auto const& object : objects) {
+		auto const* material = object.drawable.material.get();
+		auto const* primitive = object.drawable.primitive.get();
+		auto const format = primitive ? primitive->layout().format : VertexFormat{};
+		auto const pre_skinned = primitive && primitive->layout().pre_skinned;
+		if (material == previous && format == previous_format && pre_skinned == previous_pre_skinned) { continue; }
+		previous = material;
+		previous_format = format;
+		previous_pre_skinned = pre_skinned;
+		if (auto* vulkan_material = material->vulkan_material()) {
+			vulkan_material->build_layout(pipeline_builder, material->vertex_shader, material->fragment_shader, format, pre_skinned);
+		}
+	}
+}
 } // namespace
 
+LodSelector LodSelector::make(Camera const& camera, float const bias) {
+	auto const* perspective = std::get_if<Camera::Perspective>(&camera.type);
+	// orthographic views and a zero bias always draw full detail
+	if (!perspective || bias <= 0.0f) { return {}; }
+	return {camera.transform.position(), 1.0f / (std::tan(0.5f * perspective->field_of_view.value) * bias)};
+}
+
+float LodSelector::screen_size(float const bounds_radius, glm::mat4 const& model) const {
+	if (scale <= 0.0f || bounds_radius <= 0.0f) { return 0.0f; }
+	auto const radius = world_radius(bounds_radius, model);
+	auto const distance = glm::length(glm::vec3{model[3]} - eye);
+	if (distance <= radius) { return std::numeric_limits<float>::max(); }
+	return radius / distance * scale;
+}
+
+std::size_t LodSelector::select(Drawable const& drawable, glm::mat4 const& model) const {
+	if (scale <= 0.0f || drawable.radius <= 0.0f || drawable.lods.empty()) { return 0; }
+	auto const screen_size = this->screen_size(drawable.radius, model);
+	auto ret = std::size_t{};
+	for (std::size_t i = 0; i < drawable.lods.size(); ++i) {
+		if (screen_size < drawable.lods[i].screen_size) { ret = i + 1; }
+	}
+	return ret;
+}
+
+LightBounds spot_bounds(SpotLight const& light) {
+	auto const angle = light.outer_angle.value;
+	if (angle >= glm::half_pi<float>()) { return {light.position, light.range}; }
+	auto const direction = glm::normalize(light.direction * front_v);
+	if (angle > glm::quarter_pi<float>()) { return {light.position + direction * std::cos(angle) * light.range, std::sin(angle) * light.range}; }
+	auto const radius = 0.5f * light.range / std::cos(angle);
+	return {light.position + direction * radius, radius};
+}
+
 CollisionRenderer::CollisionRenderer(DeviceView device) : m_pool{device} {
 	static constexpr RenderMode render_mode_v{
 		.line_width = 3.0,
@@ -212,6 +631,7 @@ void CollisionRenderer::update(Collision const& collision) {
 			if (!in.collider || !in.active) { continue; }
 			auto& out = m_pool.next();
 			out.primitive.geometry = make_wire_cube(in.aabb.size, in.aabb.origin);
+			++out.primitive.version;
 			out.material = in.colliding ? &m_red : &m_green;
 		}
 	}
@@ -229,12 +649,13 @@ void CollisionRenderer::render(DrawList& out) const {
 }
 
 SceneRenderer::SceneRenderer(DeviceView const& device)
-	: device(device), skybox_cube(make_skybox_cube(device)), global_layout(make_global_layout(device.device)), collision_renderer(device),
-	  device_block(device.device) {
+	: device(device), skybox_cube(make_skybox_cube(device)), global_layout(make_global_layout(device.device)), collision_renderer(device), ui_batcher(device),
+	  skinning_pass(device), device_block(device.device) {
 	for (auto& buffer_pool : buffer_pools) { buffer_pool = HostBuffer::Pool::make(device); }
 
 	for (Xbo xbo{}; xbo < Xbo::eCOUNT_; xbo = Xbo(int(xbo) + 1)) {
-		auto const usage = xbo == Xbo::eDirLights ? vk::BufferUsageFlagBits::eStorageBuffer : vk::BufferUsageFlagBits::eUniformBuffer;
+		auto const is_ssbo = xbo == Xbo::eDirLights || xbo == Xbo::eLocalLights || xbo == Xbo::eClusters;
+		auto const usage = is_ssbo ? vk::BufferUsageFlagBits::eStorageBuffer : vk::BufferUsageFlagBits::eUniformBuffer;
 		xbos[xbo] = HostBuffer::make(device, usage);
 	}
 
@@ -256,98 +677,176 @@ void SceneRenderer::next_frame() {
 	frame = build_render_frame(*this, *scene, *render_list);
 }
 
-void SceneRenderer::render_shadow(vk::CommandBuffer cb, Depthbuffer& depthbuffer) {
-	if (frame.opaque.empty()) { return; }
+void SceneRenderer::render_skinning(vk::CommandBuffer cb) { skinning_pass.dispatch(cb); }
 
-	static auto const vertex_input = VertexInput::for_shadow();
+void SceneRenderer::render_shadow(CommandRecorder& recorder, Depthbuffer& depthbuffer, ShadowLayer const layer) {
+	auto const casters = [layer](Frame::Cascade const& cascade) {
+		return std::span<RenderObject const>{layer == ShadowLayer::eStatic ? cascade.static_casters : cascade.shadow_casters};
+	};
+	if (std::ranges::all_of(frame.cascades, [&](Frame::Cascade const& cascade) { return casters(cascade).empty(); })) { return; }
+
+	// shadow.vert only reads positions, which the vertex input unpacks for either format
+	static auto const vertex_inputs = EnumArray<VertexFormat, VertexInput>{
+		VertexInput::for_shadow(),
+		VertexStreams::make(VertexFormat::ePacked, false).shadow_input(),
+	};
 
 	auto const format = depthbuffer.pipeline_format();
 	auto pipeline_builder = PipelineBuilder{*device.pipeline_storage, asset_providers->shader(), device.device, format};
 	auto layout = pipeline_builder.try_build_layout("shaders/shadow.vert", "shaders/noop.frag");
 	assert(layout);
-	auto pipeline = pipeline_builder.try_build(vertex_input, {}, layout->hash);
-	assert(pipeline);
-	pipeline.bind(cb, depthbuffer.image.extent);
-
-	auto& view_buffer = buffer_pools[*device.buffered_index].next(vk::BufferUsageFlagBits::eUniformBuffer);
-	assert(scene);
-	auto const view_plane = ViewPlane{.near = -0.5f * scene->shadow_frustum.z, .far = 0.5f * scene->shadow_frustum.z};
-	auto camera = Camera{.type = Camera::Orthographic{.view_plane = view_plane}, .face = Camera::Face::ePositiveZ};
-	camera.transform.set_orientation(frame.primary_light_direction);
-	camera.transform.set_position(frame.camera_3d.transform.position());
-	frame.primary_light_mat = camera.projection(scene->shadow_frustum) * camera.view();
-	view_buffer.write(&frame.primary_light_mat, sizeof(frame.primary_light_mat));
-	auto shader = Shader{device, pipeline};
-	shader.update(0, 0, view_buffer.view());
-	shader.bind(pipeline.layout, cb);
-
-	for (auto const& object : frame.opaque) {
-		auto* primitive = object.drawable.primitive.get();
-		assert(primitive);
-		if (!object.instances.mats_vbo.buffer || primitive->layout().joints_binding) { continue; }
-		cb.bindVertexBuffers(*primitive->layout().instances_binding, object.instances.mats_vbo.buffer, vk::DeviceSize{0});
-		primitive->draw(cb, object.instances.count);
+	auto pipelines = EnumArray<VertexFormat, Pipeline>{};
+	for (auto vf = VertexFormat{}; vf < VertexFormat::eCOUNT_; vf = VertexFormat(int(vf) + 1)) {
+		pipelines[vf] = pipeline_builder.try_build(vertex_inputs[vf], {}, layout->hash);
+		assert(pipelines[vf]);
+	}
+
+	for (auto const& cascade : frame.cascades) {
+		auto const objects = casters(cascade);
+		if (objects.empty()) { continue; }
+		auto& view_buffer = buffer_pools[*device.buffered_index].next(vk::BufferUsageFlagBits::eUniformBuffer);
+		view_buffer.write(&cascade.mat, sizeof(cascade.mat));
+		auto shader = Shader{device, pipelines[VertexFormat::eFull]};
+		shader.update(0, 0, view_buffer.view());
+
+		// each cascade draws into its own region of the atlas
+		auto const bind = [&cascade, &depthbuffer](Pipeline& pipeline, vk::CommandBuffer cb) {
+			pipeline.bind(cb, depthbuffer.image.extent);
+			auto const offset = glm::vec2{cascade.rect.offset.x, cascade.rect.offset.y};
+			auto const extent = glm::vec2{cascade.rect.extent.width, cascade.rect.extent.height};
+			cb.setViewport(0u, vk::Viewport{offset.x, offset.y + extent.y, extent.x, -extent.y, 0.0f, 1.0f});
+			cb.setScissor(0u, cascade.rect);
+		};
+		recorder.record(objects.size(), [&](CommandRecorder::Context const& context, std::size_t begin, std::size_t end) {
+			auto bound = VertexFormat::eFull;
+			bind(pipelines[bound], context.cb);
+			shader.bind(pipelines[bound].layout, context.cb);
+			for (auto const& object : objects.subspan(begin, end - begin)) {
+				auto* primitive = object.drawable.primitive.get();
+				assert(primitive);
+				if (!object.instances.mats_vbo.buffer || primitive->layout().joints_binding) { continue; }
+				if (primitive->layout().format != bound) {
+					bound = primitive->layout().format;
+					bind(pipelines[bound], context.cb);
+				}
+				context.cb.bindVertexBuffers(*primitive->layout().instances_binding, object.instances.mats_vbo.buffer, vk::DeviceSize{0});
+				if (object.indirect) {
+					primitive->draw(context.cb, object.indirect);
+				} else {
+					primitive->draw(context.cb, object.instances.count);
+				}
+			}
+		});
 	}
 }
 
-void SceneRenderer::render_3d(vk::CommandBuffer cb, Framebuffer& framebuffer, ImageView const& shadow_map) {
+void SceneRenderer::render_3d(CommandRecorder& recorder, Framebuffer& framebuffer, ImageView const& shadow_map) {
 	if (!frame.skybox && frame.opaque.empty() && frame.transparent.empty() && frame.overlay.empty()) { return; }
 
 	auto const format = framebuffer.pipeline_format();
-	auto pipeline_builder = PipelineBuilder{*device.pipeline_storage, asset_providers->shader(), device.device, format};
-	auto drawer_3d = Drawer{device, *asset_providers, pipeline_builder, framebuffer.colour.extent, cb, xbos[Xbo::eDirLights].view(), shadow_map};
+	auto const extent = framebuffer.colour.extent;
+	auto const lights = LightBuffers{xbos[Xbo::eDirLights].view(), xbos[Xbo::eLocalLights].view(), xbos[Xbo::eClusters].view()};
 
 	if (frame.skybox) {
 		auto skybox_camera = frame.camera_3d;
 		skybox_camera.transform.set_position({});
-		bind_view_set(cb, xbos[Xbo::eSkybox], skybox_camera, {drawer_3d.extent.width, drawer_3d.extent.height});
-		drawer_3d.draw(*frame.skybox);
+		auto const set = make_view_set(xbos[Xbo::eSkybox], skybox_camera, {extent.width, extent.height});
+		recorder.record([&](CommandRecorder::Context const& context) {
+			auto pipeline_builder = PipelineBuilder{*device.pipeline_storage, asset_providers->shader(), device.device, format};
+			bind_view_set(context.cb, set);
+			Drawer{context.device, *asset_providers, pipeline_builder, extent, context.cb, lights, shadow_map}.draw(*frame.skybox);
+		});
 	}
 
-	bind_view_set(cb, xbos[Xbo::e3d], frame.camera_3d, {drawer_3d.extent.width, drawer_3d.extent.height});
-	for (auto const& object : frame.opaque) { drawer_3d.draw(object); }
-	for (auto const& object : frame.transparent) { drawer_3d.draw(object); }
-	for (auto const& object : frame.overlay) { drawer_3d.draw(object); }
+	auto const set = make_view_set(xbos[Xbo::e3d], frame.camera_3d, {extent.width, extent.height});
+	auto const coverage = LodSelector::make(frame.camera_3d, 1.0f);
+	auto const record = [&](std::span<RenderObject const> objects) {
+		if (recorder.is_parallel()) {
+			auto pipeline_builder = PipelineBuilder{*device.pipeline_storage, asset_providers->shader(), device.device, format};
+			build_layouts(objects, pipeline_builder);
+		}
+		recorder.record(objects.size(), [&](CommandRecorder::Context const& context, std::size_t begin, std::size_t end) {
+			auto pipeline_builder = PipelineBuilder{*device.pipeline_storage, asset_providers->shader(), device.device, format};
+			auto drawer = Drawer{context.device, *asset_providers, pipeline_builder, extent, context.cb, lights, shadow_map};
+			drawer.coverage = coverage;
+			drawer.layouts_built = recorder.is_parallel();
+			bind_view_set(context.cb, set);
+			for (auto const& object : objects.subspan(begin, end - begin)) { drawer.draw(object); }
+		});
+	};
+	record(frame.opaque);
+	record(frame.transparent);
+	record(frame.overlay);
 }
 
-void SceneRenderer::render_ui(vk::CommandBuffer cb, Framebuffer& framebuffer, ImageView const& output_3d) {
+void SceneRenderer::render_ui(CommandRecorder& recorder, Framebuffer& framebuffer, ImageView const& output_3d) {
 	auto const format = framebuffer.pipeline_format();
-	auto pipeline_builder = PipelineBuilder{*device.pipeline_storage, asset_providers->shader(), device.device, format};
-	draw_3d_to_ui(cb, output_3d, pipeline_builder, framebuffer.output().extent);
+	auto const extent = framebuffer.colour.extent;
+	recorder.record([&](CommandRecorder::Context const& context) {
+		auto pipeline_builder = PipelineBuilder{*device.pipeline_storage, asset_providers->shader(), device.device, format};
+		draw_3d_to_ui(context, output_3d, pipeline_builder, framebuffer.output().extent);
+	});
 
-	auto drawer_ui = Drawer{device, *asset_providers, pipeline_builder, framebuffer.colour.extent, cb};
-	auto camera = Camera{.type = Camera::Orthographic{}};
-	bind_view_set(drawer_ui.cb, xbos[Xbo::eUi], camera, {drawer_ui.extent.width, drawer_ui.extent.height});
-	for (auto const& object : frame.ui) { drawer_ui.draw(object); }
+	auto const camera = Camera{.type = Camera::Orthographic{}};
+	auto const set = make_view_set(xbos[Xbo::eUi], camera, {extent.width, extent.height});
+	auto const objects = std::span<RenderObject const>{frame.ui};
+	if (recorder.is_parallel()) {
+		auto pipeline_builder = PipelineBuilder{*device.pipeline_storage, asset_providers->shader(), device.device, format};
+		build_layouts(objects, pipeline_builder);
+	}
+	recorder.record(objects.size(), [&](CommandRecorder::Context const& context, std::size_t begin, std::size_t end) {
+		auto pipeline_builder = PipelineBuilder{*device.pipeline_storage, asset_providers->shader(), device.device, format};
+		auto drawer_ui = Drawer{context.device, *asset_providers, pipeline_builder, extent, context.cb};
+		drawer_ui.layouts_built = recorder.is_parallel();
+		bind_view_set(context.cb, set);
+		for (auto const& object : objects.subspan(begin, end - begin)) { drawer_ui.draw(object); }
+	});
 }
 
-void SceneRenderer::bind_view_set(vk::CommandBuffer cb, HostBuffer& out_ubo, Camera const& camera, glm::uvec2 const extent) {
-	auto const view = Frame::Std140View{
+vk::DescriptorSet SceneRenderer::make_view_set(HostBuffer& out_ubo, Camera const& camera, glm::uvec2 const extent) {
+	auto const front = camera.transform.orientation() * (camera.face == Camera::Face::ePositiveZ ? front_v : -front_v);
+	auto view = Frame::Std140View{
 		.mat_vp = camera.projection(extent) * camera.view(),
 		.vpos_exposure = {camera.transform.position(), camera.exposure},
 		.mat_shadow = frame.primary_light_mat,
 		.shadow_dir = glm::vec4{frame.primary_light_direction * front_v, 1.0f},
+		.front_cascades = glm::vec4{front, static_cast<float>(frame.cascades.size())},
+		.cluster_grid = glm::uvec4{light_clusters.grid(), frame.local_lights},
+		.cluster_depth = light_clusters.depth_params(),
 	};
+	auto const atlas = glm::vec2{shadow_atlas.extent.width, shadow_atlas.extent.height};
+	for (std::size_t i = 0; i < frame.cascades.size() && atlas.x > 0.0f && atlas.y > 0.0f; ++i) {
+		auto const& cascade = frame.cascades[i];
+		auto const offset = glm::vec2{cascade.rect.offset.x, cascade.rect.offset.y} / atlas;
+		auto const size = glm::vec2{cascade.rect.extent.width, cascade.rect.extent.height} / atlas;
+		view.cascade_far[static_cast<glm::length_t>(i)] = cascade.far;
+		view.cascade_rects[i] = glm::vec4{offset, size};
+		view.cascade_mats[i] = cascade.mat;
+	}
 	out_ubo.write(&view, sizeof(view));
 	auto const buffer_view = out_ubo.view();
-	auto set0 = device.set_allocator->allocate(*global_layout.global_set_layout);
+	auto ret = device.set_allocator->allocate(*global_layout.global_set_layout);
 	auto const dbi = vk::DescriptorBufferInfo{buffer_view.buffer, {}, buffer_view.size};
-	auto wds = vk::WriteDescriptorSet{set0, 0u, 0u, 1u, vk::DescriptorType::eUniformBuffer};
+	auto wds = vk::WriteDescriptorSet{ret, 0u, 0u, 1u, vk::DescriptorType::eUniformBuffer};
 	wds.pBufferInfo = &dbi;
 	device.device.updateDescriptorSets(wds, {});
+	return ret;
+}
 
-	cb.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *global_layout.global_pipeline_layout, 0u, set0, {});
+void SceneRenderer::bind_view_set(vk::CommandBuffer cb, vk::DescriptorSet set) const {
+	cb.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *global_layout.global_pipeline_layout, 0u, set, {});
 }
 
-void SceneRenderer::draw_3d_to_ui(vk::CommandBuffer cb, ImageView const& output_3d, PipelineBuilder& pipeline_builder, vk::Extent2D extent) {
+void SceneRenderer::draw_3d_to_ui(CommandRecorder::Context const& context, ImageView const& output_3d, PipelineBuilder& pipeline_builder,
+								  vk::Extent2D extent) {
 	auto layout = pipeline_builder.try_build_layout("shaders/fs_quad.vert", "shaders/fs_quad.frag");
 	assert(layout);
 	auto pipeline = pipeline_builder.try_build({}, {}, layout->hash);
 	assert(pipeline);
-	pipeline.bind(cb, extent, {}, false);
-	auto shader = Shader{device, pipeline};
+	pipeline.bind(context.cb, extent, {}, false);
+	auto shader = Shader{context.device, pipeline};
 	shader.update(0, 0, output_3d, {});
-	shader.bind(pipeline.layout, cb);
-	cb.draw(6u, 1u, 0u, 0u);
+	shader.bind(pipeline.layout, context.cb);
+	context.cb.draw(6u, 1u, 0u, 0u);
 }
 } // namespace levk::vulkan
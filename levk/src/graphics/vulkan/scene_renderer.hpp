@@ -1,11 +1,17 @@
 #pragma once
+#include <graphics/vulkan/command_recorder.hpp>
 #include <graphics/vulkan/device.hpp>
 #include <graphics/vulkan/framebuffer.hpp>
 #include <graphics/vulkan/primitive.hpp>
 #include <graphics/vulkan/render_object.hpp>
+#include <graphics/vulkan/skinning.hpp>
+#include <graphics/vulkan/ui_batcher.hpp>
+#include <levk/graphics/light_clusters.hpp>
 #include <levk/graphics/lights.hpp>
 #include <levk/graphics/material.hpp>
+#include <levk/graphics/occlusion_culler.hpp>
 #include <levk/util/enum_array.hpp>
+#include <array>
 #include <optional>
 
 namespace levk {
@@ -15,6 +21,23 @@ class Collision;
 namespace vulkan {
 struct PipelineBuilder;
 
+// selects a drawable's LOD by the fraction of the viewport height its bounds cover
+struct LodSelector {
+	glm::vec3 eye{};
+	// 1 / (tan(fov / 2) * bias): converts radius / distance into a fraction of the viewport height
+	float scale{};
+
+	static LodSelector make(Camera const& camera, float bias);
+
+	// fraction of the viewport height covered by the drawable's bounds; zero if unknown
+	float screen_size(float bounds_radius, glm::mat4 const& model) const;
+	// 0 for full detail, else 1 + index into drawable.lods
+	std::size_t select(Drawable const& drawable, glm::mat4 const& model) const;
+};
+
+// tightest sphere around a spot light's cone, capped by range
+LightBounds spot_bounds(SpotLight const& light);
+
 class CollisionRenderer {
   public:
 	CollisionRenderer(DeviceView device);
@@ -42,7 +65,7 @@ class CollisionRenderer {
 };
 
 struct SceneRenderer : Device::Renderer {
-	enum class Xbo { eSkybox, e3d, eUi, eDirLights, eCOUNT_ };
+	enum class Xbo { eSkybox, e3d, eUi, eDirLights, eLocalLights, eClusters, eCOUNT_ };
 
 	struct GlobalLayout {
 		vk::UniqueDescriptorSetLayout global_set_layout{};
@@ -55,6 +78,27 @@ struct SceneRenderer : Device::Renderer {
 			glm::vec4 vpos_exposure;
 			glm::mat4 mat_shadow;
 			glm::vec4 shadow_dir;
+			// xyz: camera front, w: cascade count
+			glm::vec4 front_cascades;
+			// far view space depth of each cascade
+			glm::vec4 cascade_far;
+			// xy: offset, zw: size of each cascade in the shadow atlas, in UV space
+			std::array<glm::vec4, max_shadow_cascades_v> cascade_rects;
+			std::array<glm::mat4, max_shadow_cascades_v> cascade_mats;
+			// xyz: clusters in each dimension, w: point and spot light count
+			glm::uvec4 cluster_grid;
+			// maps view depth to a cluster slice, see LightClusters::depth_params()
+			glm::vec4 cluster_depth;
+		};
+
+		struct Cascade {
+			glm::mat4 mat{1.0f};
+			vk::Rect2D rect{};
+			float far{};
+			// opaque instances within the cascade's light frustum, including those hidden behind occluders
+			// static_casters is only used with the static shadow cache, shadow_casters then holds the dynamic ones
+			std::vector<RenderObject> static_casters{};
+			std::vector<RenderObject> shadow_casters{};
 		};
 
 		struct Std430DirLight {
@@ -71,12 +115,40 @@ struct SceneRenderer : Device::Renderer {
 			}
 		};
 
+		struct Std430LocalLight {
+			glm::vec4 position_range;
+			// w: cos of the inner cone angle
+			glm::vec4 colour_inner;
+			// w: cos of the outer cone angle
+			glm::vec4 direction_outer;
+
+			static Std430LocalLight make(PointLight const& light) {
+				// a cone wider than any direction: always at full intensity
+				return {
+					.position_range = {light.position, light.range},
+					.colour_inner = {glm::vec3{light.rgb.to_vec4()}, -1.5f},
+					.direction_outer = {front_v, -2.0f},
+				};
+			}
+
+			static Std430LocalLight make(SpotLight const& light) {
+				auto const outer = std::cos(light.outer_angle.value);
+				return {
+					.position_range = {light.position, light.range},
+					.colour_inner = {glm::vec3{light.rgb.to_vec4()}, std::max(std::cos(light.inner_angle.value), outer + 0.001f)},
+					.direction_outer = {glm::normalize(light.direction * front_v), outer},
+				};
+			}
+		};
+
 		glm::quat primary_light_direction{glm::identity<glm::quat>()};
 		glm::mat4 primary_light_mat{1.0f};
 		Camera camera_3d{};
+		std::uint32_t local_lights{};
 		std::optional<RenderObject> skybox{};
 		std::vector<RenderObject> opaque{};
 		std::vector<RenderObject> transparent{};
+		std::vector<Cascade> cascades{};
 		std::vector<RenderObject> ui{};
 		std::vector<RenderObject> overlay{};
 	};
@@ -90,6 +162,12 @@ struct SceneRenderer : Device::Renderer {
 	GlobalLayout global_layout{};
 
 	CollisionRenderer collision_renderer;
+	UiBatcher ui_batcher;
+	SkinningPass skinning_pass;
+	OcclusionCuller occlusion_culler{};
+	LightClusters light_clusters{};
+	// culls shadow casters for cascades after the first (culled on the render thread), then builds light clusters
+	ThreadPool worker_pool{static_cast<std::uint32_t>(max_shadow_cascades_v - 1)};
 	Frame frame{};
 	Ptr<Scene const> scene{};
 	Ptr<RenderList const> render_list{};
@@ -101,12 +179,14 @@ struct SceneRenderer : Device::Renderer {
 	void update(Scene const& scene);
 
 	void next_frame() final;
-	void render_shadow(vk::CommandBuffer cb, Depthbuffer& depthbuffer) final;
-	void render_3d(vk::CommandBuffer cb, Framebuffer& framebuffer, ImageView const& shadow_map) final;
-	void render_ui(vk::CommandBuffer cb, Framebuffer& framebuffer, ImageView const& output_3d) final;
-
-	void bind_view_set(vk::CommandBuffer cb, HostBuffer& out_ubo, Camera const& camera, glm::uvec2 const extent);
-	void draw_3d_to_ui(vk::CommandBuffer cb, ImageView const& output_3d, PipelineBuilder& pipeline_builder, vk::Extent2D extent);
+	void render_skinning(vk::CommandBuffer cb) final;
+	void render_shadow(CommandRecorder& recorder, Depthbuffer& depthbuffer, ShadowLayer layer) final;
+	void render_3d(CommandRecorder& recorder, Framebuffer& framebuffer, ImageView const& shadow_map) final;
+	void render_ui(CommandRecorder& recorder, Framebuffer& framebuffer, ImageView const& output_3d) final;
+
+	vk::DescriptorSet make_view_set(HostBuffer& out_ubo, Camera const& camera, glm::uvec2 const extent);
+	void bind_view_set(vk::CommandBuffer cb, vk::DescriptorSet set) const;
+	void draw_3d_to_ui(CommandRecorder::Context const& context, ImageView const& output_3d, PipelineBuilder& pipeline_builder, vk::Extent2D extent);
 };
 } // namespace vulkan
 } // namespace levk
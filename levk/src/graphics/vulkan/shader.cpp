@@ -6,6 +6,8 @@
 
 namespace levk::vulkan {
 void Shader::update(std::uint32_t set, std::uint32_t binding, Texture const& texture) {
+	texture.usage.bind();
+	if (bound_textures) { bound_textures->push_back(&texture); }
 	return update(set, binding, texture.image.get().get().image_view(), texture.sampler);
 }
 
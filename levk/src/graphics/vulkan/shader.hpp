@@ -12,6 +12,8 @@ struct Shader : levk::Shader {
 	NotNull<SamplerStorage*> sampler_storage;
 	NotNull<SetAllocator*> set_allocator;
 	NotNull<ScratchBufferAllocator*> scratch_buffer_allocator;
+	// if set, textures bound through update() are appended to it
+	Ptr<std::vector<Ptr<Texture const>>> bound_textures{};
 
 	Shader(DeviceView device, Pipeline const& pipeline)
 		: Shader(device.device, pipeline, device.sampler_storage, device.set_allocator, device.scratch_buffer_allocator) {}
@@ -0,0 +1,182 @@
+#include <graphics/vulkan/pipeline.hpp>
+#include <graphics/vulkan/render_object.hpp>
+#include <graphics/vulkan/skinning.hpp>
+#include <levk/util/error.hpp>
+#include <bit>
+
+namespace levk::vulkan {
+namespace {
+// positions, then normals: three floats each
+constexpr std::uint32_t output_words_v{6u};
+constexpr auto output_usage_v = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eVertexBuffer;
+
+// must match PC in skinning.comp
+struct PushConstants {
+	std::uint32_t vertices{};
+	std::uint32_t packed{};
+	std::uint32_t joints_u16{};
+	std::uint32_t joint_base{};
+	// 32-bit word offsets of the first vertex in each source stream
+	std::uint32_t positions{};
+	std::uint32_t normals{};
+	std::uint32_t joints{};
+	std::uint32_t weights{};
+	// 32-bit word offset into the output buffer
+	std::uint32_t output{};
+};
+
+std::uint32_t word_offset(std::size_t const stream_offset, std::int32_t const vertex_offset, VertexStreams::Stream const& stream) {
+	auto const ret = stream_offset + static_cast<std::size_t>(vertex_offset) * stream.stride;
+	assert(ret % sizeof(std::uint32_t) == 0);
+	return static_cast<std::uint32_t>(ret / sizeof(std::uint32_t));
+}
+} // namespace
+
+SkinnedVertices::SkinnedVertices(GeometryLayout const& source_layout, SkinningSource const& source, Ptr<UniqueBuffer const> output,
+								 vk::DeviceSize const offset)
+	: m_source(source.buffer), m_output(output) {
+	// positions and normals are written at full precision, rgbs and uvs keep their source formats
+	auto streams = VertexStreams::make(VertexFormat::eFull, false);
+	streams.rgbs = source.streams.rgbs;
+	streams.uvs = source.streams.uvs;
+	m_layout.vertex_input = streams.vertex_input();
+	m_layout.instances_binding = RenderObject::Instances::vertex_binding_v;
+	m_layout.vertices = source_layout.vertices;
+	m_layout.indices = source_layout.indices;
+	m_layout.first_index = source_layout.first_index;
+	m_layout.index_type = source_layout.index_type;
+	m_layout.format = VertexFormat::eFull;
+	m_layout.pre_skinned = true;
+	// source streams are bound at this primitive's first vertex, so draws use a zero vertex offset
+	auto const vertex_offset = static_cast<vk::DeviceSize>(source_layout.vertex_offset);
+	m_layout.offsets.positions = offset;
+	m_layout.offsets.normals = offset + vk::DeviceSize{m_layout.vertices} * streams.positions.stride;
+	m_layout.offsets.rgbs = source_layout.offsets.rgbs + vertex_offset * source.streams.rgbs.stride;
+	m_layout.offsets.uvs = source_layout.offsets.uvs + vertex_offset * source.streams.uvs.stride;
+	m_layout.offsets.indices = source_layout.offsets.indices;
+}
+
+void SkinnedVertices::draw(vk::CommandBuffer cb, std::uint32_t instances) {
+	auto const output = m_output->get().buffer;
+	if (!output || !m_source) { return; }
+	vk::Buffer const vbos[] = {output, m_source, output, m_source};
+	vk::DeviceSize const vbo_offsets[] = {m_layout.offsets.positions, m_layout.offsets.rgbs, m_layout.offsets.normals, m_layout.offsets.uvs};
+	cb.bindVertexBuffers(0u, vbos, vbo_offsets);
+	if (m_layout.indices > 0) {
+		cb.bindIndexBuffer(m_source, m_layout.offsets.indices, m_layout.index_type);
+		cb.drawIndexed(m_layout.indices, instances, m_layout.first_index, 0, 0u);
+	} else {
+		cb.draw(m_layout.vertices, instances, 0u, 0u);
+	}
+}
+
+SkinningPass::SkinningPass(DeviceView const& device) : m_device(device), m_outputs(*device.defer) {
+	static constexpr auto stage_v = vk::ShaderStageFlagBits::eCompute;
+	// 0: source geometry, 1: joint matrices, 2: output vertices
+	auto const dslbs = std::array{
+		vk::DescriptorSetLayoutBinding{0u, vk::DescriptorType::eStorageBuffer, 1u, stage_v},
+		vk::DescriptorSetLayoutBinding{1u, vk::DescriptorType::eStorageBuffer, 1u, stage_v},
+		vk::DescriptorSetLayoutBinding{2u, vk::DescriptorType::eStorageBuffer, 1u, stage_v},
+	};
+	m_set_layout = device.device.createDescriptorSetLayoutUnique(vk::DescriptorSetLayoutCreateInfo{{}, dslbs});
+	auto const pcr = vk::PushConstantRange{stage_v, 0u, sizeof(PushConstants)};
+	m_pipeline_layout = device.device.createPipelineLayoutUnique(vk::PipelineLayoutCreateInfo{{}, *m_set_layout, pcr});
+}
+
+void SkinningPass::begin(std::span<DrawList::Skin const> skins, HostBuffer::Pool& buffer_pool, ShaderProvider& shader_provider) {
+	m_jobs.clear();
+	m_primitives.clear();
+	m_joint_bases.clear();
+	m_joints = {};
+	m_vertices = {};
+	if (skins.empty() || !build_pipeline(shader_provider)) { return; }
+
+	auto mats = std::vector<glm::mat4>{};
+	for (auto const& skin : skins) {
+		m_joint_bases.push_back(static_cast<std::uint32_t>(mats.size()));
+		for (std::size_t i = 0; i < skin.joints_global_transforms.size(); ++i) {
+			mats.push_back(skin.joints_global_transforms[i] * skin.inverse_bind_matrices[i]);
+		}
+	}
+	if (mats.empty()) { return; }
+	auto& buffer = buffer_pool.next(vk::BufferUsageFlagBits::eStorageBuffer);
+	buffer.write(mats.data(), std::span{mats}.size_bytes(), mats.size());
+	m_joints = buffer.view();
+}
+
+Ptr<Primitive> SkinningPass::add(Primitive const& primitive, std::size_t const skin_index) {
+	auto const source = primitive.skinning_source();
+	if (!source || !m_joints.buffer || skin_index >= m_joint_bases.size()) { return {}; }
+	auto const& layout = primitive.layout();
+	if (layout.vertices == 0) { return {}; }
+	auto const output_word = static_cast<std::uint32_t>(m_vertices * output_words_v);
+	m_jobs.push_back(Job{
+		.source = source->buffer,
+		.streams = source->streams,
+		.layout = layout,
+		.joint_base = m_joint_bases[skin_index],
+		.output_word = output_word,
+	});
+	m_vertices += layout.vertices;
+	auto const& output = m_outputs.get()[*m_device.buffered_index];
+	return &m_primitives.emplace_back(layout, *source, &output, vk::DeviceSize{output_word} * sizeof(float));
+}
+
+void SkinningPass::dispatch(vk::CommandBuffer cb) {
+	if (m_jobs.empty()) { return; }
+	auto& output = m_outputs.get()[*m_device.buffered_index];
+	auto const size = static_cast<vk::DeviceSize>(m_vertices * output_words_v * sizeof(float));
+	if (output.get().size < size) {
+		m_device.defer->push(std::exchange(output, m_device.vma.make_buffer(output_usage_v, std::bit_ceil(size), false)));
+		if (!output.get().buffer) { throw Error{"Failed to create Vulkan skinning buffer"}; }
+	}
+
+	cb.bindPipeline(vk::PipelineBindPoint::eCompute, *m_pipeline);
+	auto bound = vk::Buffer{};
+	for (auto const& job : m_jobs) {
+		// primitives in the same arena block share a descriptor set
+		if (job.source != bound) {
+			auto const set = m_device.set_allocator->allocate(*m_set_layout);
+			auto const dbis = std::array{
+				vk::DescriptorBufferInfo{job.source, 0u, VK_WHOLE_SIZE},
+				vk::DescriptorBufferInfo{m_joints.buffer, m_joints.offset, m_joints.size},
+				vk::DescriptorBufferInfo{output.get().buffer, 0u, VK_WHOLE_SIZE},
+			};
+			auto wds = vk::WriteDescriptorSet{set, 0u, 0u, static_cast<std::uint32_t>(dbis.size()), vk::DescriptorType::eStorageBuffer};
+			wds.pBufferInfo = dbis.data();
+			m_device.device.updateDescriptorSets(wds, {});
+			cb.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *m_pipeline_layout, 0u, set, {});
+			bound = job.source;
+		}
+		auto const& offsets = job.layout.offsets;
+		auto const vertex_offset = job.layout.vertex_offset;
+		auto const pc = PushConstants{
+			.vertices = job.layout.vertices,
+			.packed = job.layout.format == VertexFormat::ePacked ? 1u : 0u,
+			.joints_u16 = job.streams.joints.format == vk::Format::eR16G16B16A16Uint ? 1u : 0u,
+			.joint_base = job.joint_base,
+			.positions = word_offset(offsets.positions, vertex_offset, job.streams.positions),
+			.normals = word_offset(offsets.normals, vertex_offset, job.streams.normals),
+			.joints = word_offset(offsets.joints, vertex_offset, job.streams.joints),
+			.weights = word_offset(offsets.weights, vertex_offset, job.streams.weights),
+			.output = job.output_word,
+		};
+		cb.pushConstants(*m_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0u, sizeof(pc), &pc);
+		cb.dispatch((job.layout.vertices + local_size_v - 1) / local_size_v, 1u, 1u);
+	}
+}
+
+bool SkinningPass::build_pipeline(ShaderProvider& shader_provider) {
+	auto const spirv = SpirV::from(shader_provider, "shaders/skinning.comp");
+	if (!spirv) { return false; }
+	if (m_pipeline && spirv.hash == m_shader_hash) { return true; }
+	m_shader = m_device.device.createShaderModuleUnique(vk::ShaderModuleCreateInfo{{}, spirv.code.size_bytes(), spirv.code.data()});
+	auto const pssci = vk::PipelineShaderStageCreateInfo{{}, vk::ShaderStageFlagBits::eCompute, *m_shader, "main"};
+	auto const cpci = vk::ComputePipelineCreateInfo{{}, pssci, *m_pipeline_layout};
+	auto pipeline = vk::Pipeline{};
+	if (m_device.device.createComputePipelines({}, 1u, &cpci, {}, &pipeline) != vk::Result::eSuccess) { return false; }
+	m_pipeline = vk::UniquePipeline{pipeline, m_device.device};
+	m_shader_hash = spirv.hash;
+	return true;
+}
+} // namespace levk::vulkan
@@ -0,0 +1,65 @@
+#pragma once
+#include <graphics/vulkan/primitive.hpp>
+#include <levk/graphics/draw_list.hpp>
+#include <deque>
+
+namespace levk {
+class ShaderProvider;
+
+namespace vulkan {
+// Vertices of a skinned primitive written by SkinningPass: positions and normals in the frame's output buffer,
+// everything else (rgbs, uvs, indices) read from the source primitive. Drawn like static geometry.
+class SkinnedVertices : public Primitive {
+  public:
+	SkinnedVertices(GeometryLayout const& source_layout, SkinningSource const& source, Ptr<UniqueBuffer const> output, vk::DeviceSize offset);
+
+  private:
+	void draw(vk::CommandBuffer cb, std::uint32_t instances = 1u) final;
+
+	vk::Buffer m_source{};
+	Ptr<UniqueBuffer const> m_output{};
+};
+
+// Compute pre-pass: skins each queued primitive once per frame, so every view (shadow cascades, main pass) draws the result without re-skinning.
+class SkinningPass {
+  public:
+	static constexpr std::uint32_t local_size_v{64u};
+
+	SkinningPass(DeviceView const& device);
+
+	// drops last frame's queue, and uploads the joint matrices of every skin in this one
+	void begin(std::span<DrawList::Skin const> skins, HostBuffer::Pool& buffer_pool, ShaderProvider& shader_provider);
+	// returns null if primitive is not skinned device local geometry, or the compute pipeline is unavailable
+	Ptr<Primitive> add(Primitive const& primitive, std::size_t skin_index);
+	void dispatch(vk::CommandBuffer cb);
+
+	std::size_t vertex_count() const { return m_vertices; }
+
+  private:
+	struct Job {
+		vk::Buffer source{};
+		VertexStreams streams{};
+		GeometryLayout layout{};
+		std::uint32_t joint_base{};
+		std::uint32_t output_word{};
+	};
+
+	bool build_pipeline(ShaderProvider& shader_provider);
+
+	DeviceView m_device{};
+	vk::UniqueDescriptorSetLayout m_set_layout{};
+	vk::UniquePipelineLayout m_pipeline_layout{};
+	vk::UniqueShaderModule m_shader{};
+	vk::UniquePipeline m_pipeline{};
+	std::size_t m_shader_hash{};
+
+	Defer<Buffered<UniqueBuffer>> m_outputs{};
+	BufferView m_joints{};
+	std::vector<std::uint32_t> m_joint_bases{};
+	std::vector<Job> m_jobs{};
+	// referenced by this frame's drawables: stable addresses, only cleared in begin
+	std::deque<SkinnedVertices> m_primitives{};
+	std::size_t m_vertices{};
+};
+} // namespace vulkan
+} // namespace levk
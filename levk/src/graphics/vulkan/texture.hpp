@@ -1,11 +1,50 @@
 #pragma once
 #include <graphics/vulkan/common.hpp>
+#include <atomic>
 
 namespace levk::vulkan {
+// format and view swizzle for an image's channels
+struct TextureLayout {
+	vk::Format format{vk::Format::eR8G8B8A8Srgb};
+	vk::ComponentMapping components{};
+	std::uint8_t channels{4};
+};
+
+TextureLayout make_layout(TextureUsage usage, std::uint8_t channels, ColourSpace colour_space);
+// applies a layout's swizzle on the CPU, for devices that cannot use its format
+ByteArray swizzle_to_rgba(std::span<std::byte const> packed, TextureLayout const& layout);
+
 struct Texture {
+	// recorded while drawing (possibly on multiple recording threads), drives texture streaming
+	struct Usage {
+		std::atomic<std::uint64_t> binds{};
+		// largest extent (in pixels) drawn at since last taken
+		std::atomic<std::uint32_t> screen_extent{};
+
+		void bind() { binds.fetch_add(1u, std::memory_order_relaxed); }
+
+		void record(std::uint32_t const extent) {
+			auto current = screen_extent.load(std::memory_order_relaxed);
+			while (current < extent && !screen_extent.compare_exchange_weak(current, extent, std::memory_order_relaxed)) {}
+		}
+
+		std::uint32_t take_screen_extent() { return screen_extent.exchange(0u, std::memory_order_relaxed); }
+	};
+
 	DeviceView device{};
 	TextureSampler sampler{};
 	ImageCreateInfo create_info{};
 	Defer<UniqueImage> image{};
+	// null backend: no image is created, only its extent is tracked
+	vk::Extent2D null_extent{};
+	// channels (and swizzle) of source texels if the device couldn't sample their format, and they were swizzled into RGBA8 on the CPU
+	vk::ComponentMapping fallback_components{};
+	std::uint8_t fallback_channels{};
+	mutable Usage usage{};
+
+	vk::Extent2D extent() const { return image.get() ? image.get().get().extent : null_extent; }
 };
+
+// swizzles texels of fallback_channels into RGBA8 as texture was created with: empty if it didn't fall back (or channels differ)
+ByteArray to_fallback_rgba(Texture const& texture, Image::View image);
 } // namespace levk::vulkan
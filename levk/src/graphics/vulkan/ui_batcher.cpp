@@ -0,0 +1,93 @@
+#include <graphics/vulkan/ui_batcher.hpp>
+#include <levk/graphics/rgba.hpp>
+#include <algorithm>
+#include <limits>
+
+namespace levk::vulkan {
+namespace {
+constexpr auto unbatched_v = std::numeric_limits<std::size_t>::max();
+
+Ptr<HostPrimitive const> host_primitive(Drawable const& drawable) {
+	if (drawable.skin_index || !drawable.joints.empty() || drawable.instances.size() > 1 || drawable.topology != Topology::eTriangleList) { return {}; }
+	auto const* ret = dynamic_cast<HostPrimitive const*>(drawable.primitive.get());
+	if (!ret || ret->geometry.indices.empty()) { return {}; }
+	return ret;
+}
+
+bool same_batch(UnlitMaterial const& a, UnlitMaterial const& b) {
+	return a.textures == b.textures && a.render_mode == b.render_mode && a.tint.channels[3] == b.tint.channels[3] && a.vertex_shader == b.vertex_shader &&
+		   a.fragment_shader == b.fragment_shader;
+}
+
+void append(Geometry::Packed& out, Geometry::Packed const& in, glm::mat4 const& mat, glm::vec3 const rgb) {
+	auto const base = static_cast<std::uint32_t>(out.positions.size());
+	for (auto const& position : in.positions) { out.positions.push_back(mat * glm::vec4{position, 1.0f}); }
+	for (auto const& in_rgb : in.rgbs) { out.rgbs.push_back(in_rgb * rgb); }
+	out.normals.insert(out.normals.end(), in.normals.begin(), in.normals.end());
+	out.uvs.insert(out.uvs.end(), in.uvs.begin(), in.uvs.end());
+	for (auto const index : in.indices) { out.indices.push_back(base + index); }
+}
+} // namespace
+
+std::size_t UiBatcher::key_for(Drawable const& drawable) {
+	if (!host_primitive(drawable)) { return unbatched_v; }
+	auto const* material = dynamic_cast<UnlitMaterial const*>(drawable.material.get());
+	if (!material) { return unbatched_v; }
+	// a HUD uses a handful of distinct batches: a linear search is cheaper than hashing
+	for (std::size_t i = 0; i < m_keys.size(); ++i) {
+		if (same_batch(*m_keys[i], *material)) { return i; }
+	}
+	m_keys.push_back(material);
+	return m_keys.size() - 1;
+}
+
+auto UiBatcher::next_batch(UnlitMaterial const& key) -> Batch& {
+	if (m_used >= m_batches.size()) { m_batches.push_back(std::make_unique<Batch>(Batch{.primitive = m_device})); }
+	auto& ret = *m_batches[m_used++];
+	ret.material.vertex_shader = key.vertex_shader;
+	ret.material.fragment_shader = key.fragment_shader;
+	ret.material.textures = key.textures;
+	ret.material.render_mode = key.render_mode;
+	ret.material.tint = Rgba{.channels = {0xff, 0xff, 0xff, key.tint.channels[3]}};
+	auto& geometry = ret.primitive.geometry;
+	geometry.positions.clear();
+	geometry.rgbs.clear();
+	geometry.normals.clear();
+	geometry.uvs.clear();
+	geometry.indices.clear();
+	++ret.primitive.version;
+	return ret;
+}
+
+void UiBatcher::batch(std::span<Drawable const> drawables, DrawList& out) {
+	m_used = {};
+	m_keys.clear();
+	m_entries.clear();
+	m_entries.reserve(drawables.size());
+	for (std::size_t i = 0; i < drawables.size(); ++i) {
+		m_entries.push_back(Entry{.z = drawables[i].parent[3].z, .key = key_for(drawables[i]), .drawable = i});
+	}
+	// z_index, then submission order (as hit testing breaks ties): only consecutive drawables are merged, so overlapping
+	// drawables with different keys are never reordered
+	std::stable_sort(m_entries.begin(), m_entries.end(), [](Entry const& a, Entry const& b) { return a.z < b.z; });
+
+	for (auto it = m_entries.begin(); it != m_entries.end();) {
+		auto const& drawable = drawables[it->drawable];
+		// a single drawable gains nothing from being copied into a batch
+		auto const last = std::find_if(it, m_entries.end(), [key = it->key](Entry const& e) { return e.key != key; });
+		if (it->key == unbatched_v || last - it == 1) {
+			out.add(drawable);
+			++it;
+			continue;
+		}
+		auto& batch = next_batch(*m_keys[it->key]);
+		for (; it != last; ++it) {
+			auto const& in = drawables[it->drawable];
+			auto const& material = static_cast<UnlitMaterial const&>(*in.material);
+			auto const mat = in.instances.empty() ? in.parent : in.parent * in.instances.front().matrix();
+			append(batch.primitive.geometry, host_primitive(in)->geometry, mat, glm::vec3{Rgba::to_srgb(material.tint.to_vec4())});
+		}
+		out.add(Drawable{.primitive = &batch.primitive, .material = &batch.material});
+	}
+}
+} // namespace levk::vulkan
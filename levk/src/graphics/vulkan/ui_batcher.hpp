@@ -0,0 +1,45 @@
+#pragma once
+#include <graphics/vulkan/primitive.hpp>
+#include <levk/graphics/draw_list.hpp>
+#include <levk/graphics/material.hpp>
+#include <memory>
+#include <vector>
+
+namespace levk::vulkan {
+///
+/// \brief Merges UI drawables of host geometry sharing a texture and material into one primitive per frame.
+///
+/// Drawables are ordered by z_index (the translation z of their parent), then submission order; consecutive runs sharing
+/// a batch are drawn together, so the result is identical to drawing each one in turn. Tints are folded into vertex
+/// colours (except alpha, which is part of the key), so views differing only by tint still share a batch. Anything else
+/// (instanced, skinned, non unlit) is drawn as is.
+///
+class UiBatcher {
+  public:
+	UiBatcher(DeviceView device) : m_device(device) {}
+
+	void batch(std::span<Drawable const> drawables, DrawList& out);
+
+  private:
+	struct Batch {
+		HostPrimitive primitive;
+		UnlitMaterial material{};
+	};
+
+	struct Entry {
+		float z{};
+		std::size_t key{};
+		std::size_t drawable{};
+	};
+
+	std::size_t key_for(Drawable const& drawable);
+	Batch& next_batch(UnlitMaterial const& key);
+
+	// stable addresses: drawables point into batches
+	std::vector<std::unique_ptr<Batch>> m_batches{};
+	std::vector<Ptr<UnlitMaterial const>> m_keys{};
+	std::vector<Entry> m_entries{};
+	std::size_t m_used{};
+	DeviceView m_device{};
+};
+} // namespace levk::vulkan
@@ -0,0 +1,354 @@
+#include <graphics/vulkan/image_barrier.hpp>
+#include <graphics/vulkan/upload_service.hpp>
+#include <levk/util/enumerate.hpp>
+#include <levk/util/error.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace levk::vulkan {
+namespace {
+constexpr std::uint64_t align_up(std::uint64_t const value, std::uint64_t const alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+vk::CommandBuffer next_cb(std::vector<vk::CommandBuffer>& free, CommandAllocator const& allocator) {
+	if (free.empty()) { return allocator.allocate(); }
+	auto const ret = free.back();
+	free.pop_back();
+	return ret;
+}
+} // namespace
+
+UploadService::UploadService(DeviceView const& device, NotNull<Queue*> transfer_queue, vk::DeviceSize const ring_size)
+	: m_device(device), m_transfer_queue(transfer_queue) {
+	auto const flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer | vk::CommandPoolCreateFlagBits::eTransient;
+	m_transfer_allocator = CommandAllocator::make(device.device, m_transfer_queue->family, flags);
+	m_queue_families.insert(m_transfer_queue->family);
+	if (dedicated_queue()) {
+		m_graphics_allocator = CommandAllocator::make(device.device, device.queue->family, flags);
+		m_queue_families.insert(device.queue->family);
+	}
+	auto const stci = vk::SemaphoreTypeCreateInfo{vk::SemaphoreType::eTimeline, 0u};
+	m_timeline = device.device.createSemaphoreUnique(vk::SemaphoreCreateInfo{{}, &stci});
+	m_ring = make_staging_buffer(ring_size);
+	if (!m_ring.get().buffer || !m_ring.get().mapped) { throw Error{"Failed to create Vulkan staging ring"}; }
+	m_alignment = std::max(m_alignment, device.gpu->properties.limits.optimalBufferCopyOffsetAlignment);
+}
+
+std::uint64_t UploadService::upload(Vma::Image const& image, std::span<levk::Image::View const> layers) {
+	assert(!layers.empty() && image.array_layers == layers.size());
+	auto lock = std::scoped_lock{m_mutex};
+	auto size = std::size_t{};
+	for (auto const& layer : layers) { size += layer.storage.size(); }
+	auto* ptr = static_cast<std::byte*>(nullptr);
+	auto const staged = stage(size, ptr);
+	for (auto const& layer : layers) {
+		std::memcpy(ptr, layer.storage.data(), layer.storage.size());
+		ptr += layer.storage.size();
+	}
+
+	auto& batch = pending();
+	auto barrier = ImageBarrier{image};
+	barrier.set_undef_to_transfer_dst().transition(batch.transfer);
+	auto const isrl = vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, 0u, 0u, image.array_layers};
+	auto const extent = vk::Extent3D{layers[0].extent.x, layers[0].extent.y, 1u};
+	auto const bic = vk::BufferImageCopy{staged.offset, {}, {}, isrl, {}, extent};
+	batch.transfer.copyBufferToImage(staged.buffer, image.image, vk::ImageLayout::eTransferDstOptimal, bic);
+	barrier.barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+	barrier.barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+	transfer_ownership(barrier.barrier);
+	// blits need a graphics queue
+	if (image.mip_levels > 1) { m_device.vma.write_mips(batch.graphics, image); }
+	return pending_value();
+}
+
+std::uint64_t UploadService::upload_mips(Vma::Image const& image, std::span<std::span<std::byte const> const> mips) {
+	assert(!mips.empty() && image.mip_levels * image.array_layers == mips.size());
+	auto lock = std::scoped_lock{m_mutex};
+	auto size = std::size_t{};
+	for (auto const& mip : mips) { size += mip.size(); }
+	auto* ptr = static_cast<std::byte*>(nullptr);
+	auto const staged = stage(size, ptr);
+	auto bics = std::vector<vk::BufferImageCopy>{};
+	bics.reserve(mips.size());
+	auto buffer_offset = staged.offset;
+	for (auto const [mip, index] : enumerate<std::uint32_t>(mips)) {
+		std::memcpy(ptr, mip.data(), mip.size());
+		ptr += mip.size();
+		auto const level = index % image.mip_levels;
+		auto const isrl = vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, level, index / image.mip_levels, 1u};
+		auto const extent = vk::Extent3D{std::max(image.extent.width >> level, 1u), std::max(image.extent.height >> level, 1u), 1u};
+		bics.push_back(vk::BufferImageCopy{buffer_offset, {}, {}, isrl, {}, extent});
+		buffer_offset += mip.size();
+	}
+
+	auto& batch = pending();
+	auto barrier = ImageBarrier{image};
+	barrier.set_undef_to_transfer_dst().transition(batch.transfer);
+	batch.transfer.copyBufferToImage(staged.buffer, image.image, vk::ImageLayout::eTransferDstOptimal, bics);
+	barrier.barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+	barrier.barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+	transfer_ownership(barrier.barrier);
+	return pending_value();
+}
+
+std::uint64_t UploadService::write(Vma::Image const& image, std::span<ImageWrite const> writes) {
+	if (image.array_layers > 1u || writes.empty()) { return {}; }
+	auto lock = std::scoped_lock{m_mutex};
+	auto size = std::size_t{};
+	for (auto const& write : writes) { size += write.image.storage.size(); }
+	auto* ptr = static_cast<std::byte*>(nullptr);
+	auto const staged = stage(size, ptr);
+	auto& batch = pending();
+	auto it = std::find_if(batch.writes.begin(), batch.writes.end(), [&image](ImageWrites const& w) { return w.image.image == image.image; });
+	if (it == batch.writes.end()) { it = batch.writes.insert(it, ImageWrites{.image = image}); }
+	auto const isrl = vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, 0u, 0u, 1u};
+	auto buffer_offset = staged.offset;
+	for (auto const& write : writes) {
+		std::memcpy(ptr, write.image.storage.data(), write.image.storage.size());
+		ptr += write.image.storage.size();
+		auto const offset = vk::Offset3D{static_cast<std::int32_t>(write.offset.x), static_cast<std::int32_t>(write.offset.y), 0};
+		auto const extent = vk::Extent3D{write.image.extent.x, write.image.extent.y, 1u};
+		it->regions.push_back({staged.buffer, vk::BufferImageCopy{buffer_offset, {}, {}, isrl, offset, extent}});
+		buffer_offset += write.image.storage.size();
+	}
+	return pending_value();
+}
+
+std::uint64_t UploadService::copy(Vma::Image const& src, Vma::Image const& dst, glm::ivec2 const offset, Rgba const colour) {
+	auto lock = std::scoped_lock{m_mutex};
+	auto& batch = pending();
+	// src must have its pending writes before being copied from
+	record_writes(batch, src.image);
+	auto barrier = ImageBarrier{dst};
+	barrier.set_undef_to_transfer_dst().transition(batch.graphics);
+	auto const rgba = colour.to_vec4();
+	auto const clear = vk::ClearColorValue{std::array{rgba.x, rgba.y, rgba.z, rgba.w}};
+	batch.graphics.clearColorImage(dst.image, vk::ImageLayout::eTransferDstOptimal, clear, barrier.barrier.subresourceRange);
+	barrier.set_full_barrier(vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal).transition(batch.graphics);
+	auto const vk_src = Vma::Copy{src, vk::ImageLayout::eShaderReadOnlyOptimal};
+	auto const vk_dst = Vma::Copy{dst, vk::ImageLayout::eShaderReadOnlyOptimal, offset};
+	m_device.vma.copy_image(batch.graphics, vk_src, vk_dst, src.extent);
+	return pending_value();
+}
+
+std::uint64_t UploadService::copy_mips(Vma::Image const& src, Vma::Image const& dst) {
+	assert(src.mip_levels >= dst.mip_levels && src.array_layers == dst.array_layers);
+	auto lock = std::scoped_lock{m_mutex};
+	auto& batch = pending();
+	record_writes(batch, src.image);
+	auto const first = src.mip_levels - dst.mip_levels;
+	auto copies = std::vector<vk::ImageCopy>{};
+	copies.reserve(dst.mip_levels);
+	for (std::uint32_t mip = 0; mip < dst.mip_levels; ++mip) {
+		auto const isrl_src = vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, first + mip, 0u, src.array_layers};
+		auto const isrl_dst = vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, mip, 0u, dst.array_layers};
+		auto const extent = vk::Extent3D{std::max(dst.extent.width >> mip, 1u), std::max(dst.extent.height >> mip, 1u), 1u};
+		copies.push_back(vk::ImageCopy{isrl_src, {}, isrl_dst, {}, extent});
+	}
+
+	// src may be sampled by frames in flight
+	auto barriers = std::array<vk::ImageMemoryBarrier2, 2>{};
+	barriers[0] = ImageBarrier{src}.set_full_barrier(vk::ImageLayout::eShaderReadOnlyOptimal, vk::ImageLayout::eTransferSrcOptimal).barrier;
+	barriers[1] = ImageBarrier{dst}.set_undef_to_transfer_dst().barrier;
+	ImageBarrier::transition(batch.graphics, barriers);
+	batch.graphics.copyImage(src.image, vk::ImageLayout::eTransferSrcOptimal, dst.image, vk::ImageLayout::eTransferDstOptimal, copies);
+	barriers[0] = ImageBarrier{src}.set_full_barrier(vk::ImageLayout::eTransferSrcOptimal, vk::ImageLayout::eShaderReadOnlyOptimal).barrier;
+	barriers[1] = ImageBarrier{dst}.set_full_barrier(vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal).barrier;
+	ImageBarrier::transition(batch.graphics, barriers);
+	return pending_value();
+}
+
+std::uint64_t UploadService::upload(vk::Buffer dst, std::span<std::byte const> bytes, std::span<vk::BufferCopy const> copies) {
+	if (copies.empty()) { return {}; }
+	auto lock = std::scoped_lock{m_mutex};
+	auto* ptr = static_cast<std::byte*>(nullptr);
+	auto const staged = stage(bytes.size(), ptr);
+	std::memcpy(ptr, bytes.data(), bytes.size());
+
+	auto& batch = pending();
+	auto regions = std::vector<vk::BufferCopy>{copies.begin(), copies.end()};
+	for (auto& region : regions) { region.srcOffset += staged.offset; }
+	batch.transfer.copyBuffer(staged.buffer, dst, regions);
+	for (auto const& region : regions) {
+		auto barrier = vk::BufferMemoryBarrier2{};
+		barrier.buffer = dst;
+		barrier.offset = region.dstOffset;
+		barrier.size = region.size;
+		transfer_ownership(barrier);
+	}
+	return pending_value();
+}
+
+std::uint64_t UploadService::flush() {
+	auto lock = std::scoped_lock{m_mutex};
+	if (m_pending) { submit(); }
+	reclaim();
+	return m_value;
+}
+
+bool UploadService::is_complete(std::uint64_t const value) const { return m_device.device.getSemaphoreCounterValue(*m_timeline) >= value; }
+
+void UploadService::wait(std::uint64_t const value) {
+	{
+		auto lock = std::scoped_lock{m_mutex};
+		if (m_pending && value > m_value) { submit(); }
+	}
+	auto const swi = vk::SemaphoreWaitInfo{{}, *m_timeline, value};
+	if (m_device.device.waitSemaphores(swi, std::numeric_limits<std::uint64_t>::max()) != vk::Result::eSuccess) {
+		throw Error{"Failed to wait for Vulkan upload"};
+	}
+}
+
+auto UploadService::stage(std::size_t const size, std::byte*& out_ptr) -> Staged {
+	auto const capacity = m_ring.get().size;
+	if (size > capacity) {
+		auto& scratch = pending().scratch.emplace_back(make_staging_buffer(size));
+		if (!scratch.get().buffer || !scratch.get().mapped) { throw Error{"Failed to create Vulkan staging buffer"}; }
+		out_ptr = static_cast<std::byte*>(scratch.get().mapped);
+		return {scratch.get().buffer, 0u};
+	}
+
+	auto offset = align_up(m_head, m_alignment);
+	// staged bytes never wrap around the end of the ring
+	if (offset % capacity + size > capacity) { offset = align_up(offset, capacity); }
+	while (offset + size > m_tail + capacity) {
+		// out of space: the oldest batch must complete before its bytes can be reused
+		if (m_pending) { submit(); }
+		if (m_in_flight.empty()) {
+			m_tail = offset;
+			break;
+		}
+		auto const swi = vk::SemaphoreWaitInfo{{}, *m_timeline, m_in_flight.front().value};
+		if (m_device.device.waitSemaphores(swi, std::numeric_limits<std::uint64_t>::max()) != vk::Result::eSuccess) {
+			throw Error{"Failed to wait for Vulkan upload"};
+		}
+		reclaim();
+	}
+
+	auto& batch = pending();
+	m_head = offset + size;
+	batch.ring_end = m_head;
+	out_ptr = static_cast<std::byte*>(m_ring.get().mapped) + offset % capacity;
+	return {m_ring.get().buffer, offset % capacity};
+}
+
+UniqueBuffer UploadService::make_staging_buffer(vk::DeviceSize const size) const {
+	return m_device.vma.make_buffer(vk::BufferUsageFlagBits::eTransferSrc, size, true, m_queue_families.span());
+}
+
+auto UploadService::pending() -> Batch& {
+	if (m_pending) { return *m_pending; }
+	auto& ret = m_pending.emplace(Batch{.ring_end = m_head});
+	ret.transfer = next_cb(m_free_transfer, m_transfer_allocator);
+	ret.transfer.begin(vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+	if (dedicated_queue()) {
+		ret.graphics = next_cb(m_free_graphics, m_graphics_allocator);
+		ret.graphics.begin(vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+	} else {
+		ret.graphics = ret.transfer;
+	}
+	return ret;
+}
+
+void UploadService::transfer_ownership(vk::ImageMemoryBarrier2 barrier) {
+	auto const& batch = *m_pending;
+	barrier.srcStageMask = vk::PipelineStageFlagBits2::eTransfer;
+	barrier.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+	barrier.dstStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+	barrier.dstAccessMask = vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite;
+	if (!dedicated_queue()) { return ImageBarrier::transition(batch.transfer, {&barrier, 1u}); }
+	barrier.srcQueueFamilyIndex = m_transfer_queue->family;
+	barrier.dstQueueFamilyIndex = m_device.queue->family;
+	// release: destination scope is ignored
+	auto release = barrier;
+	release.dstStageMask = {};
+	release.dstAccessMask = {};
+	ImageBarrier::transition(batch.transfer, {&release, 1u});
+	// acquire: source scope is ignored, the graphics submission waits for the transfer one
+	auto acquire = barrier;
+	acquire.srcStageMask = {};
+	acquire.srcAccessMask = {};
+	ImageBarrier::transition(batch.graphics, {&acquire, 1u});
+}
+
+void UploadService::transfer_ownership(vk::BufferMemoryBarrier2 barrier) {
+	// without an ownership transfer, the batch's semaphore signal makes the writes visible to later submissions
+	if (!dedicated_queue()) { return; }
+	auto const& batch = *m_pending;
+	barrier.srcQueueFamilyIndex = m_transfer_queue->family;
+	barrier.dstQueueFamilyIndex = m_device.queue->family;
+	auto release = barrier;
+	release.srcStageMask = vk::PipelineStageFlagBits2::eTransfer;
+	release.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+	batch.transfer.pipelineBarrier2(vk::DependencyInfo{{}, {}, release, {}});
+	auto acquire = barrier;
+	acquire.dstStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+	acquire.dstAccessMask = vk::AccessFlagBits2::eMemoryRead;
+	batch.graphics.pipelineBarrier2(vk::DependencyInfo{{}, {}, acquire, {}});
+}
+
+void UploadService::record_writes(Batch& batch, vk::Image const image) {
+	auto const is_recorded = [image](ImageWrites const& w) { return !image || w.image.image == image; };
+	auto const end = std::stable_partition(batch.writes.begin(), batch.writes.end(), [&](ImageWrites const& w) { return !is_recorded(w); });
+	auto const recorded = std::span{end, batch.writes.end()};
+	if (recorded.empty()) { return; }
+
+	// the images may be sampled by frames in flight, which only the graphics queue is ordered with
+	auto barriers = std::vector<vk::ImageMemoryBarrier2>{};
+	barriers.reserve(recorded.size());
+	auto const to_dst = [](ImageWrites const& w) {
+		return ImageBarrier{w.image}.set_full_barrier(vk::ImageLayout::eShaderReadOnlyOptimal, vk::ImageLayout::eTransferDstOptimal).barrier;
+	};
+	std::transform(recorded.begin(), recorded.end(), std::back_inserter(barriers), to_dst);
+	ImageBarrier::transition(batch.graphics, barriers);
+	auto bics = std::vector<vk::BufferImageCopy>{};
+	for (auto const& write : recorded) {
+		// one copy per staging buffer: all of them are in the ring unless a write was too large for it
+		for (auto first = write.regions.begin(); first != write.regions.end();) {
+			auto const buffer = first->buffer;
+			bics.clear();
+			for (; first != write.regions.end() && first->buffer == buffer; ++first) { bics.push_back(first->copy); }
+			batch.graphics.copyBufferToImage(buffer, write.image.image, vk::ImageLayout::eTransferDstOptimal, bics);
+		}
+	}
+	barriers.clear();
+	auto const to_read = [](ImageWrites const& w) {
+		return ImageBarrier{w.image}.set_full_barrier(vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal).barrier;
+	};
+	std::transform(recorded.begin(), recorded.end(), std::back_inserter(barriers), to_read);
+	ImageBarrier::transition(batch.graphics, barriers);
+	for (auto const& write : recorded) {
+		if (write.image.mip_levels > 1) { m_device.vma.write_mips(batch.graphics, write.image); }
+	}
+	batch.writes.erase(end, batch.writes.end());
+}
+
+void UploadService::submit() {
+	assert(m_pending);
+	record_writes(*m_pending);
+	auto batch = std::move(*m_pending);
+	m_pending.reset();
+	batch.transfer.end();
+	auto const transfer_cbsi = vk::CommandBufferSubmitInfo{batch.transfer};
+	auto const transferred = vk::SemaphoreSubmitInfo{*m_timeline, ++m_value, vk::PipelineStageFlagBits2::eAllCommands};
+	m_transfer_queue->with([&](vk::Queue queue) { queue.submit2(vk::SubmitInfo2{{}, {}, transfer_cbsi, transferred}); });
+	if (dedicated_queue()) {
+		batch.graphics.end();
+		auto const graphics_cbsi = vk::CommandBufferSubmitInfo{batch.graphics};
+		auto const acquired = vk::SemaphoreSubmitInfo{*m_timeline, ++m_value, vk::PipelineStageFlagBits2::eAllCommands};
+		m_device.queue->with([&](vk::Queue queue) { queue.submit2(vk::SubmitInfo2{{}, transferred, graphics_cbsi, acquired}); });
+	}
+	batch.value = m_value;
+	m_in_flight.push_back(std::move(batch));
+}
+
+void UploadService::reclaim() {
+	auto const completed = m_device.device.getSemaphoreCounterValue(*m_timeline);
+	while (!m_in_flight.empty() && m_in_flight.front().value <= completed) {
+		auto& batch = m_in_flight.front();
+		m_tail = batch.ring_end;
+		m_free_transfer.push_back(batch.transfer);
+		if (dedicated_queue()) { m_free_graphics.push_back(batch.graphics); }
+		m_in_flight.pop_front();
+	}
+}
+} // namespace levk::vulkan
@@ -0,0 +1,110 @@
+#pragma once
+#include <graphics/vulkan/common.hpp>
+#include <levk/util/not_null.hpp>
+#include <levk/util/pinned.hpp>
+#include <deque>
+#include <mutex>
+
+namespace levk::vulkan {
+///
+/// \brief Batches uploads of new images / buffer regions, and writes to existing images, without blocking the calling thread.
+///
+/// Source bytes are staged in a persistently mapped ring buffer, and copies are recorded into a pending batch that flush()
+/// submits: copies into new resources run on a dedicated transfer queue family if the GPU has one, followed by a graphics
+/// queue submission that acquires them and records work only the graphics queue can do (mip blits, writes to images that
+/// may be in use). Batches signal a timeline semaphore: each upload returns the value it completes at.
+/// Writes to images in use are coalesced per image and recorded when the batch is submitted, so that all the writes to
+/// an image between two flushes share one pair of barriers and one copy.
+///
+/// Thread safe: uploads may be recorded from any thread, eg asset loading workers.
+///
+class UploadService : public Pinned {
+  public:
+	static constexpr vk::DeviceSize ring_size_v{32u * 1024u * 1024u};
+
+	UploadService(DeviceView const& device, NotNull<Queue*> transfer_queue, vk::DeviceSize ring_size = ring_size_v);
+
+	// writes every layer of mip 0 and generates the rest; image contents are discarded
+	std::uint64_t upload(Vma::Image const& image, std::span<levk::Image::View const> layers);
+	// writes each mip of every layer from precomputed (eg block compressed) bytes, ordered by layer then mip; image contents are discarded
+	std::uint64_t upload_mips(Vma::Image const& image, std::span<std::span<std::byte const> const> mips);
+	// writes regions of mip 0 in an image that may be in use (in shader read only layout); recorded on submit
+	std::uint64_t write(Vma::Image const& image, std::span<ImageWrite const> writes);
+	// fills a new image with colour, then copies src into it at offset
+	std::uint64_t copy(Vma::Image const& src, Vma::Image const& dst, glm::ivec2 offset, Rgba colour);
+	// fills a new image with the smallest mips of src (in use), dropping its top ones: dst extent must match that of src's first copied mip
+	std::uint64_t copy_mips(Vma::Image const& src, Vma::Image const& dst);
+	// copies regions of bytes into a buffer range not in use by the GPU; srcOffset in each copy is relative to bytes
+	std::uint64_t upload(vk::Buffer dst, std::span<std::byte const> bytes, std::span<vk::BufferCopy const> copies);
+
+	// submits the pending batch, if any, and returns the value the latest submitted upload completes at
+	std::uint64_t flush();
+	bool is_complete(std::uint64_t value) const;
+	void wait(std::uint64_t value);
+
+	vk::Semaphore timeline() const { return *m_timeline; }
+	bool dedicated_queue() const { return m_transfer_queue != m_device.queue; }
+
+  private:
+	struct ImageWrites {
+		struct Region {
+			vk::Buffer buffer{};
+			vk::BufferImageCopy copy{};
+		};
+
+		Vma::Image image{};
+		std::vector<Region> regions{};
+	};
+
+	struct Batch {
+		vk::CommandBuffer transfer{};
+		vk::CommandBuffer graphics{};
+		// staged bytes too large for the ring
+		std::vector<UniqueBuffer> scratch{};
+		// deferred writes to images that may be in use, one entry per image
+		std::vector<ImageWrites> writes{};
+		// end of this batch's staged bytes in the ring
+		std::uint64_t ring_end{};
+		std::uint64_t value{};
+	};
+
+	struct Staged {
+		vk::Buffer buffer{};
+		vk::DeviceSize offset{};
+	};
+
+	Staged stage(std::size_t size, std::byte*& out_ptr);
+	UniqueBuffer make_staging_buffer(vk::DeviceSize size) const;
+	Batch& pending();
+	// value the pending batch will signal on completion
+	std::uint64_t pending_value() const { return m_value + (dedicated_queue() ? 2u : 1u); }
+	// makes a resource written by the transfer command buffer available to the graphics command buffer
+	void transfer_ownership(vk::ImageMemoryBarrier2 barrier);
+	void transfer_ownership(vk::BufferMemoryBarrier2 barrier);
+	// records the batch's deferred writes (only those to image, if set) onto its graphics command buffer
+	void record_writes(Batch& batch, vk::Image image = {});
+	void submit();
+	void reclaim();
+
+	DeviceView m_device{};
+	Ptr<Queue> m_transfer_queue{};
+	// staging buffers are read by both queue families
+	FlexArray<std::uint32_t, 2> m_queue_families{};
+	CommandAllocator m_transfer_allocator{};
+	CommandAllocator m_graphics_allocator{};
+	std::vector<vk::CommandBuffer> m_free_transfer{};
+	std::vector<vk::CommandBuffer> m_free_graphics{};
+	vk::UniqueSemaphore m_timeline{};
+	std::uint64_t m_value{};
+
+	UniqueBuffer m_ring{};
+	vk::DeviceSize m_alignment{16u};
+	// monotonic byte positions: [m_tail, m_head) is in use by pending / in flight batches
+	std::uint64_t m_head{};
+	std::uint64_t m_tail{};
+
+	std::optional<Batch> m_pending{};
+	std::deque<Batch> m_in_flight{};
+	mutable std::mutex m_mutex{};
+};
+} // namespace levk::vulkan
@@ -0,0 +1,188 @@
+#include <glm/gtc/packing.hpp>
+#include <graphics/vulkan/vertex_format.hpp>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+
+namespace levk::vulkan {
+namespace {
+using Stream = VertexStreams::Stream;
+
+constexpr Stream full_positions_v{vk::Format::eR32G32B32Sfloat, sizeof(glm::vec3)};
+constexpr Stream full_rgbs_v{vk::Format::eR32G32B32Sfloat, sizeof(glm::vec3)};
+constexpr Stream full_normals_v{vk::Format::eR32G32B32Sfloat, sizeof(glm::vec3)};
+constexpr Stream full_uvs_v{vk::Format::eR32G32Sfloat, sizeof(glm::vec2)};
+constexpr Stream full_joints_v{vk::Format::eR32G32B32A32Uint, sizeof(glm::uvec4)};
+constexpr Stream full_weights_v{vk::Format::eR32G32B32A32Sfloat, sizeof(glm::vec4)};
+
+// static positions are quantized relative to their bounds; skinned ones stay in (bind pose) model space as halves
+constexpr Stream quantized_positions_v{vk::Format::eR16G16B16A16Unorm, sizeof(std::uint64_t)};
+constexpr Stream half_positions_v{vk::Format::eR16G16B16A16Sfloat, sizeof(std::uint64_t)};
+constexpr Stream packed_rgbs_v{vk::Format::eR8G8B8A8Unorm, sizeof(std::uint32_t)};
+constexpr Stream octahedral_normals_v{vk::Format::eR16G16Snorm, sizeof(std::uint32_t)};
+constexpr Stream half_uvs_v{vk::Format::eR16G16Sfloat, sizeof(std::uint32_t)};
+constexpr Stream u8_joints_v{vk::Format::eR8G8B8A8Uint, sizeof(std::uint32_t)};
+constexpr Stream u16_joints_v{vk::Format::eR16G16B16A16Uint, sizeof(std::uint64_t)};
+constexpr Stream unorm16_weights_v{vk::Format::eR16G16B16A16Unorm, sizeof(std::uint64_t)};
+
+void add_stream(VertexInput& out, std::uint32_t binding, Stream const& stream) {
+	out.bindings.insert(vk::VertexInputBindingDescription{binding, stream.stride});
+	out.attributes.insert(vk::VertexInputAttributeDescription{binding, binding, stream.format});
+}
+
+template <typename In, typename F>
+void encode(Stream const& stream, std::span<In const> in, std::byte* out, F func) {
+	for (auto const& value : in) {
+		auto const encoded = func(value);
+		static_assert(std::is_trivially_copyable_v<decltype(encoded)>);
+		assert(sizeof(encoded) <= stream.stride);
+		std::memcpy(out, &encoded, sizeof(encoded));
+		out += stream.stride;
+	}
+}
+
+template <typename Type>
+std::array<Type, 4> narrow(glm::uvec4 const& in) {
+	return {static_cast<Type>(in.x), static_cast<Type>(in.y), static_cast<Type>(in.z), static_cast<Type>(in.w)};
+}
+
+constexpr float sign_not_zero(float const f) { return f >= 0.0f ? 1.0f : -1.0f; }
+
+glm::vec2 octahedral(glm::vec3 n) {
+	auto const l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+	if (l1 <= 0.0f) { return {}; }
+	n /= l1;
+	if (n.z >= 0.0f) { return {n.x, n.y}; }
+	return {(1.0f - std::abs(n.y)) * sign_not_zero(n.x), (1.0f - std::abs(n.x)) * sign_not_zero(n.y)};
+}
+} // namespace
+
+VertexStreams VertexStreams::make(VertexFormat const format, bool const skinned, std::size_t const joint_count) {
+	if (format == VertexFormat::eFull) {
+		auto ret = VertexStreams{full_positions_v, full_rgbs_v, full_normals_v, full_uvs_v};
+		if (skinned) {
+			ret.joints = full_joints_v;
+			ret.weights = full_weights_v;
+		}
+		return ret;
+	}
+	auto ret = VertexStreams{skinned ? half_positions_v : quantized_positions_v, packed_rgbs_v, octahedral_normals_v, half_uvs_v};
+	if (skinned) {
+		ret.joints = joint_count <= std::numeric_limits<std::uint8_t>::max() + 1u ? u8_joints_v : u16_joints_v;
+		ret.weights = unorm16_weights_v;
+	}
+	return ret;
+}
+
+std::uint32_t VertexStreams::vertex_stride() const {
+	return positions.stride + rgbs.stride + normals.stride + uvs.stride + joints.stride + weights.stride;
+}
+
+VertexInput VertexStreams::shadow_input() const {
+	auto ret = VertexInput{};
+
+	// position
+	add_stream(ret, 0, positions);
+
+	// instance matrix
+	ret.bindings.insert(vk::VertexInputBindingDescription{4, sizeof(glm::mat4), vk::VertexInputRate::eInstance});
+	ret.attributes.insert(vk::VertexInputAttributeDescription{4, 4, vk::Format::eR32G32B32A32Sfloat, 0 * sizeof(glm::vec4)});
+	ret.attributes.insert(vk::VertexInputAttributeDescription{5, 4, vk::Format::eR32G32B32A32Sfloat, 1 * sizeof(glm::vec4)});
+	ret.attributes.insert(vk::VertexInputAttributeDescription{6, 4, vk::Format::eR32G32B32A32Sfloat, 2 * sizeof(glm::vec4)});
+	ret.attributes.insert(vk::VertexInputAttributeDescription{7, 4, vk::Format::eR32G32B32A32Sfloat, 3 * sizeof(glm::vec4)});
+
+	return ret;
+}
+
+VertexInput VertexStreams::vertex_input() const {
+	auto ret = shadow_input();
+	add_stream(ret, 1, rgbs);
+	add_stream(ret, 2, normals);
+	add_stream(ret, 3, uvs);
+	if (joints.stride > 0) {
+		add_stream(ret, 8, joints);
+		add_stream(ret, 9, weights);
+	}
+	return ret;
+}
+
+vk::IndexType index_type_for(std::size_t const vertex_count) {
+	if (vertex_count <= std::size_t{std::numeric_limits<std::uint16_t>::max()} + 1u) { return vk::IndexType::eUint16; }
+	return vk::IndexType::eUint32;
+}
+
+std::uint32_t index_size(vk::IndexType const type) { return type == vk::IndexType::eUint16 ? sizeof(std::uint16_t) : sizeof(std::uint32_t); }
+
+std::optional<glm::mat4> encode_positions(Stream const& stream, std::span<glm::vec3 const> in, std::byte* out) {
+	if (stream == full_positions_v) {
+		encode(stream, in, out, [](glm::vec3 const& p) { return p; });
+		return {};
+	}
+	if (stream == half_positions_v) {
+		encode(stream, in, out, [](glm::vec3 const& p) { return glm::packHalf4x16(glm::vec4{p, 1.0f}); });
+		return {};
+	}
+	assert(stream == quantized_positions_v);
+	if (in.empty()) { return {}; }
+	auto lo = in.front();
+	auto hi = in.front();
+	for (auto const& p : in) {
+		lo = glm::min(lo, p);
+		hi = glm::max(hi, p);
+	}
+	// uniform scale keeps the inverse-transpose of the (dequantizing) model matrix valid for normals
+	auto const size = hi - lo;
+	auto scale = std::max({size.x, size.y, size.z});
+	if (scale <= 0.0f) { scale = 1.0f; }
+	encode(stream, in, out, [lo, scale](glm::vec3 const& p) { return glm::packUnorm4x16(glm::vec4{(p - lo) / scale, 1.0f}); });
+	auto ret = glm::mat4{scale};
+	ret[3] = glm::vec4{lo, 1.0f};
+	return ret;
+}
+
+void encode_rgbs(Stream const& stream, std::span<glm::vec3 const> in, std::byte* out) {
+	if (stream == full_rgbs_v) { return encode(stream, in, out, [](glm::vec3 const& rgb) { return rgb; }); }
+	assert(stream == packed_rgbs_v);
+	encode(stream, in, out, [](glm::vec3 const& rgb) { return glm::packUnorm4x8(glm::vec4{rgb, 1.0f}); });
+}
+
+void encode_normals(Stream const& stream, std::span<glm::vec3 const> in, std::byte* out) {
+	if (stream == full_normals_v) { return encode(stream, in, out, [](glm::vec3 const& n) { return n; }); }
+	assert(stream == octahedral_normals_v);
+	encode(stream, in, out, [](glm::vec3 const& n) { return glm::packSnorm2x16(octahedral(n)); });
+}
+
+void encode_uvs(Stream const& stream, std::span<glm::vec2 const> in, std::byte* out) {
+	if (stream == full_uvs_v) { return encode(stream, in, out, [](glm::vec2 const& uv) { return uv; }); }
+	assert(stream == half_uvs_v);
+	encode(stream, in, out, [](glm::vec2 const& uv) { return glm::packHalf2x16(uv); });
+}
+
+void encode_joints(Stream const& stream, std::span<glm::uvec4 const> in, std::byte* out) {
+	if (stream == full_joints_v) { return encode(stream, in, out, [](glm::uvec4 const& j) { return j; }); }
+	if (stream == u8_joints_v) { return encode(stream, in, out, [](glm::uvec4 const& j) { return narrow<std::uint8_t>(j); }); }
+	assert(stream == u16_joints_v);
+	encode(stream, in, out, [](glm::uvec4 const& j) { return narrow<std::uint16_t>(j); });
+}
+
+void encode_weights(Stream const& stream, std::span<glm::vec4 const> in, std::byte* out) {
+	if (stream == full_weights_v) { return encode(stream, in, out, [](glm::vec4 const& w) { return w; }); }
+	assert(stream == unorm16_weights_v);
+	encode(stream, in, out, [](glm::vec4 const& w) { return glm::packUnorm4x16(w); });
+}
+
+void encode_indices(vk::IndexType const type, std::span<std::uint32_t const> in, std::byte* out) {
+	if (type == vk::IndexType::eUint32) {
+		std::memcpy(out, in.data(), in.size_bytes());
+		return;
+	}
+	assert(type == vk::IndexType::eUint16);
+	for (auto const index : in) {
+		assert(index <= std::numeric_limits<std::uint16_t>::max());
+		auto const narrowed = static_cast<std::uint16_t>(index);
+		std::memcpy(out, &narrowed, sizeof(narrowed));
+		out += sizeof(narrowed);
+	}
+}
+} // namespace levk::vulkan
@@ -0,0 +1,43 @@
+#pragma once
+#include <glm/mat4x4.hpp>
+#include <graphics/vulkan/common.hpp>
+#include <levk/graphics/geometry.hpp>
+
+namespace levk::vulkan {
+struct VertexStreams {
+	struct Stream {
+		vk::Format format{};
+		std::uint32_t stride{};
+
+		bool operator==(Stream const&) const = default;
+	};
+
+	Stream positions{};
+	Stream rgbs{};
+	Stream normals{};
+	Stream uvs{};
+	Stream joints{};
+	Stream weights{};
+
+	static VertexStreams make(VertexFormat format, bool skinned, std::size_t joint_count = {});
+
+	std::uint32_t vertex_stride() const;
+	VertexInput shadow_input() const;
+	VertexInput vertex_input() const;
+
+	bool operator==(VertexStreams const&) const = default;
+};
+
+vk::IndexType index_type_for(std::size_t vertex_count);
+std::uint32_t index_size(vk::IndexType type);
+
+// each encoder writes in.size() elements of stream.format into out, stream.stride bytes apart
+// returns the transform that maps stored positions back to model space, if quantized
+std::optional<glm::mat4> encode_positions(VertexStreams::Stream const& stream, std::span<glm::vec3 const> in, std::byte* out);
+void encode_rgbs(VertexStreams::Stream const& stream, std::span<glm::vec3 const> in, std::byte* out);
+void encode_normals(VertexStreams::Stream const& stream, std::span<glm::vec3 const> in, std::byte* out);
+void encode_uvs(VertexStreams::Stream const& stream, std::span<glm::vec2 const> in, std::byte* out);
+void encode_joints(VertexStreams::Stream const& stream, std::span<glm::uvec4 const> in, std::byte* out);
+void encode_weights(VertexStreams::Stream const& stream, std::span<glm::vec4 const> in, std::byte* out);
+void encode_indices(vk::IndexType type, std::span<std::uint32_t const> in, std::byte* out);
+} // namespace levk::vulkan
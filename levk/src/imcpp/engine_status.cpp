@@ -49,6 +49,10 @@ void EngineStatus::draw_to(NotClosed<Window> w, Engine& engine, Duration dt) {
 	vsync_combo(device, device_info);
 	float scale = device.info().render_scale;
 	if (ImGui::DragFloat("Render Scale", &scale, 0.05f, render_scale_limit_v[0], render_scale_limit_v[1])) { device.set_render_scale(scale); }
+	auto dynamic_resolution = device_info.dynamic_resolution;
+	if (ImGui::DragFloat("GPU Budget (ms)", &dynamic_resolution.budget_ms, 0.1f, 0.0f, 100.0f)) { device.set_dynamic_resolution(dynamic_resolution); }
+	auto frames_in_flight = static_cast<int>(device_info.frames_in_flight);
+	if (ImGui::SliderInt("Frames in flight", &frames_in_flight, 1, 3)) { device.set_frames_in_flight(static_cast<std::uint32_t>(frames_in_flight)); }
 	glm::vec3 clear_colour = engine.render_device().info().clear_colour.to_vec4();
 	if (imcpp::Reflector{w}("Clear colour", imcpp::Reflector::AsRgb{clear_colour})) {
 		engine.render_device().set_clear(Rgba::from(glm::vec4{clear_colour, 1.0f}));
@@ -56,6 +60,14 @@ void EngineStatus::draw_to(NotClosed<Window> w, Engine& engine, Duration dt) {
 
 	ImGui::Separator();
 	ImGui::Text("%s", FixedString{"FPS: {}", engine.framerate()}.c_str());
+	ImGui::SameLine();
+	ImGui::SeparatorEx(ImGuiSeparatorFlags_Vertical);
+	ImGui::SameLine();
+	ImGui::Text("%s", FixedString{"GPU: {:.2f}ms", device.gpu_frame_time().count() * 1000.0f}.c_str());
+	ImGui::SameLine();
+	ImGui::SeparatorEx(ImGuiSeparatorFlags_Vertical);
+	ImGui::SameLine();
+	ImGui::Text("%s", FixedString{"Latency: {:.2f}ms", device.frame_latency().count() * 1000.0f}.c_str());
 	if (auto tn = TreeNode{"DeltaTime"}) {
 		ImGui::SliderInt("Samples", &m_capacity, 50, 500);
 		ImGui::PlotLines("dt", m_dts.data(), static_cast<int>(m_dts.size()), static_cast<int>(m_offset), FixedString{"{:.2f}ms", ms}.c_str(), FLT_MAX, FLT_MAX,
@@ -63,6 +75,15 @@ void EngineStatus::draw_to(NotClosed<Window> w, Engine& engine, Duration dt) {
 	}
 	ImGui::Separator();
 	ImGui::Text("%s", FixedString{"Draw calls: {}", device.draw_calls_last_frame()}.c_str());
+	auto const geometry = device.geometry_arena_stats();
+	static constexpr auto mib_v = 1.0 / (1024.0 * 1024.0);
+	auto const used_mib = static_cast<double>(geometry.used) * mib_v;
+	auto const capacity_mib = static_cast<double>(geometry.capacity) * mib_v;
+	ImGui::Text("%s", FixedString{"Geometry: {:.1f} / {:.1f} MiB", used_mib, capacity_mib}.c_str());
+	auto const fragmentation = geometry.fragmentation * 100.0f;
+	ImGui::Text("%s", FixedString{"Blocks: {} | Primitives: {} | Fragmentation: {:.0f}%", geometry.blocks, geometry.allocations, fragmentation}.c_str());
+	auto const occlusion = device.occlusion_stats_last_frame();
+	ImGui::Text("%s", FixedString{"Occluded: {} / {} | Occluder triangles: {}", occlusion.culled, occlusion.tested, occlusion.occluder_triangles}.c_str());
 
 	ImGui::Separator();
 	if (auto tn = TreeNode{"Frame Profile"}) {
@@ -75,6 +96,16 @@ void EngineStatus::draw_to(NotClosed<Window> w, Engine& engine, Duration dt) {
 			auto const overlay = FixedString{"{} ({:.0f}%)", label, ratio * 100.0f};
 			ImGui::ProgressBar(ratio, {-1.0f, 0.0f}, overlay.c_str());
 		}
+		auto const gpu_time = frame_profile.gpu[FrameProfile::Type::eFrameTime];
+		if (gpu_time > Duration{}) {
+			ImGui::Text("%s", FixedString{"GPU time: {:.2f}ms", gpu_time.count() * 1000.0f}.c_str());
+			for (FrameProfile::Type type = FrameProfile::Type{}; type < FrameProfile::Type::eFrameTime; type = FrameProfile::Type(int(type) + 1)) {
+				if (frame_profile.gpu[type] <= Duration{}) { continue; }
+				auto const ratio = frame_profile.gpu[type] / gpu_time;
+				auto const overlay = FixedString{"gpu-{} ({:.2f}ms)", FrameProfile::to_string_v[type], frame_profile.gpu[type].count() * 1000.0f};
+				ImGui::ProgressBar(ratio, {-1.0f, 0.0f}, overlay.c_str());
+			}
+		}
 	}
 }
 } // namespace levk::imcpp
@@ -67,6 +67,7 @@ void inspect(OpenWindow w, StaticMeshRenderer& mesh_renderer) {
 		if (auto const in_mesh = DragDrop::accept_string("static_mesh"); !in_mesh.empty()) { mesh_renderer.mesh_uri = in_mesh; }
 	}
 
+	ImGui::Checkbox("Static", &mesh_renderer.is_static);
 	inspect(w, mesh_renderer.instances);
 
 	if (auto popup = imcpp::Popup{"static_mesh_renderer.right_click"}) {
@@ -241,6 +242,29 @@ void Inspector::draw_to(NotClosed<Window> w, Scene& scene) {
 			ImGui::Separator();
 			if (ImGui::Button("Add")) { scene.lights.dir_lights.push_back({}); }
 		}
+		auto const inspect_local_lights = [w](char const* label, auto& lights, auto const& inspect) {
+			auto tn = imcpp::TreeNode{label, ImGuiTreeNodeFlags_Framed};
+			if (!tn) { return; }
+			auto to_remove = std::optional<std::size_t>{};
+			for (auto [light, index] : enumerate(lights)) {
+				if (auto tn = TreeNode{FixedString{"[{}]", index}.c_str()}) {
+					imcpp::Reflector{w}("Position", light.position, 0.25f);
+					imcpp::Reflector{w}(light.rgb, {false});
+					ImGui::DragFloat("Range", &light.range, 0.25f, 0.0f, 10000.0f);
+					inspect(light);
+					if (small_button_red("X")) { to_remove = index; }
+				}
+			}
+			if (to_remove) { lights.erase(lights.begin() + static_cast<std::ptrdiff_t>(*to_remove)); }
+			ImGui::Separator();
+			if (ImGui::Button("Add")) { lights.push_back({}); }
+		};
+		inspect_local_lights("Point", scene.lights.point_lights, [](PointLight&) {});
+		inspect_local_lights("Spot", scene.lights.spot_lights, [w](SpotLight& spot_light) {
+			imcpp::Reflector{w}("Direction", spot_light.direction);
+			imcpp::Reflector{w}("Inner angle", spot_light.inner_angle, 0.25f, 0.0f, 90.0f);
+			imcpp::Reflector{w}("Outer angle", spot_light.outer_angle, 0.25f, 0.0f, 90.0f);
+		});
 		break;
 	}
 	default: {
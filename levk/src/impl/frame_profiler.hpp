@@ -8,6 +8,8 @@ struct FrameProfiler {
 	using Type = FrameProfile::Type;
 
 	std::array<FrameProfile, 2> frame_profiles{};
+	// resolved frames after the CPU profile, set by the render device
+	EnumArray<Type, Duration> gpu_profile{};
 	EnumArray<Type, Clock::time_point> start_map{};
 	std::optional<Type> previous_type{};
 	std::size_t current_index{};
@@ -30,7 +32,11 @@ struct FrameProfiler {
 		current_index = (current_index + 1) % frame_profiles.size();
 	}
 
-	FrameProfile previous_profile() const { return frame_profiles[(current_index + 1) % frame_profiles.size()]; }
+	FrameProfile previous_profile() const {
+		auto ret = frame_profiles[(current_index + 1) % frame_profiles.size()];
+		ret.gpu = gpu_profile;
+		return ret;
+	}
 
 	static FrameProfiler& instance() {
 		static auto ret = FrameProfiler{};
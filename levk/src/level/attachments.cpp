@@ -47,12 +47,14 @@ bool MeshAttachment::serialize(dj::Json& out) const {
 		auto& out_instances = out["instances"];
 		for (auto const& transform : instances) { to_json(out_instances.push_back({}), transform); }
 	}
+	if (is_static) { out["static"] = dj::Boolean{true}; }
 	return true;
 }
 
 bool MeshAttachment::deserialize(dj::Json const& json) {
 	uri = json["uri"].as<std::string>();
 	for (auto const& instance : json["instances"].array_view()) { from_json(instance, instances.emplace_back()); }
+	is_static = json["static"].as<bool>();
 	return true;
 }
 
@@ -72,6 +74,7 @@ void MeshAttachment::attach(Entity& out) {
 		auto& smr = out.attach(std::make_unique<StaticMeshRenderer>());
 		smr.mesh_uri = uri;
 		smr.instances = std::move(instances);
+		smr.is_static = is_static;
 		break;
 	}
 	default: break;
@@ -48,6 +48,7 @@ void Runtime::run() {
 		}
 		tick(dt);
 		m_context.scene_manager.get().tick(dt);
+		m_context.asset_providers.get().texture().update_streaming();
 		render();
 	}
 }
@@ -8,18 +8,20 @@ namespace levk {
 void SceneRenderer::Deleter::operator()(vulkan::SceneRenderer const* ptr) const { delete ptr; }
 
 SceneRenderer::SceneRenderer(NotNull<AssetProviders const*> asset_providers)
-	: m_impl(new vulkan::SceneRenderer{asset_providers->render_device().vulkan_device().view()}), m_render_device(&asset_providers->render_device()),
-	  m_asset_providers(asset_providers) {}
+	: m_render_device(&asset_providers->render_device()), m_asset_providers(asset_providers) {
+	// null backend: scenes are still rendered into RenderLists, which are then dropped
+	if (!m_render_device->is_null()) { m_impl.reset(new vulkan::SceneRenderer{m_render_device->vulkan_device().view()}); }
+}
 
 void SceneRenderer::update(Scene const& scene) {
-	assert(m_impl);
+	if (!m_impl) { return; }
 	m_impl->update(scene);
 }
 
 void SceneRenderer::render(Scene const& scene) const {
-	assert(m_impl);
 	auto render_list = RenderList{};
 	scene.render(render_list);
+	if (!m_impl) { return; }
 	m_impl->scene = &scene;
 	m_impl->render_list = &render_list;
 	m_render_device->vulkan_device().render(*m_impl, *m_asset_providers);
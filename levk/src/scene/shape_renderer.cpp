@@ -26,7 +26,7 @@ void ShapeRenderer::refresh_geometry() {
 }
 
 void ShapeRenderer::setup() {
-	m_primitive = DynamicPrimitive{render_device().vulkan_device()};
+	m_primitive = DynamicPrimitive{render_device()};
 	if (!m_shape) { m_shape = std::make_unique<CubeShape>(); }
 	refresh_geometry();
 }
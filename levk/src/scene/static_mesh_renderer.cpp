@@ -16,13 +16,14 @@ void StaticMeshRenderer::render(DrawList& out) const {
 
 	auto* scene = owning_scene();
 	auto const mat = scene ? scene->global_transform(*entity) : glm::identity<glm::mat4>();
-	out.add(m, DrawList::Instances{mat, instances}, asset_providers->material());
+	out.add(m, DrawList::Instances{mat, instances, is_static}, asset_providers->material());
 }
 
 std::unique_ptr<Attachment> StaticMeshRenderer::to_attachment() const {
 	auto ret = std::make_unique<MeshAttachment>();
 	ret->uri = mesh_uri;
 	ret->instances = instances;
+	ret->is_static = is_static;
 	return ret;
 }
 } // namespace levk
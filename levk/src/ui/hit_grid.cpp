@@ -0,0 +1,71 @@
+#include <glm/common.hpp>
+#include <levk/ui/hit_grid.hpp>
+
+namespace levk::ui {
+Ptr<View> HitGrid::hit_test(glm::vec2 const point) {
+	if (!m_built || m_version != m_root->layout_version()) { rebuild(); }
+	if (!m_bounds.contains(point)) { return {}; }
+	auto const cell = cell_of(point);
+	auto const index = static_cast<std::size_t>(cell.y * m_grid.x + cell.x);
+	auto const offset = m_offsets[2 * index];
+	auto const count = m_offsets[2 * index + 1];
+	auto ret = Ptr<View>{};
+	for (auto i = offset; i < offset + count; ++i) {
+		// indices are in tree order: later views are drawn over earlier ones with the same z_index
+		auto* view = m_views[m_cells[i]];
+		if (view->is_destroyed() || !view->world_frame().contains(point)) { continue; }
+		if (!ret || view->z_index >= ret->z_index) { ret = view; }
+	}
+	return ret;
+}
+
+void HitGrid::rebuild() {
+	m_version = m_root->layout_version();
+	m_built = true;
+	m_views.clear();
+	auto stack = std::vector<Ptr<View>>{};
+	for (auto it = m_root->sub_views().rbegin(); it != m_root->sub_views().rend(); ++it) { stack.push_back(it->get()); }
+	while (!stack.empty()) {
+		auto* view = stack.back();
+		stack.pop_back();
+		if (view->is_destroyed()) { continue; }
+		m_views.push_back(view);
+		for (auto it = view->sub_views().rbegin(); it != view->sub_views().rend(); ++it) { stack.push_back(it->get()); }
+	}
+
+	m_bounds = m_root->world_frame();
+	auto const extent = m_bounds.extent();
+	m_grid = glm::max(glm::ivec2{glm::ceil(extent / m_cell_size)}, glm::ivec2{1});
+	auto const cells = static_cast<std::size_t>(m_grid.x * m_grid.y);
+	m_offsets.assign(2 * cells, 0u);
+	auto const for_each_cell = [this](View const& view, auto func) {
+		auto const& frame = view.world_frame();
+		auto const first = cell_of(frame.bottom_left());
+		auto const last = cell_of(frame.top_right());
+		for (auto y = first.y; y <= last.y; ++y) {
+			for (auto x = first.x; x <= last.x; ++x) { func(static_cast<std::size_t>(y * m_grid.x + x)); }
+		}
+	};
+
+	// count, then offsets, then fill (counts become write cursors)
+	for (auto const* view : m_views) {
+		for_each_cell(*view, [this](std::size_t const cell) { ++m_offsets[2 * cell + 1]; });
+	}
+	auto total = std::uint32_t{};
+	for (std::size_t cell = 0; cell < cells; ++cell) {
+		m_offsets[2 * cell] = total;
+		total += m_offsets[2 * cell + 1];
+	}
+	m_cells.resize(total);
+	auto cursors = std::vector<std::uint32_t>(cells);
+	for (std::size_t cell = 0; cell < cells; ++cell) { cursors[cell] = m_offsets[2 * cell]; }
+	for (std::size_t i = 0; i < m_views.size(); ++i) {
+		for_each_cell(*m_views[i], [&](std::size_t const cell) { m_cells[cursors[cell]++] = static_cast<std::uint32_t>(i); });
+	}
+}
+
+glm::ivec2 HitGrid::cell_of(glm::vec2 const point) const {
+	auto const ret = glm::ivec2{glm::floor((point - m_bounds.bottom_left()) / m_cell_size)};
+	return glm::clamp(ret, glm::ivec2{0}, m_grid - 1);
+}
+} // namespace levk::ui
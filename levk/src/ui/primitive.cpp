@@ -5,11 +5,15 @@
 
 namespace levk::ui {
 Primitive::Primitive() : Primitive(Service<RenderDevice>::locate()) {}
-Primitive::Primitive(RenderDevice const& render_device) : m_primitive(render_device.vulkan_device()) { m_material.render_mode.depth_test = false; }
+Primitive::Primitive(RenderDevice const& render_device) : m_primitive(render_device) {
+	m_material.render_mode.depth_test = false;
+	// nothing to tick: subclasses that override tick() opt back in
+	set_ticking(false);
+}
 
 void Primitive::render(DrawList& out) const {
 	auto const rot = glm::angleAxis(glm::radians(z_rotation), front_v);
-	auto const mat = glm::translate(glm::toMat4(rot), {world_frame().centre(), z_index});
+	auto const mat = glm::translate(glm::toMat4(rot), {world_frame().centre() + m_origin, z_index});
 	out.add(&m_primitive, &m_material, DrawList::Instances{.parent = mat});
 	View::render(out);
 }
@@ -4,8 +4,43 @@
 #include <levk/font/ascii_font.hpp>
 #include <levk/service.hpp>
 #include <levk/ui/text.hpp>
+#include <algorithm>
 
 namespace levk::ui {
+namespace {
+constexpr std::uint32_t quad_indices_v[] = {0, 1, 2, 2, 3, 0};
+
+void resize(Geometry::Packed& out, std::size_t const quads) {
+	auto const vertices = 4 * quads;
+	if (out.positions.size() == vertices) { return; }
+	out.positions.resize(vertices);
+	out.rgbs.resize(vertices, glm::vec3{white_v.to_vec4()});
+	out.normals.resize(vertices, front_v);
+	out.uvs.resize(vertices);
+	// the index pattern only depends on the quad count: extend it for new quads
+	auto const existing = out.indices.size() / std::size(quad_indices_v);
+	out.indices.resize(quads * std::size(quad_indices_v));
+	for (auto quad = existing; quad < quads; ++quad) {
+		auto* indices = &out.indices[quad * std::size(quad_indices_v)];
+		for (auto const index : quad_indices_v) { *indices++ = static_cast<std::uint32_t>(4 * quad) + index; }
+	}
+}
+
+// same vertex order as Geometry::append(Quad)
+void write_quad(Geometry::Packed& out, std::size_t const quad, FontGlyph const& glyph, glm::vec2 const cursor) {
+	auto const rect = glyph.rect(cursor);
+	auto const first = 4 * quad;
+	out.positions[first] = {rect.lt, 0.0f};
+	out.positions[first + 1] = {rect.rb.x, rect.lt.y, 0.0f};
+	out.positions[first + 2] = {rect.rb, 0.0f};
+	out.positions[first + 3] = {rect.lt.x, rect.rb.y, 0.0f};
+	out.uvs[first] = glyph.uv_rect.top_left();
+	out.uvs[first + 1] = glyph.uv_rect.top_right();
+	out.uvs[first + 2] = glyph.uv_rect.bottom_right();
+	out.uvs[first + 3] = glyph.uv_rect.bottom_left();
+}
+} // namespace
+
 Text::Text(NotNull<AsciiFont*> font) : Primitive(font->texture_provider().render_device()), m_font(font) {}
 
 std::unique_ptr<Text> Text::try_make(Uri<AsciiFont> const& uri) {
@@ -16,9 +51,9 @@ std::unique_ptr<Text> Text::try_make(Uri<AsciiFont> const& uri) {
 	return std::make_unique<Text>(font);
 }
 
-void Text::set_string(std::string string) {
+void Text::set_string(std::string_view const string) {
 	if (string != m_string) {
-		m_string = std::move(string);
+		m_string.assign(string);
 		refresh();
 	}
 }
@@ -31,11 +66,39 @@ void Text::set_height(TextHeight height) {
 }
 
 void Text::refresh() {
-	auto geometry = Geometry{};
-	auto pen = AsciiFont::Pen{*m_font, m_height};
-	auto const extent = pen.line_extent(m_string);
-	pen.cursor = {(n_anchor - 0.5f) * extent, z_index};
-	pen.write_line(m_string, {&geometry, &texture_uri()});
-	m_primitive.set_geometry(geometry);
+	auto const* glyphs = m_font->glyph_table(m_height);
+	auto const line = std::string_view{m_string}.substr(0, m_string.find('\n'));
+	auto& geometry = m_primitive.edit_geometry();
+	if (!glyphs) {
+		geometry = {};
+		m_built.clear();
+		m_glyphs = {};
+		m_glyphs_generation = {};
+		return;
+	}
+
+	// quads of the prefix shared with the previous line are still valid if laid out with the same glyphs
+	// (a recreated table may have the same address, but not the same generation)
+	auto prefix = std::size_t{};
+	if (glyphs == m_glyphs && glyphs->generation == m_glyphs_generation) {
+		prefix = static_cast<std::size_t>(std::mismatch(line.begin(), line.end(), m_built.begin(), m_built.end()).first - line.begin());
+	}
+	resize(geometry, line.size());
+	auto cursor = glm::vec2{};
+	auto extent = glm::vec2{};
+	for (std::size_t i = 0; i < line.size(); ++i) {
+		auto const& glyph = (*glyphs)[line[i]];
+		// empty glyphs produce degenerate quads, keeping quad i at character i
+		if (i >= prefix) { write_quad(geometry, i, glyph, cursor); }
+		cursor += glyph.advance;
+		extent.y = std::max(extent.y, glyph.extent.y);
+	}
+	extent.x = cursor.x;
+
+	m_origin = (n_anchor() - 0.5f) * extent;
+	texture_uri() = glyphs->texture_uri;
+	m_built.assign(line);
+	m_glyphs = glyphs;
+	m_glyphs_generation = glyphs->generation;
 }
 } // namespace levk::ui
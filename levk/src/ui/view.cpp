@@ -2,27 +2,53 @@
 #include <algorithm>
 
 namespace levk::ui {
-Rect View::world_frame() const {
-	if (!m_super_view) { return m_frame; }
-	auto const super_frame = m_super_view->world_frame();
-	auto const origin = super_frame.centre() + n_anchor * super_frame.extent();
-	return Rect::from_extent(m_frame.extent(), origin + m_frame.centre());
+Rect const& View::world_frame() const {
+	if (!m_world_dirty) { return m_world_frame; }
+	if (!m_super_view) {
+		m_world_frame = m_frame;
+	} else {
+		// recomputes any dirty super views first: each is computed once until its frame changes
+		auto const& super_frame = m_super_view->world_frame();
+		auto const origin = super_frame.centre() + m_n_anchor * super_frame.extent();
+		m_world_frame = Rect::from_extent(m_frame.extent(), origin + m_frame.centre());
+	}
+	m_world_dirty = false;
+	return m_world_frame;
 }
 
 void View::set_frame(Rect frame) {
 	auto const extent = frame.extent();
-	if (extent.x < 0.0f || extent.y < 0.0f) { return; }
+	if (extent.x < 0.0f || extent.y < 0.0f || frame == m_frame) { return; }
 	m_frame = frame;
+	set_layout_dirty();
 }
 
-void View::set_position(glm::vec2 position) { m_frame = Rect::from_extent(m_frame.extent(), position); }
+void View::set_position(glm::vec2 position) { set_frame(Rect::from_extent(m_frame.extent(), position)); }
 
 void View::set_extent(glm::vec2 extent) { set_frame(Rect::from_extent(extent, m_frame.centre())); }
 
+void View::set_n_anchor(glm::vec2 const n_anchor) {
+	if (n_anchor == m_n_anchor) { return; }
+	m_n_anchor = n_anchor;
+	set_layout_dirty();
+}
+
 Ptr<View> View::add_sub_view(std::unique_ptr<View> view) {
 	if (!view) { return {}; }
 	view->m_super_view = this;
-	return m_sub_views.emplace_back(std::move(view)).get();
+	auto* ret = m_sub_views.emplace_back(std::move(view)).get();
+	ret->set_layout_dirty();
+	add_ticking(static_cast<std::int64_t>(ret->m_ticking_sub_views + (ret->m_ticking ? 1 : 0)));
+	if (ret->m_prune || ret->m_destroyed) {
+		for (auto* view = this; view; view = view->m_super_view) { view->m_prune = true; }
+	}
+	return ret;
+}
+
+void View::set_destroyed() {
+	if (m_destroyed) { return; }
+	m_destroyed = true;
+	for (auto* view = m_super_view; view; view = view->m_super_view) { view->m_prune = true; }
 }
 
 bool View::contains(Ptr<View const> view) const {
@@ -32,13 +58,77 @@ bool View::contains(Ptr<View const> view) const {
 	return false;
 }
 
+void View::set_ticking(bool const ticking) {
+	if (ticking == m_ticking) { return; }
+	m_ticking = ticking;
+	if (m_super_view) { m_super_view->add_ticking(ticking ? 1 : -1); }
+}
+
 void View::tick(WindowInput const& window_input, Duration dt) {
 	if (is_destroyed()) { return; }
-	for (auto const& view : m_sub_views) { view->tick(window_input, dt); }
-	std::erase_if(m_sub_views, [](auto const& view) { return view->is_destroyed(); });
+	for (auto const& view : m_sub_views) {
+		if (view->m_ticking) {
+			view->tick(window_input, dt);
+		} else if (view->m_ticking_sub_views > 0 || view->m_prune) {
+			// only its sub views need to tick
+			view->View::tick(window_input, dt);
+		}
+	}
+	if (m_prune) { prune_sub_views(); }
 }
 
 void View::render(DrawList& out) const {
 	for (auto const& view : m_sub_views) { view->render(out); }
 }
+
+void View::clear_sub_views() {
+	if (m_sub_views.empty()) { return; }
+	add_ticking(-static_cast<std::int64_t>(m_ticking_sub_views));
+	m_sub_views.clear();
+	m_prune = false;
+	bump_layout_version();
+}
+
+void View::set_layout_dirty() {
+	// if this view is already dirty so is its tree: world frames are only computed after super views'
+	if (!m_world_dirty) {
+		m_world_dirty = true;
+		auto stack = std::vector<View*>{this};
+		while (!stack.empty()) {
+			auto* view = stack.back();
+			stack.pop_back();
+			for (auto const& sub_view : view->m_sub_views) {
+				if (sub_view->m_world_dirty) { continue; }
+				sub_view->m_world_dirty = true;
+				stack.push_back(sub_view.get());
+			}
+		}
+	}
+	bump_layout_version();
+}
+
+void View::bump_layout_version() {
+	auto* root = this;
+	while (root->m_super_view) { root = root->m_super_view; }
+	++root->m_layout_version;
+}
+
+void View::add_ticking(std::int64_t const delta) {
+	if (delta == 0) { return; }
+	for (auto* view = this; view; view = view->m_super_view) {
+		view->m_ticking_sub_views = static_cast<std::uint64_t>(static_cast<std::int64_t>(view->m_ticking_sub_views) + delta);
+	}
+}
+
+void View::prune_sub_views() {
+	auto removed = std::int64_t{};
+	std::erase_if(m_sub_views, [&removed](auto const& view) {
+		if (!view->is_destroyed()) { return false; }
+		removed += static_cast<std::int64_t>(view->m_ticking_sub_views + (view->m_ticking ? 1 : 0));
+		return true;
+	});
+	m_prune = false;
+	add_ticking(-removed);
+	bump_layout_version();
+}
 } // namespace levk::ui
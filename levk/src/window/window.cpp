@@ -135,19 +135,45 @@ Window::Window(glm::uvec2 extent, char const* title) : m_impl(new glfw::Window{}
 	g_storage.state.extent = extent;
 }
 
-glm::uvec2 Window::framebuffer_extent() const { return m_impl->framebuffer_extent(); }
+Window Window::make_null(glm::uvec2 const extent) {
+	g_storage.state.extent = g_storage.state.framebuffer = extent;
+	g_storage.state.input.ui_space = extent;
+	return Window{};
+}
+
+glm::uvec2 Window::framebuffer_extent() const {
+	if (!m_impl) { return g_storage.state.framebuffer; }
+	return m_impl->framebuffer_extent();
+}
 
 glm::uvec2 Window::window_extent() const {
+	if (!m_impl) { return g_storage.state.extent; }
 	auto ret = glm::ivec2{};
 	glfwGetWindowSize(m_impl->window, &ret.x, &ret.y);
 	return ret;
 }
 
-void Window::show() { glfwShowWindow(m_impl->window); }
-void Window::hide() { glfwHideWindow(m_impl->window); }
-void Window::close() { glfwSetWindowShouldClose(m_impl->window, GLFW_TRUE); }
+void Window::show() {
+	if (m_impl) { glfwShowWindow(m_impl->window); }
+}
+
+void Window::hide() {
+	if (m_impl) { glfwHideWindow(m_impl->window); }
+}
+
+void Window::close() {
+	if (!m_impl) {
+		g_storage.state.flags.set(WindowFlag::eClosed);
+		g_storage.state.triggers.set(WindowFlag::eClosed);
+		return;
+	}
+	glfwSetWindowShouldClose(m_impl->window, GLFW_TRUE);
+}
 
-bool Window::is_open() const { return !glfwWindowShouldClose(m_impl->window); }
+bool Window::is_open() const {
+	if (!m_impl) { return !g_storage.state.flags.test(WindowFlag::eClosed); }
+	return !glfwWindowShouldClose(m_impl->window);
+}
 
 WindowState const& Window::state() const { return g_storage.state; }
 
@@ -174,6 +200,7 @@ void Window::poll() {
 		gamepad.is_active = {};
 		gamepad.axes = {};
 	}
+	if (!m_impl) { return; }
 	glfwPollEvents();
 	g_storage.state.drops = g_storage.drops;
 	g_storage.state.input.cursor = screen_to_world(g_storage.raw_cursor_position, g_storage.state.extent, g_storage.state.display_ratio());
@@ -199,23 +226,39 @@ void Window::poll() {
 	}
 }
 
-char const* Window::clipboard() const { return glfwGetClipboardString(m_impl->window); }
-void Window::set_clipboard(char const* text) { glfwSetClipboardString(m_impl->window, text); }
+char const* Window::clipboard() const { return m_impl ? glfwGetClipboardString(m_impl->window) : ""; }
+
+void Window::set_clipboard(char const* text) {
+	if (m_impl) { glfwSetClipboardString(m_impl->window, text); }
+}
+
+CursorMode Window::cursor_mode() const { return m_impl ? to_cursor_mode(glfwGetInputMode(m_impl->window, GLFW_CURSOR)) : CursorMode::eNormal; }
 
-CursorMode Window::cursor_mode() const { return to_cursor_mode(glfwGetInputMode(m_impl->window, GLFW_CURSOR)); }
-void Window::set_cursor_mode(CursorMode const mode) { glfwSetInputMode(m_impl->window, GLFW_CURSOR, from(mode)); }
+void Window::set_cursor_mode(CursorMode const mode) {
+	if (m_impl) { glfwSetInputMode(m_impl->window, GLFW_CURSOR, from(mode)); }
+}
 
-void Window::set_title(char const* title) { glfwSetWindowTitle(m_impl->window, title); }
+void Window::set_title(char const* title) {
+	if (m_impl) { glfwSetWindowTitle(m_impl->window, title); }
+}
 
 void Window::set_extent(Extent2D extent) {
+	if (!m_impl) {
+		g_storage.state.extent = g_storage.state.framebuffer = extent;
+		g_storage.state.triggers.set(WindowFlag::eResized);
+		return;
+	}
 	glm::ivec2 const size = extent;
 	glfwSetWindowSize(m_impl->window, size.x, size.y);
 }
 
 void Window::lock_aspect_ratio() {
+	if (!m_impl) { return; }
 	glm::ivec2 const size = window_extent();
 	glfwSetWindowAspectRatio(m_impl->window, size.x, size.y);
 }
 
-void Window::unlock_aspect_ratio() { glfwSetWindowAspectRatio(m_impl->window, GLFW_DONT_CARE, GLFW_DONT_CARE); }
+void Window::unlock_aspect_ratio() {
+	if (m_impl) { glfwSetWindowAspectRatio(m_impl->window, GLFW_DONT_CARE, GLFW_DONT_CARE); }
+}
 } // namespace levk
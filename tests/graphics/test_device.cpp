@@ -0,0 +1,124 @@
+#include <graphics/vulkan/device.hpp>
+#include <test/test.hpp>
+#include <array>
+#include <cmath>
+
+namespace {
+using levk::vulkan::ResolutionController;
+using levk::vulkan::ShadowAtlas;
+
+constexpr auto resolution_v = levk::Extent2D{1024u, 1024u};
+
+bool equals(vk::Rect2D const& rect, std::int32_t const x, std::int32_t const y, std::uint32_t const extent) {
+	return rect == vk::Rect2D{{x, y}, {extent, extent}};
+}
+
+// left, top, right, bottom
+std::array<std::int64_t, 4> bounds(vk::Rect2D const& rect) {
+	return {rect.offset.x, rect.offset.y, rect.offset.x + std::int64_t{rect.extent.width}, rect.offset.y + std::int64_t{rect.extent.height}};
+}
+
+bool disjoint_and_inside(ShadowAtlas const& atlas) {
+	auto const cascades = atlas.cascades.span();
+	for (std::size_t i = 0; i < cascades.size(); ++i) {
+		auto const a = bounds(cascades[i]);
+		if (a[0] < 0 || a[1] < 0 || a[2] > std::int64_t{atlas.extent.width} || a[3] > std::int64_t{atlas.extent.height}) { return false; }
+		for (std::size_t j = i + 1; j < cascades.size(); ++j) {
+			auto const b = bounds(cascades[j]);
+			if (a[0] < b[2] && b[0] < a[2] && a[1] < b[3] && b[1] < a[3]) { return false; }
+		}
+	}
+	return true;
+}
+
+TEST(shadow_atlas_single_cascade) {
+	auto const atlas = ShadowAtlas::make(resolution_v, levk::ShadowCascades{.count = 1u}, 0u);
+	ASSERT(atlas.cascades.size() == 1u);
+	EXPECT(equals(atlas.cascades.span()[0], 0, 0, 1024u));
+	EXPECT(atlas.extent == vk::Extent2D(1024u, 1024u));
+}
+
+TEST(shadow_atlas_packs_two_per_row) {
+	// resolution scales: 1, 0.5, 0.5, 0.25
+	auto const atlas = ShadowAtlas::make(resolution_v, levk::ShadowCascades{.count = 4u}, 0u);
+	ASSERT(atlas.cascades.size() == 4u);
+	auto const cascades = atlas.cascades.span();
+	EXPECT(equals(cascades[0], 0, 0, 1024u));
+	EXPECT(equals(cascades[1], 1024, 0, 512u));
+	EXPECT(equals(cascades[2], 0, 1024, 512u));
+	EXPECT(equals(cascades[3], 1024, 1024, 256u));
+	EXPECT(atlas.extent == vk::Extent2D(1536u, 1536u));
+	EXPECT(disjoint_and_inside(atlas));
+}
+
+TEST(shadow_atlas_scales_down_to_max_extent) {
+	auto const atlas = ShadowAtlas::make(resolution_v, levk::ShadowCascades{.count = 3u}, 768u);
+	ASSERT(atlas.cascades.size() == 3u);
+	auto const cascades = atlas.cascades.span();
+	EXPECT(equals(cascades[0], 0, 0, 512u));
+	EXPECT(equals(cascades[1], 512, 0, 256u));
+	EXPECT(equals(cascades[2], 0, 512, 256u));
+	EXPECT(atlas.extent.width <= 768u && atlas.extent.height <= 768u);
+	EXPECT(disjoint_and_inside(atlas));
+}
+
+TEST(shadow_atlas_cascades_are_at_least_one_texel) {
+	auto cascades = levk::ShadowCascades{.count = 2u};
+	cascades.resolution_scale = {1.0f, 0.0f};
+	auto const atlas = ShadowAtlas::make({4u, 4u}, cascades, 0u);
+	ASSERT(atlas.cascades.size() == 2u);
+	EXPECT(equals(atlas.cascades.span()[1], 4, 0, 1u));
+	EXPECT(disjoint_and_inside(atlas));
+}
+
+// 10ms budget, averaged over 2 frames, scale in [0.5, 1] by steps of 0.1
+constexpr auto dynamic_resolution_v = levk::DynamicResolution{.budget_ms = 10.0f, .headroom = 0.15f, .step = 0.1f, .frames = 2u};
+
+constexpr levk::Duration ms(float const value) { return levk::Duration{value / 1000.0f}; }
+
+bool approx(float const a, float const b) { return std::abs(a - b) < 1e-4f; }
+
+// feeds frames drawn at scale, returning the last result
+float feed(ResolutionController& controller, float const scale, float const gpu_ms, std::uint32_t const frames = dynamic_resolution_v.frames) {
+	auto ret = scale;
+	for (std::uint32_t i = 0; i < frames; ++i) { ret = controller.update(dynamic_resolution_v, scale, scale, ms(gpu_ms)); }
+	return ret;
+}
+
+TEST(resolution_controller_disabled_without_budget) {
+	auto controller = ResolutionController{};
+	auto config = dynamic_resolution_v;
+	config.budget_ms = 0.0f;
+	for (int i = 0; i < 4; ++i) { EXPECT(controller.update(config, 1.0f, 1.0f, ms(100.0f)) == 1.0f); }
+}
+
+TEST(resolution_controller_drops_to_fit_budget) {
+	auto controller = ResolutionController{};
+	// scale only changes once every frames samples
+	EXPECT(feed(controller, 1.0f, 20.0f, 1u) == 1.0f);
+	// twice the budget: sqrt(0.5) of the scale fits, rounded down to a step
+	EXPECT(approx(feed(controller, 1.0f, 20.0f, 1u), 0.7f));
+	// never below min_scale
+	EXPECT(approx(feed(controller, 0.5f, 100.0f), 0.5f));
+}
+
+TEST(resolution_controller_rises_with_headroom) {
+	auto controller = ResolutionController{};
+	// 0.8 would cost ~5.2ms: well within budget
+	EXPECT(approx(feed(controller, 0.7f, 4.0f), 0.8f));
+	// 0.8 would cost ~10.4ms: stay put rather than oscillate
+	EXPECT(approx(feed(controller, 0.7f, 8.0f), 0.7f));
+	// never above max_scale
+	EXPECT(approx(feed(controller, 1.0f, 1.0f), 1.0f));
+}
+
+TEST(resolution_controller_discards_stale_samples) {
+	auto controller = ResolutionController{};
+	EXPECT(feed(controller, 1.0f, 20.0f, 1u) == 1.0f);
+	// drawn at the previous scale: resets the average
+	EXPECT(controller.update(dynamic_resolution_v, 1.0f, 0.9f, ms(20.0f)) == 1.0f);
+	EXPECT(controller.frames == 0u);
+	EXPECT(feed(controller, 1.0f, 20.0f, 1u) == 1.0f);
+	EXPECT(approx(feed(controller, 1.0f, 20.0f, 1u), 0.7f));
+}
+} // namespace
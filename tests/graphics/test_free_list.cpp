@@ -0,0 +1,49 @@
+#include <graphics/vulkan/geometry_arena.hpp>
+#include <test/test.hpp>
+
+namespace {
+using levk::vulkan::FreeList;
+
+TEST(allocate_first_fit) {
+	auto list = FreeList{100};
+	EXPECT(list.allocate(10) == 0u);
+	EXPECT(list.allocate(20) == 10u);
+	EXPECT(list.free_size() == 70u);
+	EXPECT(list.largest_free() == 70u);
+}
+
+TEST(allocate_exhausted) {
+	auto list = FreeList{16};
+	EXPECT(list.allocate(16) == 0u);
+	EXPECT(!list.allocate(1));
+	EXPECT(list.allocate(0) == 0u);
+	EXPECT(list.free_size() == 0u);
+}
+
+TEST(release_reuses_hole) {
+	auto list = FreeList{100};
+	ASSERT(list.allocate(10) == 0u);
+	ASSERT(list.allocate(10) == 10u);
+	ASSERT(list.allocate(10) == 20u);
+	list.release({10, 10});
+	// first fit prefers the hole over the tail
+	EXPECT(list.allocate(5) == 10u);
+	EXPECT(list.allocate(5) == 15u);
+	EXPECT(list.allocate(5) == 30u);
+}
+
+TEST(release_coalesces_neighbours) {
+	auto list = FreeList{30};
+	ASSERT(list.allocate(10) == 0u);
+	ASSERT(list.allocate(10) == 10u);
+	ASSERT(list.allocate(10) == 20u);
+	list.release({0, 10});
+	list.release({20, 10});
+	EXPECT(list.largest_free() == 10u);
+	// middle release bridges both neighbours into a single range
+	list.release({10, 10});
+	EXPECT(list.largest_free() == 30u);
+	EXPECT(list.free_size() == 30u);
+	EXPECT(list.allocate(30) == 0u);
+}
+} // namespace
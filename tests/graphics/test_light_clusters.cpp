@@ -0,0 +1,84 @@
+#include <levk/graphics/light_clusters.hpp>
+#include <levk/util/thread_pool.hpp>
+#include <test/test.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+using levk::LightBounds;
+using levk::LightClusters;
+
+constexpr auto grid_v = glm::uvec3{4u, 4u, 8u};
+constexpr auto extent_v = levk::Extent2D{100u, 100u};
+
+// camera at the origin looking down -Z, square viewport: 4x4 tiles per slice
+LightClusters build(std::span<LightBounds const> lights, levk::Ptr<levk::ThreadPool> thread_pool = {}) {
+	auto ret = LightClusters{grid_v, 100.0f};
+	ret.build(levk::Camera{}, extent_v, lights, thread_pool);
+	return ret;
+}
+
+std::uint32_t slice_at(LightClusters const& clusters, float const depth) {
+	auto const& params = clusters.depth_params();
+	return static_cast<std::uint32_t>(std::floor(std::log(depth) * params.x + params.y));
+}
+
+bool contains(LightClusters const& clusters, glm::uvec3 const cluster, std::uint32_t const light) {
+	auto const data = clusters.data();
+	auto const index = 2u * ((std::size_t{cluster.z} * grid_v.y + cluster.y) * grid_v.x + cluster.x);
+	auto const lights = data.subspan(data[index], data[index + 1]);
+	return std::find(lights.begin(), lights.end(), light) != lights.end();
+}
+
+std::size_t assigned(LightClusters const& clusters) { return clusters.data().size() - 2u * clusters.cluster_count(); }
+
+TEST(light_ahead_is_in_central_tiles) {
+	auto const lights = std::array{LightBounds{.centre = {0.0f, 0.0f, -10.0f}, .radius = 0.5f}};
+	auto const clusters = build(lights);
+	auto const z = slice_at(clusters, 10.0f);
+	ASSERT(z > 0u && z < grid_v.z);
+	// the light straddles the centre lines of the viewport
+	for (std::uint32_t y = 1; y <= 2; ++y) {
+		for (std::uint32_t x = 1; x <= 2; ++x) { EXPECT(contains(clusters, {x, y, z}, 0u)); }
+	}
+	EXPECT(!contains(clusters, {0u, 0u, z}, 0u));
+	EXPECT(!contains(clusters, {3u, 1u, z}, 0u));
+	EXPECT(!contains(clusters, {1u, 1u, z - 1}, 0u));
+	EXPECT(assigned(clusters) == 4u);
+}
+
+TEST(light_left_is_in_first_column) {
+	// NDC x = -0.75 at depth 10: the middle of the leftmost column
+	auto const half_width = 10.0f * std::tan(0.5f * levk::Camera::Perspective{}.field_of_view.value);
+	auto const lights = std::array{
+		LightBounds{.centre = {0.0f, 0.0f, -10.0f}, .radius = 0.5f},
+		LightBounds{.centre = {-0.75f * half_width, 0.0f, -10.0f}, .radius = 0.5f},
+	};
+	auto const clusters = build(lights);
+	auto const z = slice_at(clusters, 10.0f);
+	EXPECT(contains(clusters, {0u, 1u, z}, 1u));
+	EXPECT(contains(clusters, {0u, 2u, z}, 1u));
+	EXPECT(!contains(clusters, {1u, 1u, z}, 1u));
+	EXPECT(!contains(clusters, {0u, 1u, z}, 0u));
+	EXPECT(assigned(clusters) == 6u);
+}
+
+TEST(light_behind_camera_is_culled) {
+	auto const lights = std::array{LightBounds{.centre = {0.0f, 0.0f, 10.0f}, .radius = 1.0f}};
+	auto const clusters = build(lights);
+	EXPECT(assigned(clusters) == 0u);
+}
+
+TEST(thread_pool_matches_serial) {
+	auto lights = std::vector<LightBounds>{};
+	for (int i = 0; i < 64; ++i) {
+		auto const t = static_cast<float>(i);
+		lights.push_back({.centre = {5.0f * std::sin(t), 3.0f * std::cos(1.3f * t), -1.0f - 1.5f * t}, .radius = 0.5f + 0.1f * static_cast<float>(i % 7)});
+	}
+	auto thread_pool = levk::ThreadPool{3u};
+	auto const serial = build(lights);
+	auto const threaded = build(lights, &thread_pool);
+	ASSERT(assigned(serial) > 0u);
+	EXPECT(std::ranges::equal(serial.data(), threaded.data()));
+}
+} // namespace
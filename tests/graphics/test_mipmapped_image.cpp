@@ -0,0 +1,206 @@
+#include <levk/graphics/mipmapped_image.hpp>
+#include <test/test.hpp>
+#include <array>
+#include <cstring>
+#include <utility>
+
+namespace {
+using levk::ImageFormat;
+using levk::MipmappedImage;
+using Block = std::array<std::byte, 16>;
+
+// packs fields LSB first, as BC7 blocks are laid out
+struct BitWriter {
+	Block bytes{};
+	std::uint32_t position{};
+
+	BitWriter& operator()(std::uint32_t const value, std::uint32_t const count) {
+		for (std::uint32_t i = 0; i < count; ++i, ++position) {
+			if (((value >> i) & 1u) != 0) { bytes[position / 8u] |= std::byte{1} << (position % 8u); }
+		}
+		return *this;
+	}
+};
+
+template <typename Type>
+void write(levk::ByteArray& out, std::size_t const offset, Type const value) {
+	std::memcpy(out.data() + offset, &value, sizeof(value));
+}
+
+// copy of the first size bytes
+levk::ByteArray copy_front(levk::ByteArray const& bytes, std::size_t const size) { return levk::ByteArray{std::span<std::byte const>{bytes.data(), size}}; }
+
+// single level 2D DDS with a DX10 header
+levk::ByteArray make_dds(std::uint32_t const dxgi_format, levk::Extent2D const extent, std::span<Block const> blocks) {
+	auto ret = levk::ByteArray{148u + blocks.size() * 16u};
+	std::memcpy(ret.data(), "DDS ", 4);
+	write(ret, 4, 124u);
+	write(ret, 12, extent.y);
+	write(ret, 16, extent.x);
+	write(ret, 28, 1u);
+	write(ret, 76, 32u);
+	write(ret, 80, 0x4u);
+	std::memcpy(ret.data() + 84, "DX10", 4);
+	write(ret, 128, dxgi_format);
+	write(ret, 132, 3u);
+	write(ret, 140, 1u);
+	for (std::size_t i = 0; i < blocks.size(); ++i) { std::memcpy(ret.data() + 148u + i * 16u, blocks[i].data(), 16u); }
+	return ret;
+}
+
+// single level KTX2 with one BC7 block
+levk::ByteArray make_ktx2(Block const& block) {
+	static constexpr std::array<std::uint8_t, 12> identifier_v{0xab, 0x4b, 0x54, 0x58, 0x20, 0x32, 0x30, 0xbb, 0x0d, 0x0a, 0x1a, 0x0a};
+	auto ret = levk::ByteArray{120u};
+	std::memcpy(ret.data(), identifier_v.data(), identifier_v.size());
+	write(ret, 12, 145u);
+	write(ret, 20, 4u);
+	write(ret, 24, 4u);
+	write(ret, 36, 1u);
+	write(ret, 40, 1u);
+	write(ret, 80, std::uint64_t{104u});
+	write(ret, 88, std::uint64_t{16u});
+	std::memcpy(ret.data() + 104, block.data(), block.size());
+	return ret;
+}
+
+constexpr std::uint32_t dxgi_bc7_unorm_v{98};
+
+// mode 6: one subset, RGBA endpoints with a p-bit each, 4 bit indices (texel index == texel)
+Block make_mode_6_block() {
+	auto bits = BitWriter{};
+	bits(1u << 6u, 7);
+	bits(127, 7)(0, 7);
+	bits(0, 7)(127, 7);
+	bits(64, 7)(64, 7);
+	bits(127, 7)(127, 7);
+	bits(1, 1)(1, 1);
+	bits(0, 3);
+	for (std::uint32_t t = 1; t < 16; ++t) { bits(t, 4); }
+	return bits.bytes;
+}
+
+// mode 1: two subsets split by partition 13 (top two rows / bottom two rows), red and green, all indices 0
+Block make_mode_1_block() {
+	auto bits = BitWriter{};
+	bits(1u << 1u, 2);
+	bits(13, 6);
+	bits(63, 6)(63, 6)(0, 6)(0, 6);
+	bits(0, 6)(0, 6)(63, 6)(63, 6);
+	bits(0, 6)(0, 6)(0, 6)(0, 6);
+	bits(1, 1)(1, 1);
+	bits(0, 23)(0, 23);
+	return bits.bytes;
+}
+
+bool equals(levk::Rgba const& rgba, std::uint8_t const r, std::uint8_t const g, std::uint8_t const b, std::uint8_t const a) {
+	return rgba.channels == glm::tvec4<std::uint8_t>{r, g, b, a};
+}
+
+TEST(bc7_mode_6_interpolates_endpoints) {
+	auto const blocks = std::array<Block, 1>{make_mode_6_block()};
+	auto const image = MipmappedImage{make_dds(dxgi_bc7_unorm_v, {4, 4}, blocks)};
+	ASSERT(image && image.format() == ImageFormat::eBc7);
+	auto const pixels = image.decode(0);
+	ASSERT(pixels.extent() == levk::Extent2D(4, 4));
+	EXPECT(equals(pixels[{0, 0}], 255, 1, 129, 255));
+	EXPECT(equals(pixels[{0, 2}], 120, 136, 129, 255));
+	EXPECT(equals(pixels[{3, 3}], 1, 255, 129, 255));
+}
+
+TEST(bc7_mode_1_uses_partition) {
+	auto const blocks = std::array{make_mode_1_block(), make_mode_6_block()};
+	auto const image = MipmappedImage{make_dds(dxgi_bc7_unorm_v, {8, 4}, blocks)};
+	ASSERT(image);
+	auto const pixels = image.decode(0);
+	ASSERT(pixels.extent() == levk::Extent2D(8, 4));
+	EXPECT(equals(pixels[{0, 0}], 255, 2, 2, 255));
+	EXPECT(equals(pixels[{3, 1}], 255, 2, 2, 255));
+	EXPECT(equals(pixels[{0, 2}], 2, 255, 2, 255));
+	EXPECT(equals(pixels[{3, 3}], 2, 255, 2, 255));
+	// second block
+	EXPECT(equals(pixels[{4, 0}], 255, 1, 129, 255));
+}
+
+TEST(bc7_reserved_mode_is_transparent) {
+	auto const blocks = std::array<Block, 1>{};
+	auto const image = MipmappedImage{make_dds(dxgi_bc7_unorm_v, {4, 4}, blocks)};
+	ASSERT(image);
+	auto const pixels = image.decode(0);
+	EXPECT(equals(pixels[{1, 1}], 0, 0, 0, 0));
+}
+
+TEST(levk_container_round_trip) {
+	auto const pixels = std::array<std::uint8_t, 32>{
+		10, 20, 30, 255, 40, 50, 60, 255, 70, 80, 90, 255, 100, 110, 120, 255, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+	};
+	auto const view = levk::Image::View{.storage = std::as_bytes(std::span{pixels}), .extent = {4u, 2u}};
+	auto const image = MipmappedImage{MipmappedImage::bake(view, levk::ColourSpace::eLinear)};
+	ASSERT(image && image.format() == ImageFormat::eRgba8);
+	EXPECT(image.colour_space() == levk::ColourSpace::eLinear);
+	ASSERT(image.mips().size() == 3u);
+	EXPECT(image.mips()[1].extent == levk::Extent2D(2u, 1u));
+	EXPECT(image.mips()[2].extent == levk::Extent2D(1u, 1u));
+	auto const decoded = image.decode(0);
+	EXPECT(equals(decoded[{1, 0}], 40, 50, 60, 255));
+	EXPECT(equals(decoded[{3, 1}], 13, 14, 15, 16));
+}
+
+TEST(levk_container_malformed_is_rejected) {
+	auto const pixels = std::array<std::uint8_t, 64>{};
+	auto const view = levk::Image::View{.storage = std::as_bytes(std::span{pixels}), .extent = {4u, 4u}};
+	auto const baked = MipmappedImage::bake(view, levk::ColourSpace::eSrgb);
+	ASSERT(MipmappedImage{copy_front(baked, baked.size())});
+	// the last (1x1) mip is padded to 16 bytes
+	EXPECT(!MipmappedImage{copy_front(baked, baked.size() - 16u)});
+	EXPECT(!MipmappedImage{copy_front(baked, 20u)});
+	// 4x4 has 3 levels, and 33 would shift extents by 32
+	for (auto const levels : {0u, 4u, 33u}) {
+		auto bytes = copy_front(baked, baked.size());
+		write(bytes, 24, levels);
+		EXPECT(!MipmappedImage{std::move(bytes)});
+	}
+	// offset + size wraps
+	auto bytes = copy_front(baked, baked.size());
+	write(bytes, 32, ~std::uint64_t{} - 15u);
+	EXPECT(!MipmappedImage{std::move(bytes)});
+}
+
+TEST(ktx2_container) {
+	auto const image = MipmappedImage{make_ktx2(make_mode_6_block())};
+	ASSERT(image && image.format() == ImageFormat::eBc7);
+	EXPECT(image.colour_space() == levk::ColourSpace::eLinear);
+	EXPECT(image.extent() == levk::Extent2D(4u, 4u));
+	EXPECT(equals(image.decode(0)[{0, 0}], 255, 1, 129, 255));
+}
+
+TEST(ktx2_container_malformed_is_rejected) {
+	auto const valid = make_ktx2(make_mode_6_block());
+	EXPECT(!MipmappedImage{copy_front(valid, valid.size() - 1u)});
+	EXPECT(!MipmappedImage{copy_front(valid, 60u)});
+	auto bytes = make_ktx2(make_mode_6_block());
+	write(bytes, 40, 33u);
+	EXPECT(!MipmappedImage{std::move(bytes)});
+	bytes = make_ktx2(make_mode_6_block());
+	write(bytes, 80, ~std::uint64_t{} - 7u);
+	EXPECT(!MipmappedImage{std::move(bytes)});
+	bytes = make_ktx2(make_mode_6_block());
+	write(bytes, 20, 0u);
+	EXPECT(!MipmappedImage{std::move(bytes)});
+}
+
+TEST(dds_container_malformed_is_rejected) {
+	auto const blocks = std::array<Block, 1>{make_mode_6_block()};
+	auto const valid = make_dds(dxgi_bc7_unorm_v, {4, 4}, blocks);
+	ASSERT(MipmappedImage{copy_front(valid, valid.size())});
+	EXPECT(!MipmappedImage{copy_front(valid, valid.size() - 1u)});
+	EXPECT(!MipmappedImage{copy_front(valid, 140u)});
+	// 3 levels would fit a 4x4 chain, but the data only has one
+	for (auto const levels : {3u, 33u}) {
+		auto bytes = make_dds(dxgi_bc7_unorm_v, {4, 4}, blocks);
+		write(bytes, 28, levels);
+		EXPECT(!MipmappedImage{std::move(bytes)});
+	}
+	EXPECT(!MipmappedImage{make_dds(0u, {4, 4}, blocks)});
+}
+} // namespace
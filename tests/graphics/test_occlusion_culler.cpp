@@ -0,0 +1,67 @@
+#include <glm/gtc/matrix_transform.hpp>
+#include <levk/graphics/camera.hpp>
+#include <levk/graphics/occlusion_culler.hpp>
+#include <test/test.hpp>
+
+namespace {
+using levk::OcclusionCuller;
+
+// unit cube centred at the origin, half extent 1
+levk::Occluder make_box() {
+	auto ret = levk::Occluder{};
+	for (int i = 0; i < 8; ++i) { ret.positions.push_back({i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f}); }
+	ret.indices = {
+		0, 1, 3, 0, 3, 2, // -z
+		4, 6, 7, 4, 7, 5, // +z
+		0, 4, 5, 0, 5, 1, // -y
+		2, 3, 7, 2, 7, 6, // +y
+		0, 2, 6, 0, 6, 4, // -x
+		1, 5, 7, 1, 7, 3, // +x
+	};
+	return ret;
+}
+
+// camera at +5 on Z looking down -Z, a 4x4 wall (0.2 thick) at the origin
+OcclusionCuller make_culler(bool with_wall = true) {
+	auto camera = levk::Camera{};
+	camera.transform.set_position({0.0f, 0.0f, 5.0f});
+	auto const extent = glm::vec2{OcclusionCuller::default_extent_v};
+	auto ret = OcclusionCuller{};
+	ret.begin(camera.projection(extent) * camera.view());
+	if (with_wall) { ret.add_occluder(make_box(), glm::scale(glm::mat4{1.0f}, glm::vec3{2.0f, 2.0f, 0.1f})); }
+	ret.build_pyramid();
+	return ret;
+}
+
+TEST(box_behind_wall_is_occluded) {
+	auto const culler = make_culler();
+	EXPECT(culler.occluder_triangles() > 0);
+	EXPECT(culler.is_occluded({0.0f, 0.0f, -5.0f}, 0.5f));
+	EXPECT(culler.is_occluded({1.0f, -1.0f, -10.0f}, 1.0f));
+}
+
+TEST(box_in_front_of_wall_is_visible) {
+	auto const culler = make_culler();
+	EXPECT(!culler.is_occluded({0.0f, 0.0f, 2.0f}, 0.5f));
+	// straddles the wall: its nearest point is in front
+	EXPECT(!culler.is_occluded({0.0f, 0.0f, 0.0f}, 0.5f));
+}
+
+TEST(box_beside_wall_is_visible) {
+	auto const culler = make_culler();
+	EXPECT(!culler.is_occluded({8.0f, 0.0f, -5.0f}, 0.5f));
+	// partially peeks out past the edge of the wall
+	EXPECT(!culler.is_occluded({0.0f, 2.5f, -1.0f}, 0.75f));
+}
+
+TEST(nothing_rasterized_occludes_nothing) {
+	auto const culler = make_culler(false);
+	EXPECT(culler.occluder_triangles() == 0);
+	EXPECT(!culler.is_occluded({0.0f, 0.0f, -5.0f}, 0.5f));
+}
+
+TEST(box_crossing_near_plane_is_visible) {
+	auto const culler = make_culler();
+	EXPECT(!culler.is_occluded({0.0f, 0.0f, 5.0f}, 1.0f));
+}
+} // namespace
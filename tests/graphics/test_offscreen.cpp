@@ -0,0 +1,87 @@
+#include <graphics/vulkan/device.hpp>
+#include <levk/asset/asset_providers.hpp>
+#include <levk/font/font_library.hpp>
+#include <levk/io/serializer.hpp>
+#include <levk/util/thread_pool.hpp>
+#include <levk/vfs/disk_vfs.hpp>
+#include <test/test.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <optional>
+
+namespace {
+using levk::vulkan::Device;
+
+constexpr auto extent_v = levk::Extent2D{64u, 32u};
+constexpr std::uint64_t frames_v{120u};
+
+// draws nothing: the offscreen target only ever holds the clear colour
+struct ClearRenderer : Device::Renderer {
+	void next_frame() final {}
+	void render_skinning(vk::CommandBuffer) final {}
+	void render_shadow(levk::vulkan::CommandRecorder&, levk::vulkan::Depthbuffer&, ShadowLayer) final {}
+	void render_3d(levk::vulkan::CommandRecorder&, levk::vulkan::Framebuffer&, levk::vulkan::ImageView const&) final {}
+	void render_ui(levk::vulkan::CommandRecorder&, levk::vulkan::Framebuffer&, levk::vulkan::ImageView const&) final {}
+};
+
+// golden colour of each frame: distinct between neighbouring frames, so a readback racing the next frame's writes shows up as a mismatch
+constexpr levk::Rgba frame_colour(std::uint64_t const frame) {
+	auto const i = static_cast<std::uint8_t>(frame * 37u);
+	return levk::Rgba{{i, static_cast<std::uint8_t>(0xff - i), static_cast<std::uint8_t>(frame), 0xff}};
+}
+
+bool matches_golden(levk::OffscreenFrame const& frame) {
+	auto const expected = frame_colour(frame.frame).channels;
+	auto const bytes = frame.pixels.storage.span();
+	if (frame.pixels.extent != extent_v || bytes.size() != std::size_t{extent_v.x} * extent_v.y * 4u) { return false; }
+	for (std::size_t i = 0; i < bytes.size(); i += 4) {
+		auto const channel = [&bytes, i](std::size_t const offset) { return static_cast<std::uint8_t>(bytes[i + offset]); };
+		auto const pixel = glm::tvec4<std::uint8_t>{channel(0), channel(1), channel(2), channel(3)};
+		if (pixel != expected) {
+			std::fprintf(stderr, "  frame %llu, pixel %zu: [%u %u %u %u] != golden [%u %u %u %u]\n", static_cast<unsigned long long>(frame.frame), i / 4,
+						 pixel.x, pixel.y, pixel.z, pixel.w, expected.x, expected.y, expected.z, expected.w);
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST(offscreen_frames_match_golden) {
+	// linear: clear colours are written to UNORM bytes as is
+	auto create_info = levk::RenderDeviceCreateInfo{.validation = false, .swapchain = levk::ColourSpace::eLinear};
+	create_info.anti_aliasing = levk::AntiAliasing::e1x;
+	auto render_device = std::optional<levk::RenderDevice>{};
+	try {
+		render_device.emplace(extent_v, create_info);
+	} catch (std::exception const& e) {
+		std::fprintf(stderr, "  %s\n", e.what());
+		SKIP("no Vulkan device available");
+	}
+
+	auto const font_library = levk::FontLibrary::Null{};
+	auto const data_source = levk::DiskVfs{std::filesystem::current_path().generic_string()};
+	auto const serializer = levk::Serializer{};
+	auto thread_pool = levk::ThreadPool{};
+	auto const asset_providers = levk::AssetProviders{{&*render_device, &font_library, &data_source, &serializer, &thread_pool}};
+	auto& device = render_device->vulkan_device();
+	auto renderer = ClearRenderer{};
+
+	auto latest = std::uint64_t{};
+	auto const check = [&](levk::OffscreenFrame const& frame) {
+		EXPECT(frame.frame > latest);
+		EXPECT(matches_golden(frame));
+		latest = frame.frame;
+	};
+
+	for (std::uint64_t frame = 1; frame <= frames_v; ++frame) {
+		render_device->set_clear(frame_colour(frame));
+		ASSERT(device.render(renderer, asset_providers));
+		if (auto const offscreen = device.read_offscreen()) { check(*offscreen); }
+	}
+	device.device->waitIdle();
+	if (auto const offscreen = device.read_offscreen()) { check(*offscreen); }
+
+	// the last frame must be readable once the GPU is idle
+	EXPECT(latest == frames_v);
+}
+} // namespace
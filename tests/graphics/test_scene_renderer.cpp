@@ -0,0 +1,102 @@
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <graphics/vulkan/scene_renderer.hpp>
+#include <test/test.hpp>
+#include <array>
+#include <cmath>
+
+namespace {
+using levk::vulkan::LodSelector;
+using levk::vulkan::spot_bounds;
+
+bool approx(float const a, float const b) { return std::abs(a - b) < 1e-4f; }
+
+glm::mat4 at_depth(float const depth, float const scale = 1.0f) {
+	return glm::scale(glm::translate(glm::mat4{1.0f}, {0.0f, 0.0f, -depth}), glm::vec3{scale});
+}
+
+// 90 degree field of view: radius / distance is the fraction of the viewport height covered
+LodSelector make_selector(float const bias = 1.0f) {
+	auto camera = levk::Camera{};
+	camera.type = levk::Camera::Perspective{.field_of_view = levk::Degrees{90.0f}};
+	return LodSelector::make(camera, bias);
+}
+
+TEST(lod_selector_disabled_without_perspective_or_bias) {
+	auto camera = levk::Camera{};
+	camera.type = levk::Camera::Orthographic{};
+	EXPECT(LodSelector::make(camera, 1.0f).scale == 0.0f);
+	EXPECT(make_selector(0.0f).scale == 0.0f);
+	EXPECT(make_selector(0.0f).screen_size(1.0f, at_depth(10.0f)) == 0.0f);
+}
+
+TEST(lod_selector_screen_size) {
+	auto const selector = make_selector();
+	EXPECT(approx(selector.scale, 1.0f));
+	EXPECT(approx(selector.screen_size(1.0f, at_depth(10.0f)), 0.1f));
+	// bounds scale with the model matrix
+	EXPECT(approx(selector.screen_size(1.0f, at_depth(10.0f, 2.0f)), 0.2f));
+	// a bias of 2 halves the projected size
+	EXPECT(approx(make_selector(2.0f).screen_size(1.0f, at_depth(10.0f)), 0.05f));
+	// the eye inside the bounds: always full detail
+	EXPECT(selector.screen_size(1.0f, at_depth(0.5f)) > 1.0f);
+	EXPECT(selector.screen_size(0.0f, at_depth(10.0f)) == 0.0f);
+}
+
+TEST(lod_selector_picks_level_by_screen_size) {
+	auto primitive = levk::vulkan::HostPrimitive{levk::vulkan::DeviceView{}};
+	auto const material = levk::UnlitMaterial{};
+	auto const lods = std::array{levk::PrimitiveLod{.screen_size = 0.5f}, levk::PrimitiveLod{.screen_size = 0.1f}};
+	auto drawable = levk::Drawable{.primitive = &primitive, .material = &material, .lods = lods, .radius = 1.0f};
+	auto const selector = make_selector();
+	EXPECT(selector.select(drawable, at_depth(1.5f)) == 0u);
+	EXPECT(selector.select(drawable, at_depth(4.0f)) == 1u);
+	EXPECT(selector.select(drawable, at_depth(20.0f)) == 2u);
+	// without bounds (or a perspective view) the full detail primitive is drawn
+	EXPECT(make_selector(0.0f).select(drawable, at_depth(20.0f)) == 0u);
+	drawable.radius = 0.0f;
+	EXPECT(selector.select(drawable, at_depth(20.0f)) == 0u);
+}
+
+bool approx(glm::vec3 const& a, glm::vec3 const& b) { return approx(a.x, b.x) && approx(a.y, b.y) && approx(a.z, b.z); }
+
+// the apex, and points on the rim of the cone's cap at range (facing -Z by default)
+bool bounds_cone(levk::LightBounds const& bounds, levk::SpotLight const& light) {
+	auto const angle = light.outer_angle.value;
+	auto const inside = [&bounds](glm::vec3 const& point) { return glm::length(point - bounds.centre) <= bounds.radius + 1e-4f; };
+	if (!inside(light.position)) { return false; }
+	for (float const t : {0.0f, 0.25f, 0.5f, 0.75f}) {
+		auto const around = t * glm::two_pi<float>();
+		auto const rim = glm::vec3{std::sin(angle) * std::cos(around), std::sin(angle) * std::sin(around), -std::cos(angle)};
+		if (!inside(light.position + light.range * rim)) { return false; }
+	}
+	return inside(light.position + glm::vec3{0.0f, 0.0f, -light.range});
+}
+
+TEST(spot_bounds_narrow_cone) {
+	auto const light = levk::SpotLight{.position = {1.0f, 2.0f, 3.0f}, .range = 10.0f, .outer_angle = levk::Degrees{30.0f}};
+	auto const bounds = spot_bounds(light);
+	// the apex and rim lie on the sphere: radius = range / (2 cos(angle))
+	auto const radius = 5.0f / std::cos(glm::radians(30.0f));
+	EXPECT(approx(bounds.radius, radius));
+	EXPECT(approx(bounds.centre, light.position + glm::vec3{0.0f, 0.0f, -radius}));
+	EXPECT(bounds_cone(bounds, light));
+}
+
+TEST(spot_bounds_wide_cone) {
+	auto const light = levk::SpotLight{.range = 10.0f, .outer_angle = levk::Degrees{60.0f}};
+	auto const bounds = spot_bounds(light);
+	// centred on the rim's circle
+	EXPECT(approx(bounds.radius, 10.0f * std::sin(glm::radians(60.0f))));
+	EXPECT(approx(bounds.centre, {0.0f, 0.0f, -5.0f}));
+	EXPECT(bounds_cone(bounds, light));
+	EXPECT(bounds.radius < light.range);
+}
+
+TEST(spot_bounds_hemisphere_falls_back_to_range) {
+	auto const light = levk::SpotLight{.position = {1.0f, 0.0f, 0.0f}, .range = 4.0f, .outer_angle = levk::Degrees{90.0f}};
+	auto const bounds = spot_bounds(light);
+	EXPECT(approx(bounds.centre, light.position));
+	EXPECT(bounds.radius == light.range);
+}
+} // namespace
@@ -0,0 +1,75 @@
+#include <levk/asset/texture_provider.hpp>
+#include <levk/graphics/render_device.hpp>
+#include <levk/graphics/texture_atlas.hpp>
+#include <levk/vfs/disk_vfs.hpp>
+#include <test/test.hpp>
+#include <filesystem>
+
+namespace {
+using levk::Extent2D;
+using levk::TextureAtlas;
+
+// null backend: cells are packed and textures resized without a GPU
+struct Fixture {
+	levk::RenderDevice render_device{levk::RenderDevice::make_null()};
+	levk::DiskVfs data_source{std::filesystem::current_path().generic_string()};
+	levk::TextureProvider texture_provider{&render_device, &data_source};
+	TextureAtlas atlas{&texture_provider, "test_atlas", TextureAtlas::CreateInfo{.initial_extent = {64u, 64u}}};
+
+	Extent2D texture_extent() const { return texture_provider.find("test_atlas")->extent(); }
+};
+
+struct Pixels {
+	levk::ByteArray bytes{};
+	levk::Image::View view{};
+
+	Pixels(Extent2D const extent) : bytes(std::size_t{extent.x} * extent.y * 4u), view{.storage = bytes.span(), .extent = extent, .channels = 4} {}
+};
+
+TextureAtlas::Cell write(TextureAtlas& atlas, Extent2D const extent) {
+	auto const pixels = Pixels{extent};
+	auto writer = TextureAtlas::Writer{atlas};
+	return writer.write(pixels.view);
+}
+
+TEST(cells_are_padded_and_disjoint) {
+	auto fixture = Fixture{};
+	auto const a = write(fixture.atlas, {16u, 16u});
+	auto const b = write(fixture.atlas, {16u, 16u});
+	EXPECT(a.lt == glm::uvec2(4u, 4u) && a.rb == glm::uvec2(20u, 20u));
+	EXPECT(b.lt == glm::uvec2(24u, 4u) && b.rb == glm::uvec2(40u, 20u));
+	EXPECT(fixture.texture_extent() == Extent2D(64u, 64u));
+}
+
+TEST(removed_cell_is_reused) {
+	auto fixture = Fixture{};
+	auto const a = write(fixture.atlas, {16u, 16u});
+	write(fixture.atlas, {16u, 16u});
+	fixture.atlas.remove(a);
+	auto const c = write(fixture.atlas, {16u, 16u});
+	EXPECT(c == a);
+	EXPECT(fixture.texture_extent() == Extent2D(64u, 64u));
+}
+
+TEST(removed_cell_is_split) {
+	auto fixture = Fixture{};
+	auto const a = write(fixture.atlas, {16u, 16u});
+	write(fixture.atlas, {16u, 16u});
+	fixture.atlas.remove(a);
+	// two smaller cells fit into the freed region: the first at its top left, the second beside it
+	auto const c = write(fixture.atlas, {4u, 4u});
+	auto const d = write(fixture.atlas, {4u, 4u});
+	EXPECT(c.lt == a.lt);
+	EXPECT(d.lt == glm::uvec2(a.lt.x + 8u, a.lt.y));
+}
+
+TEST(larger_write_skips_removed_cell) {
+	auto fixture = Fixture{};
+	auto const a = write(fixture.atlas, {16u, 16u});
+	fixture.atlas.remove(a);
+	auto const b = write(fixture.atlas, {24u, 24u});
+	EXPECT(b.lt != a.lt);
+	// the freed cell is still available
+	EXPECT(write(fixture.atlas, {16u, 16u}) == a);
+}
+} // namespace
@@ -0,0 +1,85 @@
+#include <graphics/vulkan/texture.hpp>
+#include <test/test.hpp>
+#include <array>
+
+namespace {
+using levk::ColourSpace;
+using levk::TextureUsage;
+using levk::vulkan::make_layout;
+using levk::vulkan::swizzle_to_rgba;
+using levk::vulkan::TextureLayout;
+using Swizzle = vk::ComponentSwizzle;
+
+constexpr auto grey_v = vk::ComponentMapping{Swizzle::eR, Swizzle::eR, Swizzle::eR, Swizzle::eOne};
+constexpr auto grey_alpha_v = vk::ComponentMapping{Swizzle::eR, Swizzle::eR, Swizzle::eR, Swizzle::eG};
+constexpr auto mask_v = vk::ComponentMapping{Swizzle::eR, Swizzle::eR, Swizzle::eR, Swizzle::eR};
+
+bool equals(TextureLayout const& layout, vk::Format const format, std::uint8_t const channels, vk::ComponentMapping const& components = {}) {
+	return layout.format == format && layout.channels == channels && layout.components == components;
+}
+
+template <std::size_t N>
+bool equals(levk::ByteArray const& bytes, std::array<int, N> const& expected) {
+	if (bytes.size() != N) { return false; }
+	for (std::size_t i = 0; i < N; ++i) {
+		if (bytes[i] != static_cast<std::byte>(expected[i])) { return false; }
+	}
+	return true;
+}
+
+template <typename... T>
+std::array<std::byte, sizeof...(T)> packed(T const... values) {
+	return {static_cast<std::byte>(values)...};
+}
+
+TEST(colour_layouts) {
+	EXPECT(equals(make_layout(TextureUsage::eColour, 4, ColourSpace::eSrgb), vk::Format::eR8G8B8A8Srgb, 4));
+	EXPECT(equals(make_layout(TextureUsage::eColour, 4, ColourSpace::eLinear), vk::Format::eR8G8B8A8Unorm, 4));
+	EXPECT(equals(make_layout(TextureUsage::eColour, 3, ColourSpace::eSrgb), vk::Format::eR8G8B8A8Srgb, 4));
+	EXPECT(equals(make_layout(TextureUsage::eColour, 1, ColourSpace::eSrgb), vk::Format::eR8Srgb, 1, grey_v));
+	EXPECT(equals(make_layout(TextureUsage::eColour, 1, ColourSpace::eLinear), vk::Format::eR8Unorm, 1, grey_v));
+	// sRGB grey + alpha is expanded, since RG8 sRGB would also decode alpha
+	EXPECT(equals(make_layout(TextureUsage::eColour, 2, ColourSpace::eSrgb), vk::Format::eR8G8B8A8Srgb, 4));
+	EXPECT(equals(make_layout(TextureUsage::eColour, 2, ColourSpace::eLinear), vk::Format::eR8G8Unorm, 2, grey_alpha_v));
+}
+
+TEST(masks_are_single_channel_and_linear) {
+	for (std::uint8_t channels = 1; channels <= 4; ++channels) {
+		EXPECT(equals(make_layout(TextureUsage::eMask, channels, ColourSpace::eSrgb), vk::Format::eR8Unorm, 1, mask_v));
+		EXPECT(equals(make_layout(TextureUsage::eMask, channels, ColourSpace::eLinear), vk::Format::eR8Unorm, 1, mask_v));
+	}
+}
+
+TEST(normals_are_two_channel_and_linear) {
+	for (std::uint8_t channels = 1; channels <= 4; ++channels) {
+		EXPECT(equals(make_layout(TextureUsage::eNormal, channels, ColourSpace::eSrgb), vk::Format::eR8G8Unorm, 2));
+		EXPECT(equals(make_layout(TextureUsage::eNormal, channels, ColourSpace::eLinear), vk::Format::eR8G8Unorm, 2));
+	}
+}
+
+TEST(data_is_never_srgb) {
+	EXPECT(equals(make_layout(TextureUsage::eData, 4, ColourSpace::eSrgb), vk::Format::eR8G8B8A8Unorm, 4));
+	EXPECT(equals(make_layout(TextureUsage::eData, 3, ColourSpace::eSrgb), vk::Format::eR8G8B8A8Unorm, 4));
+	EXPECT(equals(make_layout(TextureUsage::eData, 2, ColourSpace::eSrgb), vk::Format::eR8G8Unorm, 2, grey_alpha_v));
+	EXPECT(equals(make_layout(TextureUsage::eData, 1, ColourSpace::eSrgb), vk::Format::eR8Unorm, 1, grey_v));
+}
+
+TEST(swizzle_expands_to_rgba) {
+	auto const two = packed(10, 20);
+	auto const mask = make_layout(TextureUsage::eMask, 1, ColourSpace::eLinear);
+	EXPECT(equals(swizzle_to_rgba(two, mask), std::array{10, 10, 10, 10, 20, 20, 20, 20}));
+	auto const grey = make_layout(TextureUsage::eColour, 1, ColourSpace::eLinear);
+	EXPECT(equals(swizzle_to_rgba(two, grey), std::array{10, 10, 10, 255, 20, 20, 20, 255}));
+	auto const grey_alpha = make_layout(TextureUsage::eColour, 2, ColourSpace::eLinear);
+	EXPECT(equals(swizzle_to_rgba(two, grey_alpha), std::array{10, 10, 10, 20}));
+	// components missing from the format read as 0, alpha as 1
+	auto const normal = make_layout(TextureUsage::eNormal, 2, ColourSpace::eLinear);
+	EXPECT(equals(swizzle_to_rgba(two, normal), std::array{10, 20, 0, 255}));
+}
+
+TEST(swizzle_keeps_rgba) {
+	auto const four = packed(1, 2, 3, 4);
+	EXPECT(equals(swizzle_to_rgba(four, TextureLayout{}), std::array{1, 2, 3, 4}));
+	EXPECT(swizzle_to_rgba({}, TextureLayout{}).size() == 0u);
+}
+} // namespace
@@ -0,0 +1,99 @@
+#include <graphics/vulkan/ui_batcher.hpp>
+#include <test/test.hpp>
+
+namespace {
+using levk::Drawable;
+using levk::UnlitMaterial;
+using levk::vulkan::HostPrimitive;
+
+// null device: batches are merged on the host, nothing is uploaded
+struct Fixture {
+	levk::vulkan::UiBatcher batcher{levk::vulkan::DeviceView{}};
+	HostPrimitive quad{levk::vulkan::DeviceView{}};
+	UnlitMaterial a{};
+	UnlitMaterial b{};
+	levk::DrawList out{};
+
+	Fixture() {
+		quad.geometry = levk::Geometry::from(levk::Quad{});
+		a.textures.uris[0] = "a.png";
+		b.textures.uris[0] = "b.png";
+	}
+
+	Drawable at(UnlitMaterial const& material, float const z) {
+		auto ret = Drawable{.primitive = &quad, .material = &material};
+		ret.parent[3].z = z;
+		return ret;
+	}
+
+	std::span<Drawable const> batch(std::initializer_list<Drawable> drawables) {
+		out.clear();
+		batcher.batch(std::span{drawables.begin(), drawables.size()}, out);
+		return out.drawables();
+	}
+};
+
+bool is_batch_of(Drawable const& drawable, UnlitMaterial const& key, std::size_t const quads) {
+	auto const* primitive = dynamic_cast<HostPrimitive const*>(drawable.primitive.get());
+	auto const* material = dynamic_cast<UnlitMaterial const*>(drawable.material.get());
+	if (!primitive || !material || material == &key || !(material->textures == key.textures)) { return false; }
+	return primitive->geometry.positions.size() == 4 * quads && primitive->geometry.indices.size() == 6 * quads;
+}
+
+TEST(consecutive_runs_are_merged) {
+	auto fixture = Fixture{};
+	auto const& a = fixture.a;
+	auto const& b = fixture.b;
+	auto const out = fixture.batch({fixture.at(a, 0.0f), fixture.at(a, 0.0f), fixture.at(b, 0.0f), fixture.at(b, 0.0f), fixture.at(b, 0.0f)});
+	ASSERT(out.size() == 2u);
+	EXPECT(is_batch_of(out[0], a, 2));
+	EXPECT(is_batch_of(out[1], b, 3));
+	// indices of later quads are offset past earlier ones
+	auto const& geometry = dynamic_cast<HostPrimitive const&>(*out[0].primitive).geometry;
+	EXPECT(geometry.indices[6] == geometry.indices[0] + 4u);
+}
+
+TEST(interleaved_keys_at_the_same_z_are_not_merged) {
+	auto fixture = Fixture{};
+	auto const& a = fixture.a;
+	auto const& b = fixture.b;
+	auto const out = fixture.batch({fixture.at(a, 0.0f), fixture.at(b, 0.0f), fixture.at(a, 0.0f), fixture.at(b, 0.0f)});
+	ASSERT(out.size() == 4u);
+	EXPECT(out[0].material.get() == &a && out[1].material.get() == &b);
+	EXPECT(out[2].material.get() == &a && out[3].material.get() == &b);
+	EXPECT(out[0].primitive.get() == &fixture.quad);
+}
+
+TEST(drawables_are_ordered_by_z) {
+	auto fixture = Fixture{};
+	auto const& a = fixture.a;
+	auto const& b = fixture.b;
+	auto const out = fixture.batch({fixture.at(a, 1.0f), fixture.at(b, 0.0f), fixture.at(a, 1.0f)});
+	ASSERT(out.size() == 2u);
+	EXPECT(out[0].material.get() == &b);
+	EXPECT(is_batch_of(out[1], a, 2));
+}
+
+TEST(z_ties_keep_submission_order) {
+	auto fixture = Fixture{};
+	auto const& a = fixture.a;
+	auto const& b = fixture.b;
+	auto const out = fixture.batch({fixture.at(b, 1.0f), fixture.at(a, 0.0f), fixture.at(a, 1.0f), fixture.at(b, 0.0f)});
+	// sorted: a(0), b(0), b(1), a(1)
+	ASSERT(out.size() == 3u);
+	EXPECT(out[0].material.get() == &a);
+	EXPECT(is_batch_of(out[1], b, 2));
+	EXPECT(out[2].material.get() == &a);
+}
+
+TEST(unbatchable_drawables_pass_through) {
+	auto fixture = Fixture{};
+	auto const& a = fixture.a;
+	auto lines = fixture.at(a, 0.0f);
+	lines.topology = levk::Topology::eLineList;
+	auto const out = fixture.batch({lines, fixture.at(a, 0.0f)});
+	ASSERT(out.size() == 2u);
+	EXPECT(out[0].topology == levk::Topology::eLineList);
+	EXPECT(out[1].material.get() == &a && out[1].primitive.get() == &fixture.quad);
+}
+} // namespace
@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+namespace levk::test {
+struct Test {
+	std::string_view name{};
+	void (*func)(){};
+};
+
+struct Failure {};
+
+// thrown by SKIP: the test's environment is unavailable (eg no Vulkan device)
+struct Skip {
+	char const* reason{};
+};
+
+// CTest's SKIP_RETURN_CODE: returned if any test was skipped and none failed
+inline constexpr int skip_return_code_v{77};
+
+inline std::vector<Test>& tests() {
+	static auto ret = std::vector<Test>{};
+	return ret;
+}
+
+inline int& failures() {
+	static auto ret = int{};
+	return ret;
+}
+
+struct Registrar {
+	Registrar(std::string_view name, void (*func)()) { tests().push_back(Test{name, func}); }
+};
+
+inline bool check(bool pred, char const* expr, char const* file, int line) {
+	if (!pred) {
+		std::fprintf(stderr, "  %s:%d: expected: %s\n", file, line, expr);
+		++failures();
+	}
+	return pred;
+}
+
+inline int run_all() {
+	auto failed = int{};
+	auto skipped = int{};
+	for (auto const& test : tests()) {
+		auto const before = failures();
+		try {
+			test.func();
+		} catch (Failure const&) {
+		} catch (Skip const& skip) {
+			std::printf("[skip] %.*s: %s\n", static_cast<int>(test.name.size()), test.name.data(), skip.reason);
+			++skipped;
+			continue;
+		}
+		if (failures() > before) {
+			std::fprintf(stderr, "[FAIL] %.*s\n", static_cast<int>(test.name.size()), test.name.data());
+			++failed;
+		} else {
+			std::printf("[pass] %.*s\n", static_cast<int>(test.name.size()), test.name.data());
+		}
+	}
+	std::printf("%zu tests, %d failed, %d skipped\n", tests().size(), failed, skipped);
+	if (failed > 0) { return 1; }
+	return skipped > 0 ? skip_return_code_v : 0;
+}
+} // namespace levk::test
+
+#define TEST(name)                                                                                                                                             \
+	static void name();                                                                                                                                        \
+	static ::levk::test::Registrar const name##_registrar_v{#name, &name};                                                                                     \
+	static void name()
+
+// records a failure and continues
+#define EXPECT(pred) ::levk::test::check(static_cast<bool>(pred), #pred, __FILE__, __LINE__)
+// ends the current test without failing it
+#define SKIP(reason) throw ::levk::test::Skip{reason}
+// records a failure and ends the current test
+#define ASSERT(pred)                                                                                                                                           \
+	do {                                                                                                                                                       \
+		if (!EXPECT(pred)) { throw ::levk::test::Failure{}; }                                                                                                  \
+	} while (false)
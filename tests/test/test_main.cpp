@@ -0,0 +1,3 @@
+#include <test/test.hpp>
+
+int main() { return levk::test::run_all(); }
@@ -0,0 +1,90 @@
+#include <glm/geometric.hpp>
+#include <simplify.hpp>
+#include <test/test.hpp>
+#include <algorithm>
+
+namespace {
+constexpr std::uint32_t side_v{5};
+
+// flat side_v x side_v vertex grid on the XZ plane, all triangles facing +Y
+levk::asset::BinGeometry make_grid() {
+	auto ret = levk::asset::BinGeometry{};
+	auto& geometry = ret.geometry;
+	for (std::uint32_t z = 0; z < side_v; ++z) {
+		for (std::uint32_t x = 0; x < side_v; ++x) {
+			auto const index = static_cast<std::uint32_t>(geometry.positions.size());
+			geometry.positions.push_back({static_cast<float>(x), 0.0f, static_cast<float>(z)});
+			geometry.rgbs.push_back(glm::vec3{1.0f});
+			geometry.normals.push_back({0.0f, 1.0f, 0.0f});
+			geometry.uvs.push_back({static_cast<float>(x), static_cast<float>(z)});
+			ret.joints.push_back(glm::uvec4{index});
+			ret.weights.push_back({1.0f, 0.0f, 0.0f, 0.0f});
+		}
+	}
+	for (std::uint32_t z = 0; z + 1 < side_v; ++z) {
+		for (std::uint32_t x = 0; x + 1 < side_v; ++x) {
+			auto const i = z * side_v + x;
+			geometry.indices.insert(geometry.indices.end(), {i, i + side_v, i + 1, i + 1, i + side_v, i + side_v + 1});
+		}
+	}
+	return ret;
+}
+
+bool on_border(glm::vec3 const& p) {
+	auto const max = static_cast<float>(side_v - 1);
+	return p.x == 0.0f || p.z == 0.0f || p.x == max || p.z == max;
+}
+
+std::size_t triangle_count(levk::asset::BinGeometry const& bin) { return bin.geometry.indices.size() / 3; }
+
+bool all_facing_up(levk::asset::BinGeometry const& bin) {
+	auto const& positions = bin.geometry.positions;
+	auto const& indices = bin.geometry.indices;
+	for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+		auto const& a = positions[indices[i]];
+		auto const normal = glm::cross(positions[indices[i + 1]] - a, positions[indices[i + 2]] - a);
+		if (normal.y <= 0.0f) { return false; }
+	}
+	return true;
+}
+
+TEST(simplify_reduces_triangles) {
+	auto const in = make_grid();
+	auto const out = legsmi::simplify(in, triangle_count(in) / 2);
+	EXPECT(triangle_count(out) < triangle_count(in));
+	EXPECT(std::ranges::all_of(out.geometry.indices, [&out](std::uint32_t i) { return i < out.geometry.positions.size(); }));
+	EXPECT(all_facing_up(out));
+}
+
+TEST(simplify_at_target_is_noop) {
+	auto const in = make_grid();
+	auto const out = legsmi::simplify(in, triangle_count(in));
+	EXPECT(triangle_count(out) == triangle_count(in));
+	EXPECT(out.geometry.positions.size() == in.geometry.positions.size());
+}
+
+TEST(simplify_locks_open_border) {
+	auto const in = make_grid();
+	auto const out = legsmi::simplify(in, 0);
+	auto const border = std::ranges::count_if(in.geometry.positions, &on_border);
+	EXPECT(std::ranges::count_if(out.geometry.positions, &on_border) == border);
+	// a polygon with n border vertices needs at least n - 2 triangles
+	EXPECT(triangle_count(out) >= static_cast<std::size_t>(border - 2));
+	EXPECT(all_facing_up(out));
+}
+
+TEST(simplify_carries_vertex_streams) {
+	auto const in = make_grid();
+	auto const out = legsmi::simplify(in, 0);
+	ASSERT(out.joints.size() == out.geometry.positions.size());
+	ASSERT(out.weights.size() == out.geometry.positions.size());
+	ASSERT(out.geometry.uvs.size() == out.geometry.positions.size());
+	for (std::size_t i = 0; i < out.geometry.positions.size(); ++i) {
+		// each grid vertex stored its own index as its joint
+		auto const original = out.joints[i].x;
+		ASSERT(original < in.geometry.positions.size());
+		EXPECT(out.geometry.positions[i] == in.geometry.positions[original]);
+		EXPECT(out.geometry.uvs[i] == in.geometry.uvs[original]);
+	}
+}
+} // namespace
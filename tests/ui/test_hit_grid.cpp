@@ -0,0 +1,57 @@
+#include <levk/ui/hit_grid.hpp>
+#include <test/test.hpp>
+
+namespace {
+using levk::ui::HitGrid;
+using levk::ui::Rect;
+using levk::ui::View;
+
+struct Fixture {
+	View root{Rect::from_extent({256.0f, 256.0f})};
+	HitGrid grid{&root};
+
+	View& add(View& parent, glm::vec2 const extent, glm::vec2 const position = {}, float const z_index = 0.0f) {
+		auto& ret = *parent.add_sub_view(std::make_unique<View>(Rect::from_extent(extent, position)));
+		ret.z_index = z_index;
+		return ret;
+	}
+};
+
+TEST(equal_z_later_in_tree_wins) {
+	auto fixture = Fixture{};
+	auto& a = fixture.add(fixture.root, {100.0f, 100.0f});
+	auto& b = fixture.add(fixture.root, {100.0f, 100.0f}, {40.0f, 0.0f});
+	EXPECT(fixture.grid.hit_test({0.0f, 0.0f}) == &b);
+	EXPECT(fixture.grid.hit_test({-40.0f, 0.0f}) == &a);
+	EXPECT(fixture.grid.hit_test({120.0f, 120.0f}) == nullptr);
+}
+
+TEST(sub_views_are_later_than_their_super_view) {
+	auto fixture = Fixture{};
+	auto& a = fixture.add(fixture.root, {100.0f, 100.0f});
+	auto& child = fixture.add(a, {20.0f, 20.0f});
+	auto& b = fixture.add(fixture.root, {100.0f, 100.0f}, {60.0f, 0.0f});
+	// tree order is depth first: a, child, b
+	EXPECT(fixture.grid.hit_test({0.0f, 0.0f}) == &child);
+	EXPECT(fixture.grid.hit_test({20.0f, 0.0f}) == &b);
+	EXPECT(fixture.grid.hit_test({-20.0f, 0.0f}) == &a);
+}
+
+TEST(higher_z_index_wins_over_tree_order) {
+	auto fixture = Fixture{};
+	auto& a = fixture.add(fixture.root, {100.0f, 100.0f}, {}, 1.0f);
+	fixture.add(fixture.root, {100.0f, 100.0f});
+	EXPECT(fixture.grid.hit_test({0.0f, 0.0f}) == &a);
+}
+
+TEST(layout_changes_rebuild_grid) {
+	auto fixture = Fixture{};
+	auto& a = fixture.add(fixture.root, {100.0f, 100.0f});
+	auto& b = fixture.add(fixture.root, {100.0f, 100.0f});
+	EXPECT(fixture.grid.hit_test({0.0f, 0.0f}) == &b);
+	b.set_position({100.0f, 100.0f});
+	EXPECT(fixture.grid.hit_test({0.0f, 0.0f}) == &a);
+	a.set_destroyed();
+	EXPECT(fixture.grid.hit_test({0.0f, 0.0f}) == nullptr);
+}
+} // namespace
@@ -0,0 +1,84 @@
+#include <levk/asset/texture_provider.hpp>
+#include <levk/graphics/render_device.hpp>
+#include <levk/ui/text.hpp>
+#include <levk/vfs/disk_vfs.hpp>
+#include <test/test.hpp>
+#include <filesystem>
+
+namespace {
+using levk::TextHeight;
+
+// every glyph is a 4x4 coverage square, advancing 8 pixels
+struct SquareFactory : levk::GlyphSlot::Factory {
+	bool set_height(TextHeight) final { return true; }
+	TextHeight height() const final { return TextHeight::eDefault; }
+
+	levk::GlyphSlot slot_for(levk::Codepoint codepoint) const final {
+		auto ret = levk::GlyphSlot{.advance = {8 << 6, 0}, .codepoint = codepoint};
+		ret.pixmap = {.storage = levk::ByteArray{16u}, .extent = {4u, 4u}, .channels = 1};
+		return ret;
+	}
+};
+
+struct ProbeText : levk::ui::Text {
+	using levk::ui::Text::Text;
+
+	levk::Geometry::Packed& geometry() { return m_primitive.edit_geometry(); }
+};
+
+// null backend: fonts are rasterized into atlases without a GPU
+struct Fixture {
+	levk::RenderDevice render_device{levk::RenderDevice::make_null()};
+	levk::DiskVfs data_source{std::filesystem::current_path().generic_string()};
+	levk::TextureProvider texture_provider{&render_device, &data_source};
+	levk::AsciiFont font{std::make_unique<SquareFactory>(), &texture_provider, "test_font"};
+	ProbeText text{&font};
+};
+
+constexpr auto poison_v = glm::vec3{-1.0f};
+
+TEST(text_lays_out_a_quad_per_character) {
+	auto fixture = Fixture{};
+	fixture.text.set_string("abcd\nefgh");
+	auto const& geometry = fixture.text.geometry();
+	ASSERT(geometry.positions.size() == 16u);
+	EXPECT(geometry.indices.size() == 24u);
+	EXPECT(geometry.indices[6] == 4u);
+	EXPECT(geometry.positions[4].x == geometry.positions[0].x + 8.0f);
+}
+
+TEST(text_rewrites_only_past_the_shared_prefix) {
+	auto fixture = Fixture{};
+	fixture.text.set_string("abcd");
+	auto& geometry = fixture.text.geometry();
+	ASSERT(geometry.positions.size() == 16u);
+	geometry.positions[0] = poison_v;
+	geometry.positions[12] = poison_v;
+	fixture.text.set_string("abce");
+	EXPECT(geometry.positions[0] == poison_v);
+	EXPECT(geometry.positions[12] != poison_v);
+}
+
+TEST(text_rewrites_everything_after_glyphs_are_recreated) {
+	auto fixture = Fixture{};
+	fixture.text.set_string("abcd");
+	auto& geometry = fixture.text.geometry();
+	ASSERT(geometry.positions.size() == 16u);
+	geometry.positions[0] = poison_v;
+	fixture.font.destroy_font_atlas(TextHeight::eDefault);
+	fixture.text.set_string("abce");
+	EXPECT(geometry.positions[0] != poison_v);
+}
+
+TEST(text_shrinks_with_its_string) {
+	auto fixture = Fixture{};
+	fixture.text.set_string("abcd");
+	fixture.text.set_string("ab");
+	auto const& geometry = fixture.text.geometry();
+	EXPECT(geometry.positions.size() == 8u);
+	EXPECT(geometry.uvs.size() == 8u);
+	EXPECT(geometry.indices.size() == 12u);
+	fixture.text.set_string("");
+	EXPECT(geometry.positions.empty() && geometry.indices.empty());
+}
+} // namespace
@@ -0,0 +1,40 @@
+#include <levk/graphics/render_device.hpp>
+#include <levk/ui/primitive.hpp>
+#include <levk/window/window_input.hpp>
+#include <test/test.hpp>
+
+namespace {
+using levk::ui::View;
+
+struct Counter : View {
+	int ticks{};
+
+	void tick(levk::WindowInput const& window_input, levk::Duration dt) override {
+		View::tick(window_input, dt);
+		++ticks;
+	}
+};
+
+void tick(View& view) { view.tick(levk::WindowInput{}, {}); }
+
+TEST(views_tick_by_default) {
+	auto root = View{};
+	auto& counter = static_cast<Counter&>(*root.add_sub_view(std::make_unique<Counter>()));
+	EXPECT(counter.is_ticking());
+	tick(root);
+	EXPECT(counter.ticks == 1);
+	counter.set_ticking(false);
+	tick(root);
+	EXPECT(counter.ticks == 1);
+}
+
+TEST(primitives_opt_out_but_their_sub_views_tick) {
+	auto render_device = levk::RenderDevice::make_null();
+	auto root = View{};
+	auto& primitive = *root.add_sub_view(std::make_unique<levk::ui::Primitive>(render_device));
+	EXPECT(!primitive.is_ticking());
+	auto& counter = static_cast<Counter&>(*primitive.add_sub_view(std::make_unique<Counter>()));
+	tick(root);
+	EXPECT(counter.ticks == 1);
+}
+} // namespace
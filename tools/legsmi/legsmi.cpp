@@ -30,6 +30,9 @@ struct Args {
 	std::vector<std::size_t> asset_indices{};
 	bool force{};
 	bool verbose{};
+	bool packed{};
+	bool bake_textures{};
+	std::uint32_t lods{};
 };
 
 struct Args::Parser : cli_args::Parser {
@@ -64,6 +67,15 @@ struct Args::Parser : cli_args::Parser {
 			args.data_root = value;
 		} else if (key.full == "dest-dir") {
 			args.dest_dir = value;
+		} else if (key.full == "packed") {
+			args.packed = true;
+		} else if (key.full == "bake-textures") {
+			args.bake_textures = true;
+		} else if (key.full == "lods") {
+			if (!cli_args::as(args.lods, value)) {
+				std::fprintf(stderr, "%s", fmt::format("invalid LOD count, must be integral: {}\n", value).c_str());
+				return false;
+			}
 		} else {
 			return false;
 		}
@@ -181,6 +193,9 @@ struct App {
 			cli_args::Opt{cli_args::Key{"data-root"}, "/path/", false, "path to data root"},
 			cli_args::Opt{cli_args::Key{"dest-dir"}, "uri/", false, "destination directory"},
 			cli_args::Opt{cli_args::Key{"verbose", 'v'}, {}, true, "verbose logging"},
+			cli_args::Opt{cli_args::Key{"packed"}, {}, true, "import meshes with packed vertex format"},
+			cli_args::Opt{cli_args::Key{"lods"}, "count", false, "generate simplified LOD geometry per mesh primitive"},
+			cli_args::Opt{cli_args::Key{"bake-textures"}, {}, true, "bake textures with precomputed mips (.ltex)"},
 		};
 		spec.commands = {
 			"mesh",
@@ -258,7 +273,11 @@ struct App {
 
 	bool import_mesh() {
 		auto make_importer = [this] {
-			return import_list.asset_list.mesh_importer(args.data_root.generic_string(), args.dest_dir.generic_string(), import_logger, args.force);
+			auto ret = import_list.asset_list.mesh_importer(args.data_root.generic_string(), args.dest_dir.generic_string(), import_logger, args.force);
+			if (args.packed) { ret.vertex_format = levk::VertexFormat::ePacked; }
+			ret.lod_count = args.lods;
+			ret.bake_textures = args.bake_textures;
+			return ret;
 		};
 		for (auto const index : args.asset_indices) {
 			if (!import_asset(std::span{import_list.asset_list.meshes}, "Mesh", index, make_importer)) { return false; }
@@ -269,7 +288,11 @@ struct App {
 	bool import_scene() {
 		for (auto const index : args.asset_indices) {
 			auto make_importer = [this, uri = import_list.asset_list.make_default_level_uri(index)] {
-				return import_list.asset_list.scene_importer(args.data_root.generic_string(), args.dest_dir.generic_string(), uri, import_logger, args.force);
+				auto ret = import_list.asset_list.scene_importer(args.data_root.generic_string(), args.dest_dir.generic_string(), uri, import_logger, args.force);
+				if (args.packed) { ret.mesh_importer.vertex_format = levk::VertexFormat::ePacked; }
+				ret.mesh_importer.lod_count = args.lods;
+				ret.mesh_importer.bake_textures = args.bake_textures;
+				return ret;
 			};
 			if (!import_asset(std::span{import_list.asset_list.scenes}, "Scene", index, make_importer)) { return false; }
 		}
@@ -5,6 +5,7 @@
 #include <levk/util/logger.hpp>
 #include <levk/util/not_null.hpp>
 #include <levk/util/ptr.hpp>
+#include <array>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -35,6 +36,8 @@ struct SceneImporter;
 
 struct ImportMap {
 	std::unordered_map<std::size_t, std::string> images{};
+	// per colour space: sRGB mips are filtered in linear space, so bakes differ
+	std::array<std::unordered_map<std::size_t, std::string>, 2> baked_images{};
 	std::unordered_map<std::size_t, std::string> materials{};
 	std::unordered_map<std::size_t, std::string> meshes{};
 	std::unordered_map<std::size_t, std::string> skeletons{};
@@ -72,6 +75,12 @@ struct MeshImporter {
 	std::string uri_prefix{};
 	std::string dir_uri{};
 	bool overwrite_existing{};
+	// GPU vertex format recorded in imported mesh JSON, used when the mesh is loaded
+	levk::VertexFormat vertex_format{};
+	// simplified geometry levels generated per primitive (0: none)
+	std::uint32_t lod_count{};
+	// bake textures into levk containers with precomputed mips instead of copying source images
+	bool bake_textures{};
 
 	levk::Uri<levk::Mesh> try_import(Mesh const& mesh, ImportMap& out_imported) const;
 
@@ -1,6 +1,7 @@
 #include <glm/gtx/matrix_decompose.hpp>
 #include <legsmi/legsmi.hpp>
 #include <levk/asset/asset_io.hpp>
+#include <levk/graphics/mipmapped_image.hpp>
 #include <levk/io/serializer.hpp>
 #include <levk/level/attachments.hpp>
 #include <levk/scene/scene.hpp>
@@ -13,6 +14,7 @@
 #include <levk/util/logger.hpp>
 #include <levk/util/visitor.hpp>
 #include <levk/util/zip_ranges.hpp>
+#include <simplify.hpp>
 #include <filesystem>
 #include <fstream>
 #include <ranges>
@@ -251,6 +253,9 @@ struct Exporter {
 	fs::path uri_prefix;
 	fs::path dir_uri;
 	bool overwrite;
+	levk::VertexFormat vertex_format;
+	std::uint32_t lod_count;
+	bool bake_textures;
 
 	std::optional<Index<gltf2cpp::Skin>> find_skin(Resource const& resource) const {
 		for (auto const [node, index] : levk::enumerate(in_root.nodes)) {
@@ -303,8 +308,37 @@ struct Exporter {
 		return copy_image(in_root.images[in.source], index, subdir);
 	}
 
+	// decodes the image and writes it with its full mip chain, ready to upload as is
+	std::string bake_image(gltf2cpp::Image const& in, std::size_t index, levk::ColourSpace colour_space, std::string_view subdir = "textures") {
+		auto& baked_images = out_imported.baked_images[static_cast<std::size_t>(colour_space)];
+		if (auto it = baked_images.find(index); it != baked_images.end()) { return it->second; }
+		auto stem = in.source_filename.empty() ? fmt::format("image_{}", index) : fs::path{in.source_filename}.stem().string();
+		if (colour_space == levk::ColourSpace::eLinear) { stem += ".linear"; }
+		auto uri = (dir_uri / subdir / fmt::format("{}.ltex", stem)).generic_string();
+		auto dst = uri_prefix / uri;
+		if (!should_overwrite(dst.generic_string())) { return uri; }
+		auto const image = in.source_filename.empty() ? levk::Image{std::as_bytes(std::span{in.bytes}), uri}
+													  : levk::Image{(in_dir / in.source_filename).string().c_str(), uri};
+		if (!image) {
+			import_logger.warn("[legsmi] Failed to decode Image [{}], copying instead", uri);
+			return copy_image(in, index, subdir);
+		}
+		auto const baked = levk::MipmappedImage::bake(image.view(), colour_space);
+		fs::create_directories(dst.parent_path());
+		auto file = std::ofstream{dst, std::ios::binary};
+		if (!file) {
+			import_logger.error("[legsmi] Failed to open [{}] for writing, copying Image instead", dst.generic_string());
+			return copy_image(in, index, subdir);
+		}
+		file.write(reinterpret_cast<char const*>(baked.data()), static_cast<std::streamsize>(baked.size()));
+		import_logger.info("[legsmi] Image [{}] baked", uri);
+		out_imported.add_to(baked_images, index, uri);
+		return uri;
+	}
+
 	levk::Uri<levk::Texture> export_texture(gltf2cpp::Texture const& in, std::size_t index, levk::ColourSpace colour_space) {
-		auto image_uri = copy_image(in_root.images[in.source], index);
+		auto const& in_image = in_root.images[in.source];
+		auto image_uri = bake_textures ? bake_image(in_image, index, colour_space) : copy_image(in_image, index);
 		auto json_uri = fs::path{image_uri};
 		json_uri = json_uri.parent_path() / json_uri.stem();
 		auto uri = fmt::format("{}.json", json_uri.generic_string());
@@ -339,6 +373,8 @@ struct Exporter {
 		if (auto i = in.pbr.base_color_texture) { textures[0] = {export_texture(in_root.textures[i->texture], i->texture, levk::ColourSpace::eSrgb)}; }
 		if (auto i = in.pbr.metallic_roughness_texture) {
 			textures[1] = {export_texture(in_root.textures[i->texture], i->texture, levk::ColourSpace::eLinear)};
+			// roughness and metallic are read from G and B
+			material.textures.usages[1] = levk::TextureUsage::eData;
 		}
 		if (auto i = in.emissive_texture) { textures[2] = {export_texture(in_root.textures[i->texture], i->texture, levk::ColourSpace::eSrgb)}; }
 		material.emissive_factor = {in.emissive_factor[0], in.emissive_factor[1], in.emissive_factor[2]};
@@ -373,6 +409,38 @@ struct Exporter {
 		return uri;
 	}
 
+	// each level targets half the triangles of the previous one, and is drawn below half its screen size
+	std::vector<asset::Mesh3D::Lod> export_lods(gltf2cpp::Mesh const& in, std::size_t primitive_index, std::size_t mesh_index,
+												std::vector<glm::uvec4> const& joints, std::vector<glm::vec4> const& weights) {
+		static constexpr auto screen_size_v{0.25f};
+		auto ret = std::vector<asset::Mesh3D::Lod>{};
+		if (lod_count == 0) { return ret; }
+		auto source = asset::BinGeometry{.geometry = to_geometry(in.primitives[primitive_index]), .joints = joints, .weights = weights};
+		if (source.geometry.indices.empty() || source.geometry.indices.size() % 3 != 0) { return ret; }
+
+		auto screen_size = screen_size_v;
+		for (std::uint32_t level = 1; level <= lod_count; ++level, screen_size *= 0.5f) {
+			auto uri = (dir_uri / "geometries" / fmt::format("mesh_{}.geometry_{}.lod_{}.bin", mesh_index, primitive_index, level)).generic_string();
+			auto const dst = uri_prefix / uri;
+			if (should_overwrite(dst.generic_string())) {
+				auto const triangles = source.geometry.indices.size() / 3;
+				auto lod = simplify(source, triangles / 2);
+				auto const lod_triangles = lod.geometry.indices.size() / 3;
+				// borders and seams are locked: stop once collapses no longer pay for another level
+				if (lod_triangles == 0 || lod_triangles * 4 > triangles * 3) { break; }
+				fs::create_directories(dst.parent_path());
+				[[maybe_unused]] bool const res = lod.write(dst.string().c_str());
+				assert(res);
+				import_logger.info("[legsmi] BinGeometry [{}] imported ({} => {} triangles)", uri, triangles, lod_triangles);
+				source = std::move(lod);
+			} else if (!source.read(dst.string().c_str())) {
+				break;
+			}
+			ret.push_back({std::move(uri), screen_size});
+		}
+		return ret;
+	}
+
 	levk::Uri<levk::Mesh> operator()(Resource const& resource) {
 		auto uri = (dir_uri / fmt::format("{}.json", resource.name.out)).generic_string();
 		auto dst = uri_prefix / uri;
@@ -380,7 +448,7 @@ struct Exporter {
 
 		fs::create_directories(dst.parent_path());
 
-		auto out_mesh = asset::Mesh3D{.type = asset::Mesh3D::Type::eStatic};
+		auto out_mesh = asset::Mesh3D{.type = asset::Mesh3D::Type::eStatic, .vertex_format = vertex_format};
 		auto const& in_mesh = in_root.meshes[resource.index];
 		for (auto const& [in_primitive, primitive_index] : levk::enumerate(in_mesh.primitives)) {
 			bool const has_joints = !in_primitive.geometry.joints.empty();
@@ -398,6 +466,7 @@ struct Exporter {
 				weights.resize(in_primitive.geometry.weights[0].size());
 				std::memcpy(weights.data(), in_primitive.geometry.weights[0].data(), std::span{in_primitive.geometry.weights[0]}.size_bytes());
 			}
+			out_primitive.lods = export_lods(in_mesh, primitive_index, resource.index, joints, weights);
 			out_primitive.geometry = export_geometry(in_mesh, primitive_index, resource.index, std::move(joints), std::move(weights));
 			out_mesh.primitives.push_back(std::move(out_primitive));
 		}
@@ -650,6 +719,9 @@ levk::Uri<levk::Mesh> MeshImporter::try_import(Mesh const& mesh, ImportMap& out_
 			.uri_prefix = uri_prefix,
 			.dir_uri = dir_uri,
 			.overwrite = overwrite_existing,
+			.vertex_format = vertex_format,
+			.lod_count = lod_count,
+			.bake_textures = bake_textures,
 		}(make_resource(mesh.name, "mesh", mesh.index));
 	} catch (std::exception const& e) {
 		import_logger.error("[legsmi] Fatal error: {}", e.what());
@@ -0,0 +1,250 @@
+#include <glm/geometric.hpp>
+#include <simplify.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <queue>
+#include <unordered_map>
+
+namespace legsmi {
+namespace {
+// symmetric 4x4 error matrix: sum of squared distances to a set of planes
+struct Quadric {
+	std::array<double, 10> m{};
+
+	static Quadric make(glm::dvec4 const& plane, double weight) {
+		auto const [a, b, c, d] = std::array{plane.x, plane.y, plane.z, plane.w};
+		auto ret = Quadric{{a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d}};
+		for (auto& value : ret.m) { value *= weight; }
+		return ret;
+	}
+
+	Quadric& operator+=(Quadric const& rhs) {
+		for (std::size_t i = 0; i < m.size(); ++i) { m[i] += rhs.m[i]; }
+		return *this;
+	}
+
+	double error(glm::dvec3 const& p) const {
+		auto const [x, y, z] = std::array{p.x, p.y, p.z};
+		return m[0] * x * x + 2.0 * m[1] * x * y + 2.0 * m[2] * x * z + 2.0 * m[3] * x + m[4] * y * y + 2.0 * m[5] * y * z + 2.0 * m[6] * y +
+			   m[7] * z * z + 2.0 * m[8] * z + m[9];
+	}
+};
+
+struct Collapse {
+	double error{};
+	std::uint32_t from{};
+	std::uint32_t to{};
+	std::uint32_t from_version{};
+	std::uint32_t to_version{};
+
+	bool operator>(Collapse const& rhs) const { return error > rhs.error; }
+};
+
+struct PositionHash {
+	std::size_t operator()(glm::vec3 const& p) const {
+		auto ret = std::size_t{};
+		// + 0.0f folds -0.0f into 0.0f, which compare equal
+		for (int i = 0; i < 3; ++i) { ret = ret * 31 + std::hash<std::uint32_t>{}(std::bit_cast<std::uint32_t>(p[i] + 0.0f)); }
+		return ret;
+	}
+};
+
+glm::vec3 face_normal(glm::vec3 const& a, glm::vec3 const& b, glm::vec3 const& c) { return glm::cross(b - a, c - a); }
+
+// Collapses operate on nodes: vertices welded by position, so split normals / uvs don't read as borders.
+struct Simplifier {
+	std::span<glm::vec3 const> positions;
+
+	std::vector<std::array<std::uint32_t, 3>> triangles{};
+	std::vector<bool> triangle_alive{};
+	std::size_t alive_count{};
+
+	std::vector<std::uint32_t> node_of{};
+	std::vector<std::vector<std::uint32_t>> node_vertices{};
+	std::vector<std::vector<std::uint32_t>> node_triangles{};
+	std::vector<Quadric> quadrics{};
+	std::vector<std::uint32_t> versions{};
+	std::vector<bool> locked{};
+	std::vector<bool> removed{};
+
+	std::priority_queue<Collapse, std::vector<Collapse>, std::greater<>> queue{};
+
+	Simplifier(std::span<glm::vec3 const> positions, std::span<std::uint32_t const> indices) : positions(positions) {
+		weld();
+		triangles.reserve(indices.size() / 3);
+		for (std::size_t i = 0; i + 2 < indices.size(); i += 3) { triangles.push_back({indices[i], indices[i + 1], indices[i + 2]}); }
+		triangle_alive.resize(triangles.size(), true);
+		alive_count = triangles.size();
+		node_triangles.resize(node_vertices.size());
+		quadrics.resize(node_vertices.size());
+		versions.resize(node_vertices.size());
+		removed.resize(node_vertices.size());
+		locked.resize(node_vertices.size());
+		for (std::size_t node = 0; node < node_vertices.size(); ++node) { locked[node] = node_vertices[node].size() > 1; }
+		for (std::uint32_t t = 0; t < triangles.size(); ++t) {
+			auto const& tri = triangles[t];
+			auto const normal = glm::dvec3{face_normal(positions[tri[0]], positions[tri[1]], positions[tri[2]])};
+			auto const length = glm::length(normal);
+			for (auto const vertex : tri) { node_triangles[node_of[vertex]].push_back(t); }
+			if (length <= 0.0) { continue; }
+			// area weighted, so large faces resist being collapsed across
+			auto const n = normal / length;
+			auto const quadric = Quadric::make({n, -glm::dot(n, glm::dvec3{positions[tri[0]]})}, 0.5 * length);
+			for (auto const vertex : tri) { quadrics[node_of[vertex]] += quadric; }
+		}
+		lock_borders();
+		for (auto const& tri : triangles) {
+			for (std::size_t i = 0; i < 3; ++i) {
+				auto const a = node_of[tri[i]];
+				auto const b = node_of[tri[(i + 1) % 3]];
+				push(a, b);
+				push(b, a);
+			}
+		}
+	}
+
+	void weld() {
+		auto map = std::unordered_map<glm::vec3, std::uint32_t, PositionHash>{};
+		node_of.resize(positions.size());
+		for (std::uint32_t vertex = 0; vertex < positions.size(); ++vertex) {
+			auto const [it, inserted] = map.insert({positions[vertex], static_cast<std::uint32_t>(node_vertices.size())});
+			if (inserted) { node_vertices.emplace_back(); }
+			node_of[vertex] = it->second;
+			node_vertices[it->second].push_back(vertex);
+		}
+	}
+
+	// an edge used by a single triangle lies on an open border: moving either end would erode the silhouette
+	void lock_borders() {
+		auto edges = std::unordered_map<std::uint64_t, std::uint32_t>{};
+		auto const key = [](std::uint32_t a, std::uint32_t b) { return (std::uint64_t{std::min(a, b)} << 32) | std::max(a, b); };
+		for (auto const& tri : triangles) {
+			for (std::size_t i = 0; i < 3; ++i) { ++edges[key(node_of[tri[i]], node_of[tri[(i + 1) % 3]])]; }
+		}
+		for (auto const& [edge, count] : edges) {
+			if (count != 1) { continue; }
+			locked[static_cast<std::uint32_t>(edge >> 32)] = true;
+			locked[static_cast<std::uint32_t>(edge & 0xffffffff)] = true;
+		}
+	}
+
+	// from is replaced by to's (only) vertex, so to must not be split across a seam
+	bool can_collapse(std::uint32_t from, std::uint32_t to) const {
+		return from != to && !removed[from] && !removed[to] && !locked[from] && node_vertices[to].size() == 1;
+	}
+
+	void push(std::uint32_t from, std::uint32_t to) {
+		if (!can_collapse(from, to)) { return; }
+		auto quadric = quadrics[from];
+		quadric += quadrics[to];
+		auto const target = glm::dvec3{positions[node_vertices[to].front()]};
+		queue.push(Collapse{quadric.error(target), from, to, versions[from], versions[to]});
+	}
+
+	// rejects collapses that would flip or degenerate any surviving triangle around from
+	bool flips(std::uint32_t from, std::uint32_t to) const {
+		auto const target = positions[node_vertices[to].front()];
+		for (auto const t : node_triangles[from]) {
+			if (!triangle_alive[t]) { continue; }
+			auto const& tri = triangles[t];
+			if (std::ranges::any_of(tri, [&](std::uint32_t v) { return node_of[v] == to; })) { continue; }
+			auto moved = std::array{positions[tri[0]], positions[tri[1]], positions[tri[2]]};
+			auto const before = face_normal(moved[0], moved[1], moved[2]);
+			if (glm::dot(before, before) <= 0.0f) { continue; }
+			for (std::size_t i = 0; i < 3; ++i) {
+				if (node_of[tri[i]] == from) { moved[i] = target; }
+			}
+			auto const after = face_normal(moved[0], moved[1], moved[2]);
+			if (glm::dot(before, after) <= 0.0f) { return true; }
+		}
+		return false;
+	}
+
+	void collapse(std::uint32_t from, std::uint32_t to) {
+		auto const vertex = node_vertices[to].front();
+		for (auto const t : node_triangles[from]) {
+			if (!triangle_alive[t]) { continue; }
+			auto& tri = triangles[t];
+			// welded degenerate triangles can be listed twice
+			if (std::ranges::none_of(tri, [&](std::uint32_t v) { return node_of[v] == from; })) { continue; }
+			bool degenerate{};
+			for (auto& v : tri) {
+				if (node_of[v] == to) { degenerate = true; }
+				if (node_of[v] == from) { v = vertex; }
+			}
+			if (degenerate) {
+				triangle_alive[t] = false;
+				--alive_count;
+			} else {
+				node_triangles[to].push_back(t);
+			}
+		}
+		node_triangles[from].clear();
+		quadrics[to] += quadrics[from];
+		removed[from] = true;
+		++versions[to];
+		for (auto const t : node_triangles[to]) {
+			if (!triangle_alive[t]) { continue; }
+			for (auto const v : triangles[t]) {
+				if (node_of[v] == to) { continue; }
+				push(node_of[v], to);
+				push(to, node_of[v]);
+			}
+		}
+	}
+
+	void run(std::size_t target_triangles) {
+		while (alive_count > target_triangles && !queue.empty()) {
+			auto const next = queue.top();
+			queue.pop();
+			if (!can_collapse(next.from, next.to)) { continue; }
+			if (versions[next.from] != next.from_version || versions[next.to] != next.to_version) { continue; }
+			if (flips(next.from, next.to)) { continue; }
+			collapse(next.from, next.to);
+		}
+	}
+};
+
+template <typename T>
+std::vector<T> remap(std::vector<T> const& in, std::span<std::uint32_t const> used) {
+	if (in.empty()) { return {}; }
+	auto ret = std::vector<T>{};
+	ret.reserve(used.size());
+	for (auto const vertex : used) { ret.push_back(in[vertex]); }
+	return ret;
+}
+} // namespace
+
+levk::asset::BinGeometry simplify(levk::asset::BinGeometry const& in, std::size_t target_triangles) {
+	auto const& geometry = in.geometry;
+	assert(geometry.indices.size() % 3 == 0);
+	auto simplifier = Simplifier{geometry.positions, geometry.indices};
+	simplifier.run(target_triangles);
+
+	// compact: keep only referenced vertices, in first-use order
+	constexpr auto unused_v = ~std::uint32_t{};
+	auto new_index = std::vector<std::uint32_t>(geometry.positions.size(), unused_v);
+	auto used = std::vector<std::uint32_t>{};
+	auto ret = levk::asset::BinGeometry{};
+	ret.geometry.indices.reserve(simplifier.alive_count * 3);
+	for (std::size_t t = 0; t < simplifier.triangles.size(); ++t) {
+		if (!simplifier.triangle_alive[t]) { continue; }
+		for (auto const vertex : simplifier.triangles[t]) {
+			if (new_index[vertex] == unused_v) {
+				new_index[vertex] = static_cast<std::uint32_t>(used.size());
+				used.push_back(vertex);
+			}
+			ret.geometry.indices.push_back(new_index[vertex]);
+		}
+	}
+	ret.geometry.positions = remap(geometry.positions, used);
+	ret.geometry.rgbs = remap(geometry.rgbs, used);
+	ret.geometry.normals = remap(geometry.normals, used);
+	ret.geometry.uvs = remap(geometry.uvs, used);
+	ret.joints = remap(in.joints, used);
+	ret.weights = remap(in.weights, used);
+	return ret;
+}
+} // namespace legsmi
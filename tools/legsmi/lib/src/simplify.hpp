@@ -0,0 +1,9 @@
+#pragma once
+#include <levk/asset/asset_io.hpp>
+
+namespace legsmi {
+// Reduces an indexed triangle list to at most target_triangles by quadric error edge collapse.
+// Vertices only ever collapse onto existing ones, so every vertex stream (including joints / weights) is carried over unchanged;
+// open borders and attribute seams are kept in place. Returns compacted geometry, with only the vertices still referenced.
+levk::asset::BinGeometry simplify(levk::asset::BinGeometry const& in, std::size_t target_triangles);
+} // namespace legsmi